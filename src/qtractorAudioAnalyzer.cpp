@@ -0,0 +1,685 @@
+// qtractorAudioAnalyzer.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2017, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorAudioAnalyzer.h"
+
+#include <math.h>
+
+
+// Integrated loudness gating histogram (-70..+5 LUFS, 0.1 LU steps).
+#define QTRACTOR_AUDIO_ANALYZER_GATE_MIN	-70.0f
+#define QTRACTOR_AUDIO_ANALYZER_GATE_BINS	750
+
+// Consumer side work buffer size (in frames).
+#define QTRACTOR_AUDIO_ANALYZER_FRAMES		4096
+
+
+#if defined(__SSE__)
+
+#include <xmmintrin.h>
+
+// SSE detection.
+static inline bool sse_enabled (void)
+{
+#if defined(__GNUC__)
+	unsigned int eax, ebx, ecx, edx;
+#if defined(__x86_64__) || (!defined(PIC) && !defined(__PIC__))
+	__asm__ __volatile__ (
+		"cpuid\n\t" \
+		: "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx) \
+		: "a" (1) : "cc");
+#else
+	__asm__ __volatile__ (
+		"push %%ebx\n\t" \
+		"cpuid\n\t" \
+		"movl %%ebx,%1\n\t" \
+		"pop %%ebx\n\t" \
+		: "=a" (eax), "=r" (ebx), "=c" (ecx), "=d" (edx) \
+		: "a" (1) : "cc");
+#endif
+	return (edx & (1 << 25));
+#else
+	return false;
+#endif
+}
+
+
+// SSE enabled kernel versions.
+static inline void sse_peak_sumsq (
+	const float *pFrames, unsigned int iFrames, float *pfPeak, double *pfSumSq )
+{
+	static const union { int i[4]; __m128 v; } abs_mask
+		= { { 0x7fffffff, 0x7fffffff, 0x7fffffff, 0x7fffffff } };
+
+	float fPeak = *pfPeak;
+	double fSumSq = 0.0;
+
+	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames) {
+		const float x = *pFrames++;
+		const float a = ::fabsf(x);
+		if (fPeak < a)
+			fPeak = a;
+		fSumSq += x * x;
+	}
+
+	__m128 vp = _mm_set1_ps(fPeak);
+	__m128 vs = _mm_setzero_ps();
+
+	for (; iFrames >= 4; iFrames -= 4) {
+		const __m128 v = _mm_load_ps(pFrames);
+		vp = _mm_max_ps(vp, _mm_and_ps(v, abs_mask.v));
+		vs = _mm_add_ps(vs, _mm_mul_ps(v, v));
+		pFrames += 4;
+	}
+
+	float afPeak[4], afSumSq[4];
+	_mm_storeu_ps(afPeak, vp);
+	_mm_storeu_ps(afSumSq, vs);
+	for (int k = 0; k < 4; ++k) {
+		if (fPeak < afPeak[k])
+			fPeak = afPeak[k];
+		fSumSq += afSumSq[k];
+	}
+
+	for (; iFrames > 0; --iFrames) {
+		const float x = *pFrames++;
+		const float a = ::fabsf(x);
+		if (fPeak < a)
+			fPeak = a;
+		fSumSq += x * x;
+	}
+
+	*pfPeak = fPeak;
+	*pfSumSq += fSumSq;
+}
+
+static inline float sse_dot12 ( const float *pX, const float *pH )
+{
+	__m128 v = _mm_mul_ps(_mm_loadu_ps(pX), _mm_loadu_ps(pH));
+	v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(pX + 4), _mm_loadu_ps(pH + 4)));
+	v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(pX + 8), _mm_loadu_ps(pH + 8)));
+
+	float af[4];
+	_mm_storeu_ps(af, v);
+	return (af[0] + af[1]) + (af[2] + af[3]);
+}
+
+#endif
+
+
+// Standard kernel versions.
+static inline void std_peak_sumsq (
+	const float *pFrames, unsigned int iFrames, float *pfPeak, double *pfSumSq )
+{
+	float fPeak = *pfPeak;
+	double fSumSq = 0.0;
+
+	for (unsigned int n = 0; n < iFrames; ++n) {
+		const float x = pFrames[n];
+		const float a = ::fabsf(x);
+		if (fPeak < a)
+			fPeak = a;
+		fSumSq += x * x;
+	}
+
+	*pfPeak = fPeak;
+	*pfSumSq += fSumSq;
+}
+
+static inline float std_dot12 ( const float *pX, const float *pH )
+{
+	float fSum = 0.0f;
+	for (int k = 0; k < 12; ++k)
+		fSum += pX[k] * pH[k];
+	return fSum;
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioAnalyzerThread -- Off-RT metering analysis thread.
+//
+
+// Constructor.
+qtractorAudioAnalyzerThread::qtractorAudioAnalyzerThread (
+	unsigned long iSyncPeriod ) : QThread()
+{
+	m_iSyncPeriod = iSyncPeriod;
+
+	m_bRunState = false;
+}
+
+// Destructor.
+qtractorAudioAnalyzerThread::~qtractorAudioAnalyzerThread (void)
+{
+	if (isRunning()) do {
+		setRunState(false);
+	//	terminate();
+		sync();
+	} while (!wait(100));
+}
+
+
+// Run state accessor.
+void qtractorAudioAnalyzerThread::setRunState ( bool bRunState )
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_bRunState = bRunState;
+}
+
+bool qtractorAudioAnalyzerThread::runState (void) const
+{
+	return m_bRunState;
+}
+
+
+// Analyzer (tap) registry (non RT-safe).
+void qtractorAudioAnalyzerThread::addAnalyzer (
+	qtractorAudioAnalyzer *pAnalyzer )
+{
+	QMutexLocker locker(&m_mutex);
+
+	if (!m_analyzers.contains(pAnalyzer))
+		m_analyzers.append(pAnalyzer);
+}
+
+void qtractorAudioAnalyzerThread::removeAnalyzer (
+	qtractorAudioAnalyzer *pAnalyzer )
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_analyzers.removeAll(pAnalyzer);
+}
+
+
+// Wake from executive wait condition (RT-safe).
+void qtractorAudioAnalyzerThread::sync (void)
+{
+	if (m_mutex.tryLock()) {
+		m_cond.wakeAll();
+		m_mutex.unlock();
+	}
+#ifdef CONFIG_DEBUG_0
+	else qDebug("qtractorAudioAnalyzerThread[%p]::sync(): tryLock() failed.", this);
+#endif
+}
+
+
+// Bypass executive wait condition (non RT-safe).
+void qtractorAudioAnalyzerThread::syncExport (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	process();
+}
+
+
+// Thread run executive.
+void qtractorAudioAnalyzerThread::run (void)
+{
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioAnalyzerThread[%p]::run(): started.", this);
+#endif
+
+	m_mutex.lock();
+
+	m_bRunState = true;
+
+	while (m_bRunState) {
+		// Do whatever we must, then wait for more...
+		process();
+		// Wait for next period (or sync)...
+		m_cond.wait(&m_mutex, m_iSyncPeriod);
+	}
+
+	m_mutex.unlock();
+
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioAnalyzerThread[%p]::run(): stopped.", this);
+#endif
+}
+
+
+// Thread run executive.
+void qtractorAudioAnalyzerThread::process (void)
+{
+	QListIterator<qtractorAudioAnalyzer *> iter(m_analyzers);
+	while (iter.hasNext())
+		iter.next()->process();
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioAnalyzer -- Lock-free audio tap and loudness meter.
+//
+
+// Silent/unmeasured loudness floor (LUFS).
+const float qtractorAudioAnalyzer::MinLoudness = -144.0f;
+
+
+// Constructor.
+qtractorAudioAnalyzer::qtractorAudioAnalyzer ( unsigned short iChannels,
+	unsigned int iSampleRate, unsigned int iBufferSize )
+{
+	m_iChannels   = iChannels;
+	m_iSampleRate = iSampleRate;
+
+	// Hold at least a quarter of a second worth of frames,
+	// or a few periods, whichever is the largest...
+	unsigned int iRingSize = (m_iSampleRate >> 2);
+	if (iRingSize < (iBufferSize << 2))
+		iRingSize = (iBufferSize << 2);
+
+	m_pRingBuffer = new qtractorRingBuffer<float> (m_iChannels, iRingSize);
+
+	ATOMIC_SET(&m_iOverruns, 0);
+	ATOMIC_SET(&m_iResetPending, 0);
+
+	m_iFrames  = QTRACTOR_AUDIO_ANALYZER_FRAMES;
+	m_ppFrames = new float * [m_iChannels];
+	for (unsigned short i = 0; i < m_iChannels; ++i)
+		m_ppFrames[i] = new float [m_iFrames];
+
+	// K-weighting pre-filter (ITU-R BS.1770-4), stage 1: high-shelf...
+	const double fs = double(m_iSampleRate);
+	double f0 = 1681.974450955533;
+	double G  = 3.999843853973347;
+	double Q  = 0.7071752369554196;
+	double K  = ::tan(M_PI * f0 / fs);
+	const double Vh = ::pow(10.0, G / 20.0);
+	const double Vb = ::pow(Vh, 0.4996667741545416);
+	double a0 = 1.0 + K / Q + K * K;
+	m_afKCoeffs[0][0] = float((Vh + Vb * K / Q + K * K) / a0);
+	m_afKCoeffs[0][1] = float(2.0 * (K * K - Vh) / a0);
+	m_afKCoeffs[0][2] = float((Vh - Vb * K / Q + K * K) / a0);
+	m_afKCoeffs[0][3] = float(2.0 * (K * K - 1.0) / a0);
+	m_afKCoeffs[0][4] = float((1.0 - K / Q + K * K) / a0);
+
+	// K-weighting pre-filter, stage 2: RLB high-pass...
+	f0 = 38.13547087602444;
+	Q  = 0.5003270373238773;
+	K  = ::tan(M_PI * f0 / fs);
+	a0 = 1.0 + K / Q + K * K;
+	m_afKCoeffs[1][0] =  1.0f;
+	m_afKCoeffs[1][1] = -2.0f;
+	m_afKCoeffs[1][2] =  1.0f;
+	m_afKCoeffs[1][3] = float(2.0 * (K * K - 1.0) / a0);
+	m_afKCoeffs[1][4] = float((1.0 - K / Q + K * K) / a0);
+
+	m_pfKState = new double [m_iChannels << 2];
+
+	// Channel weighting (surround channels +1.5dB, LFE excluded)...
+	m_pfWeights = new float [m_iChannels];
+	for (unsigned short i = 0; i < m_iChannels; ++i)
+		m_pfWeights[i] = 1.0f;
+	if (m_iChannels == 5) {
+		m_pfWeights[3] = m_pfWeights[4] = 1.41f;
+	}
+	else
+	if (m_iChannels == 6) {
+		m_pfWeights[3] = 0.0f;
+		m_pfWeights[4] = m_pfWeights[5] = 1.41f;
+	}
+
+	// True-peak 4x oversampling interpolator;
+	// 48-tap Hann-windowed sinc, split in 4 phases of 12 taps,
+	// stored reversed to match the (oldest first) history window...
+	for (int n = 0; n < 48; ++n) {
+		const double t = (double(n) - 23.5) / 4.0;
+		const double w = 0.5 - 0.5 * ::cos(2.0 * M_PI * (double(n) + 0.5) / 48.0);
+		const double h = (t == 0.0 ? 1.0 : ::sin(M_PI * t) / (M_PI * t));
+		m_afTpCoeffs[n & 3][11 - (n >> 2)] = float(h * w);
+	}
+
+	m_pfTpHistory = new float [m_iChannels * 24];
+	m_iTpIndex = 0;
+
+	// Sub-block accumulators (100ms).
+	m_iBlockSize = m_iSampleRate / 10;
+	if (m_iBlockSize < 1)
+		m_iBlockSize = 1;
+
+	m_pfBlockSumK  = new double [m_iChannels];
+	m_pfBlockSumSq = new double [m_iChannels];
+	m_pfPeak       = new float [m_iChannels];
+	m_pfTruePeak   = new float [m_iChannels];
+	m_pfHistSq     = new double [m_iChannels * 30];
+
+	m_pfGateEnergy = new double [QTRACTOR_AUDIO_ANALYZER_GATE_BINS];
+	m_piGateCount  = new unsigned int [QTRACTOR_AUDIO_ANALYZER_GATE_BINS];
+
+	m_values.peak.resize(m_iChannels);
+	m_values.truePeak.resize(m_iChannels);
+	m_values.rms.resize(m_iChannels);
+
+#if defined(__SSE__)
+	if (sse_enabled()) {
+		m_pfnPeakSumSq = sse_peak_sumsq;
+		m_pfnDot12 = sse_dot12;
+	} else {
+#endif
+	m_pfnPeakSumSq = std_peak_sumsq;
+	m_pfnDot12 = std_dot12;
+#if defined(__SSE__)
+	}
+#endif
+
+	clear();
+}
+
+
+// Destructor.
+qtractorAudioAnalyzer::~qtractorAudioAnalyzer (void)
+{
+	delete [] m_piGateCount;
+	delete [] m_pfGateEnergy;
+
+	delete [] m_pfHistSq;
+	delete [] m_pfTruePeak;
+	delete [] m_pfPeak;
+	delete [] m_pfBlockSumSq;
+	delete [] m_pfBlockSumK;
+
+	delete [] m_pfTpHistory;
+	delete [] m_pfWeights;
+	delete [] m_pfKState;
+
+	for (unsigned short i = 0; i < m_iChannels; ++i)
+		delete [] m_ppFrames[i];
+	delete [] m_ppFrames;
+
+	delete m_pRingBuffer;
+}
+
+
+// Block tap writer (RT-safe, never blocks).
+void qtractorAudioAnalyzer::write ( float **ppFrames, unsigned int iFrames )
+{
+	if (m_pRingBuffer->writable() < iFrames)
+		ATOMIC_INC(&m_iOverruns);
+	else
+		m_pRingBuffer->write(ppFrames, iFrames);
+}
+
+
+// Request all running statistics to reset (any thread).
+void qtractorAudioAnalyzer::reset (void)
+{
+	ATOMIC_SET(&m_iResetPending, 1);
+}
+
+
+// Reset analysis state (analysis thread only).
+void qtractorAudioAnalyzer::clear (void)
+{
+	unsigned int i;
+
+	for (i = 0; i < (unsigned int) (m_iChannels << 2); ++i)
+		m_pfKState[i] = 0.0;
+
+	for (i = 0; i < (unsigned int) (m_iChannels * 24); ++i)
+		m_pfTpHistory[i] = 0.0f;
+	m_iTpIndex = 0;
+
+	m_iBlockFrames = 0;
+	for (i = 0; i < m_iChannels; ++i) {
+		m_pfBlockSumK[i]  = 0.0;
+		m_pfBlockSumSq[i] = 0.0;
+		m_pfPeak[i]       = 0.0f;
+		m_pfTruePeak[i]   = 0.0f;
+	}
+
+	for (i = 0; i < 30; ++i)
+		m_afHistK[i] = 0.0;
+	for (i = 0; i < (unsigned int) (m_iChannels * 30); ++i)
+		m_pfHistSq[i] = 0.0;
+	m_iHistIndex = 0;
+	m_iHistCount = 0;
+
+	for (i = 0; i < QTRACTOR_AUDIO_ANALYZER_GATE_BINS; ++i) {
+		m_pfGateEnergy[i] = 0.0;
+		m_piGateCount[i]  = 0;
+	}
+
+	m_iTotalFrames = 0;
+
+	ATOMIC_SET(&m_iOverruns, 0);
+
+	QMutexLocker locker(&m_mutex);
+
+	for (i = 0; i < m_iChannels; ++i) {
+		m_values.peak[i]     = 0.0f;
+		m_values.truePeak[i] = 0.0f;
+		m_values.rms[i]      = 0.0f;
+	}
+
+	m_values.momentary  = MinLoudness;
+	m_values.shortTerm  = MinLoudness;
+	m_values.integrated = MinLoudness;
+	m_values.frames     = 0;
+	m_values.overruns   = 0;
+}
+
+
+// Analysis executive (analysis thread only).
+void qtractorAudioAnalyzer::process (void)
+{
+	// Pending reset? discard whatever's queued so far...
+	if (ATOMIC_TAZ(&m_iResetPending)) {
+		m_pRingBuffer->setReadIndex(m_pRingBuffer->writeIndex());
+		clear();
+	}
+
+	const unsigned int iReadable = m_pRingBuffer->readable();
+	if (iReadable < 1)
+		return;
+
+	int nread;
+	while ((nread = m_pRingBuffer->read(m_ppFrames, m_iFrames)) > 0) {
+		unsigned int iOffset = 0;
+		while (iOffset < (unsigned int) nread) {
+			unsigned int nframes = m_iBlockSize - m_iBlockFrames;
+			if (nframes > (unsigned int) nread - iOffset)
+				nframes = (unsigned int) nread - iOffset;
+			unsigned int iTpIndex = m_iTpIndex;
+			for (unsigned short i = 0; i < m_iChannels; ++i) {
+				const float *pFrames = m_ppFrames[i] + iOffset;
+				// Sample-peak and plain sum of squares...
+				(*m_pfnPeakSumSq)(pFrames, nframes,
+					&m_pfPeak[i], &m_pfBlockSumSq[i]);
+				// K-weighted sum of squares...
+				const float *b1 = m_afKCoeffs[0];
+				const float *b2 = m_afKCoeffs[1];
+				double *s = &m_pfKState[i << 2];
+				double z1 = s[0], z2 = s[1], z3 = s[2], z4 = s[3];
+				double fSumK = 0.0;
+				// True-peak oversampling history...
+				float *pHist = &m_pfTpHistory[i * 24];
+				float fTruePeak = m_pfTruePeak[i];
+				iTpIndex = m_iTpIndex;
+				for (unsigned int n = 0; n < nframes; ++n) {
+					const double x = pFrames[n];
+					const double y1 = b1[0] * x + z1;
+					z1 = b1[1] * x - b1[3] * y1 + z2;
+					z2 = b1[2] * x - b1[4] * y1;
+					const double y2 = b2[0] * y1 + z3;
+					z3 = b2[1] * y1 - b2[3] * y2 + z4;
+					z4 = b2[2] * y1 - b2[4] * y2;
+					fSumK += y2 * y2;
+					pHist[iTpIndex] = pHist[iTpIndex + 12] = pFrames[n];
+					const float *pWindow = pHist + iTpIndex + 1;
+					for (int p = 0; p < 4; ++p) {
+						const float fTp = ::fabsf(
+							(*m_pfnDot12)(pWindow, m_afTpCoeffs[p]));
+						if (fTruePeak < fTp)
+							fTruePeak = fTp;
+					}
+					if (++iTpIndex >= 12)
+						iTpIndex = 0;
+				}
+				s[0] = z1; s[1] = z2; s[2] = z3; s[3] = z4;
+				m_pfBlockSumK[i] += fSumK;
+				// True-peak is never below sample-peak, anyway...
+				if (fTruePeak < m_pfPeak[i])
+					fTruePeak = m_pfPeak[i];
+				m_pfTruePeak[i] = fTruePeak;
+			}
+			m_iTpIndex = iTpIndex;
+			m_iBlockFrames += nframes;
+			m_iTotalFrames += nframes;
+			iOffset += nframes;
+			// Sub-block complete?
+			if (m_iBlockFrames >= m_iBlockSize)
+				commit();
+		}
+	}
+
+	// Publish current (max-hold) peaks...
+	QMutexLocker locker(&m_mutex);
+
+	for (unsigned short i = 0; i < m_iChannels; ++i) {
+		m_values.peak[i] = m_pfPeak[i];
+		m_values.truePeak[i] = m_pfTruePeak[i];
+	}
+
+	m_values.frames = m_iTotalFrames;
+	m_values.overruns = ATOMIC_GET(&m_iOverruns);
+}
+
+
+// Complete a 100ms sub-block.
+void qtractorAudioAnalyzer::commit (void)
+{
+	unsigned short i;
+	unsigned int k, n;
+
+	// Store the channel-weighted mean-square energy of this sub-block...
+	const double fBlockFrames = double(m_iBlockFrames);
+	double z = 0.0;
+	for (i = 0; i < m_iChannels; ++i) {
+		z += m_pfWeights[i] * (m_pfBlockSumK[i] / fBlockFrames);
+		m_pfHistSq[m_iHistIndex * m_iChannels + i]
+			= m_pfBlockSumSq[i] / fBlockFrames;
+		m_pfBlockSumK[i]  = 0.0;
+		m_pfBlockSumSq[i] = 0.0;
+	}
+	m_afHistK[m_iHistIndex] = z;
+	m_iBlockFrames = 0;
+
+	if (++m_iHistIndex >= 30)
+		m_iHistIndex = 0;
+	if (m_iHistCount < 30)
+		++m_iHistCount;
+
+	// Momentary loudness (400ms)...
+	const unsigned int iMomentary = (m_iHistCount < 4 ? m_iHistCount : 4);
+	double zm = 0.0;
+	for (n = 0; n < iMomentary; ++n)
+		zm += m_afHistK[(m_iHistIndex + 29 - n) % 30];
+	zm /= double(iMomentary);
+
+	// Short-term loudness (3s)...
+	double zs = 0.0;
+	for (n = 0; n < m_iHistCount; ++n)
+		zs += m_afHistK[n];
+	zs /= double(m_iHistCount);
+
+	// Gating block (400ms, 75% overlap) above absolute threshold?
+	const float fMomentary = lufs(zm);
+	if (iMomentary >= 4 && fMomentary > QTRACTOR_AUDIO_ANALYZER_GATE_MIN) {
+		int iBin = int(10.0f * (fMomentary - QTRACTOR_AUDIO_ANALYZER_GATE_MIN));
+		if (iBin >= QTRACTOR_AUDIO_ANALYZER_GATE_BINS)
+			iBin  = QTRACTOR_AUDIO_ANALYZER_GATE_BINS - 1;
+		m_pfGateEnergy[iBin] += zm;
+		++m_piGateCount[iBin];
+	}
+
+	// Integrated loudness, with relative gate (-10 LU)...
+	double fSum = 0.0;
+	unsigned int iCount = 0;
+	for (k = 0; k < QTRACTOR_AUDIO_ANALYZER_GATE_BINS; ++k) {
+		fSum += m_pfGateEnergy[k];
+		iCount += m_piGateCount[k];
+	}
+
+	float fIntegrated = MinLoudness;
+	if (iCount > 0) {
+		const float fGate = lufs(fSum / double(iCount)) - 10.0f;
+		fSum = 0.0;
+		iCount = 0;
+		for (k = 0; k < QTRACTOR_AUDIO_ANALYZER_GATE_BINS; ++k) {
+			const float fBin = QTRACTOR_AUDIO_ANALYZER_GATE_MIN
+				+ 0.1f * (float(k) + 0.5f);
+			if (fBin >= fGate) {
+				fSum += m_pfGateEnergy[k];
+				iCount += m_piGateCount[k];
+			}
+		}
+		if (iCount > 0)
+			fIntegrated = lufs(fSum / double(iCount));
+	}
+
+	// Publish...
+	QMutexLocker locker(&m_mutex);
+
+	// RMS, over the same momentary window...
+	for (i = 0; i < m_iChannels; ++i) {
+		double fSumSq = 0.0;
+		for (n = 0; n < iMomentary; ++n)
+			fSumSq += m_pfHistSq[((m_iHistIndex + 29 - n) % 30) * m_iChannels + i];
+		m_values.rms[i] = float(::sqrt(fSumSq / double(iMomentary)));
+	}
+
+	m_values.momentary  = fMomentary;
+	m_values.shortTerm  = lufs(zs);
+	m_values.integrated = fIntegrated;
+}
+
+
+// Published statistics.
+qtractorAudioAnalyzer::Values qtractorAudioAnalyzer::values (void) const
+{
+	QMutexLocker locker(&m_mutex);
+
+	return m_values;
+}
+
+
+// Loudness/level conversion helpers.
+float qtractorAudioAnalyzer::lufs ( double fEnergy )
+{
+	if (fEnergy < 1E-15)
+		return MinLoudness;
+
+	return float(-0.691 + 10.0 * ::log10(fEnergy));
+}
+
+float qtractorAudioAnalyzer::dB ( float fValue )
+{
+	if (fValue < 1E-7f)
+		return MinLoudness;
+
+	return 20.0f * ::log10f(fValue);
+}
+
+
+// end of qtractorAudioAnalyzer.cpp
@@ -0,0 +1,211 @@
+// qtractorAudioAnalyzer.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2017, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorAudioAnalyzer_h
+#define __qtractorAudioAnalyzer_h
+
+#include "qtractorRingBuffer.h"
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
+#include <QList>
+
+
+// Forward declarations.
+class qtractorAudioAnalyzer;
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioAnalyzerThread -- Off-RT metering analysis thread.
+//
+
+class qtractorAudioAnalyzerThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorAudioAnalyzerThread(unsigned long iSyncPeriod = 20);
+
+	// Destructor.
+	~qtractorAudioAnalyzerThread();
+
+	// Thread run state accessors.
+	void setRunState(bool bRunState);
+	bool runState() const;
+
+	// Analyzer (tap) registry (non RT-safe).
+	void addAnalyzer(qtractorAudioAnalyzer *pAnalyzer);
+	void removeAnalyzer(qtractorAudioAnalyzer *pAnalyzer);
+
+	// Wake from executive wait condition (RT-safe).
+	void sync();
+
+	// Bypass executive wait condition (non RT-safe).
+	void syncExport();
+
+protected:
+
+	// The main thread executives.
+	void run();
+	void process();
+
+private:
+
+	// Instance variables.
+	unsigned long m_iSyncPeriod;
+
+	QList<qtractorAudioAnalyzer *> m_analyzers;
+
+	// Whether the thread is logically running.
+	volatile bool m_bRunState;
+
+	// Thread synchronization objects.
+	QMutex m_mutex;
+	QWaitCondition m_cond;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioAnalyzer -- Lock-free audio tap and loudness meter.
+//
+
+class qtractorAudioAnalyzer
+{
+public:
+
+	// Constructor.
+	qtractorAudioAnalyzer(unsigned short iChannels,
+		unsigned int iSampleRate, unsigned int iBufferSize);
+
+	// Destructor.
+	~qtractorAudioAnalyzer();
+
+	// Properties.
+	unsigned short channels() const { return m_iChannels; }
+	unsigned int sampleRate() const { return m_iSampleRate; }
+
+	// Block tap writer (RT-safe, never blocks).
+	void write(float **ppFrames, unsigned int iFrames);
+
+	// Analysis executive (analysis thread only).
+	void process();
+
+	// Request all running statistics to reset (any thread).
+	void reset();
+
+	// Published statistics.
+	struct Values
+	{
+		// Per-channel levels (linear).
+		QVector<float> peak;		// Sample-peak (max-hold).
+		QVector<float> truePeak;	// True-peak (max-hold).
+		QVector<float> rms;			// RMS (last 400ms).
+
+		// EBU R128 loudness (LUFS).
+		float momentary;
+		float shortTerm;
+		float integrated;
+
+		// Analysed/dropped frame counters.
+		unsigned long frames;
+		unsigned int  overruns;
+	};
+
+	Values values() const;
+
+	// Loudness/level conversion helpers.
+	static float lufs(double fEnergy);
+	static float dB(float fValue);
+
+	// Silent/unmeasured loudness floor (LUFS).
+	static const float MinLoudness;
+
+protected:
+
+	// Reset analysis state (analysis thread only).
+	void clear();
+
+	// Complete a 100ms sub-block.
+	void commit();
+
+private:
+
+	// Instance variables.
+	unsigned short m_iChannels;
+	unsigned int   m_iSampleRate;
+
+	// RT producer side.
+	qtractorRingBuffer<float> *m_pRingBuffer;
+	qtractorAtomic m_iOverruns;
+	qtractorAtomic m_iResetPending;
+
+	// Consumer side work buffer.
+	float **m_ppFrames;
+	unsigned int m_iFrames;
+
+	// K-weighting filter state (two biquads per channel).
+	float m_afKCoeffs[2][5];
+	double *m_pfKState;
+
+	// Per-channel loudness weights.
+	float *m_pfWeights;
+
+	// True-peak 4x oversampling polyphase filter.
+	float m_afTpCoeffs[4][12];
+	float *m_pfTpHistory;
+	unsigned int m_iTpIndex;
+
+	// Current 100ms sub-block accumulators.
+	unsigned int m_iBlockSize;
+	unsigned int m_iBlockFrames;
+	double *m_pfBlockSumK;
+	double *m_pfBlockSumSq;
+	float  *m_pfPeak;
+	float  *m_pfTruePeak;
+
+	// Sub-block history (last 3s, 30 x 100ms).
+	double  m_afHistK[30];
+	double *m_pfHistSq;
+	unsigned int m_iHistIndex;
+	unsigned int m_iHistCount;
+
+	// Integrated loudness gating histogram.
+	double *m_pfGateEnergy;
+	unsigned int *m_piGateCount;
+
+	unsigned long m_iTotalFrames;
+
+	// Published values.
+	Values m_values;
+
+	mutable QMutex m_mutex;
+
+	// SIMD kernels.
+	void  (*m_pfnPeakSumSq)(const float *, unsigned int, float *, double *);
+	float (*m_pfnDot12)(const float *, const float *);
+};
+
+
+#endif  // __qtractorAudioAnalyzer_h
+
+// end of qtractorAudioAnalyzer.h
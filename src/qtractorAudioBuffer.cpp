@@ -22,18 +22,243 @@
 #include "qtractorAbout.h"
 #include "qtractorAudioBuffer.h"
 #include "qtractorAudioPeak.h"
+#include "qtractorAudioCache.h"
 
 #include "qtractorTimeStretcher.h"
 
 #include "qtractorSession.h"
 #include "qtractorAudioEngine.h"
 
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QHash>
+#include <QMultiHash>
+
 #include <math.h>
 
+#if !defined(__WIN32__) && !defined(_WIN32) && !defined(WIN32)
+#include <sys/mman.h>
+#endif
+
 
 // Glitch, click, pop-free ramp length (in frames).
 #define QTRACTOR_RAMP_LENGTH	32
 
+// Pinned buffers read-sync block size cap (in frames).
+#define QTRACTOR_PINNED_BLOCK	16384
+
+
+// Pinned in-memory playback budget and totals lock.
+static QMutex g_pinnedMutex;
+
+
+// Pre-opened (prefetched) audio files, by name and channels.
+static QMultiHash<QString, qtractorAudioFile *> g_prefetchFiles;
+static QMutex g_prefetchMutex;
+
+static QString prefetchKey ( const QString& sFilename, unsigned short iChannels )
+{
+	return sFilename + QChar(':') + QString::number(iChannels);
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioBuffer::PinnedFile -- Pinned whole file image.
+//
+
+class qtractorAudioBuffer::PinnedFile
+{
+public:
+
+	// Constructor (pages are only touched on load).
+	PinnedFile(const QString& sKey,
+		unsigned short iChannels, unsigned long iFrames)
+		: m_sKey(sKey), m_iChannels(iChannels), m_iFrames(iFrames),
+			m_iLocked(0), m_iRefCount(1), m_bLoaded(false)
+	{
+		m_ppFrames = new float * [m_iChannels];
+		for (unsigned short i = 0; i < m_iChannels; ++i)
+			m_ppFrames[i] = new float [m_iFrames];
+	}
+
+	// Destructor.
+	~PinnedFile()
+	{
+		for (unsigned short i = 0; i < m_iChannels; ++i) {
+		#if !defined(__WIN32__) && !defined(_WIN32) && !defined(WIN32)
+			if (m_iLocked > 0)
+				::munlock(m_ppFrames[i], m_iFrames * sizeof(float));
+		#endif
+			delete [] m_ppFrames[i];
+		}
+		delete [] m_ppFrames;
+	}
+
+	// Accessors.
+	const QString& key() const { return m_sKey; }
+	float **frames() const { return m_ppFrames; }
+
+	unsigned long bytes() const
+		{ return m_iFrames * m_iChannels * sizeof(float); }
+	unsigned long locked() const
+		{ return m_iLocked; }
+
+	// Reference counting (under the pinned lock).
+	void addRef() { ++m_iRefCount; }
+	bool release() { return (--m_iRefCount < 1); }
+
+	// Decode the whole file in, only once (sync threads).
+	void load(qtractorAudioFile *pFile);
+
+	// All pinned files, by name, channels and rate.
+	static QHash<QString, PinnedFile *> g_files;
+
+private:
+
+	// Instance variables.
+	QString        m_sKey;
+	unsigned short m_iChannels;
+	unsigned long  m_iFrames;
+	unsigned long  m_iLocked;
+	int            m_iRefCount;
+	bool           m_bLoaded;
+	float        **m_ppFrames;
+	QMutex         m_mutex;
+};
+
+
+QHash<QString, qtractorAudioBuffer::PinnedFile *>
+	qtractorAudioBuffer::PinnedFile::g_files;
+
+
+// Decode the whole file in, only once (sync threads).
+void qtractorAudioBuffer::PinnedFile::load ( qtractorAudioFile *pFile )
+{
+	QMutexLocker locker(&m_mutex);
+
+	if (m_bLoaded)
+		return;
+
+	// Try to lock it in RAM (best effort)...
+	unsigned long iLocked = 0;
+#if !defined(__WIN32__) && !defined(_WIN32) && !defined(WIN32)
+	const unsigned long iChannelBytes = m_iFrames * sizeof(float);
+	for (unsigned short i = 0; i < m_iChannels; ++i) {
+		if (::mlock(m_ppFrames[i], iChannelBytes) == 0)
+			iLocked += iChannelBytes;
+	}
+#endif
+
+	unsigned long iFrames = 0;
+	float **ppFrames = new float * [m_iChannels];
+	if (pFile->seek(0)) {
+		while (iFrames < m_iFrames) {
+			unsigned int nahead = QTRACTOR_PINNED_BLOCK;
+			if (iFrames + nahead > m_iFrames)
+				nahead = m_iFrames - iFrames;
+			for (unsigned short i = 0; i < m_iChannels; ++i)
+				ppFrames[i] = m_ppFrames[i] + iFrames;
+			const int nread = pFile->read(ppFrames, nahead);
+			if (nread < 1)
+				break;
+			iFrames += nread;
+		}
+	}
+	delete [] ppFrames;
+
+	// Whatever falls short is silence...
+	if (iFrames < m_iFrames) {
+		for (unsigned short i = 0; i < m_iChannels; ++i) {
+			::memset(m_ppFrames[i] + iFrames, 0,
+				(m_iFrames - iFrames) * sizeof(float));
+		}
+	}
+
+	m_bLoaded = true;
+
+	QMutexLocker pinned_locker(&g_pinnedMutex);
+	m_iLocked = iLocked;
+	qtractorAudioBuffer::g_iPinnedLocked += iLocked;
+}
+
+
+#if defined(__SSE__)
+
+#include <xmmintrin.h>
+
+// SSE detection.
+static inline bool sse_enabled (void)
+{
+#if defined(__GNUC__)
+	unsigned int eax, ebx, ecx, edx;
+#if defined(__x86_64__) || (!defined(PIC) && !defined(__PIC__))
+	__asm__ __volatile__ (
+		"cpuid\n\t" \
+		: "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx) \
+		: "a" (1) : "cc");
+#else
+	__asm__ __volatile__ (
+		"push %%ebx\n\t" \
+		"cpuid\n\t" \
+		"movl %%ebx,%1\n\t" \
+		"pop %%ebx\n\t" \
+		: "=a" (eax), "=r" (ebx), "=c" (ecx), "=d" (edx) \
+		: "a" (1) : "cc");
+#endif
+	return (edx & (1 << 25));
+#else
+	return false;
+#endif
+}
+
+
+// SSE enabled per-frame fade-in/out gains mix-down version.
+static inline void sse_mix_fades ( float *pFrames, const float *pBuffer,
+	const float *pfFades, unsigned int iFrames, float fGainIter, float fGainStep )
+{
+	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames) {
+		*pFrames++ += fGainIter * *pfFades++ * *pBuffer++;
+		fGainIter += fGainStep;
+	}
+
+	if (iFrames >= 4) {
+		const float fGainStep4 = 4.0f * fGainStep;
+		__m128 v0 = _mm_setr_ps(
+			fGainIter, fGainIter + fGainStep,
+			fGainIter + 2.0f * fGainStep,
+			fGainIter + 3.0f * fGainStep);
+		const __m128 v1 = _mm_load_ps1(&fGainStep4);
+		for (; iFrames >= 4; iFrames -= 4) {
+			const __m128 v2 = _mm_mul_ps(
+				_mm_mul_ps(v0, _mm_loadu_ps(pfFades)), _mm_loadu_ps(pBuffer));
+			_mm_store_ps(pFrames, _mm_add_ps(_mm_load_ps(pFrames), v2));
+			v0 = _mm_add_ps(v0, v1);
+			pFrames += 4;
+			pfFades += 4;
+			pBuffer += 4;
+		}
+		_mm_store_ss(&fGainIter, v0);
+	}
+
+	for (; iFrames > 0; --iFrames) {
+		*pFrames++ += fGainIter * *pfFades++ * *pBuffer++;
+		fGainIter += fGainStep;
+	}
+}
+
+#endif
+
+
+// Standard per-frame fade-in/out gains mix-down version.
+static inline void std_mix_fades ( float *pFrames, const float *pBuffer,
+	const float *pfFades, unsigned int iFrames, float fGainIter, float fGainStep )
+{
+	for (unsigned int n = 0; n < iFrames; ++n) {
+		pFrames[n] += fGainIter * pfFades[n] * pBuffer[n];
+		fGainIter += fGainStep;
+	}
+}
+
 
 //----------------------------------------------------------------------
 // class qtractorAudioBufferThread -- Ring-cache manager thread.
@@ -51,7 +276,9 @@ qtractorAudioBufferThread::qtractorAudioBufferThread (
 	m_iSyncRead   = 0;
 	m_iSyncWrite  = 0;
 
-	m_bRunState = false;
+	// Logically running from the start, so that
+	// it can be stopped at any time, even before.
+	m_bRunState = true;
 }
 
 // Destructor.
@@ -80,6 +307,19 @@ bool qtractorAudioBufferThread::runState (void) const
 }
 
 
+// Stop and wait for the executive to finish (blocking):
+// one wake-up under lock is enough, it can't get lost.
+void qtractorAudioBufferThread::stop (void)
+{
+	m_mutex.lock();
+	m_bRunState = false;
+	m_cond.wakeAll();
+	m_mutex.unlock();
+
+	wait();
+}
+
+
 // Wake from executive wait condition (RT-safe).
 void qtractorAudioBufferThread::sync ( qtractorAudioBuffer *pAudioBuffer )
 {
@@ -139,8 +379,6 @@ void qtractorAudioBufferThread::run (void)
 
 	m_mutex.lock();
 
-	m_bRunState = true;
-
 	while (m_bRunState) {
 		// Do whatever we must, then wait for more...
 		process();
@@ -248,6 +486,17 @@ qtractorAudioBuffer::qtractorAudioBuffer (
 	m_fNextGain      = 0.0f;
 	m_iRampGain      = 1;
 
+	m_fLastGain      = 1.0f;
+	m_pfFadeBuffer   = NULL;
+	m_iFadeBufferSize = 0;
+
+#if defined(__SSE__)
+	if (sse_enabled())
+		m_pfnMixFades = sse_mix_fades;
+	else
+#endif
+	m_pfnMixFades = std_mix_fades;
+
 #ifdef CONFIG_LIBSAMPLERATE
 	m_bResample      = false;
 	m_fResampleRatio = 1.0f;
@@ -263,6 +512,20 @@ qtractorAudioBuffer::qtractorAudioBuffer (
 	m_bWsolaTimeStretch = g_bDefaultWsolaTimeStretch;
 	m_bWsolaQuickSeek   = g_bDefaultWsolaQuickSeek;
 
+	// Pinned in-memory playback state.
+	m_bPinned        = false;
+	m_pPinnedFile    = NULL;
+	m_iPinnedLength  = 0;
+	m_bPinnedPending = false;
+
+	// Recording (write-behind) I/O statistics.
+	m_iRecordRingSize    = 0;
+	m_iRecordHighWater   = 0;
+	m_iRecordDropped     = 0;
+	m_iRecordFrames      = 0;
+	m_iRecordBytes       = 0;
+	m_iRecordTime        = 0;
+	m_iRecordSampleBytes = sizeof(float);
 }
 
 // Default destructor.
@@ -323,17 +586,24 @@ bool qtractorAudioBuffer::open ( const QString& sFilename, int iMode )
 
 	const unsigned int iSampleRate = pSession->sampleRate();
 
-	// Get proper file type class...
-	m_pFile = qtractorAudioFileFactory::createAudioFile(
-		sFilename, m_iChannels, iSampleRate);
-	if (m_pFile == NULL)
-		return false;
+	// Already open off the main thread (eg. while loading)?
+	if ((iMode & qtractorAudioFile::Write) == 0) {
+		QMutexLocker locker(&g_prefetchMutex);
+		m_pFile = g_prefetchFiles.take(prefetchKey(sFilename, m_iChannels));
+	}
 
-	// Go open it...
-	if (!m_pFile->open(sFilename, iMode)) {
-		delete m_pFile;
-		m_pFile = NULL;
-		return false;
+	if (m_pFile == NULL) {
+		// Get proper file type class...
+		m_pFile = qtractorAudioFileFactory::createAudioFile(
+			sFilename, m_iChannels, iSampleRate);
+		if (m_pFile == NULL)
+			return false;
+		// Go open it...
+		if (!m_pFile->open(sFilename, iMode)) {
+			delete m_pFile;
+			m_pFile = NULL;
+			return false;
+		}
 	}
 
 	// Check samplerate and how many channels there really are.
@@ -347,6 +617,42 @@ bool qtractorAudioBuffer::open ( const QString& sFilename, int iMode )
 		return false;
 	}
 
+	// Compressed and sample-rate mismatched sources are best played
+	// from their background transcoded cache, whenever ready...
+	QString sReadFile = sFilename;
+	if ((iMode & qtractorAudioFile::Write) == 0) {
+		bool bTranscode = qtractorAudioCacheFactory::isCompressed(sFilename);
+	#ifdef CONFIG_LIBSAMPLERATE
+		if (iSampleRate != m_pFile->sampleRate())
+			bTranscode = true;
+	#endif
+		qtractorAudioCacheFactory *pCacheFactory
+			= pSession->audioCacheFactory();
+		if (bTranscode && pCacheFactory) {
+			const QString& sCacheFile
+				= pCacheFactory->cacheFile(sFilename, iSampleRate);
+			if (!sCacheFile.isEmpty()) {
+				qtractorAudioFile *pCacheFile
+					= qtractorAudioFileFactory::createAudioFile(
+						sCacheFile, m_iChannels, iSampleRate);
+				if (pCacheFile
+					&& pCacheFile->open(sCacheFile, iMode)
+					&& pCacheFile->channels() == iBuffers
+					&& pCacheFile->sampleRate() == iSampleRate) {
+					m_pFile->close();
+					delete m_pFile;
+					m_pFile = pCacheFile;
+					sReadFile = sCacheFile;
+				}
+				else
+				if (pCacheFile) {
+					pCacheFile->close();
+					delete pCacheFile;
+				}
+			}
+		}
+	}
+
 #ifdef CONFIG_LIBSAMPLERATE
 	// Compute sample rate converter stuff.
 	m_iInputPending  = 0;
@@ -377,9 +683,78 @@ bool qtractorAudioBuffer::open ( const QString& sFilename, int iMode )
 	if (iBufferSize > (iSampleRate << 2))
 		iBufferSize = (iSampleRate << 2);
 
-	m_pRingBuffer = new qtractorRingBuffer<float> (iBuffers, iBufferSize);
-	m_iThreshold  = (m_pRingBuffer->bufferSize() >> 2);
-	m_iBufferSize = (m_iThreshold >> 2);
+	// Recording gets a much larger write-behind ring-buffer,
+	// flushed out to disk in fewer, coalesced large blocks...
+	if (iMode & qtractorAudioFile::Write)
+		iBufferSize = (iSampleRate << 2);
+
+	// Pinned playback gets the whole file in memory, exactly sized,
+	// once per file and rate, whenever it fits the budget; all clips
+	// on it just read through their own offset views...
+	const unsigned long iFileFrames = m_pFile->frames();
+	if ((iMode & qtractorAudioFile::Write) == 0
+		&& m_bPinned && !m_bTimeStretch && !m_bPitchShift
+	#ifdef CONFIG_LIBSAMPLERATE
+		&& !m_bResample
+	#endif
+		&& m_iOffset < iFileFrames && iFileFrames < (1UL << 30)) {
+		const QString& sKey = prefetchKey(sReadFile, iBuffers)
+			+ QChar(':') + QString::number(iSampleRate);
+		QMutexLocker locker(&g_pinnedMutex);
+		PinnedFile *pPinnedFile = PinnedFile::g_files.value(sKey, NULL);
+		if (pPinnedFile) {
+			pPinnedFile->addRef();
+		} else {
+			const unsigned long iPinnedBytes
+				= iFileFrames * iBuffers * sizeof(float);
+			if (g_iPinnedBudget > 0
+				&& g_iPinnedBytes + iPinnedBytes <= g_iPinnedBudget) {
+				pPinnedFile = new PinnedFile(sKey, iBuffers, iFileFrames);
+				PinnedFile::g_files.insert(sKey, pPinnedFile);
+				g_iPinnedBytes += pPinnedFile->bytes();
+			}
+		}
+		if (pPinnedFile) {
+			m_pPinnedFile = pPinnedFile;
+			m_iPinnedLength = iFileFrames - m_iOffset;
+			if (m_iPinnedLength > m_iLength)
+				m_iPinnedLength = m_iLength;
+			++g_iPinnedPending;
+			m_bPinnedPending = true;
+		}
+	}
+
+	if (m_pPinnedFile) {
+		m_pRingBuffer = new qtractorRingBuffer<float> (
+			m_pPinnedFile->frames(), iBuffers, m_iPinnedLength, m_iOffset);
+	} else {
+		m_pRingBuffer = new qtractorRingBuffer<float> (iBuffers, iBufferSize);
+	}
+
+	if (iMode & qtractorAudioFile::Write) {
+		m_iThreshold  = (m_pRingBuffer->bufferSize() >> 3);
+		m_iBufferSize = m_iThreshold;
+	} else {
+		m_iThreshold  = (m_pRingBuffer->bufferSize() >> 2);
+		m_iBufferSize = (m_iThreshold >> 2);
+		if (m_pPinnedFile && m_iBufferSize > QTRACTOR_PINNED_BLOCK)
+			m_iBufferSize = QTRACTOR_PINNED_BLOCK;
+	}
+
+	// Reset recording (write-behind) I/O statistics...
+	m_iRecordRingSize  = m_pRingBuffer->bufferSize();
+	m_iRecordHighWater = 0;
+	m_iRecordDropped   = 0;
+	m_iRecordFrames    = 0;
+	m_iRecordBytes     = 0;
+	m_iRecordTime      = 0;
+	m_iRecordSampleBytes = sizeof(float);
+	if (iMode & qtractorAudioFile::Write) {
+		const unsigned short iBits
+			= qtractorAudioFileFactory::formatBits(sFilename, -1);
+		if (iBits > 0)
+			m_iRecordSampleBytes = (iBits >> 3);
+	}
 
 #ifdef CONFIG_LIBSAMPLERATE
 	if (m_bResample && m_fResampleRatio < 1.0f) {
@@ -431,6 +806,9 @@ bool qtractorAudioBuffer::open ( const QString& sFilename, int iMode )
 		m_ppBuffer = new float * [iBuffers];
 		for (i = 0; i < iBuffers; ++i)
 			m_ppBuffer[i] = new float [iBufferSize];
+		// Per-frame fade-in/out gains, likewise...
+		m_pfFadeBuffer = new float [iBufferSize];
+		m_iFadeBufferSize = iBufferSize;
 	}
 
 	// Rebuild the whole panning-gain array...
@@ -508,12 +886,38 @@ void qtractorAudioBuffer::close (void)
 		m_ppBuffer = NULL;
 	}
 
+	if (m_pfFadeBuffer) {
+		delete [] m_pfFadeBuffer;
+		m_pfFadeBuffer = NULL;
+		m_iFadeBufferSize = 0;
+	}
+
 	if (m_pRingBuffer) {
 		deleteIOBuffers();
 		delete m_pRingBuffer;
 		m_pRingBuffer = NULL;
 	}
 
+	// Release pinned memory, if the last one on it...
+	if (m_pPinnedFile) {
+		PinnedFile *pPinnedFile = NULL;
+		g_pinnedMutex.lock();
+		if (m_bPinnedPending)
+			--g_iPinnedPending;
+		if (m_pPinnedFile->release()) {
+			pPinnedFile = m_pPinnedFile;
+			PinnedFile::g_files.remove(pPinnedFile->key());
+			g_iPinnedBytes  -= pPinnedFile->bytes();
+			g_iPinnedLocked -= pPinnedFile->locked();
+		}
+		g_pinnedMutex.unlock();
+		if (pPinnedFile)
+			delete pPinnedFile;
+		m_pPinnedFile    = NULL;
+		m_iPinnedLength  = 0;
+		m_bPinnedPending = false;
+	}
+
 	// Finally delete what we still own.
 	if (m_pFile) {
 		delete m_pFile;
@@ -537,6 +941,7 @@ void qtractorAudioBuffer::close (void)
 
 	m_fNextGain = 0.0f;
 	m_iRampGain = 1;
+	m_fLastGain = m_fGain;
 
 	m_pPeakFile = NULL;
 }
@@ -688,6 +1093,13 @@ int qtractorAudioBuffer::write ( float **ppFrames, unsigned int iFrames,
 	// Make it statiscally correct...
 	m_iWriteOffset += nwrite;
 
+	// Recording (write-behind) statistics...
+	if (nwrite < iFrames)
+		m_iRecordDropped += (iFrames - nwrite);
+	const unsigned int rs = m_pRingBuffer->readable();
+	if (m_iRecordHighWater < rs)
+		m_iRecordHighWater = rs;
+
 	// Time to sync()?
 	if (m_pSyncThread && m_pRingBuffer->readable() > m_iThreshold)
 		m_pSyncThread->sync(this);
@@ -698,7 +1110,8 @@ int qtractorAudioBuffer::write ( float **ppFrames, unsigned int iFrames,
 
 // Special kind of super-read/channel-mix.
 int qtractorAudioBuffer::readMix ( float **ppFrames, unsigned int iFrames,
-	unsigned short iChannels, unsigned int iOffset, float fGain )
+	unsigned short iChannels, unsigned int iOffset, float fGain,
+	const float *pfFades )
 {
 	if (m_pRingBuffer == NULL)
 		return -1;
@@ -740,9 +1153,12 @@ int qtractorAudioBuffer::readMix ( float **ppFrames, unsigned int iFrames,
 			const unsigned int ri = m_pRingBuffer->readIndex();
 			while (ri < le && ri + iFrames >= le && nread > 0) {
 				m_iRampGain = -1;
-				nread = readMixFrames(ppFrames, le - ri, iChannels, iOffset, fGain);
+				nread = readMixFrames(ppFrames, le - ri,
+					iChannels, iOffset, fGain, pfFades);
 				iFrames -= nread;
 				iOffset += nread;
+				if (pfFades)
+					pfFades += nread;
 				ro = m_iOffset + ls;
 				m_pRingBuffer->setReadIndex(ls);
 			}
@@ -751,9 +1167,12 @@ int qtractorAudioBuffer::readMix ( float **ppFrames, unsigned int iFrames,
 			le += m_iOffset;
 			while (le >= ro && ro + iFrames >= le && nread > 0) {
 				m_iRampGain = -1;
-				nread = readMixFrames(ppFrames, le - ro, iChannels, iOffset, fGain);
+				nread = readMixFrames(ppFrames, le - ro,
+					iChannels, iOffset, fGain, pfFades);
 				iFrames -= nread;
 				iOffset += nread;
+				if (pfFades)
+					pfFades += nread;
 				ro = ls;
 			}
 		}
@@ -765,7 +1184,8 @@ int qtractorAudioBuffer::readMix ( float **ppFrames, unsigned int iFrames,
 		m_iRampGain = -1;
 
 	// Mix the (remaining) data around...
-	nread = readMixFrames(ppFrames, iFrames, iChannels, iOffset, fGain);
+	nread = readMixFrames(ppFrames, iFrames,
+		iChannels, iOffset, fGain, pfFades);
 	m_iReadOffset = (ro + nread);
 	if (m_iReadOffset >= re) {
 		// Force out-of-sync...
@@ -800,6 +1220,7 @@ bool qtractorAudioBuffer::seek ( unsigned long iFrame )
 	// Reset running gain...
 	m_fNextGain = 0.0f;
 	m_iRampGain = 1;
+	m_fLastGain = m_fGain;
 
 	// Are we off-limits?
 	if (iFrame >= m_iLength)
@@ -905,33 +1326,52 @@ void qtractorAudioBuffer::initSync (void)
 	// Reset running gain...
 	m_fNextGain = 0.0f;
 	m_iRampGain = 1;
-
-	// Set to initial offset...
-	m_iSeekOffset = m_iOffset;
-
-	ATOMIC_INC(&m_seekPending);
-
-	// Initial buffer read in...
-	readSync();
-
-	// We're mostly done with initialization...
-	// m_bInitSync = true;
-	setSyncFlag(InitSync);
-
-	// Check if fitted integrally...
-	if (m_iFileLength < m_iOffset + m_pRingBuffer->bufferSize() - 1) {
-		m_bIntegral = true;
+	m_fLastGain = m_fGain;
+
+	// Pinned buffers just view the shared whole file image...
+	if (m_pPinnedFile) {
+		m_pPinnedFile->load(m_pFile);
+		m_pRingBuffer->setReadIndex(0);
+		m_pRingBuffer->setWriteIndex(m_iPinnedLength);
+		m_iReadOffset  = m_iOffset;
+		m_iWriteOffset = m_iOffset + m_iPinnedLength;
+		m_iFileLength  = m_iWriteOffset;
+		m_bIntegral    = true;
 		deleteIOBuffers();
-	}
-	else // Re-sync if loop falls short in initial area... 
-	if (m_iLoopStart < m_iLoopEnd
-		&& m_iWriteOffset >= m_iOffset + m_iLoopEnd) {
-		// Will do it again, but now we're
-		// sure we aren't fit integral...
+		setSyncFlag(InitSync);
+	} else {
+		// Set to initial offset...
 		m_iSeekOffset = m_iOffset;
 		ATOMIC_INC(&m_seekPending);
-		// Initial buffer re-read in...
+		// Initial buffer read in...
 		readSync();
+		// We're mostly done with initialization...
+		// m_bInitSync = true;
+		setSyncFlag(InitSync);
+		// Check if fitted integrally...
+		if (m_iFileLength < m_iOffset + m_pRingBuffer->bufferSize() - 1) {
+			m_bIntegral = true;
+			deleteIOBuffers();
+		}
+		else // Re-sync if loop falls short in initial area...
+		if (m_iLoopStart < m_iLoopEnd
+			&& m_iWriteOffset >= m_iOffset + m_iLoopEnd) {
+			// Will do it again, but now we're
+			// sure we aren't fit integral...
+			m_iSeekOffset = m_iOffset;
+			ATOMIC_INC(&m_seekPending);
+			// Initial buffer re-read in...
+			readSync();
+		}
+	}
+
+	// Pinned buffers are now done preloading...
+	if (m_bPinnedPending) {
+		QMutexLocker locker(&g_pinnedMutex);
+		if (m_bPinnedPending) {
+			--g_iPinnedPending;
+			m_bPinnedPending = false;
+		}
 	}
 
 	// Make sure we're not closing anymore,
@@ -1007,6 +1447,10 @@ void qtractorAudioBuffer::readSync (void)
 	if (m_pRingBuffer == NULL)
 		return;
 
+	// Pinned buffers have it all already...
+	if (m_pPinnedFile)
+		return;
+
 	if (isSyncFlag(CloseSync))
 		return;
 
@@ -1085,10 +1529,17 @@ void qtractorAudioBuffer::writeSync (void)
 	if (m_pRingBuffer == NULL)
 		return;
 
-	const unsigned int rs = m_pRingBuffer->readable();
+	unsigned int rs = m_pRingBuffer->readable();
+
+	// Coalesce into whole large blocks, unless closing...
+	if (!isSyncFlag(CloseSync))
+		rs -= (rs % m_iBufferSize);
 	if (rs == 0)
 		return;
 
+	QElapsedTimer timer;
+	timer.start();
+
 	unsigned int nwrite;
 	unsigned int nbehind = rs;
 	unsigned int ntotal  = 0;
@@ -1113,6 +1564,31 @@ void qtractorAudioBuffer::writeSync (void)
 			nbehind = rs - ntotal;
 		}
 	}
+
+	// Account for disk throughput...
+	m_iRecordFrames = m_iFileLength;
+	m_iRecordBytes += ntotal
+		* m_pRingBuffer->channels() * m_iRecordSampleBytes;
+	m_iRecordTime += (unsigned long) (timer.nsecsElapsed() / 1000);
+}
+
+
+// Recording (write-behind) I/O statistics.
+qtractorAudioBuffer::RecordStats qtractorAudioBuffer::recordStats (void) const
+{
+	RecordStats stats;
+
+	if (m_iRecordRingSize > 0) {
+		stats.highWater = (100 * (unsigned long) m_iRecordHighWater)
+			/ m_iRecordRingSize;
+	}
+
+	stats.frames  = m_iRecordFrames;
+	stats.dropped = m_iRecordDropped;
+	stats.bytes   = m_iRecordBytes;
+	stats.usecs   = m_iRecordTime;
+
+	return stats;
 }
 
 
@@ -1305,7 +1781,7 @@ int qtractorAudioBuffer::writeBuffer ( unsigned int iFrames )
 // Special kind of super-read/channel-mix buffer helper.
 int qtractorAudioBuffer::readMixFrames (
 	float **ppFrames, unsigned int iFrames, unsigned short iChannels,
-	unsigned int iOffset, float fGain )
+	unsigned int iOffset, float fGain, const float *pfFades )
 {
 	if (iFrames == 0)
 		return 0;
@@ -1338,9 +1814,43 @@ int qtractorAudioBuffer::readMixFrames (
 	//	fPrevGain = fGain;
 	}
 
+	// Per-frame fade-in/out gains, ramping on the clip gain only...
+	if (pfFades) {
+		const float fPrevGain = fGain * m_fLastGain;
+		m_fLastGain = m_fGain;
+		m_fNextGain = fGain * m_fGain * pfFades[nread - 1];
+		fGainStep1 = (fGain * m_fGain - fPrevGain) / float(nread);
+		if (iChannels == iBuffers) {
+			for (i = 0; i < iBuffers; ++i) {
+				(*m_pfnMixFades)(ppFrames[i] + iOffset, m_ppBuffer[i], pfFades,
+					nread, fPrevGain * m_pfGains[i], fGainStep1 * m_pfGains[i]);
+			}
+		}
+		else if (iChannels > iBuffers) {
+			j = 0;
+			for (i = 0; i < iChannels; ++i) {
+				(*m_pfnMixFades)(ppFrames[i] + iOffset, m_ppBuffer[j], pfFades,
+					nread, fPrevGain * m_pfGains[j], fGainStep1 * m_pfGains[j]);
+				if (++j >= iBuffers)
+					j = 0;
+			}
+		}
+		else { // (iChannels < iBuffers)
+			i = 0;
+			for (j = 0; j < iBuffers; ++j) {
+				(*m_pfnMixFades)(ppFrames[i] + iOffset, m_ppBuffer[j], pfFades,
+					nread, fPrevGain * m_pfGains[j], fGainStep1 * m_pfGains[j]);
+				if (++i >= iChannels)
+					i = 0;
+			}
+		}
+		return nread;
+	}
+
 	// Reset running gain...
 	const float fPrevGain = m_fNextGain;
 	m_fNextGain = fGain * m_fGain;
+	m_fLastGain = m_fGain;
 	fGainStep1 = (m_fNextGain - fPrevGain) / float(nread);
 
 	if (iChannels == iBuffers) {
@@ -1692,4 +2202,112 @@ bool qtractorAudioBuffer::isDefaultWsolaQuickSeek (void)
 }
 
 
+// Pinned in-memory playback eligibility (local option).
+void qtractorAudioBuffer::setPinned ( bool bPinned )
+{
+	m_bPinned = bPinned;
+}
+
+bool qtractorAudioBuffer::isPinned (void) const
+{
+	return m_bPinned;
+}
+
+
+// Actual pinned (whole-file) footprint, in bytes (shared).
+unsigned long qtractorAudioBuffer::pinnedBytes (void) const
+{
+	return (m_pPinnedFile ? m_pPinnedFile->bytes() : 0);
+}
+
+
+// Pinned in-memory playback budget (global option).
+unsigned long qtractorAudioBuffer::g_iPinnedBudget  = 0;
+unsigned long qtractorAudioBuffer::g_iPinnedBytes   = 0;
+unsigned long qtractorAudioBuffer::g_iPinnedLocked  = 0;
+int           qtractorAudioBuffer::g_iPinnedPending = 0;
+
+void qtractorAudioBuffer::setPinnedBudget ( unsigned long iPinnedBudget )
+{
+	QMutexLocker locker(&g_pinnedMutex);
+
+	g_iPinnedBudget = iPinnedBudget;
+}
+
+unsigned long qtractorAudioBuffer::pinnedBudget (void)
+{
+	QMutexLocker locker(&g_pinnedMutex);
+
+	return g_iPinnedBudget;
+}
+
+
+// Pinned in-memory playback statistics (global).
+qtractorAudioBuffer::PinnedStats qtractorAudioBuffer::pinnedStats (void)
+{
+	QMutexLocker locker(&g_pinnedMutex);
+
+	PinnedStats stats;
+	stats.bytes   = g_iPinnedBytes;
+	stats.locked  = g_iPinnedLocked;
+	stats.pending = g_iPinnedPending;
+
+	return stats;
+}
+
+
+// Open an audio file for reading, ahead of its buffer (any thread).
+bool qtractorAudioBuffer::prefetchFile (
+	const QString& sFilename, unsigned short iChannels )
+{
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == NULL)
+		return false;
+
+	qtractorAudioFile *pFile = qtractorAudioFileFactory::createAudioFile(
+		sFilename, iChannels, pSession->sampleRate());
+	if (pFile == NULL)
+		return false;
+
+	if (!pFile->open(sFilename)) {
+		delete pFile;
+		return false;
+	}
+
+	QMutexLocker locker(&g_prefetchMutex);
+	g_prefetchFiles.insert(prefetchKey(sFilename, iChannels), pFile);
+
+	return true;
+}
+
+
+// Whether an audio file is already open for reading (any thread).
+bool qtractorAudioBuffer::isPrefetchFile (
+	const QString& sFilename, unsigned short iChannels )
+{
+	QMutexLocker locker(&g_prefetchMutex);
+
+	return g_prefetchFiles.contains(prefetchKey(sFilename, iChannels));
+}
+
+
+// Close all pre-opened audio files left unclaimed (any thread).
+void qtractorAudioBuffer::clearPrefetchFiles (void)
+{
+	QMutexLocker locker(&g_prefetchMutex);
+
+	QMultiHash<QString, qtractorAudioFile *>::ConstIterator iter
+		= g_prefetchFiles.constBegin();
+	const QMultiHash<QString, qtractorAudioFile *>::ConstIterator& iter_end
+		= g_prefetchFiles.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		qtractorAudioFile *pFile = iter.value();
+		pFile->close();
+		delete pFile;
+	}
+
+	g_prefetchFiles.clear();
+}
+
+
 // end of qtractorAudioBuffer.cpp
@@ -60,6 +60,9 @@ public:
 	void setRunState(bool bRunState);
 	bool runState() const;
 
+	// Stop and wait for the executive to finish (blocking).
+	void stop();
+
 	// Wake from executive wait condition (RT-safe).
 	void sync(qtractorAudioBuffer *pAudioBuffer = NULL);
 
@@ -132,9 +135,16 @@ public:
 	int write(float **ppFrames, unsigned int iFrames,
 		unsigned short iChannels = 0, unsigned int iOffset = 0);
 
-	// Special kind of super-read/channel-mix.
+	// Special kind of super-read/channel-mix
+	// (optionally with per-frame fade-in/out gains).
 	int readMix(float **ppFrames, unsigned int iFrames,
-		unsigned short iChannels, unsigned int iOffset, float fGain);
+		unsigned short iChannels, unsigned int iOffset, float fGain,
+		const float *pfFades = NULL);
+
+	// Per-frame fade-in/out gains scratch buffer (for readMix);
+	// null if there's not enough room for the requested frames.
+	float *fadeBuffer(unsigned int iFrames) const
+		{ return (iFrames <= m_iFadeBufferSize ? m_pfFadeBuffer : NULL); }
 
 	// Buffer data seek.
 	bool seek(unsigned long iFrame);
@@ -218,6 +228,56 @@ public:
 	static void setDefaultResampleType(int iResampleType);
 	static int defaultResampleType();
 
+	// Pinned in-memory playback eligibility (local option).
+	void setPinned(bool bPinned);
+	bool isPinned() const;
+
+	// Actual pinned (whole-file) footprint, in bytes;
+	// shared by all buffers on the same file and rate.
+	unsigned long pinnedBytes() const;
+
+	// Pinned in-memory playback budget, in bytes (global option);
+	// zero means pinned mode is off altogether.
+	static void setPinnedBudget(unsigned long iPinnedBudget);
+	static unsigned long pinnedBudget();
+
+	// Pinned in-memory playback statistics (global).
+	struct PinnedStats
+	{
+		// Constructor.
+		PinnedStats() : bytes(0), locked(0), pending(0) {}
+
+		// Members.
+		unsigned long bytes;        // bytes pinned in memory.
+		unsigned long locked;       // bytes locked in RAM (mlock).
+		int           pending;      // buffers still preloading.
+	};
+
+	static PinnedStats pinnedStats();
+
+	// Audio files open for reading ahead of their buffers,
+	// off the main thread (eg. while loading); any buffer
+	// opening the same file and channels claims it instead.
+	static bool prefetchFile(const QString& sFilename, unsigned short iChannels);
+	static bool isPrefetchFile(const QString& sFilename, unsigned short iChannels);
+	static void clearPrefetchFiles();
+
+	// Recording (write-behind) I/O statistics.
+	struct RecordStats
+	{
+		// Constructor.
+		RecordStats() : frames(0), highWater(0), dropped(0), bytes(0), usecs(0) {}
+
+		// Members.
+		unsigned long frames;       // frames written out to disk.
+		unsigned int  highWater;    // ring-buffer peak fill (%).
+		unsigned long dropped;      // frames dropped (overruns).
+		unsigned long bytes;        // bytes written out to disk.
+		unsigned long usecs;        // time spent writing (usecs).
+	};
+
+	RecordStats recordStats() const;
+
 protected:
 
 	// Read-sync mode methods (playback).
@@ -239,7 +299,8 @@ protected:
 
 	// Special kind of super-read/channel-mix buffer helper.
 	int readMixFrames(float **ppFrames, unsigned int iFrames,
-		unsigned short iChannels, unsigned int iOffset, float fGain);
+		unsigned short iChannels, unsigned int iOffset, float fGain,
+		const float *pfFades);
 
 	// I/O buffer release.
 	void deleteIOBuffers();
@@ -298,6 +359,14 @@ private:
 	float          m_fNextGain;
 	int            m_iRampGain;
 
+	// Per-frame fade-in/out gains mix-down.
+	float          m_fLastGain;
+	float         *m_pfFadeBuffer;
+	unsigned int   m_iFadeBufferSize;
+
+	void (*m_pfnMixFades)(float *, const float *, const float *,
+		unsigned int, float, float);
+
 #ifdef CONFIG_LIBSAMPLERATE
 	bool           m_bResample;
 	float          m_fResampleRatio;
@@ -319,6 +388,29 @@ private:
 
 	// Sample-rate converter type global option.
 	static int     g_iDefaultResampleType;
+
+	// Pinned in-memory playback state.
+	class PinnedFile;
+
+	bool           m_bPinned;
+	PinnedFile    *m_pPinnedFile;
+	unsigned long  m_iPinnedLength;
+	bool           m_bPinnedPending;
+
+	// Pinned in-memory playback budget and totals.
+	static unsigned long g_iPinnedBudget;
+	static unsigned long g_iPinnedBytes;
+	static unsigned long g_iPinnedLocked;
+	static int           g_iPinnedPending;
+
+	// Recording (write-behind) I/O statistics.
+	unsigned int   m_iRecordRingSize;
+	volatile unsigned int  m_iRecordHighWater;
+	volatile unsigned long m_iRecordDropped;
+	unsigned long  m_iRecordFrames;
+	unsigned long  m_iRecordBytes;
+	unsigned long  m_iRecordTime;
+	unsigned short m_iRecordSampleBytes;
 };
 
 
@@ -0,0 +1,572 @@
+// qtractorAudioCache.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2017, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorAudioCache.h"
+#include "qtractorAudioSndFile.h"
+#include "qtractorAudioBuffer.h"
+
+#include "qtractorSession.h"
+
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#include <QThread>
+#include <QWaitCondition>
+#include <QList>
+
+#include <QDateTime>
+
+#if QT_VERSION < 0x050000
+#include <QDesktopServices>
+#else
+#include <QStandardPaths>
+#endif
+
+#include <math.h>
+
+
+// Cache files sub-directory and extension.
+static const QString c_sCacheDir     = "qtractor-cache";
+static const QString c_sCacheFileExt = ".wav";
+
+// Cache files format (native float).
+static const int c_iCacheFormat = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+// Transcoding buffer size (in frames).
+static const unsigned int c_iCacheBufferSize = 4096;
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioCacheThread -- Audio transcoding cache thread.
+//
+
+class qtractorAudioCacheThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorAudioCacheThread();
+
+	// Thread run state accessors.
+	void setRunState(bool bRunState);
+	bool runState() const;
+
+	// Transcoding job queue (any thread).
+	void append(const QString& sFilename,
+		const QString& sCacheFile, unsigned int iSampleRate);
+
+	// Drop all pending jobs and abort the current one.
+	void clear();
+
+	// Wake from executive wait condition.
+	void sync();
+
+protected:
+
+	// The main thread executive.
+	void run();
+
+	// Actual transcoding method.
+	bool transcode(const QString& sFilename,
+		const QString& sCacheFile, unsigned int iSampleRate);
+
+	// Remove stale cache files of the same source.
+	void evict(const QString& sCacheFile);
+
+private:
+
+	// Transcoding job item.
+	struct Job
+	{
+		QString      filename;
+		QString      cachefile;
+		unsigned int sampleRate;
+	};
+
+	QList<Job> m_jobs;
+
+	// Whether the thread is logically running.
+	volatile bool m_bRunState;
+
+	// Whether the current job is to be abandoned.
+	volatile bool m_bAbort;
+
+	// Thread synchronization objects.
+	QMutex m_mutex;
+	QWaitCondition m_cond;
+};
+
+
+// Constructor.
+qtractorAudioCacheThread::qtractorAudioCacheThread (void)
+	: m_bRunState(false), m_bAbort(false)
+{
+}
+
+
+// Run state accessor.
+void qtractorAudioCacheThread::setRunState ( bool bRunState )
+{
+	m_bRunState = bRunState;
+}
+
+bool qtractorAudioCacheThread::runState (void) const
+{
+	return m_bRunState;
+}
+
+
+// Transcoding job queue (any thread).
+void qtractorAudioCacheThread::append ( const QString& sFilename,
+	const QString& sCacheFile, unsigned int iSampleRate )
+{
+	QMutexLocker locker(&m_mutex);
+
+	Job job;
+	job.filename   = sFilename;
+	job.cachefile  = sCacheFile;
+	job.sampleRate = iSampleRate;
+	m_jobs.append(job);
+
+	m_cond.wakeAll();
+}
+
+
+// Drop all pending jobs and abort the current one.
+void qtractorAudioCacheThread::clear (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_jobs.clear();
+	m_bAbort = true;
+}
+
+
+// Wake from executive wait condition.
+void qtractorAudioCacheThread::sync (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_cond.wakeAll();
+}
+
+
+// The main thread executive cycle.
+void qtractorAudioCacheThread::run (void)
+{
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioCacheThread[%p]::run(): started...", this);
+#endif
+
+	m_mutex.lock();
+
+	m_bRunState = true;
+
+	while (m_bRunState) {
+		// Wait for some job...
+		if (m_jobs.isEmpty()) {
+			m_cond.wait(&m_mutex);
+			continue;
+		}
+		// Take the next one...
+		const Job job = m_jobs.takeFirst();
+		m_bAbort = false;
+		m_mutex.unlock();
+		// Do the actual transcoding job...
+		const bool bSuccess
+			= transcode(job.filename, job.cachefile, job.sampleRate);
+		// Tell the (abandoned) news...
+		qtractorAudioCacheFactory *pCacheFactory
+			= qtractorAudioCacheFactory::getInstance();
+		if (pCacheFactory) {
+			pCacheFactory->notifyCacheEvent(
+				job.filename, job.cachefile, bSuccess);
+		}
+		m_mutex.lock();
+	}
+
+	m_mutex.unlock();
+
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioCacheThread[%p]::run(): stopped.", this);
+#endif
+}
+
+
+// Actual transcoding method.
+bool qtractorAudioCacheThread::transcode ( const QString& sFilename,
+	const QString& sCacheFile, unsigned int iSampleRate )
+{
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorAudioCacheThread::transcode(\"%s\", \"%s\", %u)",
+		sFilename.toUtf8().constData(),
+		sCacheFile.toUtf8().constData(), iSampleRate);
+#endif
+
+	// Open the source file (decoder)...
+	qtractorAudioFile *pFile
+		= qtractorAudioFileFactory::createAudioFile(sFilename);
+	if (pFile == NULL)
+		return false;
+
+	if (!pFile->open(sFilename)) {
+		delete pFile;
+		return false;
+	}
+
+	const unsigned short iChannels = pFile->channels();
+	const unsigned int iFileRate = pFile->sampleRate();
+	if (iChannels < 1 || iFileRate < 1) {
+		delete pFile;
+		return false;
+	}
+
+#ifdef CONFIG_LIBSAMPLERATE
+	const bool bResample = (iFileRate != iSampleRate);
+	const double fResampleRatio = double(iSampleRate) / double(iFileRate);
+#else
+	// No way to resample, at all...
+	if (iFileRate != iSampleRate) {
+		delete pFile;
+		return false;
+	}
+#endif
+
+	// Open the (temporary) cache file (encoder)...
+	QDir().mkpath(QFileInfo(sCacheFile).absolutePath());
+
+	const QString sTempFile = sCacheFile + ".tmp";
+	qtractorAudioSndFile *pCacheFile = new qtractorAudioSndFile(
+		iChannels, iSampleRate, c_iCacheBufferSize, c_iCacheFormat);
+	if (!pCacheFile->open(sTempFile, qtractorAudioFile::Write)) {
+		delete pCacheFile;
+		delete pFile;
+		return false;
+	}
+
+	// Allocate de/interleaving buffers...
+	unsigned int iOutBufferSize = c_iCacheBufferSize;
+#ifdef CONFIG_LIBSAMPLERATE
+	if (bResample) {
+		iOutBufferSize = (unsigned int) ::ceil(
+			double(c_iCacheBufferSize) * fResampleRatio) + 64;
+	}
+#endif
+
+	unsigned short i;
+	float **ppFrames = new float * [iChannels];
+	for (i = 0; i < iChannels; ++i)
+		ppFrames[i] = new float [c_iCacheBufferSize];
+	float **ppOutFrames = ppFrames;
+
+#ifdef CONFIG_LIBSAMPLERATE
+	SRC_STATE **ppSrcState = NULL;
+	if (bResample) {
+		int err = 0;
+		ppOutFrames = new float * [iChannels];
+		ppSrcState  = new SRC_STATE * [iChannels];
+		for (i = 0; i < iChannels; ++i) {
+			ppOutFrames[i] = new float [iOutBufferSize];
+			ppSrcState[i]  = src_new(
+				qtractorAudioBuffer::defaultResampleType(), 1, &err);
+		}
+	}
+#endif
+
+	// Main transcoding loop...
+	bool bSuccess = true;
+	bool bEndOfInput = false;
+
+	while (!bEndOfInput && bSuccess) {
+		// Bail out whenever due...
+		if (!m_bRunState || m_bAbort) {
+			bSuccess = false;
+			break;
+		}
+		int nread = pFile->read(ppFrames, c_iCacheBufferSize);
+		if (nread < 1) {
+			nread = 0;
+			bEndOfInput = true;
+		}
+		int nwrite = nread;
+	#ifdef CONFIG_LIBSAMPLERATE
+		if (bResample) {
+			// Flush converter tails at the end...
+			do {
+				nwrite = 0;
+				for (i = 0; i < iChannels; ++i) {
+					SRC_DATA src_data;
+					src_data.data_in       = ppFrames[i];
+					src_data.data_out      = ppOutFrames[i];
+					src_data.input_frames  = nread;
+					src_data.output_frames = iOutBufferSize;
+					src_data.end_of_input  = (bEndOfInput ? 1 : 0);
+					src_data.src_ratio     = fResampleRatio;
+					src_data.input_frames_used = 0;
+					src_data.output_frames_gen = 0;
+					if (src_process(ppSrcState[i], &src_data) == 0)
+						nwrite = src_data.output_frames_gen;
+					else
+						bSuccess = false;
+				}
+				if (nwrite > 0 && bSuccess
+					&& pCacheFile->write(ppOutFrames, nwrite) < nwrite)
+					bSuccess = false;
+			}
+			while (bEndOfInput && nwrite > 0 && bSuccess);
+			continue;
+		}
+	#endif
+		if (nwrite > 0 && pCacheFile->write(ppOutFrames, nwrite) < nwrite)
+			bSuccess = false;
+	}
+
+	// Cleanup...
+	pCacheFile->close();
+	pFile->close();
+
+#ifdef CONFIG_LIBSAMPLERATE
+	if (ppSrcState) {
+		for (i = 0; i < iChannels; ++i) {
+			src_delete(ppSrcState[i]);
+			delete [] ppOutFrames[i];
+		}
+		delete [] ppSrcState;
+		delete [] ppOutFrames;
+	}
+#endif
+
+	for (i = 0; i < iChannels; ++i)
+		delete [] ppFrames[i];
+	delete [] ppFrames;
+
+	delete pCacheFile;
+	delete pFile;
+
+	// Only a complete cache file gets its final name...
+	if (bSuccess) {
+		QFile::remove(sCacheFile);
+		bSuccess = QFile::rename(sTempFile, sCacheFile);
+	}
+
+	if (!bSuccess)
+		QFile::remove(sTempFile);
+	else
+		evict(sCacheFile);
+
+	return bSuccess;
+}
+
+
+// Remove stale cache files of the same source, ie. the ones
+// made before its last modification or for another sample rate.
+void qtractorAudioCacheThread::evict ( const QString& sCacheFile )
+{
+	const QFileInfo cacheInfo(sCacheFile);
+	const QDir dir(cacheInfo.absolutePath());
+	const QString& sPrefix
+		= cacheInfo.completeBaseName().section('_', 0, -2);
+	const QStringList& files = dir.entryList(
+		QStringList() << sPrefix + "_*" + c_sCacheFileExt, QDir::Files);
+	QStringListIterator iter(files);
+	while (iter.hasNext()) {
+		const QString& sFile = iter.next();
+		if (sFile != cacheInfo.fileName()
+			&& sFile.section('_', 0, -2) == sPrefix)
+			QFile::remove(dir.absoluteFilePath(sFile));
+	}
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioCacheFactory -- Audio transcoding cache (singleton).
+//
+
+// The pseudo-singleton instance.
+qtractorAudioCacheFactory *qtractorAudioCacheFactory::g_pCacheFactory = NULL;
+
+// Singleton instance accessor.
+qtractorAudioCacheFactory *qtractorAudioCacheFactory::getInstance (void)
+{
+	return g_pCacheFactory;
+}
+
+
+// Constructor.
+qtractorAudioCacheFactory::qtractorAudioCacheFactory ( QObject *pParent )
+	: QObject(pParent), m_pCacheThread(NULL)
+{
+	// Pseudo-singleton reference setup.
+	g_pCacheFactory = this;
+}
+
+
+// Default destructor.
+qtractorAudioCacheFactory::~qtractorAudioCacheFactory (void)
+{
+	if (m_pCacheThread) {
+		m_pCacheThread->clear();
+		if (m_pCacheThread->isRunning()) do {
+			m_pCacheThread->setRunState(false);
+			m_pCacheThread->sync();
+		} while (!m_pCacheThread->wait(100));
+		delete m_pCacheThread;
+		m_pCacheThread = NULL;
+	}
+
+	// Pseudo-singleton reference shut-down.
+	g_pCacheFactory = NULL;
+}
+
+
+// Whether the given source is a compressed (decoded) file type.
+bool qtractorAudioCacheFactory::isCompressed ( const QString& sFilename )
+{
+	const QString& sExt = QFileInfo(sFilename).suffix().toLower();
+
+	// Last one registered for the same extension wins...
+	bool bCompressed = false;
+	const qtractorAudioFileFactory::FileFormats& list
+		= qtractorAudioFileFactory::formats();
+	QListIterator<qtractorAudioFileFactory::FileFormat *> iter(list);
+	while (iter.hasNext()) {
+		qtractorAudioFileFactory::FileFormat *pFormat = iter.next();
+		if (sExt == pFormat->ext)
+			bCompressed = (pFormat->type != qtractorAudioFileFactory::SndFile);
+	}
+
+	return bCompressed;
+}
+
+
+// Cache file lookup; schedules background transcoding if not ready.
+QString qtractorAudioCacheFactory::cacheFile (
+	const QString& sFilename, unsigned int iSampleRate )
+{
+	const QFileInfo fileInfo(sFilename);
+	if (!fileInfo.exists())
+		return QString();
+
+	// Cache files are kept local to the session,
+	// otherwise in the user's own cache location...
+	QString sCacheDir;
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession)
+		sCacheDir = pSession->sessionDir();
+	if (sCacheDir.isEmpty()) {
+	#if QT_VERSION < 0x050000
+		sCacheDir = QDesktopServices::storageLocation(
+			QDesktopServices::CacheLocation);
+	#else
+		sCacheDir = QStandardPaths::writableLocation(
+			QStandardPaths::CacheLocation);
+	#endif
+	}
+	if (sCacheDir.isEmpty())
+		sCacheDir = QDir::tempPath();
+	const QDir dir(QDir(sCacheDir).filePath(c_sCacheDir));
+
+	// Named after the source path, keyed by its modification
+	// time and target rate, so that stale ones are told apart...
+	const QString& sSourceName = fileInfo.absoluteFilePath();
+	const QString& sSourceHash
+		= QString::number(qHash(sSourceName), 16);
+	const QString& sCacheName = sSourceName
+		+ ':' + QString::number(fileInfo.lastModified().toTime_t())
+		+ ':' + QString::number(iSampleRate);
+	const QString& sCacheHash
+		= QString::number(qHash(sCacheName), 16);
+	const QFileInfo cacheInfo(dir, fileInfo.fileName()
+		+ '_' + sSourceHash + '_' + sCacheHash + c_sCacheFileExt);
+	const QString& sCacheFile = cacheInfo.absoluteFilePath();
+
+	QMutexLocker locker(&m_mutex);
+
+	// Still on the works or just given up?
+	if (m_pending.contains(sCacheFile) || m_failed.contains(sCacheFile))
+		return QString();
+
+	// Ready to go?
+	if (cacheInfo.exists())
+		return sCacheFile;
+
+	// Schedule it for later...
+	if (m_pCacheThread == NULL) {
+		m_pCacheThread = new qtractorAudioCacheThread();
+		m_pCacheThread->start(QThread::LowPriority);
+	}
+
+	m_pending.insert(sCacheFile);
+	m_pCacheThread->append(sFilename, sCacheFile, iSampleRate);
+
+	return QString();
+}
+
+
+// Source files which got their cache ready ever since.
+QStringList qtractorAudioCacheFactory::readyFiles (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	const QStringList files(m_ready);
+	m_ready.clear();
+
+	return files;
+}
+
+
+// Cache ready event notification (cache thread).
+void qtractorAudioCacheFactory::notifyCacheEvent ( const QString& sFilename,
+	const QString& sCacheFile, bool bSuccess )
+{
+	QMutexLocker locker(&m_mutex);
+
+	// Might have been cleaned up meanwhile...
+	if (!m_pending.remove(sCacheFile))
+		return;
+
+	if (bSuccess) {
+		if (!m_ready.contains(sFilename))
+			m_ready.append(sFilename);
+		emit cacheEvent();
+	} else {
+		m_failed.insert(sCacheFile);
+	}
+}
+
+
+// Cleanup method.
+void qtractorAudioCacheFactory::cleanup (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	if (m_pCacheThread)
+		m_pCacheThread->clear();
+
+	m_pending.clear();
+	m_failed.clear();
+	m_ready.clear();
+}
+
+
+// end of qtractorAudioCache.cpp
@@ -0,0 +1,105 @@
+// qtractorAudioCache.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2017, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorAudioCache_h
+#define __qtractorAudioCache_h
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QSet>
+
+#include <QMutex>
+
+
+// Forward declarations.
+class qtractorAudioCacheThread;
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioCacheFactory -- Audio transcoding cache (singleton).
+//
+// Compressed (eg. MP3, Ogg Vorbis) and sample-rate mismatched audio
+// sources are decoded and resampled once, in the background, into a
+// session-local native-rate float file, which then gets played instead.
+//
+
+class qtractorAudioCacheFactory : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	qtractorAudioCacheFactory(QObject *pParent = NULL);
+	// Default destructor.
+	~qtractorAudioCacheFactory();
+
+	// Whether the given source is a compressed (decoded) file type.
+	static bool isCompressed(const QString& sFilename);
+
+	// Cache file lookup; returns the ready transcoded file path,
+	// otherwise schedules it for background transcoding and
+	// returns an empty string.
+	QString cacheFile(const QString& sFilename, unsigned int iSampleRate);
+
+	// Source files which got their cache ready ever since.
+	QStringList readyFiles();
+
+	// Cache ready event notification (cache thread).
+	void notifyCacheEvent(const QString& sFilename,
+		const QString& sCacheFile, bool bSuccess);
+
+	// Cleanup method.
+	void cleanup();
+
+	// Singleton instance accessor.
+	static qtractorAudioCacheFactory *getInstance();
+
+signals:
+
+	// Cache ready signal.
+	void cacheEvent();
+
+private:
+
+	// Factory mutex.
+	QMutex m_mutex;
+
+	// Pending and failed cache files.
+	QSet<QString> m_pending;
+	QSet<QString> m_failed;
+
+	// Source files whose cache is ready.
+	QStringList m_ready;
+
+	// The cache file transcoding detached thread.
+	qtractorAudioCacheThread *m_pCacheThread;
+
+	// The pseudo-singleton instance.
+	static qtractorAudioCacheFactory *g_pCacheFactory;
+};
+
+
+#endif  // __qtractorAudioCache_h
+
+
+// end of qtractorAudioCache.h
@@ -33,7 +33,8 @@
 #include <QPainter>
 #include <QPolygon>
 
-#include <QDomDocument>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 #include <math.h>
 
@@ -180,23 +181,35 @@ qtractorAudioClip::~qtractorAudioClip (void)
 
 
 // Alternating overlap test.
-bool qtractorAudioClip::isOverlap ( unsigned int iOverlapSize ) const
+bool qtractorAudioClip::isOverlap (
+	Data *pData, unsigned int iOverlapSize ) const
 {
-	if (m_pData == NULL)
+	if (pData == NULL)
 		return false;
 
 	const unsigned long iClipStart = clipStart();
 	const unsigned long iClipEnd = iClipStart + clipLength() + iOverlapSize;
 
-	QListIterator<qtractorAudioClip *> iter(m_pData->clips());
-	while (iter.hasNext()) {
-		qtractorAudioClip *pClip = iter.next();
-		const unsigned long iClipStart2 = pClip->clipStart();
-		const unsigned long iClipEnd2
-			= iClipStart2 + pClip->clipLength() + iOverlapSize;
-		if ((iClipStart >= iClipStart2 && iClipEnd2 >  iClipStart) ||
-			(iClipEnd   >  iClipStart2 && iClipEnd2 >= iClipEnd))
-			return true;
+	// Only clips just around are worth checking,
+	// as given by the track clip (interval) index...
+	qtractorTrack *pTrack = track();
+	if (pTrack == NULL)
+		return false;
+
+	qtractorClip *pClip = pTrack->seekClip(
+		iClipStart > iOverlapSize ? iClipStart - iOverlapSize : 0);
+	while (pClip && pClip->clipStart() < iClipEnd) {
+		qtractorAudioClip *pAudioClip
+			= static_cast<qtractorAudioClip *> (pClip);
+		if (pAudioClip != this && pAudioClip->m_pData == pData) {
+			const unsigned long iClipStart2 = pClip->clipStart();
+			const unsigned long iClipEnd2
+				= iClipStart2 + pClip->clipLength() + iOverlapSize;
+			if ((iClipStart >= iClipStart2 && iClipEnd2 >  iClipStart) ||
+				(iClipEnd   >  iClipStart2 && iClipEnd2 >= iClipEnd))
+				return true;
+		}
+		pClip = pClip->next();
 	}
 
 	return false;
@@ -246,24 +259,26 @@ bool qtractorAudioClip::openAudioFile ( const QString& sFilename, int iMode )
 	// Register file path...
 	pSession->files()->addClipItem(qtractorFileList::Audio, this, bWrite);
 
-	// New key-data sequence...
+	// New key-data sequence; clip data gets published only when
+	// ready, as it might be played right away (eg. while rolling)...
 	if (!bWrite) {
-		m_pKey  = new Key(this);
-		m_pData = g_hashTable.value(*m_pKey, NULL);
-		if (m_pData) {
+		m_pKey = new Key(this);
+		Data *pData = g_hashTable.value(*m_pKey, NULL);
+		if (pData) {
 			// Check if current clip overlaps any other...
 			const unsigned int iOverlapSize
 				= pSession->audioEngine()->bufferSize() << 2;
-			bool bOverlap = isOverlap(iOverlapSize);
+			bool bOverlap = isOverlap(pData, iOverlapSize);
 			while (bOverlap) {
 				++m_iOverlap;
 				m_pKey->update(this);
-				m_pData = g_hashTable.value(*m_pKey, NULL);
-				bOverlap = isOverlap(iOverlapSize);
+				pData = g_hashTable.value(*m_pKey, NULL);
+				bOverlap = isOverlap(pData, iOverlapSize);
 			}
 			// Only if it doesn't overlap any...
-			if (m_pData && !bOverlap) {
-				m_pData->attach(this);
+			if (pData && !bOverlap) {
+				pData->attach(this);
+				m_pData = pData;
 				// Peak files should also be created on-the-fly...
 				qtractorAudioBuffer *pBuff = m_pData->buffer();
 				if (m_pPeak == NULL || bFilenameChanged) {
@@ -286,11 +301,17 @@ bool qtractorAudioClip::openAudioFile ( const QString& sFilename, int iMode )
 		}
 	}
 
-	// Initialize audio buffer container...
-	m_pData = new Data(pTrack, iChannels);
-	m_pData->attach(this);
+	// Initialize audio buffer container;
+	// recording goes through the track's own writer thread...
+	qtractorAudioBufferThread *pRecordThread
+		= (bWrite ? pTrack->recordThread() : NULL);
+	Data *pData;
+	if (pRecordThread)
+		pData = new Data(pRecordThread, iChannels);
+	else
+		pData = new Data(pTrack, iChannels);
 
-	qtractorAudioBuffer *pBuff = m_pData->buffer();
+	qtractorAudioBuffer *pBuff = pData->buffer();
 
 	pBuff->setOffset(clipOffset());
 	pBuff->setLength(clipLength());
@@ -300,19 +321,24 @@ bool qtractorAudioClip::openAudioFile ( const QString& sFilename, int iMode )
 	pBuff->setPitchShift(m_fPitchShift);
 	pBuff->setWsolaTimeStretch(m_bWsolaTimeStretch);
 	pBuff->setWsolaQuickSeek(m_bWsolaQuickSeek);
+	pBuff->setPinned(pRecordThread == NULL);
 
 	if (!pBuff->open(sFilename, iMode)) {
-		delete m_pData;
-		m_pData = NULL;
+		delete pData;
 		return false;
 	}
 
+	pData->attach(this);
+	m_pData = pData;
+
 	// Gain/panning fractionalizer(tm)...
 	updateFractGains(pBuff);
 
 	// Default clip length will be the whole file length.
-	if (clipLength() == 0)
+	if (clipLength() == 0) {
 		setClipLength(pBuff->length() - pBuff->offset());
+		pTrack->updateClip(this);
+	}
 
 	// Peak files should also be created on-the-fly?
 	if (m_pPeak == NULL || bFilenameChanged) {
@@ -413,6 +439,7 @@ void qtractorAudioClip::unlinkHashData (void)
 	pNewBuff->setLength(pBuff->length());
 	pNewBuff->setTimeStretch(pBuff->timeStretch());
 	pNewBuff->setPitchShift(pBuff->pitchShift());
+	pNewBuff->setPinned(pBuff->isPinned());
 
 	if (pNewBuff->open(filename())) {
 		m_pData->detach(this);
@@ -557,13 +584,25 @@ void qtractorAudioClip::close (void)
 	// Take pretended clip-length...
 	qtractorAudioBuffer *pBuff = buffer();
 	if (pBuff) {
+		unsigned long iFileLength = pBuff->fileLength();
+		const bool bPeakFile = (pBuff->peakFile() != NULL);
+		// Flush it all out, keeping the final I/O statistics...
+		qtractorAudioFile *pFile = pBuff->file();
+		if (pFile && (pFile->mode() & qtractorAudioFile::Write)) {
+			pBuff->close();
+			m_recordStats = pBuff->recordStats();
+			iFileLength = m_recordStats.frames;
+		}
 		// Commit the final clip length (record specific)...
-		if (clipLength() < 1)
-			setClipLength(pBuff->fileLength());
+		if (clipLength() < 1) {
+			setClipLength(iFileLength);
+			if (track())
+				track()->updateClip(this);
+		}
 		else
 		// Shall we ditch the current peak file?
 		// (don't if closing from recording)
-		if (m_pPeak && pBuff->peakFile() == NULL) {
+		if (m_pPeak && !bPeakFile) {
 			delete m_pPeak;
 			m_pPeak = NULL;
 		}
@@ -585,15 +624,24 @@ void qtractorAudioClip::open (void)
 void qtractorAudioClip::process (
 	unsigned long iFrameStart, unsigned long iFrameEnd )
 {
-	qtractorAudioBuffer *pBuff = buffer();
-	if (pBuff == NULL)
-		return;
-
 	qtractorAudioBus *pAudioBus
 		= static_cast<qtractorAudioBus *> (track()->outputBus());
 	if (pAudioBus == NULL)
 		return;
 
+	process_mix(pAudioBus->buffer(), pAudioBus->channels(),
+		iFrameStart, iFrameEnd);
+}
+
+
+// Audio clip mix-down into given buffer.
+void qtractorAudioClip::process_mix ( float **ppBuffer,
+	unsigned short iChannels, unsigned long iFrameStart, unsigned long iFrameEnd )
+{
+	qtractorAudioBuffer *pBuff = buffer();
+	if (pBuff == NULL)
+		return;
+
 	// Get the next bunch from the clip...
 	const unsigned long iClipStart = clipStart();
 	if (iClipStart > iFrameEnd)
@@ -606,24 +654,32 @@ void qtractorAudioClip::process (
 	const unsigned long iOffset
 		= (iFrameEnd < iClipEnd ? iFrameEnd : iClipEnd) - iClipStart;
 
+	unsigned long iFadeOffset = 0;
+	unsigned int  iFrames = iOffset;
+	unsigned int  iFrameOffset = 0;
+
 	if (iClipStart > iFrameStart) {
-		if (pBuff->inSync(0, iOffset)) {
-			pBuff->readMix(
-				pAudioBus->buffer(),
-				iOffset,
-				pAudioBus->channels(),
-				iClipStart - iFrameStart,
-				fadeInOutGain(iOffset));
-		}
+		if (!pBuff->inSync(0, iOffset))
+			return;
+		iFrameOffset = iClipStart - iFrameStart;
 	} else {
-		if (pBuff->inSync(iFrameStart - iClipStart, iOffset)) {
-			pBuff->readMix(
-				pAudioBus->buffer(),
-				(iFrameEnd < iClipEnd ? iFrameEnd : iClipEnd) - iFrameStart,
-				pAudioBus->channels(),
-				0,
-				fadeInOutGain(iOffset));
-		}
+		iFadeOffset = iFrameStart - iClipStart;
+		if (!pBuff->inSync(iFadeOffset, iOffset))
+			return;
+		iFrames = iOffset - iFadeOffset;
+	}
+
+	// Sample-accurate fade-in/out gains, whenever in a fade slope...
+	float *pfFades = NULL;
+	if (isFadeInOut(iFadeOffset, iFrames))
+		pfFades = pBuff->fadeBuffer(iFrames);
+	if (pfFades) {
+		fadeInOutGains(pfFades, iFadeOffset, iFrames);
+		pBuff->readMix(ppBuffer, iFrames, iChannels, iFrameOffset,
+			1.0f, pfFades);
+	} else {
+		pBuff->readMix(ppBuffer, iFrames, iChannels, iFrameOffset,
+			fadeInOutGain(iOffset));
 	}
 }
 
@@ -640,6 +696,31 @@ void qtractorAudioClip::process_export (
 }
 
 
+// Audio clip render-ahead process cycle executive (off-RT).
+void qtractorAudioClip::process_render ( float **ppBuffer,
+	unsigned short iChannels, unsigned long iFrameStart, unsigned long iFrameEnd,
+	bool bSync )
+{
+	qtractorAudioBuffer *pBuff = buffer();
+	if (pBuff == NULL)
+		return;
+
+	if (bSync) {
+		// Direct sync method.
+		if (m_pData) m_pData->syncExport();
+		// Must be exactly in place, otherwise seek and sync right away...
+		const unsigned long iClipStart = clipStart();
+		const unsigned long iClipOffset
+			= (iFrameStart > iClipStart ? iFrameStart - iClipStart : 0);
+		if (!pBuff->inSync(iClipOffset, iClipOffset) && m_pData)
+			m_pData->syncExport();
+	}
+
+	// Normal clip mix-down...
+	process_mix(ppBuffer, iChannels, iFrameStart, iFrameEnd);
+}
+
+
 // Audio clip paint method.
 void qtractorAudioClip::draw (
 	QPainter *pPainter, const QRect& clipRect, unsigned long iClipOffset )
@@ -756,54 +837,52 @@ QString qtractorAudioClip::toolTip (void) const
 
 
 // Virtual document element methods.
-bool qtractorAudioClip::loadClipElement (
-	qtractorDocument */*pDocument*/, QDomElement *pElement )
-{
-	// Load track children...
-	for (QDomNode nChild = pElement->firstChild();
-			!nChild.isNull();
-				nChild = nChild.nextSibling()) {
-		// Convert node to element...
-		QDomElement eChild = nChild.toElement();
-		if (eChild.isNull())
-			continue;
+bool qtractorAudioClip::loadClipStream (
+	qtractorDocument */*pDocument*/, QXmlStreamReader *pReader )
+{
+	// Load clip children...
+	while (pReader->readNextStartElement()) {
+		const QString& sChild = pReader->name().toString();
 		// Load clip properties..
-		if (eChild.tagName() == "filename")
-			qtractorAudioClip::setFilename(eChild.text());
-		else if (eChild.tagName() == "time-stretch")
-			qtractorAudioClip::setTimeStretch(eChild.text().toFloat());
-		else if (eChild.tagName() == "pitch-shift")
-			qtractorAudioClip::setPitchShift(eChild.text().toFloat());
-		else if (eChild.tagName() == "wsola-time-stretch")
+		if (sChild == "filename")
+			qtractorAudioClip::setFilename(pReader->readElementText());
+		else if (sChild == "time-stretch")
+			qtractorAudioClip::setTimeStretch(
+				pReader->readElementText().toFloat());
+		else if (sChild == "pitch-shift")
+			qtractorAudioClip::setPitchShift(
+				pReader->readElementText().toFloat());
+		else if (sChild == "wsola-time-stretch")
 			qtractorAudioClip::setWsolaTimeStretch(
-				qtractorDocument::boolFromText(eChild.text()));
-		else if (eChild.tagName() == "wsola-quick-seek")
+				qtractorDocument::boolFromText(pReader->readElementText()));
+		else if (sChild == "wsola-quick-seek")
 			qtractorAudioClip::setWsolaQuickSeek(
-				qtractorDocument::boolFromText(eChild.text()));
-
+				qtractorDocument::boolFromText(pReader->readElementText()));
+		else
+			pReader->skipCurrentElement();
 	}
 
-	return true;
+	return !pReader->hasError();
 }
 
 
-bool qtractorAudioClip::saveClipElement (
-	qtractorDocument *pDocument, QDomElement *pElement )
+bool qtractorAudioClip::saveClipStream (
+	qtractorDocument *pDocument, QXmlStreamWriter *pWriter )
 {
-	QDomElement eAudioClip = pDocument->document()->createElement("audio-clip");
-	pDocument->saveTextElement("filename",
-		qtractorAudioClip::relativeFilename(pDocument), &eAudioClip);
-	pDocument->saveTextElement("time-stretch",
-		QString::number(qtractorAudioClip::timeStretch()), &eAudioClip);
-	pDocument->saveTextElement("pitch-shift",
-		QString::number(qtractorAudioClip::pitchShift()), &eAudioClip);
-	pDocument->saveTextElement("wsola-time-stretch",
+	pWriter->writeStartElement("audio-clip");
+	pWriter->writeTextElement("filename",
+		qtractorAudioClip::relativeFilename(pDocument));
+	pWriter->writeTextElement("time-stretch",
+		QString::number(qtractorAudioClip::timeStretch()));
+	pWriter->writeTextElement("pitch-shift",
+		QString::number(qtractorAudioClip::pitchShift()));
+	pWriter->writeTextElement("wsola-time-stretch",
 		qtractorDocument::textFromBool(
-			qtractorAudioClip::isWsolaTimeStretch()), &eAudioClip);
-	pDocument->saveTextElement("wsola-quick-seek",
+			qtractorAudioClip::isWsolaTimeStretch()));
+	pWriter->writeTextElement("wsola-quick-seek",
 		qtractorDocument::textFromBool(
-			qtractorAudioClip::isWsolaQuickSeek()), &eAudioClip);
-	pElement->appendChild(eAudioClip);
+			qtractorAudioClip::isWsolaQuickSeek()));
+	pWriter->writeEndElement();
 
 	return true;
 }
@@ -811,7 +890,8 @@ bool qtractorAudioClip::saveClipElement (
 
 // Audio clip export method.
 bool qtractorAudioClip::clipExport ( ClipExport pfnClipExport, void *pvArg,
-	unsigned long iOffset, unsigned long iLength ) const
+	unsigned long iOffset, unsigned long iLength,
+	qtractorAudioBufferThread *pSyncThread ) const
 {
 	qtractorTrack *pTrack = track();
 	if (pTrack == NULL)
@@ -833,8 +913,11 @@ bool qtractorAudioClip::clipExport ( ClipExport pfnClipExport, void *pvArg,
 	if (iLength < 1)
 		iLength = clipLength();
 
+	if (pSyncThread == NULL)
+		pSyncThread = pTrack->syncThread();
+
 	qtractorAudioBuffer *pBuff
-		= new qtractorAudioBuffer(pTrack->syncThread(), iChannels);
+		= new qtractorAudioBuffer(pSyncThread, iChannels);
 
 	pBuff->setOffset(iOffset);
 	pBuff->setLength(iLength);
@@ -882,4 +965,113 @@ bool qtractorAudioClip::clipExport ( ClipExport pfnClipExport, void *pvArg,
 }
 
 
+// Audio clip (absolute) peak level export callback.
+struct audioClipPeakData
+{	// Ctor.
+	audioClipPeakData(unsigned short iChannels)
+		: channels(iChannels), peak(0.0f) {};
+	// Members.
+	unsigned short channels;
+	float peak;
+};
+
+static void audioClipPeak (
+	float **ppFrames, unsigned int iFrames, void *pvArg )
+{
+	audioClipPeakData *pData
+		= static_cast<audioClipPeakData *> (pvArg);
+
+	for (unsigned short i = 0; i < pData->channels; ++i) {
+		const float *pFrames = ppFrames[i];
+		for (unsigned int n = 0; n < iFrames; ++n) {
+			const float fSample = ::fabsf(*pFrames++);
+			if (pData->peak < fSample)
+				pData->peak = fSample;
+		}
+	}
+}
+
+
+// Audio clip (absolute) peak level, from the exact peak stats
+// of whole peak periods; only the partial ones at either end
+// are actually read from the audio file.
+bool qtractorAudioClip::clipPeak ( float& fPeak,
+	unsigned long iOffset, unsigned long iLength ) const
+{
+	if (m_pPeak == NULL)
+		return false;
+
+	// Pitch-shifting makes it a whole different signal...
+	if (pitchShift() < 0.999f || pitchShift() > 1.001f)
+		return false;
+
+	qtractorTrack *pTrack = track();
+	if (pTrack == NULL)
+		return false;
+
+	qtractorAudioBus *pAudioBus
+		= static_cast<qtractorAudioBus *> (pTrack->outputBus());
+	if (pAudioBus == NULL)
+		return false;
+
+	qtractorAudioPeakFile *pPeakFile = m_pPeak->peakFile();
+	if (!pPeakFile->openRead())
+		return false;
+
+	// No channel mixing/mapping either...
+	const unsigned short iChannels = pPeakFile->channels();
+	if (iChannels < 1 || iChannels != pAudioBus->channels())
+		return false;
+
+	const unsigned long iPeakPeriod = pPeakFile->period();
+	if (iPeakPeriod < 1)
+		return false;
+
+	if (iLength < 1)
+		iLength = clipLength();
+
+	const unsigned long iFrameStart = clipOffset() + iOffset;
+	const unsigned long iFrameEnd = iFrameStart + iLength;
+	const unsigned long iPeakStart
+		= (iFrameStart + iPeakPeriod - 1) / iPeakPeriod;
+	const unsigned long iPeakEnd
+		= iFrameEnd / iPeakPeriod;
+
+	// Too short to bother...
+	if (iPeakEnd <= iPeakStart)
+		return false;
+
+	qtractorAudioPeakFile::Stats *pStats
+		= new qtractorAudioPeakFile::Stats [iChannels];
+	const bool bStats
+		= pPeakFile->readStats(iPeakStart, iPeakEnd - iPeakStart, pStats);
+	float fMax = 0.0f;
+	for (unsigned short i = 0; bStats && i < iChannels; ++i) {
+		if (fMax < pStats[i].peak)
+			fMax = pStats[i].peak;
+	}
+	delete [] pStats;
+
+	if (!bStats)
+		return false;
+
+	// Same as exported...
+	fMax *= clipGain();
+
+	// Partial peak periods, at either end...
+	audioClipPeakData data(iChannels);
+	const unsigned long iHead = iPeakStart * iPeakPeriod - iFrameStart;
+	if (iHead > 0)
+		clipExport(audioClipPeak, &data, iOffset, iHead);
+	const unsigned long iTail = iFrameEnd - iPeakEnd * iPeakPeriod;
+	if (iTail > 0)
+		clipExport(audioClipPeak, &data, iOffset + iLength - iTail, iTail);
+	if (fMax < data.peak)
+		fMax = data.peak;
+
+	fPeak = fMax;
+	return true;
+}
+
+
 // end of qtractorAudioClip.cpp
@@ -99,12 +99,21 @@ public:
 	// Clip close-commit (record specific)
 	void close();
 
+	// Last recording (write-behind) I/O statistics.
+	const qtractorAudioBuffer::RecordStats& recordStats() const
+		{ return m_recordStats; }
+
 	// Audio clip special process cycle executive.
 	void process(unsigned long iFrameStart, unsigned long iFrameEnd);
 
 	// Audio clip freewheeling process cycle executive (needed for export).
 	void process_export(unsigned long iFrameStart, unsigned long iFrameEnd);
 
+	// Audio clip render-ahead process cycle executive
+	// (off-RT, unless not to sync directly).
+	void process_render(float **ppBuffer, unsigned short iChannels,
+		unsigned long iFrameStart, unsigned long iFrameEnd, bool bSync = true);
+
 	// Clip paint method.
 	void draw(QPainter *pPainter,
 		const QRect& clipRect, unsigned long iClipOffset);
@@ -112,10 +121,17 @@ public:
 	// Audio clip tool-tip.
 	QString toolTip() const;
 
-	// Audio clip export method.
+	// Audio clip export method; an optional private sync thread
+	// lets several clips of the same track be exported concurrently.
 	typedef void (*ClipExport)(float **, unsigned int, void *);
 
 	bool clipExport(ClipExport pfnClipExport, void *pvArg,
+		unsigned long iOffset = 0, unsigned long iLength = 0,
+		qtractorAudioBufferThread *pSyncThread = NULL) const;
+
+	// Audio clip (absolute) peak level, from the exact peak stats;
+	// false if not available (eg. peak file still being created).
+	bool clipPeak(float& fPeak,
 		unsigned long iOffset = 0, unsigned long iLength = 0) const;
 
 	// Most interesting key/data (ref-counted?)...
@@ -128,6 +144,8 @@ public:
 		Data(qtractorTrack *pTrack, unsigned short iChannels)
 			: m_pBuff(new qtractorAudioBuffer(
 				pTrack->syncThread(), iChannels)) {}
+		Data(qtractorAudioBufferThread *pSyncThread, unsigned short iChannels)
+			: m_pBuff(new qtractorAudioBuffer(pSyncThread, iChannels)) {}
 
 		// Destructor.
 		~Data() { clear(); delete m_pBuff; }
@@ -202,14 +220,18 @@ public:
 protected:
 
 	// Virtual document element methods.
-	bool loadClipElement(qtractorDocument *pDocument, QDomElement *pElement);
-	bool saveClipElement(qtractorDocument *pDocument, QDomElement *pElement);
+	bool loadClipStream(qtractorDocument *pDocument, QXmlStreamReader *pReader);
+	bool saveClipStream(qtractorDocument *pDocument, QXmlStreamWriter *pWriter);
 
 	// Private cleanup.
 	void closeAudioFile();
 
+	// Audio clip mix-down into given buffer.
+	void process_mix(float **ppBuffer, unsigned short iChannels,
+		unsigned long iFrameStart, unsigned long iFrameEnd);
+
 	// Alternating overlap test.
-	bool isOverlap(unsigned int iOverlapSize) const;
+	bool isOverlap(Data *pData, unsigned int iOverlapSize) const;
 
 	// Gain/panning fractionalizer(tm)...
 	void updateFractGains(qtractorAudioBuffer *pBuff);
@@ -228,6 +250,9 @@ private:
 	// Alternate overlap tag.
 	unsigned int m_iOverlap;
 
+	// Last recording (write-behind) I/O statistics.
+	qtractorAudioBuffer::RecordStats m_recordStats;
+
 	// Gain fractionalizers(tm)...
 	typedef struct { int num, den; } FractGain;
 
@@ -22,6 +22,8 @@
 #include "qtractorAbout.h"
 #include "qtractorAudioEngine.h"
 #include "qtractorAudioMonitor.h"
+#include "qtractorAudioAnalyzer.h"
+#include "qtractorAudioRender.h"
 #include "qtractorAudioBuffer.h"
 #include "qtractorAudioClip.h"
 
@@ -56,6 +58,11 @@
 
 #include <QApplication>
 #include <QProgressBar>
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
 #include <QDomDocument>
 
 #if defined(__SSE__)
@@ -213,6 +220,245 @@ private:
 };
 
 
+//----------------------------------------------------------------------
+// qtractorAudioExportWriter -- audio export file encoder thread.
+//
+
+class qtractorAudioExportWriter : public QThread
+{
+public:
+
+	// Constructor
+	qtractorAudioExportWriter(qtractorAudioFile *pFile,
+		unsigned int iBufferSize, unsigned int iBlockSize )
+		: m_pFile(pFile), m_iBlockSize(iBlockSize),
+			m_bRunState(false), m_iEncodeTime(0), m_iStallTime(0)
+	{
+		const unsigned short iChannels = m_pFile->channels();
+
+		m_pRingBuffer = new qtractorRingBuffer<float> (iChannels, iBufferSize);
+
+		m_ppFrames = new float * [iChannels];
+		for (unsigned short i = 0; i < iChannels; ++i)
+			m_ppFrames[i] = new float [m_iBlockSize];
+
+		m_bRunState = true;
+
+		QThread::start();
+	}
+
+	// Destructor.
+	~qtractorAudioExportWriter()
+	{
+		flush();
+
+		const unsigned short iChannels = m_pFile->channels();
+		for (unsigned short i = 0; i < iChannels; ++i)
+			delete [] m_ppFrames[i];
+		delete [] m_ppFrames;
+
+		delete m_pRingBuffer;
+	}
+
+	// Encoder file accessor.
+	qtractorAudioFile *file() const
+		{ return m_pFile; }
+
+	// Hand over one rendered block (export cycle);
+	// waits for the encoder to catch up when full (back-pressure).
+	void write(float **ppFrames, unsigned int nframes)
+	{
+		if (m_pRingBuffer->writable() < nframes) {
+			QElapsedTimer timer;
+			timer.start();
+			QMutexLocker locker(&m_mutex);
+			while (m_pRingBuffer->writable() < nframes && isRunning())
+				m_cond.wait(&m_mutex, 10);
+			m_iStallTime += timer.nsecsElapsed();
+		}
+
+		m_pRingBuffer->write(ppFrames, nframes);
+
+		QMutexLocker locker(&m_mutex);
+		m_cond.wakeAll();
+	}
+
+	// Drain all pending blocks and stop.
+	void flush()
+	{
+		if (!isRunning())
+			return;
+
+		m_mutex.lock();
+		m_bRunState = false;
+		m_cond.wakeAll();
+		m_mutex.unlock();
+
+		QThread::wait();
+	}
+
+	// Timing statistics (nanosecs).
+	qint64 encodeTime() const
+		{ return m_iEncodeTime; }
+	qint64 stallTime() const
+		{ return m_iStallTime; }
+
+protected:
+
+	// The encoder thread executive.
+	void run()
+	{
+		m_mutex.lock();
+
+		for (;;) {
+			unsigned int nread = m_pRingBuffer->readable();
+			if (nread == 0) {
+				if (!m_bRunState)
+					break;
+				m_cond.wait(&m_mutex);
+				continue;
+			}
+			m_mutex.unlock();
+			if (nread > m_iBlockSize)
+				nread = m_iBlockSize;
+			m_pRingBuffer->read(m_ppFrames, nread);
+			QElapsedTimer timer;
+			timer.start();
+			m_pFile->write(m_ppFrames, nread);
+			m_iEncodeTime += timer.nsecsElapsed();
+			// Release any back-pressure...
+			m_mutex.lock();
+			m_cond.wakeAll();
+		}
+
+		m_mutex.unlock();
+	}
+
+private:
+
+	qtractorAudioFile *m_pFile;
+
+	// The lock-free block queue.
+	qtractorRingBuffer<float> *m_pRingBuffer;
+
+	float      **m_ppFrames;
+	unsigned int m_iBlockSize;
+
+	// Whether the thread is logically running.
+	volatile bool m_bRunState;
+
+	// Thread synchronization objects.
+	QMutex m_mutex;
+	QWaitCondition m_cond;
+
+	// Timing statistics.
+	qint64 m_iEncodeTime;
+	qint64 m_iStallTime;
+};
+
+
+//----------------------------------------------------------------------
+// qtractorAudioExportStem -- audio export stem (one file per bus/track).
+//
+
+class qtractorAudioExportStem
+{
+public:
+
+	// Constructor
+	qtractorAudioExportStem(qtractorAudioExportWriter *pWriter,
+		qtractorAudioBus *pBus, qtractorTrack *pTrack,
+		unsigned short iDitherBits, unsigned int iBufferSize )
+		: m_pWriter(pWriter), m_pBus(pBus), m_pTrack(pTrack),
+			m_ppDither(NULL), m_fDither(0.0f), m_iRandom(0x9e3779b9)
+	{
+		m_iChannels = m_pWriter->file()->channels();
+		// TPDF dither is meant for integer sample formats only...
+		if (iDitherBits > 0) {
+			m_fDither = 1.0f / float(1 << (iDitherBits - 1));
+			m_ppDither = new float * [m_iChannels];
+			for (unsigned short i = 0; i < m_iChannels; ++i)
+				m_ppDither[i] = new float [iBufferSize];
+		}
+	}
+
+	// Destructor.
+	~qtractorAudioExportStem()
+	{
+		if (m_ppDither) {
+			for (unsigned short i = 0; i < m_iChannels; ++i)
+				delete [] m_ppDither[i];
+			delete [] m_ppDither;
+		}
+
+		qtractorAudioFile *pFile = m_pWriter->file();
+		delete m_pWriter;
+		delete pFile;
+	}
+
+	// Stem accessors.
+	qtractorAudioExportWriter *writer() const
+		{ return m_pWriter; }
+	qtractorAudioBus *bus() const
+		{ return m_pBus; }
+	qtractorTrack *track() const
+		{ return m_pTrack; }
+
+	// Grab current bus output or (uncommitted) track buffer.
+	void process(unsigned int nframes)
+	{
+		float **ppBuffer = NULL;
+		if (m_pTrack) {
+			qtractorAudioBus *pTrackBus
+				= static_cast<qtractorAudioBus *> (m_pTrack->outputBus());
+			if (pTrackBus)
+				ppBuffer = pTrackBus->buffer();
+		}
+		else
+		if (m_pBus)
+			ppBuffer = m_pBus->out();
+
+		if (ppBuffer == NULL)
+			return;
+
+		if (m_ppDither) {
+			for (unsigned short i = 0; i < m_iChannels; ++i) {
+				const float *pFrames = ppBuffer[i];
+				float *pDither = m_ppDither[i];
+				for (unsigned int n = 0; n < nframes; ++n)
+					pDither[n] = pFrames[n] + m_fDither * (random() - random());
+			}
+			ppBuffer = m_ppDither;
+		}
+
+		m_pWriter->write(ppBuffer, nframes);
+	}
+
+protected:
+
+	// Cheap uniform [0,1) pseudo-random generator (LCG).
+	float random()
+	{
+		m_iRandom = m_iRandom * 1664525 + 1013904223;
+		return float(m_iRandom >> 8) / float(1 << 24);
+	}
+
+private:
+
+	qtractorAudioExportWriter *m_pWriter;
+
+	qtractorAudioBus  *m_pBus;
+	qtractorTrack     *m_pTrack;
+
+	unsigned short m_iChannels;
+
+	// Dither buffer and amplitude (one LSB).
+	float        **m_ppDither;
+	float          m_fDither;
+	unsigned int   m_iRandom;
+};
+
+
 //----------------------------------------------------------------------
 // qtractorAudioEngine_process -- JACK client process callback.
 //
@@ -411,15 +657,33 @@ qtractorAudioEngine::qtractorAudioEngine ( qtractorSession *pSession )
 	// Common audio buffer sync thread.
 	m_pSyncThread = NULL;
 
+	// Off-RT metering/loudness analysis thread.
+	m_pAnalyzerThread = NULL;
+
+	// Anticipative track render-ahead thread.
+	m_pRenderPool = NULL;
+	m_bRenderAhead = false;
+
 	// Audio-export (in)active state.
 	m_bExporting   = false;
 	m_pExportFile  = NULL;
+	m_pExportWriter = NULL;
 	m_pExportBuses = NULL;
 	m_pExportBuffer = NULL;
 	m_iExportStart = 0;
 	m_iExportEnd   = 0;
 	m_bExportDone  = true;
 
+	m_iExportRenderTime = 0;
+	m_iExportEncodeTime = 0;
+	m_iExportStallTime  = 0;
+	m_iExportDrainTime  = 0;
+
+	// Track freeze (render cache) target.
+	m_pFreezeTrack = NULL;
+	m_iFreezeTrack = 0;
+	m_bFreezePostFader = true;
+
 	// Audio metronome stuff.
 	m_bMetronome        = false;
 	m_bMetroBus         = false;
@@ -584,6 +848,14 @@ bool qtractorAudioEngine::init (void)
 	m_pSyncThread = new qtractorAudioBufferThread();
 	m_pSyncThread->start(QThread::HighPriority);
 
+	// Our dedicated (off-RT) metering analysis thread...
+	m_pAnalyzerThread = new qtractorAudioAnalyzerThread();
+	m_pAnalyzerThread->start(QThread::LowPriority);
+
+	// Our dedicated track render-ahead worker threads...
+	m_pRenderPool = new qtractorAudioRenderPool();
+	m_pRenderPool->start(QThread::HighPriority);
+
 	return true;
 }
 
@@ -768,6 +1040,30 @@ void qtractorAudioEngine::clean (void)
 		m_pSyncThread = NULL;
 	}
 
+	// Terminate track render-ahead worker threads...
+	if (m_pRenderPool) {
+		qtractorSession *pSession = session();
+		if (pSession) {
+			for (qtractorTrack *pTrack = pSession->tracks().first();
+					pTrack; pTrack = pTrack->next()) {
+				pTrack->setRenderAhead(false);
+			}
+		}
+		m_pRenderPool->stop();
+		delete m_pRenderPool;
+		m_pRenderPool = NULL;
+	}
+
+	// Terminate metering analysis thread...
+	if (m_pAnalyzerThread) {
+		if (m_pAnalyzerThread->isRunning()) do {
+			m_pAnalyzerThread->setRunState(false);
+			m_pAnalyzerThread->sync();
+		} while (!m_pAnalyzerThread->wait(100));
+		delete m_pAnalyzerThread;
+		m_pAnalyzerThread = NULL;
+	}
+
 	// Audio-export stilll around? weird...
 	if (m_pExportBuffer) {
 		delete m_pExportBuffer;
@@ -779,11 +1075,20 @@ void qtractorAudioEngine::clean (void)
 		m_pExportBuses = NULL;
 	}
 
+	if (m_pExportWriter) {
+		delete m_pExportWriter;
+		m_pExportWriter = NULL;
+	}
+
 	if (m_pExportFile) {
 		delete m_pExportFile;
 		m_pExportFile = NULL;
 	}
 
+	qDeleteAll(m_exportStems);
+	m_exportStems.clear();
+	m_exportTrackStems.clear();
+
 	// Close the JACK client, finally.
 	if (m_pJackClient) {
 		jack_client_close(m_pJackClient);
@@ -823,7 +1128,9 @@ int qtractorAudioEngine::process ( unsigned int nframes )
 	if (pAudioCursor == NULL)
 		return 0;
 
-	// Session RT-safeness lock...
+	// Session RT-safeness lock: while locked for editing, this
+	// whole period is skipped, as there's no immutable snapshot
+	// of tracks, clips, buses and plugins to go on instead...
 	if (!pSession->acquire())
 		return 0;
 
@@ -1044,9 +1351,9 @@ void qtractorAudioEngine::process_export ( unsigned int nframes )
 {
 	if (m_bExportDone)
 		return;
-	if (m_pExportBuses  == NULL ||
-		m_pExportFile   == NULL ||
-		m_pExportBuffer == NULL)
+	if (m_pExportBuses == NULL)
+		return;
+	if (m_pExportWriter == NULL && m_exportStems.isEmpty())
 		return;
 
 	qtractorSession *pSession = session();
@@ -1077,8 +1384,13 @@ void qtractorAudioEngine::process_export ( unsigned int nframes )
 
 	// Write output bus buffers to export audio file...
 	if (iFrameStart < m_iExportEnd && iFrameEnd > m_iExportStart) {
+		// Check end-of-export...
+		unsigned int nexport = nframes;
+		if (iFrameEnd > m_iExportEnd)
+			nexport -= (iFrameEnd - m_iExportEnd);
 		// Prepare mix-down buffer...
-		m_pExportBuffer->process_prepare(nframes);
+		if (m_pExportBuffer)
+			m_pExportBuffer->process_prepare(nframes);
 		// Force/sync every audio clip approaching...
 	#ifdef CONFIG_LV2
 	#ifdef CONFIG_LV2_TIME
@@ -1093,27 +1405,62 @@ void qtractorAudioEngine::process_export ( unsigned int nframes )
 			pMidiManager = pMidiManager->next();
 		}
 		// Perform all tracks processing...
-		int iTrack = 0;
-		for (qtractorTrack *pTrack = pSession->tracks().first();
-				pTrack; pTrack = pTrack->next()) {
-			pTrack->process_export(pAudioCursor->clip(iTrack),
-				iFrameStart, iFrameEnd);
-			++iTrack;
+		if (m_pFreezeTrack) {
+			// Track freeze rendering, on its own...
+			m_pFreezeTrack->process_freeze(
+				pAudioCursor->clip(m_iFreezeTrack),
+				iFrameStart, iFrameEnd, m_bFreezePostFader);
+		} else {
+			int iTrack = 0;
+			for (qtractorTrack *pTrack = pSession->tracks().first();
+					pTrack; pTrack = pTrack->next()) {
+				pTrack->process_export(pAudioCursor->clip(iTrack),
+					iFrameStart, iFrameEnd);
+				// Track stems grab their own post-fader buffer,
+				// before the next track on the same bus clobbers it...
+				if (!m_exportTrackStems.isEmpty()) {
+					qtractorAudioExportStem *pTrackStem
+						= m_exportTrackStems.value(pTrack, NULL);
+					if (pTrackStem)
+						pTrackStem->process(nexport);
+				}
+				++iTrack;
+			}
 		}
 		// Prepare advance for next cycle...
 		pAudioCursor->seek(iFrameEnd);
-		// Check end-of-export...
-		if (iFrameEnd > m_iExportEnd)
-			nframes -= (iFrameEnd - m_iExportEnd);
+		// Stick to the export range...
+		nframes = nexport;
 		// Commit the output buses...
 		iter.toFront();
 		while (iter.hasNext()) {
 			qtractorAudioBus *pExportBus = iter.next();
 			pExportBus->process_commit(nframes);
-			m_pExportBuffer->process_add(pExportBus, nframes);
+			if (m_pExportBuffer)
+				m_pExportBuffer->process_add(pExportBus, nframes);
 		}
 		// Write to export file...
-		m_pExportFile->write(m_pExportBuffer->buffer(), nframes);
+		if (m_pFreezeTrack) {
+			// Track freeze grabs the (uncommitted) track buffer...
+			qtractorAudioBus *pFreezeBus
+				= static_cast<qtractorAudioBus *> (m_pFreezeTrack->outputBus());
+			if (pFreezeBus)
+				m_pExportWriter->write(pFreezeBus->buffer(), nframes);
+		}
+		else
+		if (m_pExportWriter && m_pExportBuffer) {
+			m_pExportWriter->write(m_pExportBuffer->buffer(), nframes);
+		}
+		// Write each bus stem on its own...
+		QListIterator<qtractorAudioExportStem *> stem_iter(m_exportStems);
+		while (stem_iter.hasNext()) {
+			qtractorAudioExportStem *pExportStem = stem_iter.next();
+			if (pExportStem->bus())
+				pExportStem->process(nframes);
+		}
+		// Freewheeling analysis is done in-line (non RT safe)...
+		if (m_pAnalyzerThread)
+			m_pAnalyzerThread->syncExport();
 		// HACK! Freewheeling observers update (non RT safe!)...
 		qtractorSubject::flushQueue(false);
 	} else {
@@ -1356,24 +1703,20 @@ bool qtractorAudioEngine::fileExport (
 	if (pSession == NULL)
 		return false;
 
-	// About to show some progress bar...
-	qtractorMainForm *pMainForm = qtractorMainForm::getInstance();
-	if (pMainForm == NULL)
-		return false;
-
-	QProgressBar *pProgressBar = pMainForm->progressBar();
-	if (pProgressBar == NULL)
-		return false;
-
 	// Cannot have exports longer than current session.
 	if (iExportStart >= iExportEnd)
 		iExportEnd = pSession->sessionEnd();
 	if (iExportStart >= iExportEnd)
 		return false;
 
+	// Lazy (deferred) clips must be all open by now...
+	pSession->openDeferClips();
+
 	// We'll grab the first bus around, as reference...
+	// (or the one track being frozen is assigned to)
 	qtractorAudioBus *pExportBus
-		= static_cast<qtractorAudioBus *> (buses().first());
+		= static_cast<qtractorAudioBus *> (m_pFreezeTrack
+			? m_pFreezeTrack->outputBus() : buses().first());
 	if (pExportBus == NULL)
 		return false;
 
@@ -1392,25 +1735,138 @@ bool qtractorAudioEngine::fileExport (
 		return false;
 	}
 
+	// Single mix-down file...
+	m_pExportFile  = pExportFile;
+	m_pExportBuffer = new qtractorAudioExportBuffer(iChannels, bufferSize());
+
+	return fileExportRun(exportBuses, iExportStart, iExportEnd);
+}
+
+
+// Audio-export multi-stem (single pass) method.
+bool qtractorAudioEngine::fileExportStems (
+	const QList<ExportStem>& exportStems,
+	unsigned long iExportStart, unsigned long iExportEnd )
+{
+	// No simultaneous or foul exports...
+	if (!isActivated() || isPlaying() || isExporting())
+		return false;
+
+	if (exportStems.isEmpty())
+		return false;
+
+	// Make sure we have an actual session cursor...
+	qtractorSession *pSession = session();
+	if (pSession == NULL)
+		return false;
+
+	// Cannot have exports longer than current session.
+	if (iExportStart >= iExportEnd)
+		iExportEnd = pSession->sessionEnd();
+	if (iExportStart >= iExportEnd)
+		return false;
+
+	// Lazy (deferred) clips must be all open by now...
+	pSession->openDeferClips();
+
+	// Open all stem files, each one on its own...
+	QList<qtractorAudioBus *> exportBuses;
+	QListIterator<ExportStem> iter(exportStems);
+	while (iter.hasNext()) {
+		const ExportStem& stem = iter.next();
+		// Either an output bus or an audio track (post-fader)...
+		qtractorAudioBus *pExportBus = stem.bus;
+		if (stem.track) {
+			if (stem.track->trackType() != qtractorTrack::Audio)
+				continue;
+			pExportBus = static_cast<qtractorAudioBus *> (
+				stem.track->outputBus());
+		}
+		if (pExportBus == NULL)
+			continue;
+		// Get proper file type class...
+		qtractorAudioFile *pExportFile
+			= qtractorAudioFileFactory::createAudioFile(stem.path,
+				pExportBus->channels(), sampleRate(), bufferSize(), stem.format);
+		// Go open it, for writeing of course...
+		if (pExportFile
+			&& !pExportFile->open(stem.path, qtractorAudioFile::Write)) {
+			delete pExportFile;
+			pExportFile = NULL;
+		}
+		// Bail out, all or nothing...
+		if (pExportFile == NULL) {
+			qDeleteAll(m_exportStems);
+			m_exportStems.clear();
+			m_exportTrackStems.clear();
+			return false;
+		}
+		const unsigned short iDitherBits = (stem.dither
+			? qtractorAudioFileFactory::formatBits(stem.path, stem.format)
+			: 0);
+		qtractorAudioExportStem *pExportStem
+			= new qtractorAudioExportStem(
+				new qtractorAudioExportWriter(pExportFile,
+					exportWriterSize(), bufferSize()),
+				stem.track ? NULL : stem.bus, stem.track,
+				iDitherBits, bufferSize());
+		m_exportStems.append(pExportStem);
+		if (stem.track)
+			m_exportTrackStems.insert(stem.track, pExportStem);
+		else
+		if (!exportBuses.contains(stem.bus))
+			exportBuses.append(stem.bus);
+	}
+
+	// Nothing to export?
+	if (m_exportStems.isEmpty())
+		return false;
+
+	return fileExportRun(exportBuses, iExportStart, iExportEnd);
+}
+
+
+// Audio-export freewheeling executive (common to all exports).
+bool qtractorAudioEngine::fileExportRun (
+	const QList<qtractorAudioBus *>& exportBuses,
+	unsigned long iExportStart, unsigned long iExportEnd )
+{
+	qtractorSession *pSession = session();
+
+	// About to show some progress bar...
+	QProgressBar *pProgressBar = NULL;
+	qtractorMainForm *pMainForm = qtractorMainForm::getInstance();
+	if (pMainForm)
+		pProgressBar = pMainForm->progressBar();
+
 	// We'll be busy...
 	pSession->lock();
 
 	// HACK! reset subject/observers queue...
 	qtractorSubject::resetQueue();
 
+	// Encoding is pipelined on its own thread...
+	if (m_pExportFile) {
+		m_pExportWriter = new qtractorAudioExportWriter(
+			m_pExportFile, exportWriterSize(), bufferSize());
+	}
+
 	// Start with fixing the export range...
 	m_bExporting   = true;
 	m_pExportBuses = new QList<qtractorAudioBus *> (exportBuses);
-	m_pExportFile  = pExportFile;
-	m_pExportBuffer = new qtractorAudioExportBuffer(iChannels, bufferSize());
 	m_iExportStart = iExportStart;
 	m_iExportEnd   = iExportEnd;
 	m_bExportDone  = false;
 
+	// Render-ahead tracks get back to regular processing...
+	pSession->updateRenderAhead();
+
 	// Prepare and show some progress...
-	pProgressBar->setRange(iExportStart, iExportEnd);
-	pProgressBar->reset();
-	pProgressBar->show();
+	if (pProgressBar) {
+		pProgressBar->setRange(iExportStart, iExportEnd);
+		pProgressBar->reset();
+		pProgressBar->show();
+	}
 
 	// We'll have to save some session parameters...
 	const unsigned long iPlayHead  = pSession->playHead();
@@ -1423,6 +1879,10 @@ bool qtractorAudioEngine::fileExport (
 		qtractorAudioBus *pAudioBus = bus_iter.next();
 		exportMonitors.insert(pAudioBus, pAudioBus->isMonitor());
 		pAudioBus->setMonitor(false);
+		// Loudness statistics start afresh, for the export report...
+		qtractorAudioAnalyzer *pAudioAnalyzer = pAudioBus->audioAnalyzer_out();
+		if (pAudioAnalyzer)
+			pAudioAnalyzer->reset();
 	}
 
 	// Because we'll have to set the export conditions...
@@ -1440,17 +1900,52 @@ bool qtractorAudioEngine::fileExport (
 	ts.tv_sec  = 0;
 	ts.tv_nsec = 20000000L; // 20msec.
 
+	QElapsedTimer timer;
+	timer.start();
+
 	while (m_bExporting && !m_bExportDone) {
 		qtractorSession::stabilize(200);
 		::nanosleep(&ts, NULL); // Ain't that enough?
-		pProgressBar->setValue(pSession->playHead());
+		if (pProgressBar)
+			pProgressBar->setValue(pSession->playHead());
 	}
 
+	// Rendering is over, now on to the final drain...
+	const qint64 iElapsedTime = timer.nsecsElapsed();
+
 	// Stop export (freewheeling)...
 	jack_set_freewheel(m_pJackClient, 0);
 
-	// May close the file...
-	m_pExportFile->close();
+	// Drain all pending encoding and close the file(s)...
+	QList<qtractorAudioExportWriter *> writers;
+	if (m_pExportWriter)
+		writers.append(m_pExportWriter);
+	QListIterator<qtractorAudioExportStem *> stem_iter(m_exportStems);
+	while (stem_iter.hasNext())
+		writers.append(stem_iter.next()->writer());
+
+	qint64 iStallTime  = 0;
+	qint64 iEncodeTime = 0;
+	QListIterator<qtractorAudioExportWriter *> writer_iter(writers);
+	while (writer_iter.hasNext()) {
+		qtractorAudioExportWriter *pExportWriter = writer_iter.next();
+		pExportWriter->flush();
+		pExportWriter->file()->close();
+		iStallTime  += pExportWriter->stallTime();
+		iEncodeTime += pExportWriter->encodeTime();
+	}
+
+	// Rendering is what's left while not stalled on encoding...
+	const qint64 iDrainTime = timer.nsecsElapsed() - iElapsedTime;
+	m_iExportStallTime  = (iStallTime / 1000000);
+	m_iExportEncodeTime = (iEncodeTime / 1000000);
+	m_iExportDrainTime  = (iDrainTime / 1000000);
+	m_iExportRenderTime = (iElapsedTime > iStallTime
+		? (iElapsedTime - iStallTime) / 1000000 : 0);
+
+	// Flush any remaining analysis...
+	if (m_pAnalyzerThread)
+		m_pAnalyzerThread->syncExport();
 
 	// Restore session at ease...
 	pSession->setLoop(iLoopStart, iLoopEnd);
@@ -1466,16 +1961,27 @@ bool qtractorAudioEngine::fileExport (
 	const bool bResult = m_bExporting;
 
 	// Free up things here.
-	delete m_pExportBuffer;
+	if (m_pExportBuffer)
+		delete m_pExportBuffer;
+	if (m_pExportWriter)
+		delete m_pExportWriter;
+	if (m_pExportFile)
+		delete m_pExportFile;
+
 	delete m_pExportBuses;
-	delete m_pExportFile;
+
+	qDeleteAll(m_exportStems);
+	m_exportStems.clear();
+	m_exportTrackStems.clear();
 
 	// Made some progress...
-	pProgressBar->hide();
+	if (pProgressBar)
+		pProgressBar->hide();
 
 	m_bExporting   = false;
 	m_pExportBuses = NULL;
 	m_pExportFile  = NULL;
+	m_pExportWriter = NULL;
 	m_pExportBuffer = NULL;
 	m_iExportStart = 0;
 	m_iExportEnd   = 0;
@@ -1489,6 +1995,71 @@ bool qtractorAudioEngine::fileExport (
 }
 
 
+// Audio-export encoder queue size (in frames).
+unsigned int qtractorAudioEngine::exportWriterSize (void) const
+{
+	// About a second worth of rendered blocks...
+	unsigned int iWriterSize = (bufferSize() << 2);
+	while (iWriterSize < sampleRate())
+		iWriterSize <<= 1;
+
+	return iWriterSize;
+}
+
+
+// Last audio-export timing statistics (msecs).
+unsigned long qtractorAudioEngine::exportRenderTime (void) const
+{
+	return m_iExportRenderTime;
+}
+
+unsigned long qtractorAudioEngine::exportEncodeTime (void) const
+{
+	return m_iExportEncodeTime;
+}
+
+unsigned long qtractorAudioEngine::exportStallTime (void) const
+{
+	return m_iExportStallTime;
+}
+
+unsigned long qtractorAudioEngine::exportDrainTime (void) const
+{
+	return m_iExportDrainTime;
+}
+
+
+// Track freeze (render cache) method.
+bool qtractorAudioEngine::fileFreeze ( const QString& sFreezePath,
+	qtractorTrack *pTrack, bool bPostFader )
+{
+	if (pTrack == NULL || pTrack->trackType() != qtractorTrack::Audio)
+		return false;
+
+	qtractorSession *pSession = session();
+	if (pSession == NULL)
+		return false;
+
+	const int iTrack = pSession->tracks().find(pTrack);
+	if (iTrack < 0)
+		return false;
+
+	// Render the track alone, as a regular (freewheeling) export...
+	m_pFreezeTrack = pTrack;
+	m_iFreezeTrack = iTrack;
+	m_bFreezePostFader = bPostFader;
+
+	const bool bResult
+		= fileExport(sFreezePath, QList<qtractorAudioBus *> ());
+
+	m_pFreezeTrack = NULL;
+	m_iFreezeTrack = 0;
+	m_bFreezePostFader = true;
+
+	return bResult;
+}
+
+
 // Special track-immediate methods.
 void qtractorAudioEngine::trackMute ( qtractorTrack *pTrack, bool bMute )
 {
@@ -2049,6 +2620,32 @@ unsigned long qtractorAudioEngine::jackFrameTime (void) const
 }
 
 
+// Off-RT metering/loudness analysis thread accessor.
+qtractorAudioAnalyzerThread *qtractorAudioEngine::analyzerThread (void) const
+{
+	return m_pAnalyzerThread;
+}
+
+
+// Anticipative (render-ahead) track processing mode.
+void qtractorAudioEngine::setRenderAhead ( bool bRenderAhead )
+{
+	m_bRenderAhead = bRenderAhead;
+}
+
+bool qtractorAudioEngine::isRenderAhead (void) const
+{
+	return m_bRenderAhead;
+}
+
+
+// Render-ahead worker threads accessor.
+qtractorAudioRenderPool *qtractorAudioEngine::renderPool (void) const
+{
+	return m_pRenderPool;
+}
+
+
 // Reset all audio monitoring...
 void qtractorAudioEngine::resetAllMonitors (void)
 {
@@ -2115,6 +2712,9 @@ qtractorAudioBus::qtractorAudioBus (
 		m_pOCurveFile    = NULL;
 	}
 
+	m_pIAudioAnalyzer = NULL;
+	m_pOAudioAnalyzer = NULL;
+
 	m_bAutoConnect = false;
 
 	m_ppIPorts  = NULL;
@@ -2263,6 +2863,25 @@ bool qtractorAudioBus::open (void)
 	// Update monitor subject names...
 	qtractorAudioBus::updateBusName();
 
+	// Off-RT metering analysis taps...
+	qtractorAudioAnalyzerThread *pAnalyzerThread
+		= pAudioEngine->analyzerThread();
+	if (pAnalyzerThread) {
+		const unsigned int iSampleRate = pAudioEngine->sampleRate();
+		if (m_pIAudioMonitor) {
+			m_pIAudioAnalyzer = new qtractorAudioAnalyzer(
+				m_iChannels, iSampleRate, iBufferSize);
+			pAnalyzerThread->addAnalyzer(m_pIAudioAnalyzer);
+			m_pIAudioMonitor->setAnalyzer(m_pIAudioAnalyzer);
+		}
+		if (m_pOAudioMonitor) {
+			m_pOAudioAnalyzer = new qtractorAudioAnalyzer(
+				m_iChannels, iSampleRate, iBufferSize);
+			pAnalyzerThread->addAnalyzer(m_pOAudioAnalyzer);
+			m_pOAudioMonitor->setAnalyzer(m_pOAudioAnalyzer);
+		}
+	}
+
 	// Plugin lists need some buffer (re)allocation too...
 	if (m_pIPluginList)
 		updatePluginList(m_pIPluginList, qtractorPluginList::AudioInBus);
@@ -2294,6 +2913,38 @@ void qtractorAudioBus::close (void)
 
 	unsigned short i;
 
+	// Detach off-RT metering analysis taps,
+	// making sure the RT thread is not using them...
+	qtractorAudioAnalyzer *pIAudioAnalyzer = m_pIAudioAnalyzer;
+	qtractorAudioAnalyzer *pOAudioAnalyzer = m_pOAudioAnalyzer;
+	if (pIAudioAnalyzer || pOAudioAnalyzer) {
+		qtractorSession *pSession = pAudioEngine->session();
+		if (pSession)
+			pSession->lock();
+		if (m_pIAudioMonitor)
+			m_pIAudioMonitor->setAnalyzer(NULL);
+		if (m_pOAudioMonitor)
+			m_pOAudioMonitor->setAnalyzer(NULL);
+		m_pIAudioAnalyzer = NULL;
+		m_pOAudioAnalyzer = NULL;
+		if (pSession)
+			pSession->unlock();
+	}
+
+	// Now free them, off the analysis thread too...
+	qtractorAudioAnalyzerThread *pAnalyzerThread
+		= pAudioEngine->analyzerThread();
+	if (pIAudioAnalyzer) {
+		if (pAnalyzerThread)
+			pAnalyzerThread->removeAnalyzer(pIAudioAnalyzer);
+		delete pIAudioAnalyzer;
+	}
+	if (pOAudioAnalyzer) {
+		if (pAnalyzerThread)
+			pAnalyzerThread->removeAnalyzer(pOAudioAnalyzer);
+		delete pOAudioAnalyzer;
+	}
+
 	if (busMode & qtractorBus::Input) {
 		// Unregister and free input ports,
 		// if we're not shutdown...
@@ -2544,8 +3195,13 @@ void qtractorAudioBus::process_commit ( unsigned int nframes )
 	if (!m_bEnabled)
 		return;
 
-	if (m_pOPluginList)
-		m_pOPluginList->process(m_ppOBuffer, nframes);
+	// Output plugin chain gets skipped while silent
+	// (a buffer scan is way cheaper than any DSP)...
+	if (m_pOPluginList) {
+		m_pOPluginList->process(m_ppOBuffer, nframes,
+			qtractorPluginList::isSilentBuffer(
+				m_ppOBuffer, m_iChannels, nframes));
+	}
 	if (m_pOAudioMonitor)
 		m_pOAudioMonitor->process(m_ppOBuffer, nframes);
 }
@@ -2643,6 +3299,18 @@ qtractorAudioMonitor *qtractorAudioBus::audioMonitor_out (void) const
 }
 
 
+// Audio I/O bus-analyzer (off-RT metering) accessors.
+qtractorAudioAnalyzer *qtractorAudioBus::audioAnalyzer_in (void) const
+{
+	return m_pIAudioAnalyzer;
+}
+
+qtractorAudioAnalyzer *qtractorAudioBus::audioAnalyzer_out (void) const
+{
+	return m_pOAudioAnalyzer;
+}
+
+
 // Plugin-chain accessors.
 qtractorPluginList *qtractorAudioBus::pluginList_in (void) const
 {
@@ -28,14 +28,20 @@
 #include <jack/jack.h>
 
 #include <QObject>
+#include <QHash>
 
 
 // Forward declarations.
 class qtractorAudioBus;
 class qtractorAudioBuffer;
 class qtractorAudioMonitor;
+class qtractorAudioAnalyzer;
+class qtractorAudioAnalyzerThread;
+class qtractorAudioRenderPool;
 class qtractorAudioFile;
 class qtractorAudioExportBuffer;
+class qtractorAudioExportStem;
+class qtractorAudioExportWriter;
 class qtractorPluginList;
 class qtractorCurveList;
 
@@ -150,6 +156,40 @@ public:
 		const QList<qtractorAudioBus *>& exportBuses,
 		unsigned long iExportStart = 0, unsigned long iExportEnd = 0);
 
+	// Audio-export stem descriptor: one file per output bus
+	// or audio track (post-fader), all written in one single pass.
+	struct ExportStem
+	{
+		ExportStem(const QString& sPath = QString(),
+			qtractorAudioBus *pBus = NULL, qtractorTrack *pTrack = NULL,
+			int iFormat = -1, bool bDither = false)
+			: path(sPath), bus(pBus), track(pTrack),
+				format(iFormat), dither(bDither) {}
+
+		QString           path;     // Target file path.
+		qtractorAudioBus *bus;      // Output bus, or...
+		qtractorTrack    *track;    // ...audio track (post-fader).
+		int               format;   // Sample format (-1=default).
+		bool              dither;   // TPDF dither (integer formats).
+	};
+
+	// Audio-export multi-stem (single pass) method.
+	bool fileExportStems(const QList<ExportStem>& exportStems,
+		unsigned long iExportStart = 0, unsigned long iExportEnd = 0);
+
+	// Last audio-export timing statistics (msecs):
+	// rendering (DSP-bound), encoding (all files) and
+	// rendering stalled while encoding (encode-bound)
+	// and final encoder drain, after rendering is over.
+	unsigned long exportRenderTime() const;
+	unsigned long exportEncodeTime() const;
+	unsigned long exportStallTime() const;
+	unsigned long exportDrainTime() const;
+
+	// Track freeze (render cache) method.
+	bool fileFreeze(const QString& sFreezePath,
+		qtractorTrack *pTrack, bool bPostFader = true);
+
 	// Special track-immediate methods.
 	void trackMute(qtractorTrack *pTrack, bool bMute);
 
@@ -227,6 +267,16 @@ public:
 	// Reset all audio monitoring...
 	void resetAllMonitors();
 
+	// Off-RT metering/loudness analysis thread accessor.
+	qtractorAudioAnalyzerThread *analyzerThread() const;
+
+	// Anticipative (render-ahead) track processing mode.
+	void setRenderAhead(bool bRenderAhead);
+	bool isRenderAhead() const;
+
+	// Render-ahead worker threads accessor.
+	qtractorAudioRenderPool *renderPool() const;
+
 protected:
 
 	// Concrete device (de)activation methods.
@@ -254,6 +304,13 @@ protected:
 	// Metronome latency offset compensation.
 	unsigned long metro_offset(unsigned long iFrame) const;
 
+	// Audio-export freewheeling executive (common to all exports).
+	bool fileExportRun(const QList<qtractorAudioBus *>& exportBuses,
+		unsigned long iExportStart, unsigned long iExportEnd);
+
+	// Audio-export encoder queue size (in frames).
+	unsigned int exportWriterSize() const;
+
 private:
 
 	// Special event notifier proxy object.
@@ -282,9 +339,17 @@ private:
 	// Common audio buffer sync thread.
 	qtractorAudioBufferThread *m_pSyncThread;
 
+	// Off-RT metering/loudness analysis thread.
+	qtractorAudioAnalyzerThread *m_pAnalyzerThread;
+
+	// Anticipative track render-ahead worker threads.
+	qtractorAudioRenderPool *m_pRenderPool;
+	bool m_bRenderAhead;
+
 	// Audio-export (in)active state.
 	volatile bool        m_bExporting;
 	qtractorAudioFile   *m_pExportFile;
+	qtractorAudioExportWriter *m_pExportWriter;
 	unsigned long        m_iExportStart;
 	unsigned long        m_iExportEnd;
 	volatile bool        m_bExportDone;
@@ -292,6 +357,21 @@ private:
 	QList<qtractorAudioBus *> *m_pExportBuses;
 	qtractorAudioExportBuffer *m_pExportBuffer;
 
+	// Audio-export stems (single pass multi-file).
+	QList<qtractorAudioExportStem *> m_exportStems;
+	QHash<qtractorTrack *, qtractorAudioExportStem *> m_exportTrackStems;
+
+	// Audio-export timing statistics (msecs).
+	unsigned long m_iExportRenderTime;
+	unsigned long m_iExportEncodeTime;
+	unsigned long m_iExportStallTime;
+	unsigned long m_iExportDrainTime;
+
+	// Track freeze (render cache) target.
+	qtractorTrack       *m_pFreezeTrack;
+	unsigned int         m_iFreezeTrack;
+	bool                 m_bFreezePostFader;
+
 	// Audio metronome stuff.
 	bool                 m_bMetronome;
 	bool                 m_bMetroBus;
@@ -384,6 +464,10 @@ public:
 	qtractorAudioMonitor *audioMonitor_in()  const;
 	qtractorAudioMonitor *audioMonitor_out() const;
 
+	// Audio I/O bus-analyzer (off-RT metering) accessors.
+	qtractorAudioAnalyzer *audioAnalyzer_in()  const;
+	qtractorAudioAnalyzer *audioAnalyzer_out() const;
+
 	// Plugin-chain accessors.
 	qtractorPluginList *pluginList_in()  const;
 	qtractorPluginList *pluginList_out() const;
@@ -436,6 +520,10 @@ private:
 	qtractorAudioMonitor *m_pIAudioMonitor;
 	qtractorAudioMonitor *m_pOAudioMonitor;
 
+	// Specific analyzer (off-RT metering) instances.
+	qtractorAudioAnalyzer *m_pIAudioAnalyzer;
+	qtractorAudioAnalyzer *m_pOAudioAnalyzer;
+
 	// Plugin-chain instances.
 	qtractorPluginList *m_pIPluginList;
 	qtractorPluginList *m_pOPluginList;
@@ -182,6 +182,63 @@ qtractorAudioFile *qtractorAudioFileFactory::createAudioFile (
 	return getInstance().newAudioFile(type, iChannels, iSampleRate, iBufferSize);
 }
 
+qtractorAudioFile *qtractorAudioFileFactory::createAudioFile (
+	const QString& sFilename, unsigned short iChannels,
+	unsigned int iSampleRate, unsigned int iBufferSize, int iFormat )
+{
+	if (iFormat < 0)
+		return createAudioFile(sFilename, iChannels, iSampleRate, iBufferSize);
+
+	const QString sExt = QFileInfo(sFilename).suffix().toLower();
+
+	FileTypes::ConstIterator iter = getInstance().m_types.constFind(sExt);
+	if (iter == getInstance().m_types.constEnd())
+		return NULL;
+
+	const FileFormat *pFormat = iter.value();
+	if (pFormat->type == SndFile) {
+		return new qtractorAudioSndFile(iChannels, iSampleRate, iBufferSize,
+			pFormat->data | format(pFormat, iFormat));
+	}
+
+	return getInstance().newAudioFile(
+		pFormat->type, iChannels, iSampleRate, iBufferSize);
+}
+
+
+// Sample word length (bits) of the given file type/format index.
+unsigned short qtractorAudioFileFactory::formatBits (
+	const QString& sFilename, int iFormat )
+{
+	const QString sExt = QFileInfo(sFilename).suffix().toLower();
+
+	FileTypes::ConstIterator iter = getInstance().m_types.constFind(sExt);
+	if (iter == getInstance().m_types.constEnd())
+		return 0;
+
+	const FileFormat *pFormat = iter.value();
+	if (iFormat < 0) {
+		if (pFormat != getInstance().m_pDefaultFormat)
+			return 0;
+		iFormat = getInstance().m_iDefaultFormat;
+	} else {
+		iFormat = format(pFormat, iFormat);
+	}
+
+	// Only libsndfile ones are to be translated at all...
+	switch (iFormat & SF_FORMAT_SUBMASK) {
+	case SF_FORMAT_PCM_S8:
+	case SF_FORMAT_PCM_U8:
+		return 8;
+	case SF_FORMAT_PCM_16:
+		return 16;
+	case SF_FORMAT_PCM_24:
+		return 24;
+	default:
+		return 0;
+	}
+}
+
 
 // Internal factory methods.
 qtractorAudioFile *qtractorAudioFileFactory::newAudioFile (
@@ -82,6 +82,16 @@ public:
 		FileType type, unsigned short iChannels = 0,
 		unsigned int iSampleRate = 0, unsigned int iBufferSize = 0);
 
+	// Explicit sample format factory method (writing only;
+	// format index as for setDefaultType, negative for default).
+	static qtractorAudioFile *createAudioFile (
+		const QString& sFilename, unsigned short iChannels,
+		unsigned int iSampleRate, unsigned int iBufferSize, int iFormat);
+
+	// Sample word length (bits) of the given file type/format index,
+	// zero if floating point or lossy compressed (eg. for dithering).
+	static unsigned short formatBits(const QString& sFilename, int iFormat);
+
 	// Audio file format descriptor.
 	struct FileFormat
 	{
@@ -22,6 +22,7 @@
 #include "qtractorAbout.h"
 #include "qtractorAudioMeter.h"
 #include "qtractorAudioMonitor.h"
+#include "qtractorAudioAnalyzer.h"
 
 #include "qtractorObserverWidget.h"
 
@@ -33,6 +34,8 @@
 #include <QPixmap>
 #include <QLayout>
 #include <QLabel>
+#include <QHelpEvent>
+#include <QToolTip>
 
 #include <math.h>
 
@@ -501,6 +504,50 @@ void qtractorAudioMeter::resizeEvent ( QResizeEvent *pResizeEvent )
 }
 
 
+// Loudness statistics tool-tip handler.
+bool qtractorAudioMeter::event ( QEvent *pEvent )
+{
+	if (pEvent->type() == QEvent::ToolTip && m_pAudioMonitor) {
+		qtractorAudioAnalyzer *pAudioAnalyzer = m_pAudioMonitor->analyzer();
+		QHelpEvent *pHelpEvent = static_cast<QHelpEvent *> (pEvent);
+		if (pAudioAnalyzer && pHelpEvent) {
+			const qtractorAudioAnalyzer::Values& values
+				= pAudioAnalyzer->values();
+			float fPeak = 0.0f;
+			float fTruePeak = 0.0f;
+			float fRms = 0.0f;
+			for (unsigned short i = 0; i < pAudioAnalyzer->channels(); ++i) {
+				if (fPeak < values.peak.at(i))
+					fPeak = values.peak.at(i);
+				if (fTruePeak < values.truePeak.at(i))
+					fTruePeak = values.truePeak.at(i);
+				if (fRms < values.rms.at(i))
+					fRms = values.rms.at(i);
+			}
+			QString sText;
+			sText += tr("Momentary: %1 LUFS").arg(values.momentary, 0, 'f', 1);
+			sText += '\n';
+			sText += tr("Short-term: %1 LUFS").arg(values.shortTerm, 0, 'f', 1);
+			sText += '\n';
+			sText += tr("Integrated: %1 LUFS").arg(values.integrated, 0, 'f', 1);
+			sText += '\n';
+			sText += tr("RMS: %1 dB").arg(
+				qtractorAudioAnalyzer::dB(fRms), 0, 'f', 1);
+			sText += '\n';
+			sText += tr("Peak: %1 dB").arg(
+				qtractorAudioAnalyzer::dB(fPeak), 0, 'f', 1);
+			sText += '\n';
+			sText += tr("True-peak: %1 dBTP").arg(
+				qtractorAudioAnalyzer::dB(fTruePeak), 0, 'f', 1);
+			QToolTip::showText(pHelpEvent->globalPos(), sText, this);
+			return true;
+		}
+	}
+
+	return qtractorMeter::event(pEvent);
+}
+
+
 // Virtual monitor accessor.
 void qtractorAudioMeter::setMonitor ( qtractorMonitor *pMonitor )
 {
@@ -31,6 +31,7 @@ class qtractorAudioMonitor;
 
 class QResizeEvent;
 class QPaintEvent;
+class QEvent;
 
 
 //----------------------------------------------------------------------------
@@ -143,6 +144,9 @@ protected:
 	// Specific event handlers.
 	void resizeEvent(QResizeEvent *);
 
+	// Loudness statistics tool-tip handler.
+	bool event(QEvent *pEvent);
+
 private:
 
 	// Local instance variables.
@@ -20,6 +20,7 @@
 *****************************************************************************/
 
 #include "qtractorAudioMonitor.h"
+#include "qtractorAudioAnalyzer.h"
 
 #include <math.h>
 
@@ -163,7 +164,8 @@ static inline void std_process_meter (
 qtractorAudioMonitor::qtractorAudioMonitor ( unsigned short iChannels,
 	float fGain, float fPanning ) : qtractorMonitor(fGain, fPanning),
 	m_iChannels(0), m_piStamps(NULL), m_pfValues(NULL), m_pfPrevValues(NULL),
-	m_pfGains(NULL), m_pfPrevGains(NULL), m_iProcessRamp(0)
+	m_pfGains(NULL), m_pfPrevGains(NULL), m_iProcessRamp(0),
+	m_pAnalyzer(NULL)
 {
 	qtractorMonitor::gainSubject()->setMaxValue(2.0f);	// +6dB
 	qtractorMonitor::gainObserver()->setLogarithmic(true);
@@ -344,6 +346,12 @@ void qtractorAudioMonitor::process (
 		}
 		// Done normal-processing.
 	}
+
+	// Post-gain tap for off-RT analysis...
+	qtractorAudioAnalyzer *pAnalyzer = m_pAnalyzer;
+	if (pAnalyzer && iChannels == m_iChannels
+		&& pAnalyzer->channels() == m_iChannels)
+		pAnalyzer->write(ppFrames, iFrames);
 }
 
 
@@ -376,6 +384,18 @@ void qtractorAudioMonitor::process_meter (
 }
 
 
+// Off-RT analysis tap accessors.
+void qtractorAudioMonitor::setAnalyzer ( qtractorAudioAnalyzer *pAnalyzer )
+{
+	m_pAnalyzer = pAnalyzer;
+}
+
+qtractorAudioAnalyzer *qtractorAudioMonitor::analyzer (void) const
+{
+	return m_pAnalyzer;
+}
+
+
 // Rebuild the whole panning-gain array...
 void qtractorAudioMonitor::update (void)
 {
@@ -25,6 +25,10 @@
 #include "qtractorMonitor.h"
 
 
+// Forward declarations.
+class qtractorAudioAnalyzer;
+
+
 //----------------------------------------------------------------------------
 // qtractorAudioMonitor -- Audio monitor bridge value processor.
 
@@ -55,6 +59,10 @@ public:
 	// Reset channel gain trackers.
 	void reset();
 
+	// Off-RT analysis tap accessors.
+	void setAnalyzer(qtractorAudioAnalyzer *pAnalyzer);
+	qtractorAudioAnalyzer *analyzer() const;
+
 protected:
 
 	// Rebuild the whole panning-gain array...
@@ -71,6 +79,9 @@ private:
 	float         *m_pfPrevGains;
 	volatile int   m_iProcessRamp;
 
+	// Off-RT analysis tap (not owned).
+	qtractorAudioAnalyzer *volatile m_pAnalyzer;
+
 	// Monitoring evaluator processor.
 	void (*m_pfnProcess)(float *, unsigned int, float, float *);
 	void (*m_pfnProcessRamp)(float *, unsigned int, float, float, float *);
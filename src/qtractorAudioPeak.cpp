@@ -51,6 +51,12 @@ static const unsigned short c_iPeakPeriod = 1024;
 // Default peak filename extension.
 static const QString c_sPeakFileExt = ".peak";
 
+// Default peak stats filename extension.
+static const QString c_sStatsFileExt = ".stats";
+
+// Silent sample threshold (about -90dB).
+static const float c_fStatsSilence = 3.16e-5f;
+
 
 //----------------------------------------------------------------------
 // class qtractorAudioPeakThread -- Audio Peak file thread.
@@ -375,6 +381,7 @@ qtractorAudioPeakFile::qtractorAudioPeakFile (
 	m_iBuffOffset  = 0;
 
 	m_bWaitSync = false;
+	m_bNoStats  = false;
 
 	m_iRefCount = 0;
 
@@ -390,11 +397,15 @@ qtractorAudioPeakFile::qtractorAudioPeakFile (
 	const QString& sPeakFilePrefix
 		= QFileInfo(dir, fileInfo.fileName()).filePath();
 	const QString& sPeakName = peakName(sFilename, fTimeStretch);
+	const QString& sPeakFileHash
+		= QString::number(qHash(sPeakName), 16);
 	const QFileInfo peakInfo(sPeakFilePrefix + '_'
-		+ QString::number(qHash(sPeakName), 16)
-		+ c_sPeakFileExt);
+		+ sPeakFileHash + c_sPeakFileExt);
+	const QFileInfo statsInfo(sPeakFilePrefix + '_'
+		+ sPeakFileHash + c_sStatsFileExt);
 
 	m_peakFile.setFileName(peakInfo.absoluteFilePath());
+	m_statsFile.setFileName(statsInfo.absoluteFilePath());
 }
 
 
@@ -419,10 +430,18 @@ bool qtractorAudioPeakFile::openRead (void)
 	// Need some preliminary file information...
 	QFileInfo fileInfo(m_sFilename);
 	QFileInfo peakInfo(m_peakFile.fileName());
-	// Have we a peak file up-to-date,
-	// or must the peak file be (re)created?
-	if (!peakInfo.exists() || peakInfo.created() < fileInfo.created()) {
-	//	|| peakInfo.lastModified() < fileInfo.lastModified()) {
+	// Have we a peak file up-to-date (and its stats sidecar),
+	// or must the peak file be (re)created? A missing sidecar
+	// gets its one chance only, marked as such from now on...
+	bool bSync = (!peakInfo.exists()
+		|| peakInfo.created() < fileInfo.created());
+	//	|| peakInfo.lastModified() < fileInfo.lastModified());
+	if (!bSync && !m_bNoStats
+		&& !QFileInfo(m_statsFile.fileName()).exists()) {
+		m_bNoStats = true;
+		bSync = true;
+	}
+	if (bSync) {
 		qtractorAudioPeakFactory *pPeakFactory
 			= qtractorAudioPeakFactory::getInstance();
 		if (pPeakFactory)
@@ -486,6 +505,85 @@ void qtractorAudioPeakFile::closeRead (void)
 }
 
 
+// Read exact statistics summary over a range of peak periods.
+bool qtractorAudioPeakFile::readStats (
+	unsigned long iPeakOffset, unsigned long iPeakLength, Stats *pStats )
+{
+	// Peak file must be there, complete and ready...
+	if (m_openMode == Write || m_bWaitSync || !openRead())
+		return false;
+
+	// Known to be missing or broken already?
+	if (m_bNoStats)
+		return false;
+
+	const unsigned short iChannels = m_peakHeader.channels;
+	if (iChannels < 1)
+		return false;
+
+	for (unsigned short i = 0; i < iChannels; ++i) {
+		Stats& stats = pStats[i];
+		stats.peak   = 0.0f;
+		stats.sum    = 0.0;
+		stats.sumsq  = 0.0;
+		stats.frames = 0;
+		stats.zeros  = 0;
+	}
+
+	QFile file(m_statsFile.fileName());
+	if (!file.open(QIODevice::ReadOnly)) {
+		m_bNoStats = true;
+		return false;
+	}
+
+	Header header;
+	if (file.read((char *) &header, sizeof(Header)) != qint64(sizeof(Header))
+		|| header.period != m_peakHeader.period
+		|| header.channels != iChannels) {
+		file.close();
+		m_bNoStats = true;
+		return false;
+	}
+
+	const unsigned int nsize = iChannels * sizeof(Block);
+	if (!file.seek(sizeof(Header) + iPeakOffset * nsize)) {
+		file.close();
+		return false;
+	}
+
+	// Go through it in reasonable chunks...
+	const unsigned int iBlocks = c_iPeakFrames;
+	Block *pBlocks = new Block [iChannels * iBlocks];
+	while (iPeakLength > 0) {
+		const unsigned int nblocks
+			= (iPeakLength > iBlocks ? iBlocks : iPeakLength);
+		const int nread = int(file.read((char *) pBlocks, nblocks * nsize)
+			/ qint64(nsize));
+		if (nread < 1)
+			break;
+		const Block *pBlock = pBlocks;
+		for (int n = 0; n < nread; ++n) {
+			for (unsigned short i = 0; i < iChannels; ++i, ++pBlock) {
+				Stats& stats = pStats[i];
+				if (stats.peak < pBlock->peak)
+					stats.peak = pBlock->peak;
+				stats.sum    += pBlock->sum;
+				stats.sumsq  += pBlock->sumsq;
+				stats.frames += pBlock->frames;
+				stats.zeros  += pBlock->zeros;
+			}
+		}
+		iPeakLength -= nread;
+	}
+	delete [] pBlocks;
+
+	file.close();
+
+	// Short read? stats are incomplete...
+	return (iPeakLength < 1);
+}
+
+
 // Audio properties accessors.
 const QString& qtractorAudioPeakFile::filename (void) const
 {
@@ -641,6 +739,16 @@ bool qtractorAudioPeakFile::openWrite (
 		return false;
 	}
 
+	// Exact stats sidecar, same header (best effort).
+	m_bNoStats = !m_statsFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+	if (!m_bNoStats
+		&& m_statsFile.write((const char *) &m_peakHeader, sizeof(Header))
+			!= qint64(sizeof(Header))) {
+		m_statsFile.close();
+		m_statsFile.remove();
+		m_bNoStats = true;
+	}
+
 #ifdef CONFIG_DEBUG_0
 	qDebug("qtractorAudioPeakFile[%p]::openWrite() ---", this);
 	qDebug("name        = %s", m_peakFile.fileName().toUtf8().constData());
@@ -661,8 +769,13 @@ bool qtractorAudioPeakFile::openWrite (
 	m_pWriter->amax = new float [m_peakHeader.channels];
 	m_pWriter->amin = new float [m_peakHeader.channels];
 	m_pWriter->arms = new float [m_peakHeader.channels];
-	for (unsigned short i = 0; i < m_peakHeader.channels; ++i)
+	m_pWriter->asum = new float [m_peakHeader.channels];
+	m_pWriter->azeros = new unsigned int [m_peakHeader.channels];
+	for (unsigned short i = 0; i < m_peakHeader.channels; ++i) {
 		m_pWriter->amax[i] = m_pWriter->amin[i] = m_pWriter->arms[i] = 0.0f;
+		m_pWriter->asum[i] = 0.0f;
+		m_pWriter->azeros[i] = 0;
+	}
 
 	// Get resample/timestretch-aware internal peak period ratio...
 	m_pWriter->period_p = iSampleRate;
@@ -709,10 +822,15 @@ void qtractorAudioPeakFile::closeWrite (void)
 		m_openMode = None;
 	}
 
+	if (m_statsFile.isOpen())
+		m_statsFile.close();
+
 	if (m_pWriter) {
 		delete [] m_pWriter->amax;
 		delete [] m_pWriter->amin;
 		delete [] m_pWriter->arms;
+		delete [] m_pWriter->asum;
+		delete [] m_pWriter->azeros;
 		delete m_pWriter;
 		m_pWriter = NULL;
 	}
@@ -739,6 +857,9 @@ int qtractorAudioPeakFile::write (
 			if (m_pWriter->amin[i] > fSample)
 				m_pWriter->amin[i] = fSample;
 			m_pWriter->arms[i] += (fSample * fSample);
+			m_pWriter->asum[i] += fSample;
+			if (::fabsf(fSample) < c_fStatsSilence)
+				++m_pWriter->azeros[i];
 		}
 		// Count peak frames (incremental)...
 		++m_pWriter->npeak;
@@ -774,7 +895,25 @@ void qtractorAudioPeakFile::writeFrame (void)
 		return;
 
 	Frame frame;
+	Block block;
 	for (unsigned short i = 0; i < m_peakHeader.channels; ++i) {
+		// Write the exact stats values first...
+		if (m_statsFile.isOpen()) {
+			block.peak   = qMax(::fabsf(m_pWriter->amax[i]),
+				::fabsf(m_pWriter->amin[i]));
+			block.sum    = m_pWriter->asum[i];
+			block.sumsq  = m_pWriter->arms[i];
+			block.frames = m_pWriter->npeak;
+			block.zeros  = m_pWriter->azeros[i];
+			if (m_statsFile.write((const char *) &block, sizeof(Block))
+					!= qint64(sizeof(Block))) {
+				m_statsFile.close();
+				m_statsFile.remove();
+				m_bNoStats = true;
+			}
+		}
+		m_pWriter->asum[i] = 0.0f;
+		m_pWriter->azeros[i] = 0;
 		// Write the denormalized peak values...
 		float& fmax = m_pWriter->amax[i];
 		float& fmin = m_pWriter->amin[i];
@@ -810,6 +949,7 @@ void qtractorAudioPeakFile::removeRef (void)
 void qtractorAudioPeakFile::remove (void)
 {
 	m_peakFile.remove();
+	m_statsFile.remove();
 }
 
 
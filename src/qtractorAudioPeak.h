@@ -75,11 +75,36 @@ public:
 		unsigned char rms;
 	};
 
+	// Audio peak stats file block record (exact, per channel).
+	struct Block
+	{
+		float        peak;		// Absolute peak.
+		float        sum;		// Sum of samples (DC).
+		float        sumsq;		// Sum of squares (energy).
+		unsigned int frames;	// Number of sample frames.
+		unsigned int zeros;		// Number of silent sample frames.
+	};
+
+	// Exact statistics summary record (per channel).
+	struct Stats
+	{
+		float         peak;
+		double        sum;
+		double        sumsq;
+		unsigned long frames;
+		unsigned long zeros;
+	};
+
 	// Peak cache file methods.
 	bool openRead();
 	Frame *read(unsigned long iPeakOffset, unsigned int iPeakLength);
 	void closeRead();
 
+	// Read exact statistics summary over a range of peak periods
+	// (pStats must hold as many items as channels()).
+	bool readStats(unsigned long iPeakOffset, unsigned long iPeakLength,
+		Stats *pStats);
+
 	// Write peak from audio frame methods.
 	bool openWrite(unsigned short iChannels, unsigned int iSampleRate);
 	int write(float **ppAudioFrames, unsigned int iAudioFrames);
@@ -118,6 +143,7 @@ private:
 	float          m_fTimeStretch;
 
 	QFile          m_peakFile;
+	QFile          m_statsFile;
 
 	enum { None = 0, Read = 1, Write = 2 } m_openMode;
 
@@ -131,6 +157,7 @@ private:
 	QMutex         m_mutex;
 
 	volatile bool  m_bWaitSync;
+	volatile bool  m_bNoStats;
 
 	// Current reference count.
 	unsigned int   m_iRefCount;
@@ -142,6 +169,8 @@ private:
 		float         *amax;
 		float         *amin;
 		float         *arms;
+		float         *asum;
+		unsigned int  *azeros;
 		unsigned long  period_p;
 		unsigned int   period_q;
 		unsigned int   period_r;
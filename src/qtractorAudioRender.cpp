@@ -0,0 +1,532 @@
+// qtractorAudioRender.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2017, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorAudioRender.h"
+
+#include "qtractorSession.h"
+#include "qtractorAudioClip.h"
+#include "qtractorPlugin.h"
+
+
+// Render-ahead FIFO length (in msecs).
+#define QTRACTOR_AUDIO_RENDER_LOOKAHEAD	250
+
+// Minimum settled regular processing before hand-over (in msecs).
+#define QTRACTOR_AUDIO_RENDER_HANDOVER	50
+
+// Nominal render-ahead block size (in frames).
+#define QTRACTOR_AUDIO_RENDER_BLOCKSIZE	1024
+
+// Maximum number of render-ahead worker threads.
+#define QTRACTOR_AUDIO_RENDER_THREADS	8
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioRenderThread -- Anticipative track render worker.
+//
+
+// Constructor.
+qtractorAudioRenderThread::qtractorAudioRenderThread (
+	qtractorAudioRenderPool *pRenderPool, unsigned int iIndex ) : QThread()
+{
+	m_pRenderPool = pRenderPool;
+	m_iIndex = iIndex;
+}
+
+
+// Thread run executive.
+void qtractorAudioRenderThread::run (void)
+{
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioRenderThread[%p]::run(%u): started.", this, m_iIndex);
+#endif
+
+	while (m_pRenderPool->wait())
+		m_pRenderPool->process(m_iIndex);
+
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioRenderThread[%p]::run(%u): stopped.", this, m_iIndex);
+#endif
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioRenderPool -- Anticipative track render workers.
+//
+
+// Constructor.
+qtractorAudioRenderPool::qtractorAudioRenderPool ( unsigned long iSyncPeriod )
+{
+	m_iSyncPeriod = iSyncPeriod;
+
+	m_bRunState = false;
+
+	ATOMIC_SET(&m_syncPending, 0);
+}
+
+
+// Destructor.
+qtractorAudioRenderPool::~qtractorAudioRenderPool (void)
+{
+	stop();
+}
+
+
+// Worker threads (de)activation.
+void qtractorAudioRenderPool::start ( QThread::Priority priority )
+{
+	if (!m_threads.isEmpty())
+		return;
+
+	m_mutex.lock();
+	m_bRunState = true;
+	m_mutex.unlock();
+
+	// Leave at least one core to the RT...
+	int iThreads = QThread::idealThreadCount() - 1;
+	if (iThreads > QTRACTOR_AUDIO_RENDER_THREADS)
+		iThreads = QTRACTOR_AUDIO_RENDER_THREADS;
+	if (iThreads < 1)
+		iThreads = 1;
+
+	for (int i = 0; i < iThreads; ++i) {
+		qtractorAudioRenderThread *pRenderThread
+			= new qtractorAudioRenderThread(this, i);
+		pRenderThread->start(priority);
+		m_threads.append(pRenderThread);
+	}
+}
+
+void qtractorAudioRenderPool::stop (void)
+{
+	m_mutex.lock();
+	m_bRunState = false;
+	m_mutex.unlock();
+
+	QListIterator<qtractorAudioRenderThread *> iter(m_threads);
+	while (iter.hasNext()) {
+		qtractorAudioRenderThread *pRenderThread = iter.next();
+		if (pRenderThread->isRunning()) do {
+		//	pRenderThread->terminate();
+			sync();
+		} while (!pRenderThread->wait(100));
+	}
+
+	qDeleteAll(m_threads);
+	m_threads.clear();
+}
+
+
+// Track render-ahead registry (non RT-safe).
+void qtractorAudioRenderPool::addRender (
+	qtractorAudioRender *pAudioRender )
+{
+	QWriteLocker locker(&m_lock);
+
+	if (!m_renders.contains(pAudioRender))
+		m_renders.append(pAudioRender);
+}
+
+void qtractorAudioRenderPool::removeRender (
+	qtractorAudioRender *pAudioRender )
+{
+	// All workers must be out of sight...
+	QWriteLocker locker(&m_lock);
+
+	m_renders.removeAll(pAudioRender);
+}
+
+
+// Wake workers from executive wait condition (RT-safe).
+void qtractorAudioRenderPool::sync (void)
+{
+	ATOMIC_SET(&m_syncPending, 1);
+
+	if (m_mutex.tryLock()) {
+		m_cond.wakeAll();
+		m_mutex.unlock();
+	}
+#ifdef CONFIG_DEBUG_0
+	else qDebug("qtractorAudioRenderPool[%p]::sync(): tryLock() failed.", this);
+#endif
+}
+
+
+// Worker wait executive (worker threads only).
+bool qtractorAudioRenderPool::wait (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	// Wait for next period (or sync), unless missed already...
+	if (m_bRunState && !ATOMIC_TAZ(&m_syncPending))
+		m_cond.wait(&m_mutex, m_iSyncPeriod);
+
+	return m_bRunState;
+}
+
+
+// Worker process executive (worker threads only).
+void qtractorAudioRenderPool::process ( unsigned int iIndex )
+{
+	QReadLocker locker(&m_lock);
+
+	// Each worker starts off a different track, while
+	// the ones being rendered by others are just skipped...
+	const int iRenders = m_renders.count();
+	for (int i = 0; i < iRenders; ++i)
+		m_renders.at((iIndex + i) % iRenders)->render();
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioRender -- Track render-ahead (lookahead) FIFO.
+//
+
+// Constructor.
+qtractorAudioRender::qtractorAudioRender ( qtractorTrack *pTrack,
+	qtractorAudioRenderPool *pRenderPool, unsigned short iChannels,
+	unsigned int iSampleRate, unsigned int iBufferSize )
+{
+	m_pTrack = pTrack;
+	m_pRenderPool = pRenderPool;
+
+	m_iChannels   = iChannels;
+	m_iBufferSize = iBufferSize;
+
+	// Render blocks are a whole number of periods...
+	m_iBlockSize = m_iBufferSize;
+	while (m_iBlockSize < QTRACTOR_AUDIO_RENDER_BLOCKSIZE)
+		m_iBlockSize += m_iBufferSize;
+
+	m_iHandover = (iSampleRate * QTRACTOR_AUDIO_RENDER_HANDOVER) / 1000;
+
+	const unsigned int iLookAhead
+		= (iSampleRate * QTRACTOR_AUDIO_RENDER_LOOKAHEAD) / 1000;
+	m_pRingBuffer = new qtractorRingBuffer<float> (m_iChannels,
+		iLookAhead + (m_iBlockSize << 1));
+
+	m_ppFrames = new float * [m_iChannels];
+	m_ppSlice  = new float * [m_iChannels];
+	for (unsigned short i = 0; i < m_iChannels; ++i) {
+		m_ppFrames[i] = new float [m_iBlockSize];
+		m_ppSlice[i]  = NULL;
+	}
+
+	// Start with regular processing, as it was...
+	m_iReadFrame    = 0;
+	m_iDirectFrames = 0;
+	m_bDirect       = true;
+
+	ATOMIC_SET(&m_direct, 1);
+	ATOMIC_SET(&m_busy, 0);
+	ATOMIC_SET(&m_resetPending, 0);
+
+	m_iRenderFrame = 0;
+	m_iClipStart   = 0;
+	m_iClipEnd     = 0;
+}
+
+
+// Destructor.
+qtractorAudioRender::~qtractorAudioRender (void)
+{
+	for (unsigned short i = 0; i < m_iChannels; ++i)
+		delete [] m_ppFrames[i];
+
+	delete [] m_ppFrames;
+	delete [] m_ppSlice;
+
+	delete m_pRingBuffer;
+}
+
+
+// Pre-rendered audio reader (RT-safe, never blocks).
+bool qtractorAudioRender::process ( float **ppBuffer,
+	unsigned long iFrameStart, unsigned long iFrameEnd )
+{
+	const unsigned int nframes = iFrameEnd - iFrameStart;
+
+	// Something (else) has changed meanwhile?
+	const bool bReset = ATOMIC_TAZ(&m_resetPending);
+
+	// Wrap around loop-end, just like the engine does...
+	qtractorSession *pSession = m_pTrack->session();
+	if (pSession->isLooping()
+		&& iFrameStart == pSession->loopStart()
+		&& m_iReadFrame == pSession->loopEnd())
+		m_iReadFrame = iFrameStart;
+
+	const bool bContinuous = (!bReset && m_iReadFrame == iFrameStart);
+
+	m_iReadFrame = iFrameEnd;
+
+	// Regular processing, until it settles down again...
+	if (m_bDirect) {
+		if (bContinuous && ppBuffer)
+			m_iDirectFrames += nframes;
+		else
+			m_iDirectFrames = 0;
+		return false;
+	}
+
+	// Pre-rendered playback (just consumed, when muted)...
+	if (bContinuous && m_pRingBuffer->readable() >= nframes) {
+		if (ppBuffer) {
+			m_pRingBuffer->read(ppBuffer, nframes);
+		} else {
+			m_pRingBuffer->setReadIndex(
+				m_pRingBuffer->readIndex() + nframes);
+		}
+		// Running short? let go of the track while there's
+		// still a whole period in reserve, otherwise make room...
+		if (m_pRingBuffer->readable() < (nframes << 1))
+			ATOMIC_SET(&m_direct, 1);
+		else if (!ATOMIC_GET(&m_direct))
+			m_pRenderPool->sync();
+		return true;
+	}
+
+	// Underrun or discontinuity: workers have been told to let go
+	// of the track at least a period ago (or synchronously, on any
+	// seek, loop change or edit) and stop at period boundaries...
+	ATOMIC_SET(&m_direct, 1);
+
+	if (!ATOMIC_TAS(&m_busy)) {
+	#ifdef CONFIG_DEBUG
+		qDebug("qtractorAudioRender[%p]::process(%lu): worker stalled.",
+			this, iFrameStart);
+	#endif
+		return true;
+	}
+
+	// Take over all clips (and plugins) from where they are...
+	if (!bContinuous || m_iRenderFrame != iFrameStart)
+		syncClips(iFrameStart);
+
+	m_pRingBuffer->setReadIndex(m_pRingBuffer->writeIndex());
+
+	ATOMIC_TAZ(&m_busy);
+
+	m_bDirect = true;
+	m_iDirectFrames = 0;
+
+	return false;
+}
+
+
+// Hand the track over to render-ahead, once regular
+// processing has settled down (RT-safe).
+void qtractorAudioRender::handover ( unsigned long iFrameEnd )
+{
+	if (!m_bDirect || m_iReadFrame != iFrameEnd
+		|| m_iDirectFrames < m_iHandover)
+		return;
+
+	// Not right at loop-end, where the engine wraps around...
+	qtractorSession *pSession = m_pTrack->session();
+	if (pSession->isLooping() && iFrameEnd == pSession->loopEnd())
+		return;
+
+	if (!ATOMIC_TAS(&m_busy))
+		return;
+
+	// Render-ahead goes on exactly where regular processing left...
+	m_pRingBuffer->setReadIndex(m_pRingBuffer->writeIndex());
+
+	m_iRenderFrame = iFrameEnd;
+	m_iClipStart   = iFrameEnd;
+	m_iClipEnd     = iFrameEnd;
+
+	// Prime it with the very next two periods, right here and now,
+	// so that there's always a period in reserve for the workers...
+	renderBlock(m_iBufferSize << 1, false);
+
+	ATOMIC_SET(&m_direct, 0);
+	ATOMIC_TAZ(&m_busy);
+
+	m_bDirect = false;
+
+	m_pRenderPool->sync();
+}
+
+
+// Request to render everything all over again (non RT-safe).
+void qtractorAudioRender::reset (void)
+{
+	// Cancel any block in progress, so that the reader
+	// may take over the track right away...
+	ATOMIC_SET(&m_direct, 1);
+
+	while (ATOMIC_GET(&m_busy))
+		QThread::yieldCurrentThread();
+
+	ATOMIC_SET(&m_resetPending, 1);
+}
+
+
+// Render-ahead executive (worker threads only).
+void qtractorAudioRender::render (void)
+{
+	// Regular processing is on?
+	if (ATOMIC_GET(&m_direct))
+		return;
+
+	// Another worker (or the reader) is at it?
+	if (!ATOMIC_TAS(&m_busy))
+		return;
+
+	// Session edits always take precedence...
+	qtractorSession *pSession = m_pTrack->session();
+	if (pSession && pSession->acquireRender()) {
+		// Fill it up, block by block...
+		while (!ATOMIC_GET(&m_direct) && !pSession->isBusy()) {
+			// Blocks grow larger as far as it gets ahead...
+			const unsigned int iReadable = m_pRingBuffer->readable();
+			unsigned int iBlockSize = m_iBufferSize;
+			while ((iBlockSize << 1) <= iReadable && iBlockSize < m_iBlockSize)
+				iBlockSize <<= 1;
+			if (iBlockSize > m_iBlockSize)
+				iBlockSize = m_iBlockSize;
+			if (m_pRingBuffer->writable() < iBlockSize)
+				break;
+			if (!renderBlock(iBlockSize, true))
+				break;
+		}
+		ATOMIC_TAZ(&m_busy);
+		pSession->releaseRender();
+	} else {
+		ATOMIC_TAZ(&m_busy);
+	}
+}
+
+
+// Render and write one block ahead (render owner only).
+bool qtractorAudioRender::renderBlock ( unsigned int iBlockSize, bool bSync )
+{
+	qtractorSession *pSession = m_pTrack->session();
+
+	const unsigned long iFrameStart = m_iRenderFrame;
+	unsigned long iFrameEnd = iFrameStart + iBlockSize;
+
+	// Take care of loop-end wrap-around...
+	bool bLoopEnd = false;
+	if (pSession->isLooping()) {
+		const unsigned long iLoopEnd = pSession->loopEnd();
+		if (iFrameStart < iLoopEnd && iFrameEnd >= iLoopEnd) {
+			iFrameEnd = iLoopEnd;
+			bLoopEnd = true;
+		}
+	}
+
+	if (!render(iFrameStart, iFrameEnd, bSync))
+		return false;
+
+	// Next block (render frame is already past this one)...
+	if (bLoopEnd) {
+		m_iRenderFrame = pSession->loopStart();
+		syncClips(m_iRenderFrame);
+	}
+
+	return true;
+}
+
+
+// Render one block of track audio (render owner only).
+bool qtractorAudioRender::render (
+	unsigned long iFrameStart, unsigned long iFrameEnd, bool bSync )
+{
+	const unsigned int nframes = iFrameEnd - iFrameStart;
+
+	for (unsigned short i = 0; i < m_iChannels; ++i)
+		::memset(m_ppFrames[i], 0, nframes * sizeof(float));
+
+	// Keep track of whatever clips get touched...
+	if (m_iClipStart > iFrameStart)
+		m_iClipStart = iFrameStart;
+	if (m_iClipEnd < iFrameEnd)
+		m_iClipEnd = iFrameEnd;
+
+	// Now, for every clip...
+	qtractorClip *pClip = m_pTrack->seekClip(iFrameStart);
+	while (pClip && pClip->clipStart() < iFrameEnd) {
+		if (iFrameStart < pClip->clipStart() + pClip->clipLength()) {
+			qtractorAudioClip *pAudioClip
+				= static_cast<qtractorAudioClip *> (pClip);
+			pAudioClip->process_render(m_ppFrames,
+				m_iChannels, iFrameStart, iFrameEnd, bSync);
+		}
+		pClip = pClip->next();
+	}
+
+	// Plugin chain post-processing, period by period,
+	// each one made readable as soon as it gets done...
+	qtractorSession *pSession = m_pTrack->session();
+	qtractorPluginList *pPluginList = m_pTrack->pluginList();
+	for (unsigned int iOffset = 0; iOffset < nframes;
+			iOffset += m_iBufferSize) {
+		// Reader wants the track back, right now?
+		if (bSync && (ATOMIC_GET(&m_direct) || pSession->isBusy())) {
+			// Clips were read ahead: give them back in place...
+			syncClips(m_iRenderFrame);
+			return false;
+		}
+		unsigned int iFrames = nframes - iOffset;
+		if (iFrames > m_iBufferSize)
+			iFrames = m_iBufferSize;
+		for (unsigned short i = 0; i < m_iChannels; ++i)
+			m_ppSlice[i] = m_ppFrames[i] + iOffset;
+		pPluginList->process(m_ppSlice, iFrames);
+		m_pRingBuffer->write(m_ppSlice, iFrames);
+		m_iRenderFrame += iFrames;
+	}
+
+	return true;
+}
+
+
+// Give all touched clips back in place (RT-safe).
+void qtractorAudioRender::syncClips ( unsigned long iFrame )
+{
+	qtractorSession *pSession = m_pTrack->session();
+	const bool bLooping = (iFrame >= pSession->loopStart());
+
+	const unsigned long iClipStart
+		= (m_iClipStart < iFrame ? m_iClipStart : iFrame);
+	const unsigned long iClipEnd
+		= (m_iClipEnd > iFrame ? m_iClipEnd : iFrame);
+
+	qtractorClip *pClip = m_pTrack->seekClip(iClipStart);
+	while (pClip && pClip->clipStart() <= iClipEnd) {
+		const unsigned long iStart = pClip->clipStart();
+		if (iFrame >= iStart && iFrame < iStart + pClip->clipLength())
+			pClip->seek(iFrame - iStart);
+		else
+			pClip->reset(bLooping);
+		pClip = pClip->next();
+	}
+
+	m_iClipStart = iFrame;
+	m_iClipEnd   = iFrame;
+}
+
+
+// end of qtractorAudioRender.cpp
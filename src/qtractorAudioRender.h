@@ -0,0 +1,207 @@
+// qtractorAudioRender.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2017, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorAudioRender_h
+#define __qtractorAudioRender_h
+
+#include "qtractorRingBuffer.h"
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QReadWriteLock>
+#include <QList>
+
+
+// Forward declarations.
+class qtractorAudioRender;
+class qtractorAudioRenderPool;
+class qtractorTrack;
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioRenderThread -- Anticipative track render worker.
+//
+
+class qtractorAudioRenderThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorAudioRenderThread(qtractorAudioRenderPool *pRenderPool,
+		unsigned int iIndex);
+
+protected:
+
+	// The main thread executive.
+	void run();
+
+private:
+
+	// Instance variables.
+	qtractorAudioRenderPool *m_pRenderPool;
+
+	unsigned int m_iIndex;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioRenderPool -- Anticipative track render workers.
+//
+
+class qtractorAudioRenderPool
+{
+public:
+
+	// Constructor.
+	qtractorAudioRenderPool(unsigned long iSyncPeriod = 20);
+
+	// Destructor.
+	~qtractorAudioRenderPool();
+
+	// Worker threads (de)activation.
+	void start(QThread::Priority priority = QThread::InheritPriority);
+	void stop();
+
+	// Track render-ahead registry (non RT-safe).
+	void addRender(qtractorAudioRender *pAudioRender);
+	void removeRender(qtractorAudioRender *pAudioRender);
+
+	// Wake workers from executive wait condition (RT-safe).
+	void sync();
+
+	// Worker executives (worker threads only).
+	bool wait();
+	void process(unsigned int iIndex);
+
+private:
+
+	// Instance variables.
+	unsigned long m_iSyncPeriod;
+
+	QList<qtractorAudioRenderThread *> m_threads;
+	QList<qtractorAudioRender *> m_renders;
+
+	// Whether the workers are logically running.
+	volatile bool m_bRunState;
+
+	// Whether a wake-up call was missed meanwhile.
+	qtractorAtomic m_syncPending;
+
+	// Thread synchronization objects.
+	QMutex m_mutex;
+	QWaitCondition m_cond;
+	QReadWriteLock m_lock;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioRender -- Track render-ahead (lookahead) FIFO.
+//
+
+class qtractorAudioRender
+{
+public:
+
+	// Constructor.
+	qtractorAudioRender(qtractorTrack *pTrack,
+		qtractorAudioRenderPool *pRenderPool,
+		unsigned short iChannels, unsigned int iSampleRate,
+		unsigned int iBufferSize);
+
+	// Destructor.
+	~qtractorAudioRender();
+
+	// Properties.
+	qtractorTrack *track() const { return m_pTrack; }
+	unsigned short channels() const { return m_iChannels; }
+
+	// Pre-rendered audio reader (RT-safe, never blocks);
+	// returns false whenever the track must be processed
+	// directly, as regular (a null buffer just consumes
+	// the pre-rendered audio).
+	bool process(float **ppBuffer,
+		unsigned long iFrameStart, unsigned long iFrameEnd);
+
+	// Hand the track over to render-ahead, once regular
+	// processing has settled down (RT-safe).
+	void handover(unsigned long iFrameEnd);
+
+	// Whether the track is being processed directly (RT-safe).
+	bool isDirect() const { return m_bDirect; }
+
+	// Render-ahead executive (worker threads only).
+	void render();
+
+	// Request to render everything all over again, cancelling
+	// any block in progress (non RT-safe, may wait a period).
+	void reset();
+
+	// Give all touched clips back in place (RT-safe).
+	void syncClips(unsigned long iFrame);
+
+protected:
+
+	// Render and write one block ahead (render owner only).
+	bool renderBlock(unsigned int iBlockSize, bool bSync);
+
+	// Render one block of track audio (render owner only);
+	// returns false if aborted on behalf of the reader.
+	bool render(unsigned long iFrameStart,
+		unsigned long iFrameEnd, bool bSync);
+
+private:
+
+	// Instance variables.
+	qtractorTrack *m_pTrack;
+
+	qtractorAudioRenderPool *m_pRenderPool;
+
+	unsigned short m_iChannels;
+	unsigned int   m_iBufferSize;
+	unsigned int   m_iBlockSize;
+	unsigned int   m_iHandover;
+
+	// The pre-rendered audio FIFO.
+	qtractorRingBuffer<float> *m_pRingBuffer;
+
+	// Reader (RT) side state.
+	unsigned long  m_iReadFrame;
+	unsigned long  m_iDirectFrames;
+	bool           m_bDirect;
+
+	// Track (clips and plugins) ownership hand-shake.
+	qtractorAtomic m_direct;
+	qtractorAtomic m_busy;
+	qtractorAtomic m_resetPending;
+
+	// Render owner side state.
+	unsigned long  m_iRenderFrame;
+	unsigned long  m_iClipStart;
+	unsigned long  m_iClipEnd;
+	float        **m_ppFrames;
+	float        **m_ppSlice;
+};
+
+
+#endif  // __qtractorAudioRender_h
+
+// end of qtractorAudioRender.h
@@ -22,6 +22,18 @@
 #include "qtractorAbout.h"
 #include "qtractorAudioSndFile.h"
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(FALLOC_FL_KEEP_SIZE) && defined(FALLOC_FL_PUNCH_HOLE)
+#define CONFIG_AUDIO_PREALLOC 1
+#endif
+#endif
+
+
+// Write mode disk space preallocation extent size (bytes).
+#define QTRACTOR_PREALLOC_EXTENT	(16 << 20)
+
 
 //----------------------------------------------------------------------
 // class qtractorAudioSndFile -- Buffered audio file implementation.
@@ -29,16 +41,21 @@
 
 // Constructor.
 qtractorAudioSndFile::qtractorAudioSndFile ( unsigned short iChannels,
-	unsigned int iSampleRate, unsigned int iBufferSize )
+	unsigned int iSampleRate, unsigned int iBufferSize, int iFormat )
 {
 	// Need a minimum of specification, at least for write mode.
 	::memset(&m_sfinfo, 0, sizeof(m_sfinfo));
 	m_sfinfo.channels   = iChannels;
 	m_sfinfo.samplerate = iSampleRate;
 
+	// Explicit write format, if any.
+	m_iFormat = iFormat;
+
 	// Initialize other stuff.
 	m_pSndFile    = NULL;
 	m_iMode       = qtractorAudioSndFile::None;
+	m_iFd         = -1;
+	m_iPrealloc   = 0;
 	m_pBuffer     = NULL;
 	m_iBufferSize = 1024;
 
@@ -80,11 +97,30 @@ bool qtractorAudioSndFile::open ( const QString& sFilename, int iMode )
 	if (sfmode & SFM_WRITE) {
 		if (m_sfinfo.channels == 0 || m_sfinfo.samplerate == 0)
 			return false;
-		m_sfinfo.format = qtractorAudioFileFactory::defaultFormat();
+		m_sfinfo.format = (m_iFormat ? m_iFormat
+			: qtractorAudioFileFactory::defaultFormat());
 	}
 
 	// Now open it.
 	QByteArray aFilename = sFilename.toUtf8();
+#ifdef CONFIG_AUDIO_PREALLOC
+	// Writing through our own descriptor, so that disk space
+	// may get preallocated ahead, in large contiguous extents...
+	if (sfmode & SFM_WRITE) {
+		m_iFd = ::open(aFilename.constData(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (m_iFd < 0)
+			return false;
+		m_pSndFile = ::sf_open_fd(m_iFd, sfmode, &m_sfinfo, SF_FALSE);
+		if (m_pSndFile == NULL) {
+			::close(m_iFd);
+			m_iFd = -1;
+			return false;
+		}
+		m_iPrealloc = 0;
+		preallocCheck();
+	}
+	else
+#endif
 	m_pSndFile = ::sf_open(aFilename.constData(), sfmode, &m_sfinfo);
 	if (m_pSndFile == NULL)
 		return false;
@@ -132,7 +168,9 @@ int qtractorAudioSndFile::write ( float **ppFrames, unsigned int iFrames )
 		for (i = 0; i < (unsigned short) m_sfinfo.channels; ++i)
 			m_pBuffer[k++] = ppFrames[i][n];
 	}
-	return ::sf_writef_float(m_pSndFile, m_pBuffer, iFrames);
+	const int nwrite = ::sf_writef_float(m_pSndFile, m_pBuffer, iFrames);
+	preallocCheck();
+	return nwrite;
 }
 
 
@@ -159,6 +197,20 @@ void qtractorAudioSndFile::close (void)
 		m_iMode = qtractorAudioSndFile::None;
 	}
 
+#ifdef CONFIG_AUDIO_PREALLOC
+	// Give back any preallocated disk space past the end...
+	if (m_iFd >= 0) {
+		const off_t iSize = ::lseek(m_iFd, 0, SEEK_END);
+		if (iSize >= 0 && m_iPrealloc > qint64(iSize)) {
+			::fallocate(m_iFd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+				iSize, off_t(m_iPrealloc - iSize));
+		}
+		::close(m_iFd);
+		m_iFd = -1;
+		m_iPrealloc = 0;
+	}
+#endif
+
 	if (m_pBuffer) {
 		delete [] m_pBuffer;
 		m_pBuffer = NULL;
@@ -194,6 +246,29 @@ unsigned int qtractorAudioSndFile::sampleRate (void) const
 }
 
 
+// Write mode disk space preallocation (in large extents).
+void qtractorAudioSndFile::preallocCheck (void)
+{
+#ifdef CONFIG_AUDIO_PREALLOC
+	if (m_iFd < 0)
+		return;
+
+	const off_t iOffset = ::lseek(m_iFd, 0, SEEK_CUR);
+	if (iOffset < 0)
+		return;
+
+	// Keep at least half an extent ahead of the writing position;
+	// file size is kept as is, thus it's all invisible to readers...
+	while (m_iPrealloc < qint64(iOffset) + (QTRACTOR_PREALLOC_EXTENT >> 1)) {
+		if (::fallocate(m_iFd, FALLOC_FL_KEEP_SIZE,
+				off_t(m_iPrealloc), QTRACTOR_PREALLOC_EXTENT) < 0)
+			break; // Not supported or no space left, most probably.
+		m_iPrealloc += QTRACTOR_PREALLOC_EXTENT;
+	}
+#endif
+}
+
+
 // De/interleaving buffer stuff.
 void qtractorAudioSndFile::allocBufferCheck ( unsigned int iBufferSize )
 {
@@ -38,7 +38,8 @@ public:
 
 	// Constructor.
 	qtractorAudioSndFile(unsigned short iChannels = 0,
-		unsigned int iSampleRate = 0, unsigned int iBufferSize = 0);
+		unsigned int iSampleRate = 0, unsigned int iBufferSize = 0,
+		int iFormat = 0);
 
 	// Destructor.
 	virtual ~qtractorAudioSndFile();
@@ -63,11 +64,19 @@ protected:
 	// De/interleaving buffer (re)allocation check.
 	void allocBufferCheck(unsigned int iBufferSize);
 
+	// Write mode disk space preallocation (in large extents).
+	void preallocCheck();
+
 private:
 
 	int           m_iMode;          // open mode (Read|Write).
 	SNDFILE      *m_pSndFile;       // libsndfile descriptor.
 	SF_INFO       m_sfinfo;         // libsndfile info struct.
+	int           m_iFormat;        // write format (0=default).
+
+	// Write mode file descriptor and preallocated size.
+	int           m_iFd;
+	qint64        m_iPrealloc;
 
 	// De/interleaving buffer stuff.
 	float        *m_pBuffer;
@@ -35,13 +35,18 @@
 #include <QPolygon>
 #include <QDir>
 
-#include <QDomDocument>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 #ifdef CONFIG_GRADIENT
 #include <QLinearGradient>
 #endif
 
 
+// Fade curve lookup table resolution (linear segments).
+#define QTRACTOR_FADE_TABLE_SIZE	1024
+
+
 //-------------------------------------------------------------------------
 // qtractorClip -- Track clip capsule.
 
@@ -55,8 +60,8 @@ qtractorClip::qtractorClip ( qtractorTrack *pTrack )
 
 	m_pTakeInfo = NULL;
 
-	m_pFadeInFunctor  = NULL;
-	m_pFadeOutFunctor = NULL;
+	m_pfFadeInTable  = new float [QTRACTOR_FADE_TABLE_SIZE + 1];
+	m_pfFadeOutTable = new float [QTRACTOR_FADE_TABLE_SIZE + 1];
 
 	clear();
 }
@@ -68,10 +73,8 @@ qtractorClip::~qtractorClip (void)
 	if (m_pTakeInfo)
 		m_pTakeInfo->releaseRef();
 
-	if (m_pFadeInFunctor)
-		delete m_pFadeInFunctor;
-	if (m_pFadeOutFunctor)
-		delete m_pFadeOutFunctor;
+	delete [] m_pfFadeInTable;
+	delete [] m_pfFadeOutTable;
 }
 
 
@@ -233,11 +236,9 @@ void qtractorClip::setClipSelect (
 // Clip fade-in accessors
 void qtractorClip::setFadeInType ( qtractorClip::FadeType fadeType )
 {
-	if (m_pFadeInFunctor)
-		delete m_pFadeInFunctor;
-
 	m_fadeInType = fadeType;
-	m_pFadeInFunctor = createFadeFunctor(FadeIn, fadeType);
+
+	updateFadeTable(m_pfFadeInTable, FadeIn, fadeType);
 }
 
 
@@ -257,11 +258,9 @@ void qtractorClip::setFadeInLength ( unsigned long iFadeInLength )
 // Clip fade-out accessors
 void qtractorClip::setFadeOutType ( qtractorClip::FadeType fadeType )
 {
-	if (m_pFadeOutFunctor)
-		delete m_pFadeOutFunctor;
-
 	m_fadeOutType = fadeType;
-	m_pFadeOutFunctor = createFadeFunctor(FadeOut, fadeType);
+
+	updateFadeTable(m_pfFadeOutTable, FadeOut, fadeType);
 }
 
 
@@ -279,24 +278,124 @@ void qtractorClip::setFadeOutLength ( unsigned long iFadeOutLength )
 }
 
 
+// Fade curve lookup table (re)builder.
+void qtractorClip::updateFadeTable ( float *pfTable,
+	qtractorClip::FadeMode fadeMode, qtractorClip::FadeType fadeType )
+{
+	FadeFunctor *pFadeFunctor = createFadeFunctor(fadeMode, fadeType);
+	if (pFadeFunctor == NULL)
+		return;
+
+	const float fScale = 1.0f / float(QTRACTOR_FADE_TABLE_SIZE);
+	for (unsigned int i = 0; i <= QTRACTOR_FADE_TABLE_SIZE; ++i)
+		pfTable[i] = (*pFadeFunctor)(fScale * float(i));
+
+	delete pFadeFunctor;
+}
+
+
+// Fade curve table lookup (linear interpolated).
+static inline float fadeTableGain ( const float *pfTable, double x )
+{
+	if (x >= double(QTRACTOR_FADE_TABLE_SIZE))
+		return pfTable[QTRACTOR_FADE_TABLE_SIZE];
+
+	const unsigned int i = (unsigned int) x;
+	const float f = float(x - double(i));
+
+	return pfTable[i] + f * (pfTable[i + 1] - pfTable[i]);
+}
+
+
+// Fade curve table lookup, per-frame (linear interpolated).
+static inline void fadeTableGains ( float *pfGains, const float *pfTable,
+	unsigned long iOffset, unsigned long iLength, unsigned int iFrames )
+{
+	const double dScale = double(QTRACTOR_FADE_TABLE_SIZE) / double(iLength);
+	const double x0 = dScale * double(iOffset);
+
+	for (unsigned int n = 0; n < iFrames; ++n)
+		pfGains[n] = fadeTableGain(pfTable, x0 + dScale * double(n));
+}
+
+
 // Compute clip gain, given current fade-in/out slopes.
 float qtractorClip::fadeInOutGain ( unsigned long iOffset ) const
 {
 	if (m_iFadeInLength > 0 && iOffset < m_iFadeInLength) {
-		return (*m_pFadeInFunctor)(
-			float(iOffset) / float(m_iFadeInLength));
+		return fadeTableGain(m_pfFadeInTable,
+			double(QTRACTOR_FADE_TABLE_SIZE) * double(iOffset)
+				/ double(m_iFadeInLength));
 	}
 
 	if (m_iFadeOutLength > 0 && iOffset > m_iClipLength - m_iFadeOutLength) {
-		return (*m_pFadeOutFunctor)(
-			float(iOffset - (m_iClipLength - m_iFadeOutLength))
-				/ float(m_iFadeOutLength));
+		return fadeTableGain(m_pfFadeOutTable,
+			double(QTRACTOR_FADE_TABLE_SIZE)
+				* double(iOffset - (m_iClipLength - m_iFadeOutLength))
+				/ double(m_iFadeOutLength));
 	}
 
 	return (iOffset < m_iClipLength ? 1.0f : 0.0f);
 }
 
 
+// Whether a given clip range is under any fade-in/out slope.
+bool qtractorClip::isFadeInOut (
+	unsigned long iOffset, unsigned int iFrames ) const
+{
+	if (m_iFadeInLength > 0 && iOffset < m_iFadeInLength)
+		return true;
+
+	const unsigned long iOffsetEnd = iOffset + iFrames;
+	if (m_iFadeOutLength > 0)
+		return (iOffsetEnd > m_iClipLength - m_iFadeOutLength + 1);
+	else
+		return (iOffsetEnd > m_iClipLength);
+}
+
+
+// Compute per-frame clip gains, given current fade-in/out slopes.
+void qtractorClip::fadeInOutGains ( float *pfGains,
+	unsigned long iOffset, unsigned int iFrames ) const
+{
+	unsigned int n = 0;
+
+	// Fade-in slope...
+	if (m_iFadeInLength > 0 && iOffset < m_iFadeInLength) {
+		const unsigned long iFadeIn = m_iFadeInLength - iOffset;
+		n = (iFadeIn < iFrames ? iFadeIn : iFrames);
+		fadeTableGains(pfGains, m_pfFadeInTable,
+			iOffset, m_iFadeInLength, n);
+	}
+
+	// Sustain...
+	const unsigned long iFadeOutStart = m_iClipLength - m_iFadeOutLength;
+	for ( ; n < iFrames; ++n) {
+		const unsigned long iFrame = iOffset + n;
+		if ((m_iFadeOutLength > 0 && iFrame > iFadeOutStart)
+			|| iFrame >= m_iClipLength)
+			break;
+		pfGains[n] = 1.0f;
+	}
+
+	// Fade-out slope...
+	if (m_iFadeOutLength > 0 && n < iFrames) {
+		const unsigned long iFrame = iOffset + n;
+		if (iFrame < m_iClipLength) {
+			const unsigned long iFadeOut = m_iClipLength - iFrame;
+			const unsigned int n2 = (iFadeOut < iFrames - n ? iFadeOut : iFrames - n);
+			fadeTableGains(pfGains + n, m_pfFadeOutTable,
+				iFrame - iFadeOutStart, m_iFadeOutLength, n2);
+			n += n2;
+		}
+	}
+
+	// Past the end...
+	for ( ; n < iFrames; ++n)
+		pfGains[n] = 0.0f;
+}
+
+
 // Clip time reference settler method.
 void qtractorClip::updateClipTime (void)
 {
@@ -554,68 +653,62 @@ QString qtractorClip::toolTip (void) const
 }
 
 
-// Document element methods.
-bool qtractorClip::loadElement (
-	qtractorDocument *pDocument, QDomElement *pElement )
+// Document element (streaming) methods.
+bool qtractorClip::loadStream (
+	qtractorDocument *pDocument, QXmlStreamReader *pReader )
 {
-	qtractorClip::setClipName(pElement->attribute("name"));
+	qtractorClip::setClipName(
+		pReader->attributes().value("name").toString());
 
 	// Load clip children...
-	for (QDomNode nChild = pElement->firstChild();
-			!nChild.isNull();
-				nChild = nChild.nextSibling()) {
+	while (pReader->readNextStartElement()) {
 
-		// Convert node to element...
-		QDomElement eChild = nChild.toElement();
-		if (eChild.isNull())
-			continue;
+		const QString& sChild = pReader->name().toString();
 
 		// Load clip properties...
-		if (eChild.tagName() == "properties") {
-			for (QDomNode nProp = eChild.firstChild();
-					!nProp.isNull();
-						nProp = nProp.nextSibling()) {
-				// Convert property node to element...
-				QDomElement eProp = nProp.toElement();
-				if (eProp.isNull())
-					continue;
-				if (eProp.tagName() == "name")
-					qtractorClip::setClipName(eProp.text());
-				else if (eProp.tagName() == "start")
-					qtractorClip::setClipStart(eProp.text().toULong());
-				else if (eProp.tagName() == "offset")
-					qtractorClip::setClipOffset(eProp.text().toULong());
-				else if (eProp.tagName() == "length")
-					qtractorClip::setClipLength(eProp.text().toULong());
-				else if (eProp.tagName() == "gain")
-					qtractorClip::setClipGain(eProp.text().toFloat());
-				else if (eProp.tagName() == "panning")
-					qtractorClip::setClipPanning(eProp.text().toFloat());
-				else if (eProp.tagName() == "fade-in") {
+		if (sChild == "properties") {
+			while (pReader->readNextStartElement()) {
+				const QString& sProp = pReader->name().toString();
+				if (sProp == "name")
+					qtractorClip::setClipName(pReader->readElementText());
+				else if (sProp == "start")
+					qtractorClip::setClipStart(pReader->readElementText().toULong());
+				else if (sProp == "offset")
+					qtractorClip::setClipOffset(pReader->readElementText().toULong());
+				else if (sProp == "length")
+					qtractorClip::setClipLength(pReader->readElementText().toULong());
+				else if (sProp == "gain")
+					qtractorClip::setClipGain(pReader->readElementText().toFloat());
+				else if (sProp == "panning")
+					qtractorClip::setClipPanning(pReader->readElementText().toFloat());
+				else if (sProp == "fade-in") {
 					qtractorClip::setFadeInType(
-						qtractorClip::fadeInTypeFromText(eProp.attribute("type")));
-					qtractorClip::setFadeInLength(eProp.text().toULong());
+						qtractorClip::fadeInTypeFromText(
+							pReader->attributes().value("type").toString()));
+					qtractorClip::setFadeInLength(pReader->readElementText().toULong());
 				}
-				else if (eProp.tagName() == "fade-out") {
+				else if (sProp == "fade-out") {
 					qtractorClip::setFadeOutType(
-						qtractorClip::fadeOutTypeFromText(eProp.attribute("type")));
-					qtractorClip::setFadeOutLength(eProp.text().toULong());
+						qtractorClip::fadeOutTypeFromText(
+							pReader->attributes().value("type").toString()));
+					qtractorClip::setFadeOutLength(pReader->readElementText().toULong());
 				}
+				else pReader->skipCurrentElement();
 			}
 		}
 		else
 		// Load clip derivative properties...
-		if (eChild.tagName() == "audio-clip" ||
-			eChild.tagName() == "midi-clip") {
-			if (!loadClipElement(pDocument, &eChild))
+		if (sChild == "audio-clip" || sChild == "midi-clip") {
+			if (!loadClipStream(pDocument, pReader))
 				return false;
 		}
 		else
-		if (eChild.tagName() == "take-info") {
-			int iTakeID = eChild.attribute("id").toInt();
+		if (sChild == "take-info") {
+			const QXmlStreamAttributes& attrs = pReader->attributes();
+			int iTakeID = attrs.value("id").toString().toInt();
 			qtractorClip::TakeInfo::ClipPart cpart
 				= qtractorClip::TakeInfo::ClipPart(
-					eChild.attribute("part").toInt());
+					attrs.value("part").toString().toInt());
 			// Load take(record) descriptor children, if any...
 			unsigned long iClipStart  = 0;
 			unsigned long iClipOffset = 0;
@@ -624,34 +717,31 @@ bool qtractorClip::loadElement (
 			unsigned long iTakeEnd    = 0;
 			unsigned long iTakeGap    = 0;
 			int iCurrentTake = -1;
-			for (QDomNode nProp = eChild.firstChild();
-					!nProp.isNull();
-						nProp = nProp.nextSibling()) {
-				// Convert node to element...
-				QDomElement eProp = nProp.toElement();
-				if (eProp.isNull())
-					continue;
+			while (pReader->readNextStartElement()) {
+				const QString& sProp = pReader->name().toString();
 				// Load take-info properties...
-				if (eProp.tagName() == "clip-start")
-					iClipStart = eProp.text().toULong();
+				if (sProp == "clip-start")
+					iClipStart = pReader->readElementText().toULong();
+				else
+				if (sProp == "clip-offset")
+					iClipOffset = pReader->readElementText().toULong();
 				else
-				if (eProp.tagName() == "clip-offset")
-					iClipOffset = eProp.text().toULong();
+				if (sProp == "clip-length")
+					iClipLength = pReader->readElementText().toULong();
 				else
-				if (eProp.tagName() == "clip-length")
-					iClipLength = eProp.text().toULong();
+				if (sProp == "take-start")
+					iTakeStart = pReader->readElementText().toULong();
 				else
-				if (eProp.tagName() == "take-start")
-					iTakeStart = eProp.text().toULong();
+				if (sProp == "take-end")
+					iTakeEnd = pReader->readElementText().toULong();
 				else
-				if (eProp.tagName() == "take-end")
-					iTakeEnd = eProp.text().toULong();
+				if (sProp == "take-gap")
+					iTakeGap = pReader->readElementText().toULong();
 				else
-				if (eProp.tagName() == "take-gap")
-					iTakeGap = eProp.text().toULong();
+				if (sProp == "current-take")
+					iCurrentTake = pReader->readElementText().toInt();
 				else
-				if (eProp.tagName() == "current-take")
-					iCurrentTake = eProp.text().toInt();
+					pReader->skipCurrentElement();
 			}
 			qtractorTrack::TakeInfo *pTakeInfo = NULL;
 			qtractorTrack *pTrack = qtractorClip::track();
@@ -672,48 +762,48 @@ bool qtractorClip::loadElement (
 					pTakeInfo->setCurrentTake(iCurrentTake);
 			}
 		}
+		else pReader->skipCurrentElement();
 	}
 
-	return true;
+	return !pReader->hasError();
 }
 
 
-bool qtractorClip::saveElement (
-	qtractorDocument *pDocument, QDomElement *pElement )
+bool qtractorClip::saveStream (
+	qtractorDocument *pDocument, QXmlStreamWriter *pWriter )
 {
-	pElement->setAttribute("name", qtractorClip::clipName());
+	pWriter->writeAttribute("name", qtractorClip::clipName());
 
 	// Save clip properties...
-	QDomElement eProps = pDocument->document()->createElement("properties");
-	pDocument->saveTextElement("name", qtractorClip::clipName(), &eProps);
-	pDocument->saveTextElement("start",
-		QString::number(qtractorClip::clipStart()), &eProps);
-	pDocument->saveTextElement("offset",
-		QString::number(qtractorClip::clipOffset()), &eProps);
-	pDocument->saveTextElement("length",
-		QString::number(qtractorClip::clipLength()), &eProps);
-	pDocument->saveTextElement("gain",
-		QString::number(qtractorClip::clipGain()), &eProps);
-	pDocument->saveTextElement("panning",
-		QString::number(qtractorClip::clipPanning()), &eProps);
-    QDomElement eFadeIn = pDocument->document()->createElement("fade-in");
-	eFadeIn.setAttribute("type",
+	pWriter->writeStartElement("properties");
+	pWriter->writeTextElement("name", qtractorClip::clipName());
+	pWriter->writeTextElement("start",
+		QString::number(qtractorClip::clipStart()));
+	pWriter->writeTextElement("offset",
+		QString::number(qtractorClip::clipOffset()));
+	pWriter->writeTextElement("length",
+		QString::number(qtractorClip::clipLength()));
+	pWriter->writeTextElement("gain",
+		QString::number(qtractorClip::clipGain()));
+	pWriter->writeTextElement("panning",
+		QString::number(qtractorClip::clipPanning()));
+
+	pWriter->writeStartElement("fade-in");
+	pWriter->writeAttribute("type",
 		qtractorClip::textFromFadeType(qtractorClip::fadeInType()));
-    eFadeIn.appendChild(pDocument->document()->createTextNode(
-		QString::number(qtractorClip::fadeInLength())));
-	eProps.appendChild(eFadeIn);
+	pWriter->writeCharacters(QString::number(qtractorClip::fadeInLength()));
+	pWriter->writeEndElement();
 
-    QDomElement eFadeOut = pDocument->document()->createElement("fade-out");
-	eFadeOut.setAttribute("type",
+	pWriter->writeStartElement("fade-out");
+	pWriter->writeAttribute("type",
 		qtractorClip::textFromFadeType(qtractorClip::fadeOutType()));
-    eFadeOut.appendChild(pDocument->document()->createTextNode(
-		QString::number(qtractorClip::fadeOutLength())));
-	eProps.appendChild(eFadeOut);
+	pWriter->writeCharacters(QString::number(qtractorClip::fadeOutLength()));
+	pWriter->writeEndElement();
 
-	pElement->appendChild(eProps);
+	pWriter->writeEndElement();
 
 	// Save clip derivative properties...
-	if (!saveClipElement(pDocument, pElement))
+	if (!saveClipStream(pDocument, pWriter))
 		return false;
 
 	// At last, save clip take(record) properties, if any...
@@ -722,30 +812,31 @@ bool qtractorClip::saveElement (
 	if (pTakeInfo) {
 		qtractorTrack *pTrack = qtractorClip::track();
 		if (pTrack) {
-			QDomElement eTakeInfo
-				= pDocument->document()->createElement("take-info");
+			pWriter->writeStartElement("take-info");
 			int iTakeID = pTrack->takeInfoId(pTakeInfo);
-			if (iTakeID < 0) {
+			const bool bTakeNew = (iTakeID < 0);
+			if (bTakeNew)
 				iTakeID = pTrack->takeInfoNew(pTakeInfo);
-				pDocument->saveTextElement("clip-start", 
-					QString::number(pTakeInfo->clipStart()), &eTakeInfo);
-				pDocument->saveTextElement("clip-offset", 
-					QString::number(pTakeInfo->clipOffset()), &eTakeInfo);
-				pDocument->saveTextElement("clip-length", 
-					QString::number(pTakeInfo->clipLength()), &eTakeInfo);
-				pDocument->saveTextElement("take-start", 
-					QString::number(pTakeInfo->takeStart()), &eTakeInfo);
-				pDocument->saveTextElement("take-end", 
-					QString::number(pTakeInfo->takeEnd()), &eTakeInfo);
-				pDocument->saveTextElement("take-gap",
-					QString::number(pTakeInfo->takeGap()), &eTakeInfo);
-				pDocument->saveTextElement("current-take",
-					QString::number(pTakeInfo->currentTake()), &eTakeInfo);
-			}
-			eTakeInfo.setAttribute("id", QString::number(iTakeID));
-			eTakeInfo.setAttribute("part",
+			pWriter->writeAttribute("id", QString::number(iTakeID));
+			pWriter->writeAttribute("part",
 				QString::number(int(pTakeInfo->partClip(this))));
-			pElement->appendChild(eTakeInfo);
+			if (bTakeNew) {
+				pWriter->writeTextElement("clip-start",
+					QString::number(pTakeInfo->clipStart()));
+				pWriter->writeTextElement("clip-offset",
+					QString::number(pTakeInfo->clipOffset()));
+				pWriter->writeTextElement("clip-length",
+					QString::number(pTakeInfo->clipLength()));
+				pWriter->writeTextElement("take-start",
+					QString::number(pTakeInfo->takeStart()));
+				pWriter->writeTextElement("take-end",
+					QString::number(pTakeInfo->takeEnd()));
+				pWriter->writeTextElement("take-gap",
+					QString::number(pTakeInfo->takeGap()));
+				pWriter->writeTextElement("current-take",
+					QString::number(pTakeInfo->currentTake()));
+			}
+			pWriter->writeEndElement();
 		}
 	}
 
@@ -148,6 +148,13 @@ public:
 	// Compute clip gain, given current fade-in/out slopes.
 	float fadeInOutGain(unsigned long iOffset) const;
 
+	// Whether a given clip range is under any fade-in/out slope.
+	bool isFadeInOut(unsigned long iOffset, unsigned int iFrames) const;
+
+	// Compute per-frame clip gains, given current fade-in/out slopes.
+	void fadeInOutGains(float *pfGains,
+		unsigned long iOffset, unsigned int iFrames) const;
+
 	// Clip time reference settler method.
 	void updateClipTime();
 
@@ -200,9 +207,9 @@ public:
 	bool isDirty() const
 		{ return m_bDirty; }
 
-	// Document element methods.
-	bool loadElement(qtractorDocument *pDocument, QDomElement *pElement);
-	bool saveElement(qtractorDocument *pDocument, QDomElement *pElement);
+	// Document element (streaming) methods.
+	bool loadStream(qtractorDocument *pDocument, QXmlStreamReader *pReader);
+	bool saveStream(qtractorDocument *pDocument, QXmlStreamWriter *pWriter);
 
 	// Clip fade type textual helper methods.
 	static FadeType fadeInTypeFromText(const QString& sText);
@@ -351,11 +358,16 @@ protected:
 	static FadeFunctor *createFadeFunctor(
 		FadeMode fadeMode, FadeType fadeType);
 
-	// Virtual document element methods.
-	virtual bool loadClipElement(
-		qtractorDocument *pDocument, QDomElement *pElement) = 0;
-	virtual bool saveClipElement(
-		qtractorDocument *pDocument, QDomElement *pElement) = 0;
+	// Fade curve lookup table (re)builder.
+	//
+	static void updateFadeTable(float *pfTable,
+		FadeMode fadeMode, FadeType fadeType);
+
+	// Virtual document element (streaming) methods.
+	virtual bool loadClipStream(
+		qtractorDocument *pDocument, QXmlStreamReader *pReader) = 0;
+	virtual bool saveClipStream(
+		qtractorDocument *pDocument, QXmlStreamWriter *pWriter) = 0;
 
 private:
 
@@ -391,9 +403,9 @@ private:
 	FadeType m_fadeInType;              // Fade-in curve type.
 	FadeType m_fadeOutType;             // Fade-out curve type.
 
-	// Aproximations to exponential fade interpolation.
-	FadeFunctor *m_pFadeInFunctor;
-	FadeFunctor *m_pFadeOutFunctor;
+	// Fade curve lookup tables (linear interpolated).
+	float *m_pfFadeInTable;
+	float *m_pfFadeOutTable;
 
 	// Local dirty flag.
 	bool m_bDirty;
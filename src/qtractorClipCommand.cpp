@@ -37,6 +37,8 @@
 #include "qtractorSessionCommand.h"
 #include "qtractorCurveCommand.h"
 
+#include <QFileInfo>
+
 
 //----------------------------------------------------------------------
 // class qtractorClipCommand - declaration.
@@ -430,6 +432,23 @@ bool qtractorClipCommand::addClipRecord (
 	if (pClip->clipLength() < 1)
 		return false;
 
+	// Report this take recording I/O statistics...
+	if (pTrack->trackType() == qtractorTrack::Audio) {
+		qtractorAudioClip *pAudioClip
+			= static_cast<qtractorAudioClip *> (pClip);
+		const qtractorAudioBuffer::RecordStats& stats
+			= pAudioClip->recordStats();
+		qtractorMainForm *pMainForm = qtractorMainForm::getInstance();
+		if (pMainForm && stats.usecs > 0) {
+			pMainForm->appendMessages(
+				QObject::tr("Recording: \"%1\" written at %2 MB/s "
+				"(buffer peak %3%, %4 frames dropped).")
+				.arg(QFileInfo(pAudioClip->filename()).fileName())
+				.arg(float(stats.bytes) / float(stats.usecs), 0, 'f', 1)
+				.arg(stats.highWater).arg(stats.dropped));
+		}
+	}
+
 	// Check whether in loop-recording/takes mode...
 	const unsigned long iLoopStart = pSession->loopStart();
 	const unsigned long iLoopEnd = pSession->loopEnd();
@@ -551,6 +570,10 @@ qtractorMidiEditCommand *qtractorClipCommand::createMidiEditCommand (
 	if (pSession == NULL)
 		return NULL;
 
+	// Lazy (deferred) clips must be open by now...
+	if (!pSession->openDeferClip(pMidiClip))
+		return NULL;
+
 	// Make it like an undoable command...
 	qtractorMidiEditCommand *pEditCommand
 		= new qtractorMidiEditCommand(pMidiClip, name());
@@ -744,6 +767,8 @@ bool qtractorClipCommand::execute ( bool bRedo )
 			}
 			if (iOldStart != pItem->clipStart)
 				pTrack->insertClip(pClip);
+			else
+				pTrack->updateClip(pClip);
 			pItem->clipStart = iOldStart;
 			pItem->clipOffset = iOldOffset;
 			pItem->clipLength = iOldLength;
@@ -790,6 +815,7 @@ bool qtractorClipCommand::execute ( bool bRedo )
 				const float fOldTimeStretch = pAudioClip->timeStretch();
 				pAudioClip->setTimeStretch(pItem->timeStretch);
 				pAudioClip->updateClipTime();	// Care of tempo change.
+				pTrack->updateClip(pClip);
 				pItem->timeStretch = fOldTimeStretch;
 			}
 			break;
@@ -821,6 +847,7 @@ bool qtractorClipCommand::execute ( bool bRedo )
 			const unsigned long iClipLengthTime = pClip->clipLengthTime();
 			pClip->setClipOffset(pItem->clipOffset);
 			pClip->setClipLength(pItem->clipLength);
+			pTrack->updateClip(pClip);
 			pItem->clipOffset =	pSession->frameFromTickRange(
 				iClipStartTime, iClipStartTime + iClipOffsetTime, true);
 			pItem->clipLength =	pSession->frameFromTickRange(
@@ -844,6 +871,8 @@ bool qtractorClipCommand::execute ( bool bRedo )
 		default:
 			break;
 		}
+		// Frozen track contents might be stale now...
+		pTrack->setContentsDirty();
 	}
 
 	// Re-open needed clips, just once...
@@ -1184,6 +1213,11 @@ void qtractorClipToolCommand::swapMidiClipCtx ( qtractorMidiClip *pMidiClip )
 		mctx.pre.filename = sPostFilename;
 		mctx.pre.length = iPostLength;
 	}
+
+	// Keep track clip index in sync...
+	qtractorTrack *pTrack = pMidiClip->track();
+	if (pTrack)
+		pTrack->updateClip(pMidiClip);
 }
 
 
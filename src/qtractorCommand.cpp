@@ -29,11 +29,17 @@
 // class qtractorCommandList - declaration.
 //
 
+// Global memory budget (default 256MB).
+unsigned long qtractorCommandList::g_iMaxSize = (256 << 20);
+
+
 // Constructor.
 qtractorCommandList::qtractorCommandList (void)
 {
 	m_pLastCommand = NULL;
 
+	m_iSize = 0;
+
 	m_commands.setAutoDelete(true);
 }
 
@@ -50,6 +56,8 @@ void qtractorCommandList::clear (void)
 	m_commands.clear();
 
 	m_pLastCommand = NULL;
+
+	m_iSize = 0;
 }
 
 
@@ -74,7 +82,7 @@ void qtractorCommandList::removeLastCommand (void)
 {
 	if (m_pLastCommand) {
 		qtractorCommand *pPrevCommand = m_pLastCommand->prev();
-		m_commands.remove(m_pLastCommand);
+		removeCommand(m_pLastCommand);
 		m_pLastCommand = pPrevCommand;
 	}
 }
@@ -105,7 +113,7 @@ bool qtractorCommandList::push ( qtractorCommand *pCommand )
 	qtractorCommand *pNextCommand = nextCommand();
 	while (pNextCommand) {
 		qtractorCommand *pLateCommand = pNextCommand->next();
-		m_commands.remove(pNextCommand);
+		removeCommand(pNextCommand);
 		pNextCommand = pLateCommand;
 	}
 
@@ -116,6 +124,11 @@ bool qtractorCommandList::push ( qtractorCommand *pCommand )
 	m_commands.append(pCommand);
 	m_pLastCommand = m_commands.last();
 
+	m_iSize += pCommand->size();
+
+	// Forget the oldest ones, if over budget...
+	trimCommands();
+
 	return (m_pLastCommand != NULL);
 }
 
@@ -126,7 +139,12 @@ bool qtractorCommandList::exec ( qtractorCommand *pCommand )
 	// Append command...
 	if (push(pCommand)) {
 		// Execute operation...
+		const unsigned long iOldSize = m_pLastCommand->size();
 		bResult = m_pLastCommand->redo();
+		// Execution may have grown it (eg. adjustments)...
+		m_iSize += m_pLastCommand->size();
+		m_iSize -= qMin(m_iSize, iOldSize);
+		trimCommands();
 		// Notify commanders...
 		emit updateNotifySignal(m_pLastCommand->flags());
 	}
@@ -140,7 +158,11 @@ bool qtractorCommandList::undo (void)
 
 	if (m_pLastCommand) {
 		// Undo operation...
+		const unsigned long iOldSize = m_pLastCommand->size();
 		bResult = m_pLastCommand->undo();
+		// Undoing may have changed it as well...
+		m_iSize += m_pLastCommand->size();
+		m_iSize -= qMin(m_iSize, iOldSize);
 		// Backward one command...
 		const unsigned int flags = m_pLastCommand->flags();
 		m_pLastCommand = m_pLastCommand->prev();
@@ -159,7 +181,12 @@ bool qtractorCommandList::redo (void)
 	m_pLastCommand = nextCommand();
 	if (m_pLastCommand) {
 		// Redo operation...
+		const unsigned long iOldSize = m_pLastCommand->size();
 		bResult = m_pLastCommand->redo();
+		// Redoing may have changed it as well...
+		m_iSize += m_pLastCommand->size();
+		m_iSize -= qMin(m_iSize, iOldSize);
+		trimCommands();
 		// Notify commanders...
 		emit updateNotifySignal(m_pLastCommand->flags());
 	}
@@ -168,6 +195,43 @@ bool qtractorCommandList::redo (void)
 }
 
 
+// Remove one command from the list, keeping account.
+void qtractorCommandList::removeCommand ( qtractorCommand *pCommand )
+{
+	m_iSize -= qMin(m_iSize, pCommand->size());
+
+	m_commands.remove(pCommand);
+}
+
+
+// Evict oldest commands while over the memory budget;
+// always keeping the last executed command though.
+void qtractorCommandList::trimCommands (void)
+{
+	if (g_iMaxSize == 0)
+		return;
+
+	qtractorCommand *pCommand = m_commands.first();
+	while (pCommand && pCommand != m_pLastCommand && m_iSize > g_iMaxSize) {
+		qtractorCommand *pNextCommand = pCommand->next();
+		removeCommand(pCommand);
+		pCommand = pNextCommand;
+	}
+}
+
+
+// Global memory budget (in bytes; zero for unlimited).
+void qtractorCommandList::setMaxSize ( unsigned long iMaxSize )
+{
+	g_iMaxSize = iMaxSize;
+}
+
+unsigned long qtractorCommandList::maxSize (void)
+{
+	return g_iMaxSize;
+}
+
+
 // Command action update helper.
 void qtractorCommandList::updateAction (
 	QAction *pAction, qtractorCommand *pCommand ) const
@@ -88,6 +88,10 @@ public:
 	virtual bool redo() = 0;
 	virtual bool undo() = 0;
 
+	// Approximate memory footprint (in bytes).
+	virtual unsigned long size() const
+		{ return sizeof(*this) + m_sName.size() * sizeof(QChar); }
+
 protected:
 
 	// Discrete flag accessors.
@@ -144,17 +148,38 @@ public:
 	// Command action update helper.
 	void updateAction(QAction *pAction, qtractorCommand *pCommand) const;
 
+	// Current memory footprint (in bytes).
+	unsigned long size() const { return m_iSize; }
+
+	// Global memory budget (in bytes; zero for unlimited).
+	static void setMaxSize(unsigned long iMaxSize);
+	static unsigned long maxSize();
+
+	// Evict oldest commands while over the memory budget.
+	void trimCommands();
+
 signals:
 
 	// Command update notification.
 	void updateNotifySignal(unsigned int);
 
+protected:
+
+	// Remove one command from the list, keeping account.
+	void removeCommand(qtractorCommand *pCommand);
+
 private:
 
 	// Instance variables.
 	qtractorList<qtractorCommand> m_commands;
 
 	qtractorCommand *m_pLastCommand;
+
+	// Memory footprint accounting.
+	unsigned long m_iSize;
+
+	// Global memory budget.
+	static unsigned long g_iMaxSize;
 };
 
 
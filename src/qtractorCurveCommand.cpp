@@ -57,6 +57,13 @@ bool qtractorCurveBaseCommand::execute ( bool /*bRedo*/ )
 	if (pSession && !pSession->isPlaying())
 		pSession->process_curve(pSession->playHead());
 
+	// Owner track contents might have changed...
+	qtractorTrack *pTrack = NULL;
+	if (pSession)
+		pTrack = pSession->findTrack(curveList());
+	if (pTrack)
+		pTrack->setContentsDirty();
+
 	qtractorMainForm *pMainForm = qtractorMainForm::getInstance();
 	if (pMainForm) {
 		qtractorTracks *pTracks = pMainForm->tracks();
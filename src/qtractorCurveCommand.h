@@ -45,6 +45,9 @@ protected:
 
 	// Common executive method.
 	virtual bool execute(bool bRedo);
+
+	// Target curve list accessor.
+	virtual qtractorCurveList *curveList() const { return NULL; }
 };
 
 
@@ -64,6 +67,10 @@ public:
 
 protected:
 
+	// Target curve list accessor.
+	qtractorCurveList *curveList() const
+		{ return (m_pCurve ? m_pCurve->list() : NULL); }
+
 	// Instance variables.
 	qtractorCurve *m_pCurve;
 };
@@ -82,6 +89,9 @@ public:
 
 protected:
 
+	// Target curve list accessor.
+	qtractorCurveList *curveList() const { return m_pCurveList; }
+
 	// Instance variables.
 	qtractorCurveList *m_pCurveList;
 };
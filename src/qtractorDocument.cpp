@@ -33,8 +33,79 @@
 
 #include <QFileInfo>
 #include <QTextStream>
+#include <QBuffer>
 #include <QDir>
 
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QRegExp>
+#include <QSet>
+
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+#if defined(__WIN32__) || defined(_WIN32) || defined(WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+
+// Binary state (BLOB) store sub-directory.
+#define QTRACTOR_BLOB_DIR	"qtractor-state"
+#define QTRACTOR_BLOB_EXT	"blob"
+#define QTRACTOR_BLOB_REFS	"refs"
+
+
+// Flush a file all the way down to disk.
+static bool sync_file ( QFile& file )
+{
+	if (!file.flush())
+		return false;
+
+#if defined(__WIN32__) || defined(_WIN32) || defined(WIN32)
+	return (::_commit(file.handle()) == 0);
+#else
+	return (::fsync(file.handle()) == 0);
+#endif
+}
+
+
+// Write a whole file through a synced temporary, renamed over
+// at last, so that it never gets half-written on a crash.
+static bool write_file ( const QString& sPath, const QByteArray& data )
+{
+	const QString sTemp = sPath + ".tmp";
+	QFile file(sTemp);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	bool bResult = (file.write(data) == data.size() && sync_file(file));
+	file.close();
+	if (bResult) {
+		if (QFile::exists(sPath))
+			QFile::remove(sPath);
+		bResult = QFile::rename(sTemp, sPath);
+	}
+	if (!bResult)
+		QFile::remove(sTemp);
+
+	return bResult;
+}
+
+
+// Write down one sidecar file, unless it's already there.
+static bool write_blob ( const QString& sPath, const QString& sText )
+{
+	if (QFileInfo(sPath).exists())
+		return true;
+
+	if (!QDir().mkpath(QFileInfo(sPath).absolutePath()))
+		return false;
+
+	return write_file(sPath, QByteArray::fromBase64(sText.toLatin1()));
+}
+
 
 // Local prototypes.
 static void remove_dir_list(const QList<QFileInfo>& list);
@@ -92,7 +163,7 @@ qtractorDocument *qtractorDocument::g_pArchive = NULL;
 qtractorDocument::qtractorDocument ( QDomDocument *pDocument,
 	const QString& sTagName, Flags flags )
 	: m_pDocument(pDocument), m_sTagName(sTagName), m_flags(flags),
-		m_pZipFile(NULL)
+		m_pZipFile(NULL), m_bDeferBlobs(false)
 {
 }
 
@@ -165,6 +236,337 @@ bool qtractorDocument::isTemporary (void) const
 }
 
 
+//-------------------------------------------------------------------------
+// qtractorDocument -- binary state (BLOB) store.
+//
+
+// Templates and archives must be self-contained: no sidecars.
+bool qtractorDocument::isBlobStore (void) const
+{
+	return !isTemplate() && !isArchive() && !m_sDir.isEmpty();
+}
+
+
+// Store (base64 encoded) binary data into its own sidecar file,
+// named after its content hash; writes only if not there already.
+// In-memory snapshots just queue it up for the actual writer.
+// Returns the document relative path or empty string on failure.
+QString qtractorDocument::saveBlob (
+	const QString& sText, const QString& sHash )
+{
+	if (m_sDir.isEmpty())
+		return QString();
+
+	QString sBlobHash = sHash;
+	if (sBlobHash.isEmpty()) {
+		sBlobHash = QString::fromLatin1(QCryptographicHash::hash(
+			QByteArray::fromBase64(sText.toLatin1()),
+			QCryptographicHash::Sha1).toHex());
+	}
+
+	const QString sBlobFile = sBlobHash + '.' + QTRACTOR_BLOB_EXT;
+	const QString sBlob = QTRACTOR_BLOB_DIR "/" + sBlobFile;
+
+	// Referenced by this document, from now on...
+	if (!m_blobs.contains(sBlobFile))
+		m_blobs.append(sBlobFile);
+
+	const QString& sPath = QDir(m_sDir).absoluteFilePath(sBlob);
+	if (m_bDeferBlobs) {
+		m_pendingBlobs.insert(sPath, sText);
+		return sBlob;
+	}
+
+	if (!write_blob(sPath, sText))
+		return QString();
+
+	return sBlob;
+}
+
+
+// Write down all sidecar files queued by a snapshot (any thread).
+bool qtractorDocument::writeBlobs ( const QHash<QString, QString>& blobs )
+{
+	QHash<QString, QString>::ConstIterator iter = blobs.constBegin();
+	const QHash<QString, QString>::ConstIterator& iter_end = blobs.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		if (!write_blob(iter.key(), iter.value()))
+			return false;
+	}
+
+	return true;
+}
+
+
+// Retrieve (base64 encoded) binary data from its sidecar file.
+// Returns false if the sidecar file is missing or unreadable,
+// or if it's not named after a content hash right in the store.
+bool qtractorDocument::loadBlob ( const QString& sBlob, QString& sText ) const
+{
+	const QRegExp rxBlob(QTRACTOR_BLOB_DIR "/[0-9a-f]{40}\\." QTRACTOR_BLOB_EXT);
+	if (!rxBlob.exactMatch(sBlob))
+		return false;
+
+	QFile file(QDir(m_sDir).absoluteFilePath(sBlob));
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	const QByteArray& data = file.readAll();
+	const bool bRead = (data.size() == file.size());
+	file.close();
+
+	if (!bRead)
+		return false;
+
+	sText = QString::fromLatin1(data.toBase64());
+	return true;
+}
+
+
+// Sidecar files referenced by the document last saved.
+const QStringList& qtractorDocument::blobs (void) const
+{
+	return m_blobs;
+}
+
+
+// Sidecar files still to be written by the last snapshot.
+const QHash<QString, QString>& qtractorDocument::pendingBlobs (void) const
+{
+	return m_pendingBlobs;
+}
+
+
+// Record which sidecar files a document just written refers to,
+// optionally sweeping any others no document refers to anymore.
+bool qtractorDocument::commitBlobs ( const QString& sFilename,
+	const QStringList& blobs, bool bSweep )
+{
+	const QFileInfo info(sFilename);
+	const QDir dir(info.absolutePath());
+	if (!dir.exists(QTRACTOR_BLOB_DIR))
+		return true;
+
+	const QDir blob_dir(dir.absoluteFilePath(QTRACTOR_BLOB_DIR));
+
+	// One reference list per document...
+	const QString& sRefs = blob_dir.absoluteFilePath(
+		info.fileName() + '.' + QTRACTOR_BLOB_REFS);
+	if (blobs.isEmpty()) {
+		QFile::remove(sRefs);
+	} else {
+		const QByteArray& data
+			= blobs.join(QString(QChar('\n'))).toUtf8() + '\n';
+		if (!write_file(sRefs, data))
+			return false;
+	}
+
+	if (!bSweep)
+		return true;
+
+	// Gather all references still alive...
+	QSet<QString> refs;
+	const QStringList& ref_files = blob_dir.entryList(
+		QStringList() << "*." QTRACTOR_BLOB_REFS, QDir::Files);
+	QStringListIterator ref_iter(ref_files);
+	while (ref_iter.hasNext()) {
+		const QString& sRefFile = ref_iter.next();
+		// Document is gone? so are its references...
+		const QString& sDocFile = sRefFile.section('.', 0, -2);
+		if (!dir.exists(sDocFile)) {
+			blob_dir.remove(sRefFile);
+			continue;
+		}
+		QFile file(blob_dir.absoluteFilePath(sRefFile));
+		if (!file.open(QIODevice::ReadOnly))
+			return false; // Better safe than sorry.
+		while (!file.atEnd()) {
+			const QString& sBlobFile
+				= QString::fromUtf8(file.readLine()).trimmed();
+			if (!sBlobFile.isEmpty())
+				refs.insert(sBlobFile);
+		}
+		file.close();
+	}
+
+	// Sweep all unreferenced, and any stale temporaries...
+	const QDateTime& stale = QDateTime::currentDateTime().addSecs(-3600);
+	const QList<QFileInfo>& list = blob_dir.entryInfoList(
+		QStringList() << "*." QTRACTOR_BLOB_EXT << "*.tmp", QDir::Files);
+	QListIterator<QFileInfo> iter(list);
+	while (iter.hasNext()) {
+		const QFileInfo& fi = iter.next();
+		if (fi.suffix() == "tmp") {
+			if (fi.lastModified() < stale)
+				blob_dir.remove(fi.fileName());
+		}
+		else
+		if (!refs.contains(fi.fileName()))
+			blob_dir.remove(fi.fileName());
+	}
+
+	return true;
+}
+
+
+//-------------------------------------------------------------------------
+// qtractorDocument -- streaming methods.
+//
+
+// External storage element (DOM) default methods.
+bool qtractorDocument::loadElement ( QDomElement */*pElement*/ )
+{
+	return false;
+}
+
+bool qtractorDocument::saveElement ( QDomElement */*pElement*/ )
+{
+	return false;
+}
+
+
+// External storage streaming default methods:
+// the whole document goes through DOM element methods.
+bool qtractorDocument::loadStream ( QXmlStreamReader *pReader )
+{
+	QDomElement elem;
+	if (!readElement(pReader, &elem))
+		return false;
+
+	m_pDocument->appendChild(elem);
+
+	return loadElement(&elem);
+}
+
+bool qtractorDocument::saveStream ( QXmlStreamWriter *pWriter )
+{
+	QDomElement elem = m_pDocument->createElement(m_sTagName);
+	if (!saveElement(&elem))
+		return false;
+
+	m_pDocument->appendChild(elem);
+
+	writeElement(pWriter, elem);
+	return true;
+}
+
+
+// Read the current element, and all of its contents, into
+// a detached DOM element (whitespace-only text is dropped).
+bool qtractorDocument::readElement (
+	QXmlStreamReader *pReader, QDomElement *pElement )
+{
+	if (!pReader->isStartElement())
+		return false;
+
+	QDomNode node = *pElement
+		= m_pDocument->createElement(pReader->qualifiedName().toString());
+
+	int iDepth = 0;
+
+	while (!pReader->atEnd()) {
+		switch (pReader->tokenType()) {
+		case QXmlStreamReader::StartElement: {
+			QDomElement elem = (iDepth > 0
+				? m_pDocument->createElement(pReader->qualifiedName().toString())
+				: *pElement);
+			const QXmlStreamAttributes& attrs = pReader->attributes();
+			QXmlStreamAttributes::ConstIterator attr = attrs.constBegin();
+			const QXmlStreamAttributes::ConstIterator& attr_end
+				= attrs.constEnd();
+			for ( ; attr != attr_end; ++attr) {
+				elem.setAttribute(
+					attr->qualifiedName().toString(),
+					attr->value().toString());
+			}
+			if (iDepth > 0)
+				node = node.appendChild(elem);
+			++iDepth;
+			break;
+		}
+		case QXmlStreamReader::EndElement:
+			if (--iDepth > 0)
+				node = node.parentNode();
+			break;
+		case QXmlStreamReader::Characters: {
+			if (pReader->isWhitespace())
+				break;
+			const QString& sText = pReader->text().toString();
+			if (pReader->isCDATA()) {
+				node.appendChild(m_pDocument->createCDATASection(sText));
+				break;
+			}
+			// Text may come out in chunks...
+			QDomText text = node.lastChild().toText();
+			if (text.isNull() || text.isCDATASection())
+				node.appendChild(m_pDocument->createTextNode(sText));
+			else
+				text.appendData(sText);
+			break;
+		}
+		default:
+			break;
+		}
+		// Stop right at its own end...
+		if (iDepth < 1)
+			break;
+		pReader->readNext();
+	}
+
+	return (iDepth == 0 && !pReader->hasError());
+}
+
+
+// Write a DOM element, and all of its contents, as it is.
+void qtractorDocument::writeElement (
+	QXmlStreamWriter *pWriter, const QDomElement& element )
+{
+	pWriter->writeStartElement(element.tagName());
+
+	const QDomNamedNodeMap& attrs = element.attributes();
+	const int iAttrs = attrs.count();
+	for (int i = 0; i < iAttrs; ++i) {
+		const QDomAttr& attr = attrs.item(i).toAttr();
+		pWriter->writeAttribute(attr.name(), attr.value());
+	}
+
+	for (QDomNode nChild = element.firstChild();
+			!nChild.isNull();
+				nChild = nChild.nextSibling()) {
+		if (nChild.isElement())
+			writeElement(pWriter, nChild.toElement());
+		else
+		if (nChild.isCDATASection())
+			pWriter->writeCDATA(nChild.toCDATASection().data());
+		else
+		if (nChild.isText())
+			pWriter->writeCharacters(nChild.toText().data());
+	}
+
+	pWriter->writeEndElement();
+}
+
+
+// Whole document streaming writer (no DOM tree in between).
+bool qtractorDocument::writeStream ( QIODevice *pDevice )
+{
+	QXmlStreamWriter xml(pDevice);
+	xml.setAutoFormatting(true);
+	xml.setAutoFormattingIndent(1);
+
+	const QString& sDocType = m_pDocument->doctype().name();
+	if (!sDocType.isEmpty())
+		xml.writeDTD("<!DOCTYPE " + sDocType + '>');
+
+	if (!saveStream(&xml))
+		return false;
+
+	xml.writeEndDocument();
+
+	return !xml.hasError();
+}
+
+
 //-------------------------------------------------------------------------
 // qtractorDocument -- loaders.
 //
@@ -231,23 +633,24 @@ bool qtractorDocument::load ( const QString& sFilename, Flags flags )
 #endif
 	QDir::setCurrent(info.absolutePath());
 
+	m_sDir = QDir::currentPath();
+
 	// Open file...
 	QFile file(sDocname);
 	if (!file.open(mode))
 		return false;
-	// Parse it a-la-DOM :-)
-	if (!m_pDocument->setContent(&file)) {
-		file.close();
-		return false;
-	}
-	file.close();
+
+	// Parse it, streaming all along :-)
+	QXmlStreamReader xml(&file);
 
 	// Get root element and check for proper taqg name.
-	QDomElement elem = m_pDocument->documentElement();
-	if (elem.tagName() != m_sTagName)
-	    return false;
+	bool bResult = (xml.readNextStartElement() && xml.name().toString() == m_sTagName);
+	if (bResult)
+		bResult = (loadStream(&xml) && !xml.hasError());
 
-	return loadElement(&elem);
+	file.close();
+
+	return bResult;
 }
 
 
@@ -276,12 +679,17 @@ bool qtractorDocument::save ( const QString& sFilename, Flags flags )
 	// Is it an archive about to stuff?
 	const QFileInfo info(sFilename);
 	m_sName = info.completeBaseName();
+	m_sDir  = info.absolutePath();
 	QString sDocname = info.filePath();
 
+	m_blobs.clear();
+	m_pendingBlobs.clear();
+	m_bDeferBlobs = false;
+
+#ifdef CONFIG_LIBZ
 	const QIODevice::OpenMode mode
 		= QIODevice::WriteOnly | QIODevice::Truncate;
 
-#ifdef CONFIG_LIBZ
 	if (isArchive()) {
 		m_pZipFile = new qtractorZipFile(sDocname, mode);
 		if (!m_pZipFile->isWritable()) {
@@ -295,22 +703,38 @@ bool qtractorDocument::save ( const QString& sFilename, Flags flags )
 	}
 #endif
 
-	// Save spec...
-	QDomElement elem = m_pDocument->createElement(m_sTagName);
-	if (!saveElement(&elem))
+	// Save spec, streaming in memory first...
+	QByteArray data;
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::WriteOnly);
+	const bool bResult = writeStream(&buffer);
+	buffer.close();
+	if (!bResult)
 		return false;
-	m_pDocument->appendChild(elem);
 
-	// Finally, we're ready to save to external file.
+	// Finally, we're ready to save to external file;
+	// never leave a half-written one behind though...
 	QFile file(sDocname);
 #ifdef CONFIG_LIBZ
 	const bool bRemove = !file.exists();
+	if (m_pZipFile) {
+		if (!file.open(mode))
+			return false;
+		const bool bWrite = (file.write(data) == data.size());
+		file.close();
+		if (!bWrite) {
+			if (bRemove) file.remove();
+			return false;
+		}
+	}
+	else
 #endif
-	if (!file.open(mode))
+	if (!write_file(sDocname, data))
 		return false;
-	QTextStream ts(&file);
-	ts << m_pDocument->toString() << endl;
-	file.close();
+
+	// Sidecar files no longer referenced may go now...
+	if (isBlobStore())
+		commitBlobs(sFilename, m_blobs, true);
 
 #ifdef CONFIG_LIBZ
 	// Commit to archive.
@@ -331,6 +755,38 @@ bool qtractorDocument::save ( const QString& sFilename, Flags flags )
 }
 
 
+// In-memory only save method: the document gets fully serialized
+// but it's up to the caller to write it out to external storage.
+bool qtractorDocument::snapshot (
+	const QString& sFilename, QByteArray& data, Flags flags )
+{
+	// Hold template mode.
+	setFlags(flags);
+
+	// We must have a valid tag name and no archives...
+	if (m_sTagName.isEmpty() || isArchive())
+		return false;
+
+	const QFileInfo info(sFilename);
+	m_sName = info.completeBaseName();
+	m_sDir  = info.absolutePath();
+
+	m_blobs.clear();
+	m_pendingBlobs.clear();
+	m_bDeferBlobs = true;
+
+	// Save spec...
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::WriteOnly);
+	const bool bResult = writeStream(&buffer);
+	buffer.close();
+
+	m_bDeferBlobs = false;
+
+	return bResult;
+}
+
+
 QString qtractorDocument::addFile ( const QString& sFilename )
 {
 #ifdef CONFIG_LIBZ
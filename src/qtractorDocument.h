@@ -23,10 +23,14 @@
 #define __qtractorDocument_h
 
 #include <QStringList>
+#include <QHash>
 
 // Forward declartions.
 class QDomDocument;
 class QDomElement;
+class QIODevice;
+class QXmlStreamReader;
+class QXmlStreamWriter;
 
 class qtractorZipFile;
 
@@ -64,6 +68,25 @@ public:
 	bool isArchive() const;
 	bool isTemporary() const;
 
+	// Session-local binary state (BLOB) store;
+	// content-addressed sidecar files, by hash.
+	bool isBlobStore() const;
+
+	QString saveBlob(const QString& sText, const QString& sHash = QString());
+	bool loadBlob(const QString& sBlob, QString& sText) const;
+
+	// Sidecar files referenced by the document last saved;
+	// committed once the document is written, sweeping any
+	// others no document in the same directory refers to.
+	const QStringList& blobs() const;
+	static bool commitBlobs(const QString& sFilename,
+		const QStringList& blobs, bool bSweep = false);
+
+	// Sidecar files a snapshot left to be written
+	// (absolute path to base64 text), by any thread.
+	const QHash<QString, QString>& pendingBlobs() const;
+	static bool writeBlobs(const QHash<QString, QString>& blobs);
+
 	// Archive filename filter.
 	QString addFile (const QString& sFilename);
 
@@ -71,9 +94,23 @@ public:
 	bool load (const QString& sFilename, Flags flags = Default);
 	bool save (const QString& sFilename, Flags flags = Default);
 
-	// External storage element pure virtual methods.
-	virtual bool loadElement (QDomElement *pElement) = 0;
-	virtual bool saveElement (QDomElement *pElement) = 0;
+	// In-memory only save method (no archives, nothing written).
+	bool snapshot (const QString& sFilename, QByteArray& data,
+		Flags flags = Default);
+
+	// External storage element (DOM) virtual methods.
+	virtual bool loadElement (QDomElement *pElement);
+	virtual bool saveElement (QDomElement *pElement);
+
+	// External storage streaming virtual methods; the default
+	// ones just go through the (whole) DOM element methods.
+	virtual bool loadStream (QXmlStreamReader *pReader);
+	virtual bool saveStream (QXmlStreamWriter *pWriter);
+
+	// Streaming DOM fragment reader/writer, for the parts
+	// that are still loaded/saved as DOM elements.
+	bool readElement (QXmlStreamReader *pReader, QDomElement *pElement);
+	void writeElement (QXmlStreamWriter *pWriter, const QDomElement& element);
 
 	// Helper methods.
 	static bool    boolFromText (const QString& sText);
@@ -96,6 +133,11 @@ public:
 	static QString addArchiveFile(
 		const QString& sDir, const QString& sFilename);
 
+protected:
+
+	// Whole document streaming writer.
+	bool writeStream (QIODevice *pDevice);
+
 private:
 
 	// Instance variables.
@@ -106,12 +148,22 @@ private:
 	// Base document name (derived from filename).
 	QString m_sName;
 
+	// Absolute document directory.
+	QString m_sDir;
+
 	// Archive stuff.
 	qtractorZipFile *m_pZipFile;
 
 	// Temporary files;
 	QStringList m_tempFiles;
 
+	// Referenced sidecar (BLOB) files.
+	QStringList m_blobs;
+
+	// Sidecar files left to write (snapshot mode).
+	QHash<QString, QString> m_pendingBlobs;
+	bool m_bDeferBlobs;
+
 	// Filename extensions (file suffixes).
 	static QString g_sDefaultExt;
 	static QString g_sTemplateExt;
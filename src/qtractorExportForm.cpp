@@ -23,6 +23,7 @@
 
 #include "qtractorAbout.h"
 #include "qtractorAudioEngine.h"
+#include "qtractorAudioAnalyzer.h"
 #include "qtractorMidiEngine.h"
 
 #include "qtractorAudioFile.h"
@@ -37,6 +38,8 @@
 #include <QPushButton>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QRegExp>
+#include <QDir>
 #include <QUrl>
 
 
@@ -101,6 +104,9 @@ qtractorExportForm::qtractorExportForm (
 	QObject::connect(m_ui.FormatComboBox,
 		SIGNAL(activated(int)),
 		SLOT(formatChanged(int)));
+	QObject::connect(m_ui.ExportStemsCheckBox,
+		SIGNAL(toggled(bool)),
+		SLOT(stabilizeForm()));
 	QObject::connect(m_ui.AddTrackCheckBox,
 		SIGNAL(toggled(bool)),
 		SLOT(stabilizeForm()));
@@ -166,8 +172,16 @@ void qtractorExportForm::setExportType ( qtractorTrack::TrackType exportType )
 	if (pOptions) {
 		pOptions->loadComboBoxHistory(m_ui.ExportPathComboBox);
 		m_ui.AddTrackCheckBox->setChecked(pOptions->bExportAddTrack);
+		m_ui.ExportStemsCheckBox->setChecked(pOptions->bExportStems);
+		m_ui.ExportTracksCheckBox->setChecked(pOptions->bExportTracks);
+		m_ui.ExportDitherCheckBox->setChecked(pOptions->bExportDither);
 	}
 
+	// Stems are an audio export specialty...
+	m_ui.ExportStemsCheckBox->setVisible(m_exportType == qtractorTrack::Audio);
+	m_ui.ExportTracksCheckBox->setVisible(m_exportType == qtractorTrack::Audio);
+	m_ui.ExportDitherCheckBox->setVisible(m_exportType == qtractorTrack::Audio);
+
 	// Suggest a brand new export filename...
 	if (pSession) {
 		m_ui.ExportPathComboBox->setEditText(
@@ -225,14 +239,35 @@ void qtractorExportForm::accept (void)
 	if (QFileInfo(sExportPath).suffix().isEmpty())
 		sExportPath += '.' + m_sExportExt;
 
-	// Check (again) wether the file already exists...
-	if (QFileInfo(sExportPath).exists()) {
+	// Audio stems get one file per bus and/or track...
+	const QList<qtractorAudioEngine::ExportStem>& exportStems
+		= audioExportStems(sExportPath, exportBusNameItems);
+
+	QStringList exportPaths;
+	if (exportStems.isEmpty()) {
+		exportPaths.append(sExportPath);
+	} else {
+		QListIterator<qtractorAudioEngine::ExportStem> stem_iter(exportStems);
+		while (stem_iter.hasNext())
+			exportPaths.append(stem_iter.next().path);
+	}
+
+	// Check (again) wether the file(s) already exists...
+	QStringList existingPaths;
+	QStringListIterator path_iter(exportPaths);
+	while (path_iter.hasNext()) {
+		const QString& sPath = path_iter.next();
+		if (QFileInfo(sPath).exists())
+			existingPaths.append(sPath);
+	}
+
+	if (!existingPaths.isEmpty()) {
 		if (QMessageBox::warning(this,
 			tr("Warning") + " - " QTRACTOR_TITLE,
 			tr("The file already exists:\n\n"
 			"\"%1\"\n\n"
 			"Do you want to replace it?")
-			.arg(sExportPath),
+			.arg(existingPaths.join("\"\n\"")),
 			QMessageBox::Ok | QMessageBox::Cancel) == QMessageBox::Cancel) {
 			m_ui.ExportPathComboBox->setFocus();
 			return;
@@ -271,25 +306,66 @@ void qtractorExportForm::accept (void)
 					.arg(sExportPath));
 				// Do the export as commanded...
 				QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-				const bool bResult = pAudioEngine->fileExport(
-					sExportPath, exportBuses,
-					m_ui.ExportStartSpinBox->value(),
-					m_ui.ExportEndSpinBox->value());
+				bool bResult = false;
+				if (exportStems.isEmpty()) {
+					bResult = pAudioEngine->fileExport(
+						sExportPath, exportBuses,
+						m_ui.ExportStartSpinBox->value(),
+						m_ui.ExportEndSpinBox->value());
+				} else {
+					bResult = pAudioEngine->fileExportStems(
+						exportStems,
+						m_ui.ExportStartSpinBox->value(),
+						m_ui.ExportEndSpinBox->value());
+				}
 				QApplication::restoreOverrideCursor();
 				if (bResult) {
 					// Add new tracks if necessary...
 					qtractorTracks *pTracks = pMainForm->tracks();
 					if (pTracks && m_ui.AddTrackCheckBox->isChecked()) {
-						pTracks->addAudioTracks(
-							QStringList(sExportPath),
+						pTracks->addAudioTracks(exportPaths,
 							m_ui.ExportStartSpinBox->value(),
 							pTracks->currentTrack());
+					} else {
+						QStringListIterator file_iter(exportPaths);
+						while (file_iter.hasNext())
+							pMainForm->addAudioFile(file_iter.next());
 					}
-					else pMainForm->addAudioFile(sExportPath);
 					// Log the success...
 					pMainForm->appendMessages(
 						tr("Audio file export: \"%1\" complete.")
 						.arg(sExportPath));
+					// Log the timing report...
+					pMainForm->appendMessages(
+						tr("Audio file export: \"%1\" rendering %2 s, "
+						"encoding %3 s (stalled %4 s, drain %5 s).")
+						.arg(sExportPath)
+						.arg(0.001f * pAudioEngine->exportRenderTime(), 0, 'f', 1)
+						.arg(0.001f * pAudioEngine->exportEncodeTime(), 0, 'f', 1)
+						.arg(0.001f * pAudioEngine->exportStallTime(), 0, 'f', 1)
+						.arg(0.001f * pAudioEngine->exportDrainTime(), 0, 'f', 1));
+					// Log the loudness report...
+					QListIterator<qtractorAudioBus *> bus_iter(exportBuses);
+					while (bus_iter.hasNext()) {
+						qtractorAudioBus *pExportBus = bus_iter.next();
+						qtractorAudioAnalyzer *pAudioAnalyzer
+							= pExportBus->audioAnalyzer_out();
+						if (pAudioAnalyzer == NULL)
+							continue;
+						const qtractorAudioAnalyzer::Values& values
+							= pAudioAnalyzer->values();
+						float fTruePeak = 0.0f;
+						for (int i = 0; i < values.truePeak.count(); ++i) {
+							if (fTruePeak < values.truePeak.at(i))
+								fTruePeak = values.truePeak.at(i);
+						}
+						pMainForm->appendMessages(
+							tr("Audio file export: \"%1\" bus: "
+							"integrated %2 LUFS, true-peak %3 dBTP.")
+							.arg(pExportBus->busName())
+							.arg(values.integrated, 0, 'f', 1)
+							.arg(qtractorAudioAnalyzer::dB(fTruePeak), 0, 'f', 1));
+					}
 				} else {
 					// Log the failure...
 					pMainForm->appendMessagesError(
@@ -351,6 +427,11 @@ void qtractorExportForm::accept (void)
 		if (pOptions) {
 			pOptions->saveComboBoxHistory(m_ui.ExportPathComboBox);
 			pOptions->bExportAddTrack = m_ui.AddTrackCheckBox->isChecked();
+			if (m_exportType == qtractorTrack::Audio) {
+				pOptions->bExportStems  = m_ui.ExportStemsCheckBox->isChecked();
+				pOptions->bExportTracks = m_ui.ExportTracksCheckBox->isChecked();
+				pOptions->bExportDither = m_ui.ExportDitherCheckBox->isChecked();
+			}
 		}
 	}
 
@@ -518,6 +599,75 @@ void qtractorExportForm::formatChanged ( int iDisplayFormat )
 }
 
 
+// Audio export stems (one file per bus and/or track), if any.
+QList<qtractorAudioEngine::ExportStem> qtractorExportForm::audioExportStems (
+	const QString& sExportPath,
+	const QList<QListWidgetItem *>& exportBusNameItems ) const
+{
+	QList<qtractorAudioEngine::ExportStem> exportStems;
+
+	if (m_exportType != qtractorTrack::Audio
+		|| !m_ui.ExportStemsCheckBox->isChecked())
+		return exportStems;
+
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == NULL)
+		return exportStems;
+
+	qtractorAudioEngine *pAudioEngine = pSession->audioEngine();
+	if (pAudioEngine == NULL)
+		return exportStems;
+
+	// Stem file names are made after the export one...
+	const QFileInfo info(sExportPath);
+	const QString sStemPrefix
+		= QFileInfo(info.dir(), info.completeBaseName()).filePath() + '-';
+	const QString sStemSuffix = '.' + info.suffix();
+	const QRegExp rxStemName("[^\\w\\-\\.]+");
+
+	const bool bDither = m_ui.ExportDitherCheckBox->isChecked();
+
+	// One stem per output bus...
+	QList<qtractorAudioBus *> exportBuses;
+	QListIterator<QListWidgetItem *> iter(exportBusNameItems);
+	while (iter.hasNext()) {
+		qtractorAudioBus *pExportBus
+			= static_cast<qtractorAudioBus *> (
+				pAudioEngine->findOutputBus(iter.next()->text()));
+		if (pExportBus == NULL)
+			continue;
+		exportBuses.append(pExportBus);
+		QString sStemName = pExportBus->busName();
+		sStemName.replace(rxStemName, "_");
+		exportStems.append(qtractorAudioEngine::ExportStem(
+			sStemPrefix + sStemName + sStemSuffix,
+			pExportBus, NULL, -1, bDither));
+	}
+
+	// Plus one stem per audio track (post-fader) on those...
+	if (m_ui.ExportTracksCheckBox->isChecked()) {
+		int iTrack = 0;
+		for (qtractorTrack *pTrack = pSession->tracks().first();
+				pTrack; pTrack = pTrack->next()) {
+			++iTrack;
+			if (pTrack->trackType() != qtractorTrack::Audio)
+				continue;
+			qtractorAudioBus *pAudioBus
+				= static_cast<qtractorAudioBus *> (pTrack->outputBus());
+			if (!exportBuses.contains(pAudioBus))
+				continue;
+			QString sStemName = pTrack->trackName();
+			sStemName.replace(rxStemName, "_");
+			exportStems.append(qtractorAudioEngine::ExportStem(
+				sStemPrefix + QString("%1-").arg(iTrack, 2, 10, QChar('0'))
+				+ sStemName + sStemSuffix, NULL, pTrack, -1, bDither));
+		}
+	}
+
+	return exportStems;
+}
+
+
 // Stabilize current form state.
 void qtractorExportForm::stabilizeForm (void)
 {
@@ -536,6 +686,10 @@ void qtractorExportForm::stabilizeForm (void)
 	m_ui.ExportStartSpinBox->setMaximum(iExportEnd);
 	m_ui.ExportEndSpinBox->setMinimum(iExportStart);
 
+	const bool bExportStems = m_ui.ExportStemsCheckBox->isChecked();
+	m_ui.ExportTracksCheckBox->setEnabled(bExportStems);
+	m_ui.ExportDitherCheckBox->setEnabled(bExportStems);
+
 	m_ui.DialogButtonBox->button(QDialogButtonBox::Ok)->setEnabled(
 		!m_ui.ExportPathComboBox->currentText().isEmpty() &&
 		m_ui.ExportBusNameListBox->currentItem() != NULL &&
@@ -25,6 +25,7 @@
 #include "ui_qtractorExportForm.h"
 
 #include "qtractorTrack.h"
+#include "qtractorAudioEngine.h"
 
 
 //----------------------------------------------------------------------------
@@ -57,6 +58,13 @@ protected slots:
 
 	void stabilizeForm();
 
+protected:
+
+	// Audio export stems (one file per bus and/or track), if any.
+	QList<qtractorAudioEngine::ExportStem> audioExportStems(
+		const QString& sExportPath,
+		const QList<QListWidgetItem *>& exportBusNameItems) const;
+
 private:
 
 	// The Qt-designer UI struct...
@@ -41,6 +41,8 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QUrl>
+
+#include <QMutex>
 #endif
 
 #include <math.h>
@@ -56,6 +58,9 @@
 static QHash<QString, LV2_URID>    g_uri_map;
 static QHash<LV2_URID, QByteArray> g_ids_map;
 
+// Plugins may map/unmap from any (instantiation) thread.
+static QMutex g_uri_mutex;
+
 
 static LV2_URID qtractor_lv2_urid_map (
 	LV2_URID_Map_Handle /*handle*/, const char *uri )
@@ -155,6 +160,8 @@ static const void *qtractor_lv2_state_retrieve ( LV2_State_Handle handle,
 // URI map helpers (static).
 LV2_URID qtractorLv2Plugin::lv2_urid_map ( const char *uri )
 {
+	QMutexLocker locker(&g_uri_mutex);
+
 	const QString sUri(uri);
 
 	QHash<QString, uint32_t>::ConstIterator iter
@@ -171,6 +178,8 @@ LV2_URID qtractorLv2Plugin::lv2_urid_map ( const char *uri )
 
 const char *qtractorLv2Plugin::lv2_urid_unmap ( LV2_URID id )
 {
+	QMutexLocker locker(&g_uri_mutex);
+
 	QHash<LV2_URID, QByteArray>::ConstIterator iter
 		= g_ids_map.constFind(id);
 	if (iter == g_ids_map.constEnd())
@@ -187,12 +196,13 @@ const char *qtractorLv2Plugin::lv2_urid_unmap ( LV2_URID id )
 #include <QMutex>
 #include <QWaitCondition>
 
+#include <jack/jack.h>
 #include <jack/ringbuffer.h>
 
 //----------------------------------------------------------------------
 // class qtractorLv2Worker -- LV2 Worker/Schedule item decl.
 //
-class qtractorLv2WorkerThread;
+class qtractorLv2WorkerPool;
 
 class qtractorLv2Worker
 {
@@ -221,6 +231,9 @@ public:
 	// Process work.
 	void process();
 
+	// Statistics accessor.
+	void stats(qtractorLv2Plugin::WorkerStats& stats) const;
+
 private:
 
 	// Instance members.
@@ -235,8 +248,20 @@ private:
 	jack_ringbuffer_t  *m_pResponses;
 	void               *m_pResponse;
 
-	static qtractorLv2WorkerThread *g_pWorkerThread;
-	static unsigned int             g_iWorkerRefCount;
+	// Scheduled requests still pending;
+	// non-zero means it's already in line.
+	qtractorAtomic      m_pending;
+
+	// Statistics (queue depth and latency).
+	jack_time_t         m_iScheduleTime;
+	unsigned long       m_iRequests;
+	unsigned int        m_iDepthMax;
+	unsigned long       m_iBatches;
+	jack_time_t         m_iLatencySum;
+	jack_time_t         m_iLatencyMax;
+
+	static qtractorLv2WorkerPool *g_pWorkerPool;
+	static unsigned int           g_iWorkerRefCount;
 };
 
 static LV2_Worker_Status qtractor_lv2_worker_schedule (
@@ -272,148 +297,214 @@ static LV2_Worker_Status qtractor_lv2_worker_respond (
 }
 
 //----------------------------------------------------------------------
-// class qtractorLv2WorkerThread -- LV2 Worker/Schedule thread.
+// class qtractorLv2WorkerPool -- LV2 Worker/Schedule thread pool.
 //
-class qtractorLv2WorkerThread : public QThread
+class qtractorLv2WorkerThread;
+
+class qtractorLv2WorkerPool
 {
 public:
 
 	// Constructor.
-	qtractorLv2WorkerThread(unsigned int iSyncSize = 128);
+	qtractorLv2WorkerPool(unsigned int iSyncSize = 1024);
 	// Destructor.
-	~qtractorLv2WorkerThread();
+	~qtractorLv2WorkerPool();
 
-	// Thread run state accessors.
-	void setRunState(bool bRunState);
-	bool runState() const;
+	// Pool threads start/stop.
+	void start(int iThreads);
+	void stop();
 
-	// Wake from executive wait condition.
-	void sync(qtractorLv2Worker *pLv2Worker = NULL);
+	// Thread run state accessor.
+	bool runState() const;
 
-protected:
+	// Put worker in line and wake from executive wait condition;
+	// returns false if the line is already full (RT-safe). May be
+	// called from several threads at once (eg. JACK process thread,
+	// render-ahead and batch threads), so slots are claimed by CAS.
+	bool sync(qtractorLv2Worker *pLv2Worker = NULL);
 
-	// The main thread executive.
+	// The pool threads executive.
 	void run();
 
 private:
 
-	// The peak file queue instance reference.
+	// The worker queue instance reference
+	// (multi-producer: a claimed slot is NULL until published).
 	unsigned int          m_iSyncSize;
 	unsigned int          m_iSyncMask;
-	qtractorLv2Worker   **m_ppSyncItems;
+	qtractorLv2Worker * volatile *m_ppSyncItems;
 
 	volatile unsigned int m_iSyncRead;
-	volatile unsigned int m_iSyncWrite;
+	qtractorAtomic        m_iSyncWrite;
 
-	// Whether the thread is logically running.
+	// Whether the threads are logically running.
 	volatile bool m_bRunState;
 
 	// Thread synchronization objects.
 	QMutex m_mutex;
 	QWaitCondition m_cond;
+
+	// The pool threads.
+	QList<qtractorLv2WorkerThread *> m_threads;
+};
+
+//----------------------------------------------------------------------
+// class qtractorLv2WorkerThread -- LV2 Worker/Schedule thread.
+//
+class qtractorLv2WorkerThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorLv2WorkerThread(qtractorLv2WorkerPool *pPool)
+		: QThread(), m_pPool(pPool) {}
+
+protected:
+
+	// The main thread executive.
+	void run() { m_pPool->run(); }
+
+private:
+
+	// Instance members.
+	qtractorLv2WorkerPool *m_pPool;
 };
 
 // Constructor.
-qtractorLv2WorkerThread::qtractorLv2WorkerThread ( unsigned int iSyncSize )
+qtractorLv2WorkerPool::qtractorLv2WorkerPool ( unsigned int iSyncSize )
 {
 	m_iSyncSize = (64 << 1);
 	while (m_iSyncSize < iSyncSize)
 		m_iSyncSize <<= 1;
 	m_iSyncMask = (m_iSyncSize - 1);
-	m_ppSyncItems = new qtractorLv2Worker * [m_iSyncSize];
+	m_ppSyncItems = new qtractorLv2Worker * volatile [m_iSyncSize];
 	m_iSyncRead   = 0;
-	m_iSyncWrite  = 0;
 
-	::memset(m_ppSyncItems, 0, m_iSyncSize * sizeof(qtractorLv2Worker *));
+	ATOMIC_SET(&m_iSyncWrite, 0);
+
+	for (unsigned int i = 0; i < m_iSyncSize; ++i)
+		m_ppSyncItems[i] = NULL;
 
 	m_bRunState = false;
 }
 
 // Destructor.
-qtractorLv2WorkerThread::~qtractorLv2WorkerThread (void)
+qtractorLv2WorkerPool::~qtractorLv2WorkerPool (void)
 {
+	stop();
+
 	delete [] m_ppSyncItems;
 }
 
-// Run state accessor.
-void qtractorLv2WorkerThread::setRunState ( bool bRunState )
+// Pool threads start.
+void qtractorLv2WorkerPool::start ( int iThreads )
+{
+	m_bRunState = true;
+
+	for (int i = 0; i < iThreads; ++i) {
+		qtractorLv2WorkerThread *pThread = new qtractorLv2WorkerThread(this);
+		m_threads.append(pThread);
+		pThread->start();
+	}
+}
+
+// Pool threads stop.
+void qtractorLv2WorkerPool::stop (void)
 {
-	QMutexLocker locker(&m_mutex);
+	m_mutex.lock();
+	m_bRunState = false;
+	m_cond.wakeAll();
+	m_mutex.unlock();
 
-	m_bRunState = bRunState;
+	QListIterator<qtractorLv2WorkerThread *> iter(m_threads);
+	while (iter.hasNext()) {
+		qtractorLv2WorkerThread *pThread = iter.next();
+		pThread->wait();
+		delete pThread;
+	}
+	m_threads.clear();
 }
 
-bool qtractorLv2WorkerThread::runState (void) const
+// Run state accessor.
+bool qtractorLv2WorkerPool::runState (void) const
 {
 	return m_bRunState;
 }
 
-// Wake from executive wait condition.
-void qtractorLv2WorkerThread::sync ( qtractorLv2Worker *pLv2Worker )
+// Put worker in line and wake from executive wait condition.
+bool qtractorLv2WorkerPool::sync ( qtractorLv2Worker *pLv2Worker )
 {
 	if (pLv2Worker) {
-		unsigned int n;
-		unsigned int r = m_iSyncRead;
-		unsigned int w = m_iSyncWrite;
-		if (w > r) {
-			n = ((r - w + m_iSyncSize) & m_iSyncMask) - 1;
-		} else if (r > w) {
-			n = (r - w) - 1;
-		} else {
-			n = m_iSyncSize - 1;
-		}
-		if (n > 0) {
-			m_ppSyncItems[w] = pLv2Worker;
-			m_iSyncWrite = (w + 1) & m_iSyncMask;
-		}
+		// Claim the next free slot, lock-free...
+		unsigned int w;
+		do {
+			const unsigned int r = m_iSyncRead;
+			w = (unsigned int) ATOMIC_GET(&m_iSyncWrite);
+			if (((w + 1) & m_iSyncMask) == r)
+				return false;
+		} while (!ATOMIC_CAS(&m_iSyncWrite, w, (w + 1) & m_iSyncMask));
+		// Publish into our own slot...
+		m_ppSyncItems[w] = pLv2Worker;
 	}
 
 	if (m_mutex.tryLock()) {
-		m_cond.wakeAll();
+		m_cond.wakeOne();
 		m_mutex.unlock();
 	}
 #ifdef CONFIG_DEBUG_0
-	else qDebug("qtractorLv2WorkerThread[%p]::sync(): tryLock() failed.", this);
+	else qDebug("qtractorLv2WorkerPool[%p]::sync(): tryLock() failed.", this);
 #endif
+
+	return true;
 }
 
-// The main thread executive cycle.
-void qtractorLv2WorkerThread::run (void)
+// The pool threads executive cycle.
+void qtractorLv2WorkerPool::run (void)
 {
 #ifdef CONFIG_DEBUG_0
-	qDebug("qtractorLv2WorkerThread[%p]::run(): started...", this);
+	qDebug("qtractorLv2WorkerPool[%p]::run(): started...", this);
 #endif
 
 	m_mutex.lock();
 
-	m_bRunState = true;
-
 	while (m_bRunState) {
-		// Do whatever we must, then wait for more...
-		unsigned int r = m_iSyncRead;
-		unsigned int w = m_iSyncWrite;
-		while (r != w) {
-			m_ppSyncItems[r]->process();
-			++r &= m_iSyncMask;
-			w = m_iSyncWrite;
+		// Take the next worker in line, if any...
+		const unsigned int r = m_iSyncRead;
+		if (r != (unsigned int) ATOMIC_GET(&m_iSyncWrite)) {
+			qtractorLv2Worker *pLv2Worker = m_ppSyncItems[r];
+			if (pLv2Worker == NULL) {
+				// Claimed but not published yet...
+				m_mutex.unlock();
+				QThread::yieldCurrentThread();
+				m_mutex.lock();
+				continue;
+			}
+			m_ppSyncItems[r] = NULL;
+			m_iSyncRead = (r + 1) & m_iSyncMask;
+			// Let the other threads take on while this one's busy;
+			// a worker is never in line more than once, so its own
+			// requests are always processed in order, one at a time...
+			m_mutex.unlock();
+			pLv2Worker->process();
+			m_mutex.lock();
+		} else {
+			// Wait for sync (lest a wake-up gets lost)...
+			m_cond.wait(&m_mutex, 100);
 		}
-		m_iSyncRead = r;
-		// Wait for sync...
-		m_cond.wait(&m_mutex);
 	}
 
 	m_mutex.unlock();
 
 #ifdef CONFIG_DEBUG_0
-	qDebug("qtractorLv2WorkerThread[%p]::run(): stopped.\n", this);
+	qDebug("qtractorLv2WorkerPool[%p]::run(): stopped.\n", this);
 #endif
 }
 
 //----------------------------------------------------------------------
 // class qtractorLv2Worker -- LV2 Worker/Schedule item impl.
 //
-qtractorLv2WorkerThread *qtractorLv2Worker::g_pWorkerThread   = NULL;
-unsigned int             qtractorLv2Worker::g_iWorkerRefCount = 0;
+qtractorLv2WorkerPool *qtractorLv2Worker::g_pWorkerPool     = NULL;
+unsigned int           qtractorLv2Worker::g_iWorkerRefCount = 0;
 
 // Constructor.
 qtractorLv2Worker::qtractorLv2Worker (
@@ -441,23 +532,45 @@ qtractorLv2Worker::qtractorLv2Worker (
 	m_pResponses = ::jack_ringbuffer_create(4096);
 	m_pResponse  = (void *) ::malloc(4096);
 
+	ATOMIC_SET(&m_pending, 0);
+
+	m_iScheduleTime = 0;
+	m_iRequests   = 0;
+	m_iDepthMax   = 0;
+	m_iBatches    = 0;
+	m_iLatencySum = 0;
+	m_iLatencyMax = 0;
+
 	if (++g_iWorkerRefCount == 1) {
-		g_pWorkerThread = new qtractorLv2WorkerThread();
-		g_pWorkerThread->start();
+		int iThreads = QThread::idealThreadCount();
+		if (iThreads < 2)
+			iThreads = 2;
+		else
+		if (iThreads > 8)
+			iThreads = 8;
+		g_pWorkerPool = new qtractorLv2WorkerPool();
+		g_pWorkerPool->start(iThreads);
 	}
 }
 
 // Destructor.
 qtractorLv2Worker::~qtractorLv2Worker (void)
 {
+	// Wait for any work still in line or in progress...
+	while (ATOMIC_GET(&m_pending) > 0 && g_pWorkerPool->runState())
+		QThread::yieldCurrentThread();
+
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorLv2Worker[%p]::~qtractorLv2Worker()"
+		" requests=%lu depth_max=%u latency_avg=%g latency_max=%g (msecs)",
+		this, m_iRequests, m_iDepthMax,
+		(m_iBatches > 0 ? 0.001f * float(m_iLatencySum / m_iBatches) : 0.0f),
+		0.001f * float(m_iLatencyMax));
+#endif
+
 	if (--g_iWorkerRefCount == 0) {
-		if (g_pWorkerThread->isRunning()) do {
-			g_pWorkerThread->setRunState(false);
-		//	g_pWorkerThread->terminate();
-			g_pWorkerThread->sync();
-		} while (!g_pWorkerThread->wait(100));
-		delete g_pWorkerThread;
-		g_pWorkerThread = NULL;
+		delete g_pWorkerPool;
+		g_pWorkerPool = NULL;
 	}
 
 	::jack_ringbuffer_free(m_pRequests);
@@ -472,16 +585,21 @@ void qtractorLv2Worker::schedule ( uint32_t size, const void *data )
 {
 	const uint32_t request_size = size + sizeof(size);
 
-	if (::jack_ringbuffer_write_space(m_pRequests) >= request_size) {
-		char request_data[request_size];
-		::memcpy(request_data, &size, sizeof(size));
-		::memcpy(request_data + sizeof(size), data, size);
-		::jack_ringbuffer_write(m_pRequests,
-			(const char *) &request_data, request_size);
-	}
+	if (::jack_ringbuffer_write_space(m_pRequests) < request_size)
+		return;
 
-	if (g_pWorkerThread)
-		g_pWorkerThread->sync(this);
+	char request_data[request_size];
+	::memcpy(request_data, &size, sizeof(size));
+	::memcpy(request_data + sizeof(size), data, size);
+	::jack_ringbuffer_write(m_pRequests,
+		(const char *) &request_data, request_size);
+
+	// Get in line, only if not already...
+	if (ATOMIC_INC(&m_pending) == 1) {
+		m_iScheduleTime = ::jack_get_time();
+		if (g_pWorkerPool == NULL || !g_pWorkerPool->sync(this))
+			ATOMIC_DEC(&m_pending); // Retry on next schedule.
+	}
 }
 
 // Response work.
@@ -533,39 +651,63 @@ void qtractorLv2Worker::commit (void)
 	}
 }
 
-// Process work.
+// Process work (pool thread only).
 void qtractorLv2Worker::process (void)
 {
 	const LV2_Worker_Interface *worker
 		= m_pLv2Plugin->lv2_worker_interface(0);
-	if (worker == NULL)
-		return;
 
 	const unsigned short iInstances = m_pLv2Plugin->instances();
 	unsigned short i;
 
-	void *buf = NULL;
-	uint32_t size = 0;
+	// Time spent in line...
+	const jack_time_t iLatency = ::jack_get_time() - m_iScheduleTime;
+	m_iLatencySum += iLatency;
+	if (m_iLatencyMax < iLatency)
+		m_iLatencyMax = iLatency;
+	++m_iBatches;
 
-	uint32_t read_space = ::jack_ringbuffer_read_space(m_pRequests);
-	if (read_space > 0)
-		buf = ::malloc(read_space);
+	int iPending = ATOMIC_GET(&m_pending);
 
-	while (read_space > 0) {
-		::jack_ringbuffer_read(m_pRequests, (char *) &size, sizeof(size));
-		::jack_ringbuffer_read(m_pRequests, (char *) buf, size);
-		if (worker->work) {
-			for (i = 0; i < iInstances; ++i) {
-				LV2_Handle handle = m_pLv2Plugin->lv2_handle(i);
-				if (handle)
-					(*worker->work)(handle,
-						qtractor_lv2_worker_respond, this, size, buf);
+	while (iPending > 0) {
+		void *buf = NULL;
+		uint32_t size = 0;
+		unsigned int iDepth = 0;
+		uint32_t read_space = ::jack_ringbuffer_read_space(m_pRequests);
+		if (read_space > 0)
+			buf = ::malloc(read_space);
+		while (read_space > 0) {
+			::jack_ringbuffer_read(m_pRequests, (char *) &size, sizeof(size));
+			::jack_ringbuffer_read(m_pRequests, (char *) buf, size);
+			if (worker && worker->work) {
+				for (i = 0; i < iInstances; ++i) {
+					LV2_Handle handle = m_pLv2Plugin->lv2_handle(i);
+					if (handle)
+						(*worker->work)(handle,
+							qtractor_lv2_worker_respond, this, size, buf);
+				}
 			}
+			read_space -= sizeof(size) + size;
+			++iDepth;
 		}
-		read_space -= sizeof(size) + size;
+		if (buf) ::free(buf);
+		// Statistics...
+		m_iRequests += iDepth;
+		if (m_iDepthMax < iDepth)
+			m_iDepthMax = iDepth;
+		// Any more scheduled meanwhile? keep on, still in order...
+		iPending = ATOMIC_ADD(&m_pending, -iPending);
 	}
+}
 
-	if (buf) ::free(buf);
+// Statistics accessor.
+void qtractorLv2Worker::stats ( qtractorLv2Plugin::WorkerStats& stats ) const
+{
+	stats.requests = m_iRequests;
+	stats.depth_max = m_iDepthMax;
+	stats.latency_avg = (m_iBatches > 0
+		? 0.001f * float(m_iLatencySum / m_iBatches) : 0.0f);
+	stats.latency_max = 0.001f * float(m_iLatencyMax);
 }
 
 #endif	// CONFIG_LV2_WORKER
@@ -2086,6 +2228,11 @@ const QString& qtractorLv2PluginType::aboutText (void)
 // Dynamic singleton list of LV2 plugins.
 static QList<qtractorLv2Plugin *> g_lv2Plugins;
 
+// Neither the lilv world nor the above are thread-safe
+// (plugin instances might be created in parallel); held
+// just around each lilv world query or roster change.
+static QMutex g_lv2_mutex;
+
 // Constructors.
 qtractorLv2Plugin::qtractorLv2Plugin ( qtractorPluginList *pList,
 	qtractorLv2PluginType *pLv2Type )
@@ -2637,9 +2784,11 @@ void qtractorLv2Plugin::setChannels ( unsigned short iChannels )
 	setInstances(iInstances);
 
 	// Close old instances, all the way...
+	g_lv2_mutex.lock();
 	const int iLv2Plugin = g_lv2Plugins.indexOf(this);
 	if (iLv2Plugin >= 0)
 		g_lv2Plugins.removeAt(iLv2Plugin);
+	g_lv2_mutex.unlock();
 
 #ifdef CONFIG_LV2_WORKER
 	if (m_lv2_worker) {
@@ -2648,11 +2797,14 @@ void qtractorLv2Plugin::setChannels ( unsigned short iChannels )
 	}
 #endif
 	if (m_ppInstances) {
+		// Might close the plugin library (lilv world)...
+		g_lv2_mutex.lock();
 		for (unsigned short i = 0; i < iOldInstances; ++i) {
 			LilvInstance *instance = m_ppInstances[i];
 			if (instance)
 				lilv_instance_free(instance);
 		}
+		g_lv2_mutex.unlock();
 		delete [] m_ppInstances;
 		m_ppInstances = NULL;
 	}
@@ -2697,8 +2849,21 @@ void qtractorLv2Plugin::setChannels ( unsigned short iChannels )
 	//	::memset(m_pfODummy, 0, iBufferSize * sizeof(float));
 	}
 
+	// Lilv world queries, all at once...
+	g_lv2_mutex.lock();
 #ifdef CONFIG_LV2_WORKER
-	if (lilv_plugin_has_feature(plugin, g_lv2_worker_schedule_hint))
+	const bool bWorker
+		= lilv_plugin_has_feature(plugin, g_lv2_worker_schedule_hint);
+#endif
+#ifdef CONFIG_LV2_STATE
+	const bool bStateDefault
+		= lilv_plugin_has_feature(plugin, g_lv2_state_load_default_hint);
+#endif
+	const unsigned long iNumPorts = lilv_plugin_get_num_ports(plugin);
+	g_lv2_mutex.unlock();
+
+#ifdef CONFIG_LV2_WORKER
+	if (bWorker)
 		m_lv2_worker = new qtractorLv2Worker(this, m_lv2_features);
 #endif
 
@@ -2716,12 +2881,14 @@ void qtractorLv2Plugin::setChannels ( unsigned short iChannels )
 	// Allocate new instances...
 	m_ppInstances = new LilvInstance * [iInstances];
 	for (i = 0; i < iInstances; ++i) {
-		// Instantiate them properly first...
+		// Instantiate them properly first
+		// (opens the plugin library, lilv world)...
+		g_lv2_mutex.lock();
 		LilvInstance *instance
 			= lilv_plugin_instantiate(plugin, iSampleRate, features);
+		g_lv2_mutex.unlock();
 		if (instance) {
 			// (Dis)connect all ports...
-			const unsigned long iNumPorts = lilv_plugin_get_num_ports(plugin);
 			for (unsigned long k = 0; k < iNumPorts; ++k)
 				lilv_instance_connect_port(instance, k, NULL);
 			// Connect all existing input control ports...
@@ -2769,11 +2936,13 @@ void qtractorLv2Plugin::setChannels ( unsigned short iChannels )
 	}
 
 	// Finally add it to the LV2 plugin roster...
+	g_lv2_mutex.lock();
 	g_lv2Plugins.append(this);
+	g_lv2_mutex.unlock();
 
 #ifdef CONFIG_LV2_STATE
 	// Load default state as needed...
-	if (lilv_plugin_has_feature(plugin, g_lv2_state_load_default_hint))
+	if (bStateDefault)
 		lv2_state_load_default();
 #endif
 
@@ -4401,6 +4570,17 @@ const LV2_Worker_Interface *qtractorLv2Plugin::lv2_worker_interface (
 		(*descriptor->extension_data)(LV2_WORKER__interface);
 }
 
+
+// LV2 Worker/Schedule statistics accessor.
+bool qtractorLv2Plugin::lv2_worker_stats ( WorkerStats& stats ) const
+{
+	if (m_lv2_worker == NULL)
+		return false;
+
+	m_lv2_worker->stats(stats);
+	return true;
+}
+
 #endif	// CONFIG_LV2_WORKER
 
 
@@ -4409,12 +4589,16 @@ const LV2_Worker_Interface *qtractorLv2Plugin::lv2_worker_interface (
 // Load default plugin state
 void qtractorLv2Plugin::lv2_state_load_default (void)
 {
+	// Lilv world queries only...
+	g_lv2_mutex.lock();
+	LilvState *state = NULL;
 	const LilvNode *default_state = lilv_plugin_get_uri(lv2_plugin());
-	if (default_state == NULL)
-		return;
+	if (default_state) {
+		state = lilv_state_new_from_world(g_lv2_world,
+			&g_lv2_urid_map, default_state);
+	}
+	g_lv2_mutex.unlock();
 
-	LilvState *state = lilv_state_new_from_world(g_lv2_world,
-		&g_lv2_urid_map, default_state);
 	if (state == NULL)
 		return;
 
@@ -4488,13 +4672,8 @@ LV2_State_Status qtractorLv2Plugin::lv2_state_store (
 	else
 	if (type == g_lv2_urids.atom_Double)
 		setConfig(sKey, QString::number(*(const double *) pchValue));
-	else {
-		QByteArray data = qCompress(
-			QByteArray(pchValue, size)).toBase64();
-		for (int i = data.size() - (data.size() % 72); i >= 0; i -= 72)
-			data.insert(i, "\n       "); // Indentation.
-		setConfig(sKey, data.constData());
-	}
+	else
+		setConfigBlob(sKey, QByteArray(pchValue, size));
 
 	if (!bIsString)
 		setConfigType(sKey, QString::fromUtf8(pszType));
@@ -283,6 +283,17 @@ public:
 #ifdef CONFIG_LV2_WORKER
 	// LV2 Worker/Schedule extension data interface accessor.
 	const LV2_Worker_Interface *lv2_worker_interface(unsigned short iInstance) const;
+
+	// LV2 Worker/Schedule statistics (queue depth and latency).
+	struct WorkerStats
+	{
+		unsigned long requests;     // Total requests processed.
+		unsigned int  depth_max;    // Most requests processed in one go.
+		float         latency_avg;  // Average time in line (msecs).
+		float         latency_max;  // Longest time in line (msecs).
+	};
+
+	bool lv2_worker_stats(WorkerStats& stats) const;
 #endif
 
 #ifdef CONFIG_LV2_STATE
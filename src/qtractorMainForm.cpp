@@ -38,6 +38,7 @@
 #include "qtractorSpinBox.h"
 
 #include "qtractorAudioPeak.h"
+#include "qtractorAudioCache.h"
 #include "qtractorAudioBuffer.h"
 #include "qtractorAudioEngine.h"
 #include "qtractorMidiEngine.h"
@@ -120,9 +121,17 @@
 #include <QLabel>
 #include <QTimer>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QClipboard>
 #include <QProgressBar>
 
+#include <QThread>
+#include <QCryptographicHash>
+
+#if QT_VERSION >= 0x050100
+#include <QSaveFile>
+#endif
+
 #include <QColorDialog>
 
 #include <QContextMenuEvent>
@@ -148,6 +157,11 @@
 #define QTRACTOR_TIMER_MSECS    66
 #define QTRACTOR_TIMER_DELAY    233
 
+// Lazy (deferred) clip opening: play-head look-ahead (secs)
+// and background time-slice (msecs) per fast-timer cycle.
+#define QTRACTOR_DEFER_AHEAD    8
+#define QTRACTOR_DEFER_MSECS    10
+
 #if QT_VERSION < 0x040500
 namespace Qt {
 const WindowFlags WindowCloseButtonHint = WindowFlags(0x08000000);
@@ -269,6 +283,10 @@ qtractorMainForm::qtractorMainForm (
 
 	m_iBackupCount = 0;
 
+	// Background auto-save state.
+	m_iAutoSaveDirty = 0;
+	m_pAutoSaveThread = NULL;
+
 	m_iTransportUpdate  = 0;
 	m_iTransportRolling = 0;
 	m_bTransportPlaying = false;
@@ -280,6 +298,10 @@ qtractorMainForm::qtractorMainForm (
 	m_iXrunTimer = 0;
 
 	m_iAudioPeakTimer = 0;
+	m_iAudioCacheTimer = 0;
+
+	m_iAudioRecordWarn = 0;
+	m_iAudioRecordDropped = 0;
 
 	m_iAudioRefreshTimer = 0;
 	m_iMidiRefreshTimer  = 0;
@@ -300,6 +322,15 @@ qtractorMainForm::qtractorMainForm (
 			SLOT(audioPeakNotify()));
 	}
 
+	// Configure the audio transcoding cache factory...
+	qtractorAudioCacheFactory *pAudioCacheFactory
+		= m_pSession->audioCacheFactory();
+	if (pAudioCacheFactory) {
+		QObject::connect(pAudioCacheFactory,
+			SIGNAL(cacheEvent()),
+			SLOT(audioCacheNotify()));
+	}
+
 	// Configure the audio engine event handling...
 	const qtractorAudioEngineProxy *pAudioEngineProxy = NULL;
 	qtractorAudioEngine *pAudioEngine = m_pSession->audioEngine();
@@ -876,6 +907,9 @@ qtractorMainForm::qtractorMainForm (
 	QObject::connect(m_ui.trackAutoMonitorAction,
 		SIGNAL(triggered(bool)),
 		SLOT(trackAutoMonitor(bool)));
+	QObject::connect(m_ui.trackFreezeAction,
+		SIGNAL(triggered(bool)),
+		SLOT(trackFreeze(bool)));
 	QObject::connect(m_ui.trackImportAudioAction,
 		SIGNAL(triggered(bool)),
 		SLOT(trackImportAudio()));
@@ -1219,6 +1253,12 @@ qtractorMainForm::~qtractorMainForm (void)
 		delete m_pUsr1Notifier;
 #endif
 
+	// Wait for any pending auto-save...
+	if (m_pAutoSaveThread) {
+		m_pAutoSaveThread->wait();
+		delete m_pAutoSaveThread;
+	}
+
 	// View/Snap-to-beat actions termination...
 	qDeleteAll(m_snapPerBeatActions);
 	m_snapPerBeatActions.clear();
@@ -1484,6 +1524,18 @@ void qtractorMainForm::setup ( qtractorOptions *pOptions )
 		m_pOptions->bAudioWsolaTimeStretch);
 	qtractorAudioBuffer::setDefaultWsolaQuickSeek(
 		m_pOptions->bAudioWsolaQuickSeek);
+	// Pinned in-memory playback budget...
+	qtractorAudioBuffer::setPinnedBudget(m_pOptions->bAudioPinned
+		? (unsigned long) qMax(0, m_pOptions->iAudioPinnedBudget) << 20 : 0);
+	// Anticipative (render-ahead) track processing...
+	m_pSession->audioEngine()->setRenderAhead(
+		m_pOptions->bAudioRenderAhead);
+	// Plugin-chain ring-out hold time...
+	qtractorPluginList::setSilentHold(
+		(unsigned int) qMax(0, m_pOptions->iAudioSilentHold));
+	// Undo/redo history memory budget...
+	qtractorCommandList::setMaxSize(
+		(unsigned long) qMax(0, m_pOptions->iMaxUndoSize) << 20);
 
 	// Load (action) keyboard shortcuts...
 	m_pOptions->loadActionShortcuts(this);
@@ -2370,15 +2422,28 @@ bool qtractorMainForm::loadSessionFileEx (
 	// We'll take some time anyhow...
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
+	// Clip files are to be open later, in the background...
+	m_pSession->setDeferClips(true);
+
+	// Plugins are to be instantiated later, in parallel...
+	m_pSession->setDeferPlugins(true);
+
 	// Read the file.
 	QDomDocument doc("qtractorSession");
 	const bool bLoadSessionFileEx
 		= qtractorSessionDocument(&doc, m_pSession, m_pFiles)
 			.load(sFilename, qtractorDocument::Flags(iFlags));
 
+	m_pSession->setDeferPlugins(false);
+	m_pSession->setDeferClips(false);
+
 	// We're formerly done.
 	QApplication::restoreOverrideCursor();
 
+	// Pinned in-memory playback gets it all preloaded now...
+	if (bLoadSessionFileEx && qtractorAudioBuffer::pinnedBudget() > 0)
+		openPinnedClips();
+
 	if (bLoadSessionFileEx) {
 		// Got something loaded...
 		// we're not dirty anymore.
@@ -2487,28 +2552,21 @@ bool qtractorMainForm::saveSessionFileEx (
 	// Tell the world we'll take some time...
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 	appendMessages(tr("Saving \"%1\"...").arg(sFilename));
+
+	// Archives must have all clip files in place...
+	if (iFlags & qtractorDocument::Archive)
+		m_pSession->openDeferClips();
 	
 	// Trap dirty clips (only MIDI at this time...)
-	for (qtractorTrack *pTrack = m_pSession->tracks().first();
-			pTrack; pTrack = pTrack->next()) {
-		// Only MIDI track/clips...
-		if (pTrack->trackType() != qtractorTrack::Midi)
-			continue;
-		for (qtractorClip *pClip = pTrack->clips().first();
-				pClip; pClip = pClip->next()) {
-			// Are any dirty changes pending commit?
-			if (pClip->isDirty()) {
-				qtractorMidiClip *pMidiClip
-					= static_cast<qtractorMidiClip *> (pClip);
-				if (pMidiClip)
-					pMidiClip->saveCopyFile(bUpdate);
-			}
-		}
-	}
+	saveDirtyClips(bUpdate);
 
 	// Soft-house-keeping...
 	m_pSession->files()->cleanup(false);
 
+	// Any auto-save in progress shares the same state sidecar
+	// files, so it must be over before those get swept...
+	autoSaveFinish(true);
+
 	// Write the file...
 	QDomDocument doc("qtractorSession");
 	bool bResult = qtractorSessionDocument(&doc, m_pSession, m_pFiles)
@@ -2568,6 +2626,28 @@ bool qtractorMainForm::saveSessionFileEx (
 }
 
 
+// Trap dirty clips (only MIDI at this time...)
+void qtractorMainForm::saveDirtyClips ( bool bUpdate )
+{
+	for (qtractorTrack *pTrack = m_pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		// Only MIDI track/clips...
+		if (pTrack->trackType() != qtractorTrack::Midi)
+			continue;
+		for (qtractorClip *pClip = pTrack->clips().first();
+				pClip; pClip = pClip->next()) {
+			// Are any dirty changes pending commit?
+			if (pClip->isDirty()) {
+				qtractorMidiClip *pMidiClip
+					= static_cast<qtractorMidiClip *> (pClip);
+				if (pMidiClip)
+					pMidiClip->saveCopyFile(bUpdate);
+			}
+		}
+	}
+}
+
+
 bool qtractorMainForm::saveSessionFile ( const QString& sFilename )
 {
 	return saveSessionFileEx(sFilename, false, true);
@@ -2781,6 +2861,91 @@ void qtractorMainForm::hideNsmSession (void)
 }
 
 
+//-------------------------------------------------------------------------
+// qtractorAutoSaveThread -- Background auto-save writer.
+
+class qtractorAutoSaveThread : public QThread
+{
+public:
+
+	// Constructor (takes the serialized session document snapshot,
+	// its pending sidecar files and the dirty count it stands for).
+	qtractorAutoSaveThread(const QByteArray& data,
+		const QString& sFilename, const QByteArray& aHash,
+		const QStringList& blobs, const QHash<QString, QString>& pending,
+		int iDirtyCount)
+		: QThread(), m_data(data), m_sFilename(sFilename),
+			m_aHash(aHash), m_blobs(blobs), m_pending(pending),
+			m_iDirtyCount(iDirtyCount), m_bResult(false) {}
+
+	// Accessors.
+	const QString& filename() const { return m_sFilename; }
+	const QByteArray& hash() const { return m_aHash; }
+	int dirtyCount() const { return m_iDirtyCount; }
+	bool result() const { return m_bResult; }
+
+protected:
+
+	// The main thread executive.
+	void run()
+	{
+		const QByteArray& data = m_data;
+
+		// State sidecar files must be there before being referenced...
+		if (!qtractorDocument::writeBlobs(m_pending))
+			return;
+
+		// Nothing changed since last time, still there?
+		const QByteArray& aHash
+			= QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+		if (aHash == m_aHash && QFileInfo(m_sFilename).exists()) {
+			m_bResult = true;
+			return;
+		}
+
+		// Write it atomically: never leave a half-written file behind.
+	#if QT_VERSION >= 0x050100
+		QSaveFile file(m_sFilename);
+		if (file.open(QIODevice::WriteOnly)
+			&& file.write(data) == data.size())
+			m_bResult = file.commit();	// Includes fsync.
+		else
+			file.cancelWriting();
+	#else
+		const QString sTemp = m_sFilename + ".tmp";
+		QFile file(sTemp);
+		if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+			m_bResult = (file.write(data) == data.size() && file.flush());
+			file.close();
+			if (m_bResult) {
+				QFile::remove(m_sFilename);
+				m_bResult = QFile::rename(sTemp, m_sFilename);
+			}
+			if (!m_bResult)
+				QFile::remove(sTemp);
+		}
+	#endif
+
+		// Its state sidecar files are referenced from now on...
+		if (m_bResult) {
+			qtractorDocument::commitBlobs(m_sFilename, m_blobs);
+			m_aHash = aHash;
+		}
+	}
+
+private:
+
+	// Instance variables.
+	QByteArray    m_data;
+	QString       m_sFilename;
+	QByteArray    m_aHash;
+	QStringList   m_blobs;
+	QHash<QString, QString> m_pending;
+	int           m_iDirtyCount;
+	bool          m_bResult;
+};
+
+
 //-------------------------------------------------------------------------
 // qtractorMainForm -- auot-save executive methods.
 
@@ -2792,6 +2957,7 @@ void qtractorMainForm::autoSaveReset (void)
 #endif
 
 	m_iAutoSaveTimer = 0;
+	m_iAutoSaveDirty = 0;
 
 	if (m_pOptions->bAutoSaveEnabled)
 		m_iAutoSavePeriod = 60000 * m_pOptions->iAutoSavePeriod;
@@ -2800,9 +2966,14 @@ void qtractorMainForm::autoSaveReset (void)
 }
 
 
-// Execute auto-save routine...
+// Execute auto-save routine: take an in-memory snapshot of the
+// session document, leaving it to be written in the background,
+// along with any new state sidecar files it refers to.
 void qtractorMainForm::autoSaveSession (void)
 {
+	// Make sure the previous one is really over...
+	autoSaveFinish(true);
+
 	QString sAutoSaveDir = m_pOptions->sSessionDir;
 	if (sAutoSaveDir.isEmpty())
 		sAutoSaveDir = QDir::tempPath();
@@ -2827,11 +2998,65 @@ void qtractorMainForm::autoSaveSession (void)
 		sAutoSavePathname.toUtf8().constData());
 #endif
 
-	if (saveSessionFileEx(sAutoSavePathname, false, false)) {
-		m_pOptions->sAutoSavePathname = sAutoSavePathname;
-		m_pOptions->sAutoSaveFilename = m_sFilename;
-		m_pOptions->saveOptions();
+	// Trap dirty clips (only MIDI at this time...)
+	saveDirtyClips(false);
+
+	// Soft-house-keeping...
+	m_pSession->files()->cleanup(false);
+
+	// Take the snapshot...
+	QDomDocument document("qtractorSession");
+	qtractorSessionDocument sessionDocument(&document, m_pSession, m_pFiles);
+	QByteArray data;
+	if (!sessionDocument.snapshot(sAutoSavePathname, data)) {
+		appendMessagesError(
+			tr("Session could not be auto-saved\n"
+			"to \"%1\".\n\n"
+			"Sorry.").arg(sAutoSavePathname));
+		return;
 	}
+
+	// Write it all to disk in the background...
+	m_pAutoSaveThread = new qtractorAutoSaveThread(
+		data, sAutoSavePathname, m_aAutoSaveHash,
+		sessionDocument.blobs(), sessionDocument.pendingBlobs(),
+		m_iDirtyCount);
+	m_pAutoSaveThread->start(QThread::LowPriority);
+}
+
+
+// Auto-save completion (background writer clean-up).
+void qtractorMainForm::autoSaveFinish ( bool bWait )
+{
+	if (m_pAutoSaveThread == NULL)
+		return;
+
+	if (bWait)
+		m_pAutoSaveThread->wait();
+	else
+	if (!m_pAutoSaveThread->isFinished())
+		return;
+
+	const QString& sAutoSavePathname = m_pAutoSaveThread->filename();
+	if (m_pAutoSaveThread->result()) {
+		m_aAutoSaveHash = m_pAutoSaveThread->hash();
+		m_iAutoSaveDirty = m_pAutoSaveThread->dirtyCount();
+		if (m_pOptions->sAutoSavePathname != sAutoSavePathname
+			|| m_pOptions->sAutoSaveFilename != m_sFilename) {
+			m_pOptions->sAutoSavePathname = sAutoSavePathname;
+			m_pOptions->sAutoSaveFilename = m_sFilename;
+			m_pOptions->saveOptions();
+		}
+	} else {
+		m_aAutoSaveHash.clear();
+		appendMessagesError(
+			tr("Session could not be auto-saved\n"
+			"to \"%1\".\n\n"
+			"Sorry.").arg(sAutoSavePathname));
+	}
+
+	delete m_pAutoSaveThread;
+	m_pAutoSaveThread = NULL;
 }
 
 
@@ -2872,6 +3097,9 @@ bool qtractorMainForm::autoSaveOpen (void)
 // Auto-save/crash-recovery cleanup.
 void qtractorMainForm::autoSaveClose (void)
 {
+	// Make sure nothing gets written behind our back...
+	autoSaveFinish(true);
+
 	const QString& sAutoSavePathname = m_pOptions->sAutoSavePathname;
 
 #ifdef CONFIG_DEBUG_0
@@ -2886,10 +3114,80 @@ void qtractorMainForm::autoSaveClose (void)
 	m_pOptions->sAutoSavePathname.clear();
 	m_pOptions->sAutoSaveFilename.clear();
 
+	m_aAutoSaveHash.clear();
+
 	autoSaveReset();
 }
 
 
+// Open any lazy (deferred) clips under or just ahead of the play-head.
+int qtractorMainForm::openDeferClips ( unsigned long iPlayHead )
+{
+	const unsigned long iFrameAhead
+		= QTRACTOR_DEFER_AHEAD * m_pSession->sampleRate();
+
+	int iDeferClips = m_pSession->openDeferClips(
+		iPlayHead, iPlayHead + iFrameAhead);
+
+	// Mind the loop turn-around...
+	if (m_pSession->isLooping()) {
+		const unsigned long iLoopStart = m_pSession->loopStart();
+		iDeferClips += m_pSession->openDeferClips(
+			iLoopStart, iLoopStart + iFrameAhead);
+	}
+
+	return iDeferClips;
+}
+
+
+// Open all deferred clips and wait for pinned buffers preload.
+void qtractorMainForm::openPinnedClips (void)
+{
+	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+
+	// All clip files get open right away; each track
+	// sync thread will preload its own clips in parallel...
+	m_pSession->openDeferClips();
+
+	qtractorAudioBuffer::PinnedStats stats
+		= qtractorAudioBuffer::pinnedStats();
+	const int iPending = stats.pending;
+	if (iPending > 0) {
+		m_pProgressBar->setRange(0, iPending);
+		m_pProgressBar->reset();
+		m_pProgressBar->show();
+		// Don't wait forever on any stalled sync thread though;
+		// whatever remains will just get preloaded in background...
+		QElapsedTimer timer;
+		timer.start();
+		int iLastPending = iPending;
+		while (stats.pending > 0 && timer.elapsed() < 30000) {
+			m_pProgressBar->setValue(iPending - stats.pending);
+			QApplication::processEvents();
+			QThread::msleep(20);
+			stats = qtractorAudioBuffer::pinnedStats();
+			if (iLastPending != stats.pending) {
+				iLastPending = stats.pending;
+				timer.restart();
+			}
+		}
+		m_pProgressBar->hide();
+	}
+
+	QApplication::restoreOverrideCursor();
+
+	if (stats.bytes > 0) {
+		appendMessages(tr("Audio pinned in memory: %1 MB (%2 MB locked).")
+			.arg(stats.bytes >> 20).arg(stats.locked >> 20));
+		if (stats.locked < stats.bytes) {
+			appendMessagesColor(
+				tr("Not all pinned audio could be locked in RAM "
+				"(check the memlock resource limit)."), "#cc6633");
+		}
+	}
+}
+
+
 //-------------------------------------------------------------------------
 // qtractorMainForm -- File Action slots.
 
@@ -3732,6 +4030,41 @@ void qtractorMainForm::trackAutoMonitor ( bool bOn )
 }
 
 
+// Freeze (or thaw) current track.
+void qtractorMainForm::trackFreeze ( bool bOn )
+{
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorMainForm::trackFreeze(%d)", int(bOn));
+#endif
+
+	qtractorTrack *pTrack = NULL;
+	if (m_pTracks)
+		pTrack = m_pTracks->currentTrack();
+	if (pTrack == NULL)
+		return;
+
+	if (bOn) {
+		// Make sure it's post-fader...
+		QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+		const bool bResult = pTrack->freeze(true);
+		QApplication::restoreOverrideCursor();
+		if (bResult) {
+			appendMessages(tr("Track \"%1\" frozen to \"%2\".")
+				.arg(pTrack->trackName()).arg(pTrack->freezeFilename()));
+		} else {
+			appendMessagesError(
+				tr("Track could not be frozen:\n\n\"%1\".\n\nSorry.")
+				.arg(pTrack->trackName()));
+		}
+	} else {
+		pTrack->unfreeze();
+	}
+
+	dirtyNotifySlot();
+	stabilizeForm();
+}
+
+
 // Import some tracks from Audio file.
 void qtractorMainForm::trackImportAudio (void)
 {
@@ -4878,11 +5211,14 @@ void qtractorMainForm::viewOptions (void)
 	const bool    bOldPeakAutoRemove     = m_pOptions->bPeakAutoRemove;
 	const bool    bOldKeepToolsOnTop     = m_pOptions->bKeepToolsOnTop;
 	const int     iOldMaxRecentFiles     = m_pOptions->iMaxRecentFiles;
+	const int     iOldMaxUndoSize        = m_pOptions->iMaxUndoSize;
 	const int     iOldDisplayFormat      = m_pOptions->iDisplayFormat;
 	const int     iOldBaseFontSize       = m_pOptions->iBaseFontSize;
 	const int     iOldResampleType       = m_pOptions->iAudioResampleType;
 	const bool    bOldWsolaTimeStretch   = m_pOptions->bAudioWsolaTimeStretch;
 	const bool    bOldWsolaQuickSeek     = m_pOptions->bAudioWsolaQuickSeek;
+	const bool    bOldAudioPinned        = m_pOptions->bAudioPinned;
+	const int     iOldAudioPinnedBudget  = m_pOptions->iAudioPinnedBudget;
 	const bool    bOldAudioPlayerAutoConnect = m_pOptions->bAudioPlayerAutoConnect;
 	const bool    bOldAudioPlayerBus     = m_pOptions->bAudioPlayerBus;
 	const bool    bOldAudioMetronome     = m_pOptions->bAudioMetronome;
@@ -4949,6 +5285,20 @@ void qtractorMainForm::viewOptions (void)
 				m_pOptions->bAudioWsolaQuickSeek);
 			iNeedRestart |= RestartSession;
 		}
+		if (( bOldAudioPinned && !m_pOptions->bAudioPinned) ||
+			(!bOldAudioPinned &&  m_pOptions->bAudioPinned) ||
+			(iOldAudioPinnedBudget != m_pOptions->iAudioPinnedBudget)) {
+			qtractorAudioBuffer::setPinnedBudget(m_pOptions->bAudioPinned
+				? (unsigned long) qMax(0, m_pOptions->iAudioPinnedBudget) << 20
+				: 0);
+			iNeedRestart |= RestartSession;
+		}
+		// Anticipative (render-ahead) track processing...
+		m_pSession->audioEngine()->setRenderAhead(
+			m_pOptions->bAudioRenderAhead);
+		// Plugin-chain ring-out hold time...
+		qtractorPluginList::setSilentHold(
+			(unsigned int) qMax(0, m_pOptions->iAudioSilentHold));
 		// Audio engine control modes...
 		if (iOldTransportMode != m_pOptions->iTransportMode) {
 			++m_iDirtyCount; // Fake session properties change.
@@ -4995,6 +5345,12 @@ void qtractorMainForm::viewOptions (void)
 			(!bOldCompletePath &&  m_pOptions->bCompletePath) ||
 			(iOldMaxRecentFiles != m_pOptions->iMaxRecentFiles))
 			updateRecentFilesMenu();
+		if (iOldMaxUndoSize != m_pOptions->iMaxUndoSize) {
+			qtractorCommandList::setMaxSize(
+				(unsigned long) qMax(0, m_pOptions->iMaxUndoSize) << 20);
+			m_pSession->commands()->trimCommands();
+			stabilizeForm();
+		}
 		if (( bOldPeakAutoRemove && !m_pOptions->bPeakAutoRemove) ||
 			(!bOldPeakAutoRemove &&  m_pOptions->bPeakAutoRemove))
 			updatePeakAutoRemove();
@@ -5325,6 +5681,11 @@ void qtractorMainForm::transportPlay (void)
 
 	// Toggle playing...
 	const bool bPlaying = !m_pSession->isPlaying();
+
+	// Clips under the play-head must be ready, at least...
+	if (bPlaying && openDeferClips(m_pSession->playHead()) > 0)
+		m_pTracks->trackView()->updateContents();
+
 	if (setPlaying(bPlaying)) {
 		qtractorMidiEngine *pMidiEngine = m_pSession->midiEngine();
 		if (pMidiEngine) {
@@ -6470,6 +6831,95 @@ void qtractorMainForm::updatePeakAutoRemove (void)
 }
 
 
+// Reopen audio clips which got their transcoded cache ready.
+void qtractorMainForm::updateAudioCache (void)
+{
+	qtractorAudioCacheFactory *pCacheFactory
+		= m_pSession->audioCacheFactory();
+	if (pCacheFactory == NULL)
+		return;
+
+	const QStringList& files = pCacheFactory->readyFiles();
+	if (files.isEmpty())
+		return;
+
+	m_pSession->lock();
+
+	for (qtractorTrack *pTrack = m_pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		if (pTrack->trackType() != qtractorTrack::Audio)
+			continue;
+		bool bReopen = false;
+		for (qtractorClip *pClip = pTrack->clips().first();
+				pClip; pClip = pClip->next()) {
+			if (files.contains(pClip->filename())) {
+				pClip->open();
+				bReopen = true;
+			}
+		}
+		if (bReopen)
+			pTrack->resetRenderAhead();
+	}
+
+	m_pSession->unlock();
+
+	// Make sure all clips get back in place...
+	m_pSession->setPlayHead(m_pSession->playHead());
+}
+
+
+// Audio recording write-behind watchdog: warn well before
+// any recorded audio is to be dropped, due to slow disk I/O.
+void qtractorMainForm::updateAudioRecord (void)
+{
+	if (!m_pSession->isRecording() || m_pSession->audioRecord() < 1) {
+		m_iAudioRecordWarn = 0;
+		m_iAudioRecordDropped = 0;
+		return;
+	}
+
+	unsigned int iHighWater = 0;
+	unsigned long iDropped = 0;
+	QString sTrackName;
+
+	for (qtractorTrack *pTrack = m_pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		if (pTrack->trackType() != qtractorTrack::Audio)
+			continue;
+		qtractorAudioClip *pAudioClip
+			= static_cast<qtractorAudioClip *> (pTrack->clipRecord());
+		if (pAudioClip == NULL)
+			continue;
+		qtractorAudioBuffer *pBuff = pAudioClip->buffer();
+		if (pBuff == NULL)
+			continue;
+		const qtractorAudioBuffer::RecordStats& stats = pBuff->recordStats();
+		if (iHighWater < stats.highWater) {
+			iHighWater = stats.highWater;
+			sTrackName = pTrack->trackName();
+		}
+		iDropped += stats.dropped;
+	}
+
+	// Half-full is the early warning; then for each 10% up...
+	if (iHighWater >= 50 && iHighWater >= m_iAudioRecordWarn + 10) {
+		m_iAudioRecordWarn = iHighWater;
+		appendMessagesColor(
+			tr("Recording: disk write-behind buffer is %1% full "
+			"on track \"%2\" (disk too slow?)")
+			.arg(iHighWater).arg(sTrackName), "#cc6633");
+	}
+
+	if (iDropped > m_iAudioRecordDropped) {
+		appendMessagesColor(
+			tr("Recording: %1 frames have been dropped "
+			"(disk too slow).").arg(iDropped - m_iAudioRecordDropped),
+			"#cc0033");
+		m_iAudioRecordDropped = iDropped;
+	}
+}
+
+
 // Update main transport-time display format.
 void qtractorMainForm::updateDisplayFormat (void)
 {
@@ -6760,6 +7210,9 @@ void qtractorMainForm::updateTrackMenu (void)
 //	m_ui.trackAutoMonitorAction->setEnabled(m_pTracks != NULL);
 	m_ui.trackInstrumentMenu->setEnabled(
 		bEnabled && pTrack->trackType() == qtractorTrack::Midi);
+	m_ui.trackFreezeAction->setEnabled(bEnabled && !bPlaying
+		&& pTrack->trackType() == qtractorTrack::Audio);
+	m_ui.trackFreezeAction->setChecked(bEnabled && pTrack->isFrozen());
 
 	// Update track menu state...
 	if (bEnabled) {
@@ -7329,6 +7782,28 @@ void qtractorMainForm::fastTimerSlot (void)
 		// Done with transport tricks.
 	}
 
+	// Lazy (deferred) clips still to be open in the background,
+	// though not while batch workers walk through live clips...
+	if (!m_pSession->isBusy() && !qtractorTracks::isBatchBusy()
+		&& m_pSession->deferClipCount() > 0) {
+		// Whatever's under or just ahead of the play-head, first...
+		int iDeferClips = openDeferClips(m_pSession->playHead());
+		// Then whatever's in view, then all the rest, nearest first;
+		// while rolling, only those needing no lock (audio clips)...
+		qtractorTrackView *pTrackView = m_pTracks->trackView();
+		const int cx = pTrackView->contentsX();
+		const int cw = pTrackView->viewport()->width();
+		iDeferClips += m_pSession->openDeferClipsIdle(
+			m_pSession->frameFromPixel(cx),
+			m_pSession->frameFromPixel(cx + cw),
+			QTRACTOR_DEFER_MSECS);
+		if (iDeferClips > 0) {
+			pTrackView->updateContents();
+			if (m_pSession->deferClipCount() < 1)
+				appendMessages(tr("Session clips ready."));
+		}
+	}
+
 	// Always update meter values...
 	qtractorMeterValue::refreshAll();
 
@@ -7476,6 +7951,12 @@ void qtractorMainForm::slowTimerSlot (void)
 		}
 	}
 
+	// Audio recording write-behind watchdog...
+	updateAudioRecord();
+
+	// Anticipative (render-ahead) tracks come and go...
+	m_pSession->updateRenderAhead();
+
 	// Check if we've got some XRUN callbacks...
 	if (m_iXrunTimer > 0 && --m_iXrunTimer < 1) {
 		m_iXrunTimer = 0;
@@ -7502,6 +7983,15 @@ void qtractorMainForm::slowTimerSlot (void)
 		m_pTracks->trackView()->updateContents();
 	}
 
+	// Check if its time to switch clips over to their transcoded cache...
+	if (m_iAudioCacheTimer > 0 && --m_iAudioCacheTimer < 1) {
+		// Not while rolling, postpone...
+		if (m_pSession->isPlaying())
+			m_iAudioCacheTimer = 1;
+		else
+			updateAudioCache();
+	}
+
 	// Check if its time to refresh Audio connections...
 	if (m_iAudioRefreshTimer > 0 && --m_iAudioRefreshTimer < 1) {
 		m_iAudioRefreshTimer = 0;
@@ -7551,11 +8041,14 @@ void qtractorMainForm::slowTimerSlot (void)
 #endif
 
 	// Auto-save option routine...
+	autoSaveFinish();
 	if (m_iAutoSavePeriod > 0 && m_iDirtyCount > 0) {
 		m_iAutoSaveTimer += QTRACTOR_TIMER_DELAY;
 		if (m_iAutoSaveTimer > m_iAutoSavePeriod && !bPlaying) {
 			m_iAutoSaveTimer = 0;
-			autoSaveSession();
+			// Skip it if nothing changed since last snapshot...
+			if (m_iAutoSaveDirty != m_iDirtyCount)
+				autoSaveSession();
 		}
 	}
 
@@ -7588,6 +8081,15 @@ void qtractorMainForm::audioPeakNotify (void)
 }
 
 
+// Audio transcoding cache ready event handler.
+void qtractorMainForm::audioCacheNotify (void)
+{
+	// Some audio file has just been transcoded;
+	// clips will switch over as soon as possible...
+	if (m_iAudioCacheTimer < 2) ++m_iAudioCacheTimer;
+}
+
+
 // Custom audio shutdown event handler.
 void qtractorMainForm::audioShutNotify (void)
 {
@@ -8332,6 +8834,7 @@ void qtractorMainForm::updateDirtyCount ( bool bDirtyCount )
 		++m_iDirtyCount;
 	} else {
 		m_iDirtyCount = 0;
+		m_iAutoSaveDirty = 0;
 	}
 
 #ifdef CONFIG_NSM
@@ -8383,6 +8886,17 @@ void qtractorMainForm::dirtyNotifySlot (void)
 
 	updateDirtyCount(true);
 	selectionNotifySlot(NULL);
+
+	// Frozen and render-ahead tracks follow any content change...
+	for (qtractorTrack *pTrack = m_pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		if (pTrack->updateFreeze()) {
+			appendMessages(tr("Track \"%1\" unfrozen.")
+				.arg(pTrack->trackName()));
+		}
+		// Render-ahead lookahead goes stale too...
+		pTrack->refreshRenderAhead();
+	}
 }
 
 
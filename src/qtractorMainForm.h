@@ -58,6 +58,8 @@ class qtractorSubject;
 
 class qtractorNsmClient;
 
+class qtractorAutoSaveThread;
+
 class QLabel;
 class QComboBox;
 class QProgressBar;
@@ -178,6 +180,7 @@ public slots:
 	void trackHeightDown();
 	void trackHeightReset();
 	void trackAutoMonitor(bool bOn);
+	void trackFreeze(bool bOn);
 	void trackImportAudio();
 	void trackImportMidi();
 	void trackExportAudio();
@@ -298,6 +301,7 @@ protected slots:
 	void alsaNotify();
 
 	void audioPeakNotify();
+	void audioCacheNotify();
 	void audioShutNotify();
 	void audioXrunNotify();
 	void audioPortNotify();
@@ -405,6 +409,8 @@ protected:
 
 	void updateRecentFiles(const QString& sFilename);
 	void updatePeakAutoRemove();
+	void updateAudioCache();
+	void updateAudioRecord();
 	void updateMessagesFont();
 	void updateMessagesLimit();
 	void updateMessagesCapture();
@@ -438,8 +444,15 @@ protected:
 	bool autoSaveOpen();
 	void autoSaveReset();
 	void autoSaveSession();
+	void autoSaveFinish(bool bWait = false);
 	void autoSaveClose();
 
+	void saveDirtyClips(bool bUpdate);
+
+	int openDeferClips(unsigned long iPlayHead);
+
+	void openPinnedClips();
+
 private:
 
 	// The Qt-designer UI struct...
@@ -488,11 +501,17 @@ private:
 	int m_iXrunSkip;
 	int m_iXrunTimer;
 	int m_iAudioPeakTimer;
+	int m_iAudioCacheTimer;
+	unsigned int m_iAudioRecordWarn;
+	unsigned long m_iAudioRecordDropped;
 	int m_iAudioRefreshTimer;
 	int m_iMidiRefreshTimer;
 	int m_iPlayerTimer;
 	int m_iAutoSaveTimer;
 	int m_iAutoSavePeriod;
+	int m_iAutoSaveDirty;
+	QByteArray m_aAutoSaveHash;
+	qtractorAutoSaveThread *m_pAutoSaveThread;
 	int m_iAudioPropertyChange;
 
 	// Status bar item indexes
@@ -22,6 +22,7 @@
 #include "qtractorAbout.h"
 #include "qtractorMidiClip.h"
 #include "qtractorMidiEngine.h"
+#include "qtractorMidiFileCache.h"
 
 #include "qtractorSession.h"
 #include "qtractorFileList.h"
@@ -44,7 +45,8 @@
 #include <QFileInfo>
 #include <QPainter>
 
-#include <QDomDocument>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 
 #if QT_VERSION < 0x040500
@@ -176,6 +178,9 @@ qtractorMidiClip::qtractorMidiClip ( qtractorTrack *pTrack )
 	m_pKey  = NULL;
 	m_pData = NULL;
 
+	m_iFileTracks = 0;
+	m_iFileTicksPerBeat = 0;
+
 	m_iTrackChannel = 0;
 	m_iFormat = defaultFormat();
 	m_bSessionFlag = false;
@@ -195,6 +200,9 @@ qtractorMidiClip::qtractorMidiClip ( const qtractorMidiClip& clip )
 	m_pKey  = NULL;
 	m_pData = NULL;
 
+	m_iFileTracks = 0;
+	m_iFileTicksPerBeat = 0;
+
 	setFilename(clip.filename());
 	setTrackChannel(clip.trackChannel());
 	setClipGain(clip.clipGain());
@@ -369,12 +377,17 @@ bool qtractorMidiClip::openMidiFile (
 		}
 	}
 
-	// Create and open up the real MIDI file...
-	m_pFile = new qtractorMidiFile();
-	if (!m_pFile->open(sFilename, iMode)) {
-		delete m_pFile;
-		m_pFile = NULL;
-		return false;
+	// Create and open up the real MIDI file, unless it's
+	// just for reading, where the parsed file cache will do...
+	qtractorMidiFileCache *pMidiFileCache
+		= qtractorMidiFileCache::getInstance();
+	if (bWrite || m_bSessionFlag || pMidiFileCache == NULL) {
+		m_pFile = new qtractorMidiFile();
+		if (!m_pFile->open(sFilename, iMode)) {
+			delete m_pFile;
+			m_pFile = NULL;
+			return false;
+		}
 	}
 
 	// Initialize MIDI event container...
@@ -431,9 +444,30 @@ bool qtractorMidiClip::openMidiFile (
 		pSeq->setName(shortClipName(QFileInfo(m_pFile->filename()).baseName()));
 		pSeq->setChannel(pTrack->midiChannel());
 		// Nothing more as for writing...
+	} else if (m_pFile == NULL) {
+		// On read mode, get the event sequence in from cache...
+		qtractorMidiFileCache::Info info;
+		if (!pMidiFileCache->readTrack(
+				sFilename, iTrackChannel, pSeq, &info)) {
+			m_pData->detach(this);
+			delete m_pData;
+			m_pData = NULL;
+			return false;
+		}
+		// SMF format is properly given by the cached file.
+		setFormat(info.format);
+		m_iFileTracks = info.tracks;
+		m_iFileTicksPerBeat = info.ticksPerBeat;
+		// For immediate feedback, once...
+		m_noteMin = pSeq->noteMin();
+		m_noteMax = pSeq->noteMax();
+		// And initial clip name...
+		pSeq->setName(shortClipName(QFileInfo(sFilename).baseName()));
 	} else {
 		// On read mode, SMF format is properly given by open file.
 		setFormat(m_pFile->format());
+		m_iFileTracks = m_pFile->tracks();
+		m_iFileTicksPerBeat = m_pFile->ticksPerBeat();
 		// Read the event sequence in...
 		m_pFile->readTrack(pSeq, iTrackChannel);
 		// For immediate feedback, once...
@@ -490,6 +524,7 @@ bool qtractorMidiClip::openMidiFile (
 	if (iClipLength == 0) {
 		const unsigned long t1 = t0 + pSeq->timeLength();
 		setClipLength(pSession->frameFromTick(t1) - iClipStart);
+		pTrack->updateClip(this);
 	}
 
 	// Clip name should be clear about it all.
@@ -621,6 +656,10 @@ void qtractorMidiClip::setClipLengthEx ( unsigned long iClipLength )
 		qtractorMidiClip *pMidiClip = iter.next();
 		pMidiClip->setClipLength(iClipLength);
 		pMidiClip->updateHashKey();
+		// Clip (interval) index must follow...
+		qtractorTrack *pTrack = pMidiClip->track();
+		if (pTrack)
+			pTrack->updateClip(pMidiClip);
 	}
 
 	insertHashKey();
@@ -648,6 +687,17 @@ void qtractorMidiClip::resetEditorEx ( bool bSelectClear )
 		iter.next()->resetEditor(bSelectClear);
 }
 
+void qtractorMidiClip::changeEditorEx ( qtractorMidiEvent *pEvent,
+	unsigned long iTime, bool bBefore, bool bAfter )
+{
+	if (m_pData == NULL)
+		return;
+
+	QListIterator<qtractorMidiClip *> iter(m_pData->clips());
+	while (iter.hasNext())
+		iter.next()->changeEditor(pEvent, iTime, bBefore, bAfter);
+}
+
 
 // Sync all ref-counted clip-dirtyness.
 void qtractorMidiClip::setDirtyEx ( bool bDirty )
@@ -874,6 +924,7 @@ void qtractorMidiClip::close (void)
 		if (iClipLength < 1) {
 			iClipLength = pSession->frameFromTick(pSeq->duration());
 			setClipLength(iClipLength);
+			pTrack->updateClip(this);
 		}
 	}
 
@@ -1093,6 +1144,11 @@ bool qtractorMidiClip::startEditor ( QWidget *pParent )
 	if (pTrack == NULL)
 		return false;
 
+	// Lazy (deferred) clips must be open by now...
+	qtractorSession *pSession = pTrack->session();
+	if (pSession == NULL || !pSession->openDeferClip(this))
+		return false;
+
 	if (m_pMidiEditorForm == NULL) {
 		// Build up the editor form...
 		// What style do we create tool childs?
@@ -1143,6 +1199,19 @@ void qtractorMidiClip::resetEditor ( bool bSelectClear )
 }
 
 
+// Clip editor event change (pending).
+void qtractorMidiClip::changeEditor ( qtractorMidiEvent *pEvent,
+	unsigned long iTime, bool bBefore, bool bAfter )
+{
+	if (m_pMidiEditorForm == NULL)
+		return;
+
+	qtractorMidiEditor *pMidiEditor = m_pMidiEditorForm->editor();
+	if (pMidiEditor)
+		pMidiEditor->addChangeEvent(pEvent, iTime, bBefore, bAfter);
+}
+
+
 // Clip editor update.
 void qtractorMidiClip::updateEditor ( bool bSelectClear )
 {
@@ -1219,10 +1288,10 @@ QString qtractorMidiClip::toolTip (void) const
 	else
 		sToolTip += QObject::tr("Track %1").arg(m_iTrackChannel);
 
-	if (m_pFile) {
+	if (m_iFileTicksPerBeat > 0) {
 		sToolTip += QObject::tr(", %1 tracks, %2 tpqn")
-			.arg(m_pFile->tracks())
-			.arg(m_pFile->ticksPerBeat());
+			.arg(m_iFileTracks)
+			.arg(m_iFileTicksPerBeat);
 	}
 
 	const float fVolume = clipGain();
@@ -1264,42 +1333,41 @@ bool qtractorMidiClip::saveCopyFile ( bool bUpdate )
 
 
 // Virtual document element methods.
-bool qtractorMidiClip::loadClipElement (
-	qtractorDocument * /* pDocument */, QDomElement *pElement )
+bool qtractorMidiClip::loadClipStream (
+	qtractorDocument * /* pDocument */, QXmlStreamReader *pReader )
 {
-	// Load track children...
-	for (QDomNode nChild = pElement->firstChild();
-			!nChild.isNull();
-				nChild = nChild.nextSibling()) {
-		// Convert node to element...
-		QDomElement eChild = nChild.toElement();
-		if (eChild.isNull())
-			continue;
-		// Load track state..
-		if (eChild.tagName() == "filename")
-			qtractorMidiClip::setFilename(eChild.text());
-		else if (eChild.tagName() == "track-channel")
-			qtractorMidiClip::setTrackChannel(eChild.text().toUShort());
-		else if (eChild.tagName() == "revision")
-			qtractorMidiClip::setRevision(eChild.text().toUShort());
-		else if (eChild.tagName() == "editor-pos") {
-			const QStringList& sxy = eChild.text().split(',');
+	// Load clip children...
+	while (pReader->readNextStartElement()) {
+		const QString& sChild = pReader->name().toString();
+		// Load clip state..
+		if (sChild == "filename")
+			qtractorMidiClip::setFilename(pReader->readElementText());
+		else if (sChild == "track-channel")
+			qtractorMidiClip::setTrackChannel(
+				pReader->readElementText().toUShort());
+		else if (sChild == "revision")
+			qtractorMidiClip::setRevision(
+				pReader->readElementText().toUShort());
+		else if (sChild == "editor-pos") {
+			const QStringList& sxy = pReader->readElementText().split(',');
 			m_posEditor.setX(sxy.at(0).toInt());
-			m_posEditor.setY(sxy.at(1).toInt());
+			m_posEditor.setY(sxy.value(1).toInt());
 		}
-		else if (eChild.tagName() == "editor-size") {
-			const QStringList& swh = eChild.text().split(',');
+		else if (sChild == "editor-size") {
+			const QStringList& swh = pReader->readElementText().split(',');
 			m_sizeEditor.setWidth(swh.at(0).toInt());
-			m_sizeEditor.setHeight(swh.at(1).toInt());
+			m_sizeEditor.setHeight(swh.value(1).toInt());
 		}
+		else
+			pReader->skipCurrentElement();
 	}
 
-	return true;
+	return !pReader->hasError();
 }
 
 
-bool qtractorMidiClip::saveClipElement (
-	qtractorDocument *pDocument, QDomElement *pElement )
+bool qtractorMidiClip::saveClipStream (
+	qtractorDocument *pDocument, QXmlStreamWriter *pWriter )
 {
 	// Freeze current MIDI clip editor, if up and visible...
 	if (m_pMidiEditorForm && m_pMidiEditorForm->isVisible()) {
@@ -1307,24 +1375,24 @@ bool qtractorMidiClip::saveClipElement (
 		m_sizeEditor = m_pMidiEditorForm->size();
 	}
 
-	QDomElement eMidiClip = pDocument->document()->createElement("midi-clip");
-	pDocument->saveTextElement("filename",
-		qtractorMidiClip::relativeFilename(pDocument), &eMidiClip);
-	pDocument->saveTextElement("track-channel",
-		QString::number(qtractorMidiClip::trackChannel()), &eMidiClip);
-	pDocument->saveTextElement("revision",
-		QString::number(qtractorMidiClip::revision()), &eMidiClip);
+	pWriter->writeStartElement("midi-clip");
+	pWriter->writeTextElement("filename",
+		qtractorMidiClip::relativeFilename(pDocument));
+	pWriter->writeTextElement("track-channel",
+		QString::number(qtractorMidiClip::trackChannel()));
+	pWriter->writeTextElement("revision",
+		QString::number(qtractorMidiClip::revision()));
 	if (m_posEditor.x() >= 0 && m_posEditor.y() >= 0) {
-		pDocument->saveTextElement("editor-pos",
+		pWriter->writeTextElement("editor-pos",
 			QString::number(m_posEditor.x()) + ',' +
-			QString::number(m_posEditor.y()), &eMidiClip);
+			QString::number(m_posEditor.y()));
 	}
 	if (!m_sizeEditor.isNull() && m_sizeEditor.isValid()) {
-		pDocument->saveTextElement("editor-size",
+		pWriter->writeTextElement("editor-size",
 			QString::number(m_sizeEditor.width()) + ',' +
-			QString::number(m_sizeEditor.height()), &eMidiClip);
+			QString::number(m_sizeEditor.height()));
 	}
-	pElement->appendChild(eMidiClip);
+	pWriter->writeEndElement();
 
 	return true;
 }
@@ -129,6 +129,8 @@ public:
 	bool startEditor(QWidget *pParent = NULL);
 	void resetEditor(bool bSelectClear);
 	void updateEditor(bool bSelectClear);
+	void changeEditor(qtractorMidiEvent *pEvent,
+		unsigned long iTime, bool bBefore, bool bAfter);
 	void updateEditorContents();
 	bool queryEditor();
 
@@ -220,6 +222,8 @@ public:
 	// Sync all ref-counted clip editors.
 	void updateEditorEx(bool bSelectClear);
 	void resetEditorEx(bool bSelectClear);
+	void changeEditorEx(qtractorMidiEvent *pEvent,
+		unsigned long iTime, bool bBefore, bool bAfter);
 
 	// Sync all ref-counted clip-dirtyness.
 	void setDirtyEx(bool bDirty);
@@ -259,8 +263,8 @@ public:
 protected:
 
 	// Virtual document element methods.
-	bool loadClipElement(qtractorDocument *pDocument, QDomElement *pElement);
-	bool saveClipElement(qtractorDocument *pDocument, QDomElement *pElement);
+	bool loadClipStream(qtractorDocument *pDocument, QXmlStreamReader *pReader);
+	bool saveClipStream(qtractorDocument *pDocument, QXmlStreamWriter *pWriter);
 
 	// Private cleanup.
 	void closeMidiFile();
@@ -274,6 +278,10 @@ private:
 	// Instance variables.
 	qtractorMidiFile *m_pFile;
 
+	// SMF header info (as read).
+	unsigned short m_iFileTracks;
+	unsigned short m_iFileTicksPerBeat;
+
 	unsigned short m_iTrackChannel;
 	unsigned short m_iFormat;
 	bool           m_bSessionFlag;
@@ -43,14 +43,13 @@ qtractorMidiEditCommand::qtractorMidiEditCommand (
 // Destructor.
 qtractorMidiEditCommand::~qtractorMidiEditCommand (void)
 {
-	QListIterator<Item *> iter(m_items);
+	QVectorIterator<Item> iter(m_items);
 	while (iter.hasNext()) {
-		Item *pItem = iter.next();
-		if (pItem->autoDelete)
-			delete pItem->event;
+		const Item& item = iter.next();
+		if (item.autoDelete)
+			delete item.event;
 	}
 
-	qDeleteAll(m_items);
 	m_items.clear();
 }
 
@@ -58,21 +57,21 @@ qtractorMidiEditCommand::~qtractorMidiEditCommand (void)
 // Primitive command methods.
 void qtractorMidiEditCommand::insertEvent ( qtractorMidiEvent *pEvent )
 {
-	m_items.append(new Item(InsertEvent, pEvent));
+	m_items.append(Item(InsertEvent, pEvent));
 }
 
 
 void qtractorMidiEditCommand::moveEvent ( qtractorMidiEvent *pEvent,
 	int iNote, unsigned long iTime )
 {
-	m_items.append(new Item(MoveEvent, pEvent, iNote, iTime));
+	m_items.append(Item(MoveEvent, pEvent, iNote, iTime));
 }
 
 
 void qtractorMidiEditCommand::resizeEventTime ( qtractorMidiEvent *pEvent,
 	unsigned long iTime, unsigned long iDuration )
 {
-	m_items.append(new Item(ResizeEventTime, pEvent, 0, iTime, iDuration));
+	m_items.append(Item(ResizeEventTime, pEvent, 0, iTime, iDuration));
 }
 
 
@@ -82,13 +81,13 @@ void qtractorMidiEditCommand::resizeEventValue ( qtractorMidiEvent *pEvent,
 	if (pEvent->type() == qtractorMidiEvent::NOTEON && iValue < 1)
 		iValue = 1;	// Avoid zero velocity (aka. NOTEOFF)
 
-	m_items.append(new Item(ResizeEventValue, pEvent, 0, 0, 0, iValue));
+	m_items.append(Item(ResizeEventValue, pEvent, 0, 0, 0, iValue));
 }
 
 
 void qtractorMidiEditCommand::removeEvent ( qtractorMidiEvent *pEvent )
 {
-	m_items.append(new Item(RemoveEvent, pEvent));
+	m_items.append(Item(RemoveEvent, pEvent));
 }
 
 
@@ -96,11 +95,11 @@ void qtractorMidiEditCommand::removeEvent ( qtractorMidiEvent *pEvent )
 bool qtractorMidiEditCommand::findEvent ( qtractorMidiEvent *pEvent,
 	qtractorMidiEditCommand::CommandType cmd ) const
 {
-	QListIterator<Item *> iter(m_items);
+	QVectorIterator<Item> iter(m_items);
 	while (iter.hasNext()) {
-		Item *pItem = iter.next();
-		if (pItem->event == pEvent
-			&& (pItem->command == InsertEvent || pItem->command == cmd))
+		const Item& item = iter.next();
+		if (item.event == pEvent
+			&& (item.command == InsertEvent || item.command == cmd))
 			return true;
 	}
 	return false;
@@ -131,11 +130,9 @@ bool qtractorMidiEditCommand::execute ( bool bRedo )
 	int iSelectClear = 0;
 
 	// Changes are due...
-	QListIterator<Item *> iter(m_items);
-	if (!bRedo)
-		iter.toBack();
-	while (bRedo ? iter.hasNext() : iter.hasPrevious()) {
-		Item *pItem = (bRedo ? iter.next() : iter.previous());
+	const int iItems = m_items.count();
+	for (int i = 0; i < iItems; ++i) {
+		Item *pItem = &m_items[bRedo ? i : iItems - i - 1];
 		qtractorMidiEvent *pEvent = pItem->event;
 		// Execute the command item...
 		switch (pItem->command) {
@@ -209,6 +206,30 @@ bool qtractorMidiEditCommand::execute ( bool bRedo )
 	// Adjust edit-command result to prevent event overlapping.
 	if (bRedo && !m_bAdjusted) m_bAdjusted = adjust();
 
+	// Tell editors which events have changed, exactly
+	// (items are now holding the previous event state)...
+	const int iChangeItems = m_items.count();
+	for (int i = 0; i < iChangeItems; ++i) {
+		const Item& item = m_items.at(bRedo ? i : iChangeItems - i - 1);
+		qtractorMidiEvent *pEvent = item.event;
+		switch (item.command) {
+		case InsertEvent:
+			m_pMidiClip->changeEditorEx(pEvent, pEvent->time(), !bRedo, bRedo);
+			break;
+		case RemoveEvent:
+			m_pMidiClip->changeEditorEx(pEvent, pEvent->time(), bRedo, !bRedo);
+			break;
+		case MoveEvent:
+		case ResizeEventTime:
+			m_pMidiClip->changeEditorEx(pEvent, item.time, true, true);
+			break;
+		case ResizeEventValue:
+		default:
+			m_pMidiClip->changeEditorEx(pEvent, pEvent->time(), true, true);
+			break;
+		}
+	}
+
 	// Or are we changing something more durable?
 	if (pSeq->duration() != iOldDuration) {
 		pSeq->setTimeLength(pSeq->duration());
@@ -368,6 +389,25 @@ bool qtractorMidiEditCommand::adjust (void)
 }
 
 
+// Approximate memory footprint (in bytes).
+unsigned long qtractorMidiEditCommand::size (void) const
+{
+	unsigned long iSize = qtractorCommand::size()
+		+ sizeof(*this) - sizeof(qtractorCommand)
+		+ m_items.capacity() * sizeof(Item);
+
+	// Events held on behalf of the sequence...
+	QVectorIterator<Item> iter(m_items);
+	while (iter.hasNext()) {
+		const Item& item = iter.next();
+		if (item.command == InsertEvent || item.command == RemoveEvent)
+			iSize += sizeof(qtractorMidiEvent);
+	}
+
+	return iSize;
+}
+
+
 // Virtual command methods.
 bool qtractorMidiEditCommand::redo (void)
 {
@@ -26,7 +26,7 @@
 
 #include "qtractorMidiEvent.h"
 
-#include <QList>
+#include <QVector>
 
 
 // Forward declarations.
@@ -78,6 +78,9 @@ public:
 	// Adjust edit-command result to prevent event overlapping.
 	bool adjust();
 
+	// Approximate memory footprint (in bytes).
+	unsigned long size() const;
+
 protected:
 
 	// Common executive method.
@@ -85,30 +88,30 @@ protected:
 
 private:
 
-	// Event item struct.
+	// Event item struct (packed, stored by value).
 	struct Item
 	{
 		// Item constructor.
-		Item(CommandType cmd, qtractorMidiEvent *pEvent, int iNote = 0,
-			unsigned long iTime = 0, unsigned long iDuration = 0,
-			unsigned int iValue = 0)
-			: command(cmd), event(pEvent), note(iNote),
-				time(iTime), duration(iDuration), value(iValue),
+		Item(CommandType cmd = InsertEvent, qtractorMidiEvent *pEvent = NULL,
+			int iNote = 0, unsigned long iTime = 0,
+			unsigned long iDuration = 0, int iValue = 0)
+			: event(pEvent), time(iTime), duration(iDuration),
+				value(iValue), note(iNote), command(cmd),
 				autoDelete(false) {}
 		// Item members.
-		CommandType        command;
 		qtractorMidiEvent *event;
-		int                note;
 		unsigned long      time;
 		unsigned long      duration;
 		int                value;
+		unsigned char      note;
+		unsigned char      command;
 		bool               autoDelete;
 	};
 
 	// Instance variables.
 	qtractorMidiClip *m_pMidiClip;
 
-	QList<Item *> m_items;
+	QVector<Item> m_items;
 
 	bool m_bAdjusted;
 
@@ -4745,6 +4745,34 @@ void qtractorMidiEditor::contentsChangeNotify (void)
 }
 
 
+// Edit command event changes (merged, while pending).
+void qtractorMidiEditor::addChangeEvent ( qtractorMidiEvent *pEvent,
+	unsigned long iTime, bool bBefore, bool bAfter )
+{
+	ChangeEvents::Iterator iter = m_changeEvents.find(pEvent);
+	if (iter == m_changeEvents.end()) {
+		ChangeEvent change;
+		change.time   = iTime;
+		change.before = bBefore;
+		change.after  = bAfter;
+		m_changeEvents.insert(pEvent, change);
+	}
+	else iter.value().after = bAfter;
+}
+
+
+const qtractorMidiEditor::ChangeEvents& qtractorMidiEditor::changeEvents (void) const
+{
+	return m_changeEvents;
+}
+
+
+void qtractorMidiEditor::clearChangeEvents (void)
+{
+	m_changeEvents.clear();
+}
+
+
 // Emit note on/off.
 void qtractorMidiEditor::sendNote ( int iNote, int iVelocity )
 {
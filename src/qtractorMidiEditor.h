@@ -382,6 +382,23 @@ public:
 	static unsigned char snapToScale(
 		unsigned char note, int iKey, int iScale);
 
+	// Edit command event changes, pending for
+	// the event list incremental (row) update.
+	struct ChangeEvent
+	{
+		unsigned long time;	// Event time, before change.
+		bool before;		// Whether it was in sequence before.
+		bool after;			// Whether it is in sequence after.
+	};
+
+	typedef QHash<qtractorMidiEvent *, ChangeEvent> ChangeEvents;
+
+	void addChangeEvent(qtractorMidiEvent *pEvent,
+		unsigned long iTime, bool bBefore, bool bAfter);
+
+	const ChangeEvents& changeEvents() const;
+	void clearChangeEvents();
+
 public slots:
 
 	// Redirect selection/change notification.
@@ -688,6 +705,9 @@ private:
 	// Temporary sync-view/follow-playhead hold state.
 	bool m_bSyncViewHold;
 	int  m_iSyncViewHold;
+
+	// Pending edit command event changes.
+	ChangeEvents m_changeEvents;
 };
 
 
@@ -3463,6 +3463,9 @@ bool qtractorMidiEngine::fileExport (
 	if (iExportStart >= iExportEnd)
 		return false;
 
+	// Lazy (deferred) clips must be all open by now...
+	pSession->openDeferClips();
+
 	const unsigned short iTicksPerBeat
 		= pSession->ticksPerBeat();
 
@@ -0,0 +1,316 @@
+// qtractorMidiEvent.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2017, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorMidiEvent.h"
+
+#include <QMutex>
+#include <QThreadStorage>
+#include <QVector>
+
+#include <new>
+
+
+//----------------------------------------------------------------------
+// class qtractorMidiEventPool -- MIDI event slab allocator (singleton).
+//
+// Each thread allocates from and frees into its own (bounded) cache,
+// only going for the shared pool (and its lock) in whole batches.
+//
+
+class qtractorMidiEventPool
+{
+public:
+
+	// Constructor.
+	qtractorMidiEventPool() : m_pFreeList(NULL), m_iFreeCount(0) {}
+
+	// Allocate one event node.
+	void *alloc()
+	{
+		Cache *pCache = cache();
+		if (pCache->list == NULL)
+			fetch(pCache, BatchSize);
+
+		Node *pNode = pCache->list;
+		pCache->list = pNode->next;
+		--pCache->count;
+
+		return pNode;
+	}
+
+	// Reclaim one event node.
+	void free(void *pv)
+	{
+		Cache *pCache = cache();
+
+		Node *pNode = static_cast<Node *> (pv);
+		pNode->next = pCache->list;
+		pCache->list = pNode;
+		++pCache->count;
+
+		if (pCache->count > (BatchSize << 1))
+			flush(pCache, BatchSize);
+	}
+
+	// Make room for a bulk of event nodes, as one contiguous slab.
+	void reserve(unsigned int iNodes)
+	{
+		QMutexLocker locker(&m_mutex);
+
+		if (m_iFreeCount < iNodes)
+			grow(iNodes < SlabSize ? SlabSize : iNodes);
+	}
+
+	// Give back all slabs no event lives in anymore.
+	void release()
+	{
+		Cache *pCache = cache();
+		flush(pCache, pCache->count);
+
+		QMutexLocker locker(&m_mutex);
+
+		sweep();
+	}
+
+	// Singleton instance (never destroyed, as events may outlive it).
+	static qtractorMidiEventPool *getInstance()
+	{
+		static qtractorMidiEventPool *g_pPool = new qtractorMidiEventPool();
+		return g_pPool;
+	}
+
+protected:
+
+	// Number of event nodes per (default) slab
+	// and per transfer from/to a thread cache.
+	enum { SlabSize = 1024, BatchSize = 256 };
+
+	// Free node overlay.
+	struct Node { Node *next; };
+
+	// Slab descriptor.
+	struct Slab
+	{
+		Slab(char *p = NULL, unsigned int n = 0) : data(p), nodes(n) {}
+
+		char *data;
+		unsigned int nodes;
+	};
+
+	// Per-thread free node cache (handed back on thread exit).
+	struct Cache
+	{
+		Cache() : list(NULL), count(0) {}
+		~Cache() { getInstance()->flush(this, count); }
+
+		Node *list;
+		unsigned int count;
+	};
+
+	// Current thread free node cache.
+	Cache *cache()
+	{
+		Cache *pCache = m_cache.localData();
+		if (pCache == NULL) {
+			pCache = new Cache();
+			m_cache.setLocalData(pCache);
+		}
+		return pCache;
+	}
+
+	// Move a batch of free nodes from the pool into a thread cache.
+	void fetch(Cache *pCache, unsigned int iNodes)
+	{
+		QMutexLocker locker(&m_mutex);
+
+		if (m_iFreeCount < iNodes)
+			grow(SlabSize);
+
+		Node *pList = m_pFreeList;
+		Node *pLast = pList;
+		for (unsigned int i = 1; i < iNodes; ++i)
+			pLast = pLast->next;
+		m_pFreeList = pLast->next;
+		m_iFreeCount -= iNodes;
+
+		pLast->next = pCache->list;
+		pCache->list = pList;
+		pCache->count += iNodes;
+	}
+
+	// Move a batch of free nodes from a thread cache back into the pool.
+	void flush(Cache *pCache, unsigned int iNodes)
+	{
+		if (iNodes < 1)
+			return;
+
+		Node *pList = pCache->list;
+		Node *pLast = pList;
+		for (unsigned int i = 1; i < iNodes; ++i)
+			pLast = pLast->next;
+		pCache->list = pLast->next;
+		pCache->count -= iNodes;
+
+		QMutexLocker locker(&m_mutex);
+
+		pLast->next = m_pFreeList;
+		m_pFreeList = pList;
+		m_iFreeCount += iNodes;
+	}
+
+	// Allocate a new slab, prepending its nodes to the free-list
+	// in address order, so that the next ones come out adjacent.
+	void grow(unsigned int iNodes)
+	{
+		const size_t iNodeSize = sizeof(qtractorMidiEvent);
+		char *pSlab = static_cast<char *> (::operator new(iNodes * iNodeSize));
+		for (unsigned int i = iNodes; i > 0; --i) {
+			Node *pNode = reinterpret_cast<Node *> (pSlab + (i - 1) * iNodeSize);
+			pNode->next = m_pFreeList;
+			m_pFreeList = pNode;
+		}
+		m_iFreeCount += iNodes;
+
+		// Keep slabs sorted by address...
+		int i = m_slabs.count();
+		m_slabs.append(Slab());
+		for ( ; i > 0 && m_slabs.at(i - 1).data > pSlab; --i)
+			m_slabs[i] = m_slabs.at(i - 1);
+		m_slabs[i] = Slab(pSlab, iNodes);
+	}
+
+	// Find which slab a free node belongs to (binary search).
+	int slab(Node *pNode) const
+	{
+		const char *p = reinterpret_cast<const char *> (pNode);
+		int lo = 0;
+		int hi = m_slabs.count() - 1;
+		while (lo < hi) {
+			const int mid = (lo + hi + 1) >> 1;
+			if (m_slabs.at(mid).data > p)
+				hi = mid - 1;
+			else
+				lo = mid;
+		}
+		return lo;
+	}
+
+	// Free all slabs whose nodes are all back in the pool (locked).
+	void sweep()
+	{
+		const int iSlabs = m_slabs.count();
+		if (iSlabs < 1)
+			return;
+
+		QVector<unsigned int> counts(iSlabs, 0);
+		Node *pNode = m_pFreeList;
+		for ( ; pNode; pNode = pNode->next)
+			++counts[slab(pNode)];
+
+		int iEmpty = 0;
+		for (int i = 0; i < iSlabs; ++i) {
+			if (counts.at(i) == m_slabs.at(i).nodes)
+				++iEmpty;
+		}
+		if (iEmpty < 1)
+			return;
+
+		// Unlink the nodes of empty slabs, keeping the rest in order...
+		Node *pList = NULL;
+		Node **ppLast = &pList;
+		pNode = m_pFreeList;
+		while (pNode) {
+			Node *pNext = pNode->next;
+			const int i = slab(pNode);
+			if (counts.at(i) == m_slabs.at(i).nodes) {
+				--m_iFreeCount;
+			} else {
+				*ppLast = pNode;
+				ppLast = &pNode->next;
+			}
+			pNode = pNext;
+		}
+		*ppLast = NULL;
+		m_pFreeList = pList;
+
+		// Now go with the empty slabs...
+		for (int i = iSlabs - 1; i >= 0; --i) {
+			if (counts.at(i) == m_slabs.at(i).nodes) {
+				::operator delete(m_slabs.at(i).data);
+				m_slabs.remove(i);
+			}
+		}
+	}
+
+private:
+
+	// Instance variables.
+	Node *m_pFreeList;
+	unsigned int m_iFreeCount;
+
+	QVector<Slab> m_slabs;
+
+	QMutex m_mutex;
+
+	QThreadStorage<Cache *> m_cache;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorMidiEvent -- Pooled (slab) allocation operators.
+//
+
+void *qtractorMidiEvent::operator new ( size_t iSize )
+{
+	if (iSize != sizeof(qtractorMidiEvent))
+		return ::operator new(iSize);
+
+	return qtractorMidiEventPool::getInstance()->alloc();
+}
+
+
+void qtractorMidiEvent::operator delete ( void *pvEvent, size_t iSize )
+{
+	if (pvEvent == NULL)
+		return;
+
+	if (iSize != sizeof(qtractorMidiEvent))
+		::operator delete(pvEvent);
+	else
+		qtractorMidiEventPool::getInstance()->free(pvEvent);
+}
+
+
+// Pre-allocate room for a bulk of events (eg. cloning sequences).
+void qtractorMidiEvent::reserve ( unsigned int iEvents )
+{
+	qtractorMidiEventPool::getInstance()->reserve(iEvents);
+}
+
+
+// Give back room no events live in anymore (eg. on session close).
+void qtractorMidiEvent::release (void)
+{
+	qtractorMidiEventPool::getInstance()->release();
+}
+
+
+// end of qtractorMidiEvent.cpp
@@ -73,6 +73,9 @@ public:
 		PROPRIETARY = 0x7f
 	};
 
+	// Small sysex data gets stored inline (no extra allocation).
+	enum { SysexInline = sizeof(unsigned char *) };
+
 	// Constructor.
 	qtractorMidiEvent(unsigned long time, EventType type,
 		unsigned short param = 0, unsigned short value = 0,
@@ -84,7 +87,7 @@ public:
 	qtractorMidiEvent(const qtractorMidiEvent& e)
 		: m_time(e.m_time), m_type(e.m_type)
 	{
-		if (m_type == SYSEX) {
+		if (m_type == SYSEX && e.m_v.iSysex > SysexInline) {
 			m_v.iSysex = e.m_v.iSysex;
 			m_u.pSysex = new unsigned char [m_v.iSysex];
 			::memcpy(m_u.pSysex, e.m_u.pSysex, m_v.iSysex);
@@ -97,7 +100,17 @@ public:
 
 	// Destructor.
 	~qtractorMidiEvent()
-		{ if (m_type == SYSEX && m_u.pSysex) delete [] m_u.pSysex; }
+		{ if (isSysexAlloc()) delete [] m_u.pSysex; }
+
+	// Pooled (slab) allocation operators.
+	static void *operator new (size_t iSize);
+	static void operator delete (void *pvEvent, size_t iSize);
+
+	// Pre-allocate room for a bulk of events (eg. cloning sequences).
+	static void reserve(unsigned int iEvents);
+
+	// Give back room no events live in anymore (eg. on session close).
+	static void release();
 
 	// Event properties accessors (getters).
 	unsigned long time()       const { return m_time; }
@@ -133,16 +146,22 @@ public:
 	void setDuration(unsigned long duration)     { m_u.duration = duration; }
 
 	// Sysex data accessors (SYSEX).
-	unsigned char *sysex()     const { return m_u.pSysex; }
+	unsigned char *sysex() const
+	{
+		return (m_v.iSysex > SysexInline
+			? m_u.pSysex : const_cast<unsigned char *> (m_u.aSysex));
+	}
+
 	unsigned short sysex_len() const { return m_v.iSysex; }
 
-	// Allocate and set a new sysex buffer.
+	// Allocate (if not small enough) and set a new sysex buffer.
 	void setSysex(unsigned char *pSysex, unsigned short iSysex)
 	{
-		if (m_type == SYSEX && m_u.pSysex) delete [] m_u.pSysex;
+		if (isSysexAlloc()) delete [] m_u.pSysex;
 		m_v.iSysex = iSysex;
-		m_u.pSysex = new unsigned char [m_v.iSysex];
-		::memcpy(m_u.pSysex, pSysex, m_v.iSysex);
+		if (m_v.iSysex > SysexInline)
+			m_u.pSysex = new unsigned char [m_v.iSysex];
+		::memcpy(sysex(), pSysex, m_v.iSysex);
 	}
 
 	// Special accessors for pitch-bend event types.
@@ -153,6 +172,10 @@ public:
 
 private:
 
+	// Whether sysex data is allocated (not inline).
+	bool isSysexAlloc() const
+		{ return (m_type == SYSEX && m_v.iSysex > SysexInline && m_u.pSysex); }
+
 	// Event instance members.
 	unsigned long  m_time;
 	EventType      m_type;
@@ -169,7 +192,8 @@ private:
 	// Extra event data.
 	union {
 		unsigned long  duration;	// type == NOTEON
-		unsigned char *pSysex;		// type == SYSEX
+		unsigned char *pSysex;		// type == SYSEX (allocated)
+		unsigned char  aSysex[SysexInline];	// type == SYSEX (inline)
 	} m_u;
 };
 
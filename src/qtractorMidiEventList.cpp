@@ -34,6 +34,8 @@
 #include <QComboBox>
 #include <QSpinBox>
 
+#include <QSet>
+
 #include <QContextMenuEvent>
 
 
@@ -44,8 +46,7 @@
 qtractorMidiEventListModel::qtractorMidiEventListModel (
 	qtractorMidiEditor *pEditor, QObject *pParent )
 	: QAbstractItemModel(pParent), m_pEditor(pEditor),
-		m_pSeq(NULL), m_iTimeOffset(0),
-		m_pEvent(NULL), m_iEvent(0)
+		m_pSeq(NULL), m_iTimeOffset(0)
 {
 	m_headers
 		<< tr("Time")
@@ -61,7 +62,7 @@ qtractorMidiEventListModel::qtractorMidiEventListModel (
 int qtractorMidiEventListModel::rowCount (
 	const QModelIndex& /*parent*/ ) const
 {
-	return (m_pSeq ? m_pSeq->events().count() : 0);
+	return m_items.count();
 }
 
 
@@ -156,15 +157,20 @@ void qtractorMidiEventListModel::reset (void)
 {
 //	qDebug("reset()");
 
+#if QT_VERSION >= 0x050000
+	QAbstractItemModel::beginResetModel();
+#endif
+
 	m_pSeq = m_pEditor->sequence();
 
 	m_iTimeOffset = m_pEditor->timeOffset();
 
-	m_pEvent = NULL;
-	m_iEvent = 0;
+	buildItems(m_items);
+
+	// Any pending changes are now moot...
+	m_pEditor->clearChangeEvents();
 
 #if QT_VERSION >= 0x050000
-	QAbstractItemModel::beginResetModel();
 	QAbstractItemModel::endResetModel();
 #else
 	QAbstractItemModel::reset();
@@ -172,39 +178,298 @@ void qtractorMidiEventListModel::reset (void)
 }
 
 
-qtractorMidiEvent *qtractorMidiEventListModel::eventAt ( int i ) const
+// Incremental (fine-grained) row index update.
+void qtractorMidiEventListModel::update (void)
 {
-	if (m_pSeq == NULL)
-		return NULL;
+	// A whole different sequence (or offset) needs a full reset...
+	if (m_pSeq != m_pEditor->sequence()
+		|| m_iTimeOffset != m_pEditor->timeOffset()) {
+		reset();
+		return;
+	}
 
-	const int n = m_pSeq->events().count();
-	const int m = (n >> 1);
+	// Apply the last edit command changes, straight...
+	const qtractorMidiEditor::ChangeEvents& changes
+		= m_pEditor->changeEvents();
+	if (!changes.isEmpty()) {
+		const bool bUpdate = updateEvents(changes);
+		m_pEditor->clearChangeEvents();
+		if (bUpdate)
+			return;
+	}
+	else
+	if (m_pSeq == NULL || m_items.count() == m_pSeq->events().count())
+		return;
 
-	if (m_pEvent == NULL || i > m_iEvent + m || i < m_iEvent - m) {
-		if (i > m) {
-			m_iEvent = n - 1;
-			m_pEvent = m_pSeq->events().last();
-		} else {
-			m_iEvent = 0;
-			m_pEvent = m_pSeq->events().first();
+	// Otherwise go the long way (full diff)...
+	updateItems();
+}
+
+
+// Row index incremental update, from the editor pending changes.
+bool qtractorMidiEventListModel::updateEvents (
+	const qtractorMidiEditor::ChangeEvents& changes )
+{
+	if (m_pSeq == NULL)
+		return false;
+
+	// Way too many changes are better off with a full diff...
+	const int iChanges = changes.count();
+	if (iChanges > 16 && (iChanges << 2) > m_items.count())
+		return false;
+
+	const int iLastColumn = m_headers.count() - 1;
+
+	qtractorMidiEditor::ChangeEvents::ConstIterator iter
+		= changes.constBegin();
+	const qtractorMidiEditor::ChangeEvents::ConstIterator& iter_end
+		= changes.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		qtractorMidiEvent *pEvent = iter.key();
+		const qtractorMidiEditor::ChangeEvent& change = iter.value();
+		// Was it there already?
+		int iRow = -1;
+		if (change.before) {
+			iRow = rowOfEvent(pEvent, change.time);
+			if (iRow < 0)
+				return false;
+		}
+		// Gone for good?
+		if (!change.after) {
+			if (iRow >= 0) {
+				beginRemoveRows(QModelIndex(), iRow, iRow);
+				m_items.remove(iRow);
+				endRemoveRows();
+			}
+			continue;
+		}
+		Item item;
+		snapshotItem(item, pEvent);
+		// Brand new? (never twice)
+		if (iRow < 0) {
+			if (rowOfEvent(pEvent, item.time) >= 0)
+				return false;
+			iRow = rowFromTime(item.time);
+			beginInsertRows(QModelIndex(), iRow, iRow);
+			m_items.insert(iRow, item);
+			endInsertRows();
+			continue;
+		}
+		// Moved elsewhere? (persistent indexes are kept)
+		if (item.time != m_items.at(iRow).time) {
+			const int iNewRow = rowFromTime(item.time);
+			if (iNewRow != iRow && iNewRow != iRow + 1) {
+				beginMoveRows(QModelIndex(), iRow, iRow, QModelIndex(), iNewRow);
+				m_items.remove(iRow);
+				iRow = (iNewRow > iRow ? iNewRow - 1 : iNewRow);
+				m_items.insert(iRow, item);
+				endMoveRows();
+			}
 		}
+		// Changed in place...
+		m_items[iRow] = item;
+		emit dataChanged(
+			createIndex(iRow, 0, pEvent),
+			createIndex(iRow, iLastColumn, pEvent));
 	}
 
-	if (i > m_iEvent) {
-		while (m_pEvent && m_pEvent->next() && i > m_iEvent) {
-			m_pEvent = m_pEvent->next();
-			++m_iEvent;
+	// Must be in sync, otherwise fallback...
+	return (m_items.count() == m_pSeq->events().count());
+}
+
+
+// Row index full diff update (fallback).
+void qtractorMidiEventListModel::updateItems (void)
+{
+	QVector<Item> items;
+	buildItems(items);
+
+	const int iNewItems = items.count();
+	int iOldItems = m_items.count();
+
+	// Whether the very same events are still there, in order...
+	bool bSameEvents = (iNewItems == iOldItems);
+	for (int i = 0; bSameEvents && i < iNewItems; ++i)
+		bSameEvents = (items.at(i).event == m_items.at(i).event);
+
+	if (!bSameEvents) {
+		// 1. Remove rows of events which are gone, bottom-up...
+		QSet<qtractorMidiEvent *> news;
+		news.reserve(iNewItems);
+		for (int i = 0; i < iNewItems; ++i)
+			news.insert(items.at(i).event);
+		int i = iOldItems - 1;
+		while (i >= 0) {
+			if (news.contains(m_items.at(i).event)) {
+				--i;
+				continue;
+			}
+			const int iLast = i;
+			while (i > 0 && !news.contains(m_items.at(i - 1).event))
+				--i;
+			beginRemoveRows(QModelIndex(), i, iLast);
+			m_items.remove(i, iLast - i + 1);
+			endRemoveRows();
+			--i;
+		}
+		news.clear();
+		// 2. Re-order rows of remaining events (eg. moved)...
+		iOldItems = m_items.count();
+		QSet<qtractorMidiEvent *> olds;
+		olds.reserve(iOldItems);
+		for (i = 0; i < iOldItems; ++i)
+			olds.insert(m_items.at(i).event);
+		QVector<Item> keeps;
+		keeps.reserve(iOldItems);
+		for (i = 0; i < iNewItems; ++i) {
+			const Item& item = items.at(i);
+			if (olds.contains(item.event))
+				keeps.append(item);
+		}
+		bool bSameOrder = true;
+		for (i = 0; bSameOrder && i < iOldItems; ++i)
+			bSameOrder = (keeps.at(i).event == m_items.at(i).event);
+		if (!bSameOrder) {
+			emit layoutAboutToBeChanged();
+			const QModelIndexList& froms = persistentIndexList();
+			m_items = keeps;
+			QModelIndexList tos;
+			QListIterator<QModelIndex> iter(froms);
+			while (iter.hasNext()) {
+				const QModelIndex& from = iter.next();
+				const QModelIndex& to = indexOfEvent(eventOfIndex(from));
+				tos.append(to.isValid()
+					? createIndex(to.row(), from.column(), to.internalPointer())
+					: QModelIndex());
+			}
+			changePersistentIndexList(froms, tos);
+			emit layoutChanged();
+		}
+		keeps.clear();
+		// 3. Insert rows of brand new events, top-down...
+		i = 0;
+		while (i < iNewItems) {
+			if (olds.contains(items.at(i).event)) {
+				++i;
+				continue;
+			}
+			const int iFirst = i;
+			while (i < iNewItems - 1 && !olds.contains(items.at(i + 1).event))
+				++i;
+			beginInsertRows(QModelIndex(), iFirst, i);
+			m_items.insert(iFirst, i - iFirst + 1, Item());
+			for (int j = iFirst; j <= i; ++j)
+				m_items[j] = items.at(j);
+			endInsertRows();
+			++i;
 		}
 	}
-	else
-	if (i < m_iEvent) {
-		while (m_pEvent && m_pEvent->prev() && i < m_iEvent) {
-			m_pEvent = m_pEvent->prev();
-			--m_iEvent;
+
+	// 4. Finally, notify rows of events which have changed in place...
+	const int iLastColumn = m_headers.count() - 1;
+	int i = 0;
+	while (i < iNewItems) {
+		const Item& item = items.at(i);
+		const Item& old  = m_items.at(i);
+		if (item.time == old.time && item.type == old.type
+			&& item.param == old.param && item.value == old.value
+			&& item.duration == old.duration) {
+			++i;
+			continue;
 		}
+		const int iFirst = i;
+		m_items[i] = item;
+		while (++i < iNewItems) {
+			const Item& item2 = items.at(i);
+			const Item& old2  = m_items.at(i);
+			if (item2.time == old2.time && item2.type == old2.type
+				&& item2.param == old2.param && item2.value == old2.value
+				&& item2.duration == old2.duration)
+				break;
+			m_items[i] = item2;
+		}
+		emit dataChanged(
+			createIndex(iFirst, 0, m_items.at(iFirst).event),
+			createIndex(i - 1, iLastColumn, m_items.at(i - 1).event));
 	}
+}
+
+
+// Row index (re)builder.
+void qtractorMidiEventListModel::buildItems ( QVector<Item>& items ) const
+{
+	items.clear();
 
-	return m_pEvent;
+	if (m_pSeq == NULL)
+		return;
+
+	items.reserve(m_pSeq->events().count());
+
+	qtractorMidiEvent *pEvent = m_pSeq->events().first();
+	for ( ; pEvent; pEvent = pEvent->next()) {
+		Item item;
+		snapshotItem(item, pEvent);
+		items.append(item);
+	}
+}
+
+
+// Row index item (event snapshot) builder.
+void qtractorMidiEventListModel::snapshotItem (
+	Item& item, qtractorMidiEvent *pEvent ) const
+{
+	item.event = pEvent;
+	item.time  = pEvent->time();
+	item.type  = int(pEvent->type());
+	item.param = pEvent->param();
+	item.value = pEvent->value();
+	item.duration = (pEvent->type() == qtractorMidiEvent::NOTEON
+		? pEvent->duration() : 0);
+}
+
+
+// Row index binary search (first row at or after given time).
+int qtractorMidiEventListModel::rowFromTime ( unsigned long iTime ) const
+{
+	int iLow  = 0;
+	int iHigh = m_items.count();
+
+	while (iLow < iHigh) {
+		const int iMid = ((iLow + iHigh) >> 1);
+		if (m_items.at(iMid).time < iTime)
+			iLow = iMid + 1;
+		else
+			iHigh = iMid;
+	}
+
+	return iLow;
+}
+
+
+// Row of given event, at given (snapshot) time.
+int qtractorMidiEventListModel::rowOfEvent (
+	qtractorMidiEvent *pEvent, unsigned long iTime ) const
+{
+	const int iItems = m_items.count();
+
+	for (int i = rowFromTime(iTime); i < iItems; ++i) {
+		const Item& item = m_items.at(i);
+		if (item.event == pEvent)
+			return i;
+		if (item.time > iTime)
+			break;
+	}
+
+	return -1;
+}
+
+
+qtractorMidiEvent *qtractorMidiEventListModel::eventAt ( int i ) const
+{
+	if (i < 0 || i >= m_items.count())
+		return NULL;
+
+	return m_items.at(i).event;
 }
 
 
@@ -221,50 +486,31 @@ QModelIndex qtractorMidiEventListModel::indexOfEvent (
 	if (pEvent == NULL)
 		return QModelIndex();
 
-	const unsigned long iTime = pEvent->time();
-	if (indexFromTick(m_iTimeOffset + iTime).isValid()) {
-		while (m_pEvent != pEvent && m_pEvent->next()
-			&& m_pEvent->time() == iTime) {
-			m_pEvent = m_pEvent->next();
-			++m_iEvent;
-		}
-	}
+	const int iRow = rowOfEvent(pEvent, pEvent->time());
+	if (iRow < 0)
+		return QModelIndex();
 
-	return (m_pEvent == pEvent
-		? createIndex(m_iEvent, 0, m_pEvent) : QModelIndex());
+	return createIndex(iRow, 0, pEvent);
 }
 
 
 QModelIndex qtractorMidiEventListModel::indexFromTick (
 	unsigned long iTick ) const
 {
-	if (m_pEvent == NULL && m_pSeq) {
-		m_iEvent = 0;
-		m_pEvent = m_pSeq->events().first();
-	}
-
-	if (m_pEvent == NULL)
+	const int iItems = m_items.count();
+	if (iItems < 1)
 		return QModelIndex();
 
 	const unsigned long iTime
 		= (iTick > m_iTimeOffset ? iTick - m_iTimeOffset : 0);
 
-	if (m_pEvent->time() >= iTime) {
-		while (m_pEvent && m_pEvent->prev()
-			&& (m_pEvent->prev())->time() >= iTime) {
-			m_pEvent = m_pEvent->prev();
-			--m_iEvent;
-		}
-	}
-	else
-	while (m_pEvent && m_pEvent->next() && iTime > m_pEvent->time()) {
-		m_pEvent = m_pEvent->next();
-		++m_iEvent;
-	}
+	int iRow = rowFromTime(iTime);
+	if (iRow >= iItems)
+		iRow = iItems - 1;
 
-	//qDebug("indexFromTick(%lu) index=%d time=%lu", iTime, m_iEvent, m_pEvent->time());
+	//qDebug("indexFromTick(%lu) index=%d", iTime, iRow);
 
-	return createIndex(m_iEvent, 0, m_pEvent);
+	return createIndex(iRow, 0, m_items.at(iRow).event);
 }
 
 
@@ -774,13 +1020,8 @@ void qtractorMidiEventListView::refresh (void)
 	if (m_pListModel == NULL)
 		return;
 
-	QItemSelectionModel *pSelectionModel = QTreeView::selectionModel();
-
-	const QModelIndex& index = pSelectionModel->currentIndex();
-
-	m_pListModel->reset();
-
-	pSelectionModel->setCurrentIndex(index, QItemSelectionModel::NoUpdate);
+	// Current and selected rows are kept (persistent) across updates.
+	m_pListModel->update();
 }
 
 
@@ -845,6 +1086,41 @@ void qtractorMidiEventListView::selectEvent (
 }
 
 
+void qtractorMidiEventListView::selectEvents (
+	const QList<qtractorMidiEvent *>& events )
+{
+	if (m_pListModel == NULL)
+		return;
+
+	// Gather all rows first, then select contiguous ranges in one go...
+	QList<int> rows;
+	QListIterator<qtractorMidiEvent *> iter(events);
+	while (iter.hasNext()) {
+		const QModelIndex& index = m_pListModel->indexOfEvent(iter.next());
+		if (index.isValid())
+			rows.append(index.row());
+	}
+	qSort(rows.begin(), rows.end());
+
+	QItemSelection selection;
+	const int iLastColumn = m_pListModel->columnCount() - 1;
+	const int iRows = rows.count();
+	int i = 0;
+	while (i < iRows) {
+		const int iFirst = rows.at(i);
+		int iLast = iFirst;
+		while (++i < iRows && rows.at(i) <= iLast + 1)
+			iLast = rows.at(i);
+		selection.append(QItemSelectionRange(
+			m_pListModel->index(iFirst, 0),
+			m_pListModel->index(iLast, iLastColumn)));
+	}
+
+	QTreeView::selectionModel()->select(selection,
+		QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+}
+
+
 //----------------------------------------------------------------------------
 // qtractorMidiEventList -- MIDI Event List dockable window.
 
@@ -1041,16 +1317,13 @@ void qtractorMidiEventList::selectNotifySlot (
 
 	++m_iSelectUpdate;
 
-	m_pListView->clearSelection();
-
 	const QList<qtractorMidiEvent *>& list = pEditor->selectedEvents();
 	if (list.count() > 0) {
 		m_pListView->setCurrentIndex(
 			m_pListView->indexOfEvent(list.first()));
-		QListIterator<qtractorMidiEvent *> iter(list);
-		while (iter.hasNext())
-			m_pListView->selectEvent(iter.next(), true);
+		m_pListView->selectEvents(list);
 	}
+	else m_pListView->clearSelection();
 
 	--m_iSelectUpdate;
 }
@@ -22,16 +22,18 @@
 #ifndef __qtractorMidiEventList_h
 #define __qtractorMidiEventList_h
 
+#include "qtractorMidiEditor.h"
+
 #include <QAbstractItemModel>
 #include <QItemDelegate>
 #include <QTreeView>
 #include <QDockWidget>
 
+#include <QVector>
+
 
 // Forwards.
-class qtractorMidiEditor;
 class qtractorMidiSequence;
-class qtractorMidiEvent;
 
 
 //----------------------------------------------------------------------------
@@ -62,6 +64,9 @@ public:
 
 	void reset();
 
+	// Incremental (fine-grained) row index update.
+	void update();
+
 	// Specifics.
 	qtractorMidiEvent *eventOfIndex(const QModelIndex& index) const;
 	QModelIndex indexOfEvent(qtractorMidiEvent *pEvent) const;
@@ -78,6 +83,34 @@ protected:
 
 	qtractorMidiEvent *eventAt(int i) const;
 
+	// Row index item (event snapshot).
+	struct Item
+	{
+		qtractorMidiEvent *event;
+		unsigned long  time;
+		unsigned long  duration;
+		int            type;
+		unsigned short param;
+		unsigned short value;
+	};
+
+	// Row index (re)builder.
+	void buildItems(QVector<Item>& items) const;
+	void snapshotItem(Item& item, qtractorMidiEvent *pEvent) const;
+
+	// Row index incremental update, straight from the editor
+	// pending command changes; false if a full diff is due.
+	bool updateEvents(const qtractorMidiEditor::ChangeEvents& changes);
+
+	// Row index full diff update (fallback).
+	void updateItems();
+
+	// Row index binary search (first row at or after given time).
+	int rowFromTime(unsigned long iTime) const;
+
+	// Row of given event, at given (snapshot) time; -1 if not found.
+	int rowOfEvent(qtractorMidiEvent *pEvent, unsigned long iTime) const;
+
 	QString itemDisplay(const QModelIndex& index) const;
 	QString itemToolTip(const QModelIndex& index) const;
 
@@ -93,8 +126,8 @@ private:
 
 	unsigned long m_iTimeOffset;
 
-	mutable qtractorMidiEvent *m_pEvent;
-	mutable int m_iEvent;
+	// Row index (sorted by event time).
+	QVector<Item> m_items;
 };
 
 
@@ -167,6 +200,7 @@ public:
 
 	// Selections.
 	void selectEvent(qtractorMidiEvent *pEvent, bool bSelect = true);
+	void selectEvents(const QList<qtractorMidiEvent *>& events);
 
 private:
 
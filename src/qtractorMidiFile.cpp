@@ -21,12 +21,17 @@
 
 #include "qtractorAbout.h"
 #include "qtractorMidiFile.h"
+#include "qtractorMidiFileCache.h"
 
 #include "qtractorTimeScale.h"
 
 #include "qtractorMidiRpn.h"
 
 #include <QDir>
+#include <QFile>
+#include <QThread>
+#include <QList>
+#include <QPair>
 
 
 // Symbolic header markers.
@@ -107,6 +112,522 @@ public:
 
 
 
+//----------------------------------------------------------------------
+// class qtractorMidiFileReader -- SMF (memory-mapped) data reader.
+//
+class qtractorMidiFileReader
+{
+public:
+
+	// Constructor.
+	qtractorMidiFileReader ( const unsigned char *pData, unsigned long iSize,
+		unsigned long iOffset, unsigned long iLength )
+		: m_pData(pData), m_iSize(iSize),
+			m_iOffset(iOffset), m_iEnd(iOffset + iLength)
+		{ if (m_iEnd > m_iSize) m_iEnd = m_iSize; }
+
+	// Current position accessors.
+	unsigned long offset() const { return m_iOffset; }
+	bool atEnd() const { return (m_iOffset >= m_iEnd); }
+
+	// Force end-of-chunk.
+	void setEnd() { m_iOffset = m_iEnd; }
+
+	// Skip (forward) or go back (negative) some bytes.
+	void skip ( long n ) { m_iOffset += n; }
+
+	// Integer read method.
+	int readInt ( unsigned short n = 0 )
+	{
+		int c, val = 0;
+
+		if (n > 0) {
+			// Fixed length (n bytes) integer read.
+			for (int i = 0; i < n; ++i) {
+				if (m_iOffset >= m_iSize)
+					return -1;
+				c = m_pData[m_iOffset++];
+				val <<= 8;
+				val |= c;
+			}
+		} else {
+			// Variable length integer read.
+			do {
+				if (m_iOffset >= m_iSize)
+					return -1;
+				c = m_pData[m_iOffset++];
+				val <<= 7;
+				val |= (c & 0x7f);
+			}
+			while ((c & 0x80) == 0x80);
+		}
+
+		return val;
+	}
+
+	// Raw data read method.
+	int readData ( unsigned char *pData, unsigned int n )
+	{
+		if (m_iOffset >= m_iSize)
+			return 0;
+		if (n > m_iSize - m_iOffset)
+			n = m_iSize - m_iOffset;
+		::memcpy(pData, m_pData + m_iOffset, n);
+		m_iOffset += n;
+		return n;
+	}
+
+private:
+
+	// Instance variables.
+	const unsigned char *m_pData;
+	unsigned long m_iSize;
+	unsigned long m_iOffset;
+	unsigned long m_iEnd;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorMidiFileTrack -- SMF track chunk parser (re-entrant).
+//
+class qtractorMidiFileTrack
+{
+public:
+
+	// Constructor.
+	qtractorMidiFileTrack ( const unsigned char *pData, unsigned long iSize,
+		unsigned long iOffset, unsigned int iLength,
+		unsigned short iTicksPerBeat )
+		: m_reader(pData, iSize, iOffset, iLength),
+			m_iTicksPerBeat(iTicksPerBeat) {}
+
+	// Tempo/time-signature/marker meta event, as read.
+	struct Meta
+	{
+		unsigned long  tick;
+		unsigned short type;
+		float          tempo;
+		unsigned short beatsPerBar;
+		unsigned short beatDivisor;
+		QString        text;
+	};
+
+	// Tempo/time-signature/marker meta events accessor.
+	const QList<Meta>& metas() const { return m_metas; }
+
+	// Commit tempo/time-signature/marker meta events.
+	void commit ( qtractorMidiFileTempo *pTempoMap ) const
+	{
+		QListIterator<Meta> iter(m_metas);
+		while (iter.hasNext()) {
+			const Meta& meta = iter.next();
+			switch (meta.type) {
+			case qtractorMidiEvent::TEMPO:
+				pTempoMap->addNodeTempo(meta.tick, meta.tempo);
+				break;
+			case qtractorMidiEvent::TIME:
+				pTempoMap->addNodeTime(meta.tick,
+					meta.beatsPerBar, meta.beatDivisor);
+				break;
+			case qtractorMidiEvent::MARKER:
+				pTempoMap->addMarker(meta.tick, meta.text);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	// Sequence/track/channel reader.
+	bool read ( qtractorMidiSequence **ppSeqs, unsigned short iSeqs,
+		unsigned short iSeqTrack, unsigned short iTrack,
+		unsigned short iFormat, unsigned short iChannelFilter );
+
+	// Sequence/track/channel duration reader.
+	unsigned long readDuration ( unsigned short iChannelFilter );
+
+private:
+
+	// Instance variables.
+	qtractorMidiFileReader m_reader;
+	unsigned short m_iTicksPerBeat;
+
+	QList<Meta> m_metas;
+};
+
+
+// Sequence/track/channel reader.
+bool qtractorMidiFileTrack::read ( qtractorMidiSequence **ppSeqs,
+	unsigned short iSeqs, unsigned short iSeqTrack, unsigned short iTrack,
+	unsigned short iFormat, unsigned short iChannelFilter )
+{
+	// Expedite RPN/NRPN controllers processor...
+	qtractorMidiFileRpn xrpn;
+
+	qtractorMidiSequence *pSeq = NULL;
+
+	unsigned long iTrackTime  = 0;
+	unsigned int  iLastStatus = 0;
+	unsigned long iTimeout    = 0;
+
+	// While this track lasts...
+	while (!m_reader.atEnd()) {
+
+		// Read delta timestamp...
+		iTrackTime += m_reader.readInt();
+
+		// Read probable status byte...
+		unsigned int iStatus = m_reader.readInt(1);
+		// Maybe a running status byte?
+		if ((iStatus & 0x80) == 0) {
+			// Go back one byte...
+			m_reader.skip(-1);
+			iStatus = iLastStatus;
+		} else {
+			iLastStatus = iStatus;
+		}
+
+		const unsigned short iChannel = (iStatus & 0x0f);
+
+		qtractorMidiEvent *pEvent;
+		qtractorMidiEvent::EventType type
+			= qtractorMidiEvent::EventType(iStatus & 0xf0);
+		if (iStatus == qtractorMidiEvent::META)
+			type = qtractorMidiEvent::META;
+
+		// Make proper sequence reference...
+		unsigned short iSeq = 0;
+		if (iSeqs > 1)
+			iSeq = (iFormat == 0 ? iChannel : iTrack);
+		pSeq = ppSeqs[iSeq];
+
+		// Event time converted to sequence resolution...
+		const unsigned long iTime
+			= pSeq->timeq(iTrackTime, m_iTicksPerBeat);
+
+		// Check for sequence time length, if any...
+		if (pSeq->timeLength() > 0
+			&& iTime >= pSeq->timeOffset() + pSeq->timeLength()) {
+			break;
+		}
+
+		// Flush/timeout RPN/NRPN stuff...
+		if (iTimeout < iTime || type != qtractorMidiEvent::CONTROLLER) {
+			iTimeout = iTime + (pSeq->ticksPerBeat() >> 2);
+			xrpn.flush();
+		}
+
+		// Check whether it won't be channel filtered...
+		const bool bChannelEvent = (iTime >= pSeq->timeOffset()
+			&& ((iChannelFilter & 0xf0) || (iChannelFilter == iChannel)));
+
+		unsigned char *data, data1, data2;
+		unsigned int len, meta, bank;
+
+		switch (type) {
+		case qtractorMidiEvent::NOTEOFF:
+		case qtractorMidiEvent::NOTEON:
+			data1 = m_reader.readInt(1);
+			data2 = m_reader.readInt(1);
+			// Check if its channel filtered...
+			if (bChannelEvent) {
+				if (data2 == 0 && type == qtractorMidiEvent::NOTEON)
+					type = qtractorMidiEvent::NOTEOFF;
+				pEvent = new qtractorMidiEvent(iTime, type, data1, data2);
+				pSeq->addEvent(pEvent);
+				pSeq->setChannel(iChannel);
+			}
+			break;
+		case qtractorMidiEvent::KEYPRESS:
+			data1 = m_reader.readInt(1);
+			data2 = m_reader.readInt(1);
+			// Check if its channel filtered...
+			if (bChannelEvent) {
+				// Create the new event...
+				pEvent = new qtractorMidiEvent(iTime, type, data1, data2);
+				pSeq->addEvent(pEvent);
+				pSeq->setChannel(iChannel);
+			}
+			break;
+		case qtractorMidiEvent::CONTROLLER:
+			data1 = m_reader.readInt(1);
+			data2 = m_reader.readInt(1);
+			// Check if its channel filtered...
+			if (bChannelEvent) {
+				// Check for RPN/NRPN stuff...
+				if (xrpn.process(iTime, iSeqTrack,
+					(qtractorMidiRpn::CC | iChannel), data1, data2)) {
+					iTimeout = iTime + (pSeq->ticksPerBeat() >> 2);
+					break;
+				}
+				// Create the new event...
+				pEvent = new qtractorMidiEvent(iTime, type, data1, data2);
+				pSeq->addEvent(pEvent);
+				pSeq->setChannel(iChannel);
+				// Set the primordial bank patch...
+				switch (data1) {
+				case BANK_MSB:
+					// Bank MSB...
+					bank = (pSeq->bank() < 0 ? 0 : (pSeq->bank() & 0x007f));
+					pSeq->setBank(bank | (data2 << 7));
+					break;
+				case BANK_LSB:
+					// Bank LSB...
+					bank = (pSeq->bank() < 0 ? 0 : (pSeq->bank() & 0x3f80));
+					pSeq->setBank(bank | data2);
+					break;
+				default:
+					break;
+				}
+			}
+			break;
+		case qtractorMidiEvent::PGMCHANGE:
+			data1 = 0;
+			data2 = m_reader.readInt(1);
+			// Check if its channel filtered...
+			if (bChannelEvent) {
+				// Create the new event...
+				pEvent = new qtractorMidiEvent(iTime, type, data1, data2);
+				pSeq->addEvent(pEvent);
+				pSeq->setChannel(iChannel);
+				// Set the primordial program patch...
+				if (pSeq->prog() < 0)
+					pSeq->setProg(data2);
+			}
+			break;
+		case qtractorMidiEvent::CHANPRESS:
+			data1 = 0;
+			data2 = m_reader.readInt(1);
+			// Check if its channel filtered...
+			if (bChannelEvent) {
+				// Create the new event...
+				pEvent = new qtractorMidiEvent(iTime, type, data1, data2);
+				pSeq->addEvent(pEvent);
+				pSeq->setChannel(iChannel);
+			}
+			break;
+		case qtractorMidiEvent::PITCHBEND:
+			data1 = m_reader.readInt(1);
+			data2 = m_reader.readInt(1);
+			// Check if its channel filtered...
+			if (bChannelEvent) {
+				const unsigned short value = (data2 << 7) | data1;
+				// Create the new event...
+				pEvent = new qtractorMidiEvent(iTime, type, 0, value);
+				pSeq->addEvent(pEvent);
+				pSeq->setChannel(iChannel);
+			}
+			break;
+		case qtractorMidiEvent::SYSEX:
+			len = m_reader.readInt();
+			if ((int) len < 1) {
+				m_reader.setEnd(); // Force EoT!
+				break;
+			}
+			data = new unsigned char [1 + len];
+			data[0] = (unsigned char) type;	// Skip 0xf0 head.
+			if (m_reader.readData(&data[1], len) < (int) len) {
+				delete [] data;
+				return false;
+			}
+			// Check if its channel filtered...
+			if (bChannelEvent) {
+				pEvent = new qtractorMidiEvent(iTime, type);
+				pEvent->setSysex(data, 1 + len);
+				pSeq->addEvent(pEvent);
+				pSeq->setChannel(iChannel);
+			}
+			delete [] data;
+			break;
+		case qtractorMidiEvent::META:
+			meta = qtractorMidiEvent::MetaType(m_reader.readInt(1));
+			// Get the meta data...
+			len = m_reader.readInt();
+			if ((int) len < 1) {
+			//	m_reader.setEnd(); // Force EoT!
+				break;
+			}
+			if (meta == qtractorMidiEvent::TEMPO) {
+				Meta item;
+				item.tick  = iTrackTime;
+				item.type  = meta;
+				item.tempo = qtractorTimeScale::uroundf(
+					60000000.0f / float(m_reader.readInt(len)));
+				m_metas.append(item);
+			} else {
+				data = new unsigned char [len + 1];
+				if (m_reader.readData(data, len) < (int) len) {
+					delete [] data;
+					return false;
+				}
+				data[len] = (unsigned char) 0;
+				// Now, we'll deal only with some...
+				Meta item;
+				item.tick = iTrackTime;
+				item.type = meta;
+				switch (meta) {
+				case qtractorMidiEvent::TRACKNAME:
+					pSeq->setName(
+						QString::fromLatin1((const char *) data).simplified());
+					break;
+				case qtractorMidiEvent::TIME:
+					// Beats per bar is the numerator of time signature...
+					if ((unsigned short) data[0] > 0) {
+						item.beatsPerBar = (unsigned short) data[0];
+						item.beatDivisor = (unsigned short) data[1];
+						m_metas.append(item);
+					}
+					break;
+				case qtractorMidiEvent::MARKER:
+					item.text = QString::fromLatin1(
+						(const char *) data).simplified();
+					m_metas.append(item);
+					break;
+				default:
+					// Ignore all others...
+					break;
+				}
+				delete [] data;
+			}
+			// Fall thru...
+		default:
+			break;
+		}
+
+		// Flush/pending RPN/NRPN stuff...
+		xrpn.dequeue(pSeq);
+	}
+
+	// Flush/pending RPN/NRPN stuff, at end-of-track...
+	if (pSeq) {
+		xrpn.flush();
+		xrpn.dequeue(pSeq);
+	}
+
+	return true;
+}
+
+
+// Sequence/track/channel duration reader.
+unsigned long qtractorMidiFileTrack::readDuration (
+	unsigned short iChannelFilter )
+{
+	unsigned long iTrackDuration = 0;
+
+	unsigned long iTrackTime  = 0;
+	unsigned int  iLastStatus = 0;
+
+	// While this track lasts...
+	while (!m_reader.atEnd()) {
+
+		// Read delta timestamp...
+		iTrackTime += m_reader.readInt();
+
+		// Read probable status byte...
+		unsigned int iStatus = m_reader.readInt(1);
+		// Maybe a running status byte?
+		if ((iStatus & 0x80) == 0) {
+			// Go back one byte...
+			m_reader.skip(-1);
+			iStatus = iLastStatus;
+		} else {
+			iLastStatus = iStatus;
+		}
+
+		// Check whether it won't be channel filtered...
+		const unsigned short iChannel = (iStatus & 0x0f);
+		if ((iChannelFilter & 0xf0) || (iChannelFilter == iChannel))
+			iTrackDuration = iTrackTime;
+
+		qtractorMidiEvent::EventType type
+			= qtractorMidiEvent::EventType(iStatus & 0xf0);
+		if (iStatus == qtractorMidiEvent::META)
+			type = qtractorMidiEvent::META;
+
+		switch (type) {
+		case qtractorMidiEvent::NOTEOFF:
+		case qtractorMidiEvent::NOTEON:
+		case qtractorMidiEvent::KEYPRESS:
+		case qtractorMidiEvent::CONTROLLER:
+		case qtractorMidiEvent::PITCHBEND:
+			m_reader.readInt(2);
+			break;
+		case qtractorMidiEvent::PGMCHANGE:
+		case qtractorMidiEvent::CHANPRESS:
+			m_reader.readInt(1);
+			break;
+		case qtractorMidiEvent::META:
+			m_reader.readInt(1);
+			// Fall thru...
+		case qtractorMidiEvent::SYSEX:
+		{
+			const int n = m_reader.readInt();
+			if (n < 1)
+				m_reader.setEnd(); // Force EoT!
+			else
+				m_reader.skip(n);
+		}	// Fall thru...
+		default:
+			break;
+		}
+	}
+
+	return iTrackDuration;
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorMidiFileTrackThread -- SMF track chunk parser thread.
+//
+class qtractorMidiFileTrackThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorMidiFileTrackThread ( qtractorMidiSequence **ppSeqs,
+		unsigned short iSeqs, unsigned short iFormat )
+		: QThread(), m_ppSeqs(ppSeqs), m_iSeqs(iSeqs),
+			m_iFormat(iFormat), m_bResult(true) {}
+
+	// Track chunk parsers to run.
+	void addTrack ( unsigned short iTrack, qtractorMidiFileTrack *pTrack )
+		{ m_tracks.append(TrackItem(iTrack, pTrack)); }
+
+	// Overall parse result.
+	bool result() const { return m_bResult; }
+
+protected:
+
+	// The main thread executive.
+	void run ()
+	{
+		QListIterator<TrackItem> iter(m_tracks);
+		while (iter.hasNext() && m_bResult) {
+			const TrackItem& item = iter.next();
+			m_bResult = item.second->read(m_ppSeqs, m_iSeqs,
+				item.first, item.first, m_iFormat, 0xf0);
+		}
+	}
+
+private:
+
+	// Instance variables.
+	qtractorMidiSequence **m_ppSeqs;
+	unsigned short m_iSeqs;
+	unsigned short m_iFormat;
+
+	typedef QPair<unsigned short, qtractorMidiFileTrack *> TrackItem;
+	QList<TrackItem> m_tracks;
+
+	bool m_bResult;
+};
+
+
+// Minimum file size to have (SMF format 1) tracks parsed in parallel.
+static const unsigned long c_iParallelSize = 0x10000;
+
+
+
 //----------------------------------------------------------------------
 // class qtractorMidiFile -- A SMF (Standard MIDI File) class.
 //
@@ -119,6 +640,11 @@ qtractorMidiFile::qtractorMidiFile (void)
 	m_pFile         = NULL;
 	m_iOffset       = 0;
 
+	// Memory-mapped (read mode) file data.
+	m_pMapFile      = NULL;
+	m_pMapData      = NULL;
+	m_iMapSize      = 0;
+
 	// Header informational data.
 	m_iFormat       = 0;
 	m_iTracks       = 0;
@@ -146,74 +672,99 @@ bool qtractorMidiFile::open ( const QString& sFilename, int iMode )
 	if (iMode == None)
 		iMode = Read;
 
-	const QByteArray aFilename = sFilename.toUtf8();
-	m_pFile = ::fopen(aFilename.constData(), iMode == Write ? "w+b" : "rb");
-	if (m_pFile == NULL)
+	// Write mode goes through plain (buffered) file streaming...
+	if (iMode == Write) {
+		const QByteArray aFilename = sFilename.toUtf8();
+		m_pFile = ::fopen(aFilename.constData(), "w+b");
+		if (m_pFile == NULL)
+			return false;
+		// Any cached parse of this file is stale now...
+		qtractorMidiFileCache *pMidiFileCache
+			= qtractorMidiFileCache::getInstance();
+		if (pMidiFileCache)
+			pMidiFileCache->removeFile(sFilename);
+		m_sFilename = sFilename;
+		m_iMode     = iMode;
+		m_iOffset   = 0;
+		// Bail out of here...
+		return true;
+	}
+
+	// Read mode goes all in memory (mapped)...
+	m_pMapFile = new QFile(sFilename);
+	if (!m_pMapFile->open(QIODevice::ReadOnly)) {
+		delete m_pMapFile;
+		m_pMapFile = NULL;
 		return false;
+	}
+
+	m_iMapSize = m_pMapFile->size();
+	m_pMapData = m_pMapFile->map(0, m_iMapSize);
+	if (m_pMapData == NULL) {
+		// Not mappable? Read it all in then...
+		m_mapData = m_pMapFile->readAll();
+		m_iMapSize = m_mapData.size();
+		m_pMapData = (const unsigned char *) m_mapData.constData();
+	}
 
 	m_sFilename = sFilename;
 	m_iMode     = iMode;
 	m_iOffset   = 0;
 
-	// Bail out of here, if in write mode...
-	if (m_iMode == Write)
-		return true;
+	qtractorMidiFileReader reader(m_pMapData, m_iMapSize, 0, m_iMapSize);
 
 	// First word must identify the file as a SMF;
 	// must be literal "MThd"
 	char header[5];
-	readData((unsigned char *) &header[0], 4); header[4] = (char) 0;
+	reader.readData((unsigned char *) &header[0], 4); header[4] = (char) 0;
 	if (::strcmp(header, SMF_MTHD)) {
 		close();
 		return false;
 	}
 
 	// Second word should be the total header chunk length...
-	int iMThdLength = readInt(4);
+	int iMThdLength = reader.readInt(4);
 	if (iMThdLength < 6) {
 		close();
 		return false;
 	}
 
 	// Read header data...
-	m_iFormat = (unsigned short) readInt(2);
-	m_iTracks = (unsigned short) readInt(2);
-	m_iTicksPerBeat = (unsigned short) readInt(2);
+	m_iFormat = (unsigned short) reader.readInt(2);
+	m_iTracks = (unsigned short) reader.readInt(2);
+	m_iTicksPerBeat = (unsigned short) reader.readInt(2);
 	// Should skip any extra bytes...
-	while (iMThdLength > 6) {
-		if (::fgetc(m_pFile) < 0) {
-			close();
-			return false;
-		}
-		++m_iOffset;
-		--iMThdLength;
+	if (iMThdLength > 6)
+		reader.skip(iMThdLength - 6);
+	if (reader.offset() > m_iMapSize) {
+		close();
+		return false;
 	}
 
 	// Allocate the track map.
 	m_pTrackInfo = new TrackInfo [m_iTracks];
 	for (int iTrack = 0; iTrack < m_iTracks; ++iTrack) {
 		// Must be a track header "MTrk"...
-		readData((unsigned char *) &header[0], 4); header[4] = (char) 0;
+		if (reader.readData((unsigned char *) &header[0], 4) < 4) {
+			close();
+			return false;
+		}
+		header[4] = (char) 0;
 		if (::strcmp(header, SMF_MTRK)) {
 			close();
 			return false;
 		}
 		// Check track chunk length...
-		const int iMTrkLength = readInt(4);
+		const int iMTrkLength = reader.readInt(4);
 		if (iMTrkLength < 0) {
 			close();
 			return false;
 		}
 		// Set this one track info.
 		m_pTrackInfo[iTrack].length = iMTrkLength;
-		m_pTrackInfo[iTrack].offset = m_iOffset;
-		// Set next track offset...
-		m_iOffset += iMTrkLength;
+		m_pTrackInfo[iTrack].offset = reader.offset();
 		// Advance to next one...
-		if (::fseek(m_pFile, m_iOffset, SEEK_SET)) {
-			close();
-			return false;
-		}
+		reader.skip(iMTrkLength);
 	}
 
 	// Special tempo/time-signature map.
@@ -232,6 +783,18 @@ void qtractorMidiFile::close (void)
 		m_pFile = NULL;
 	}
 
+	if (m_pMapFile) {
+		if (m_mapData.isEmpty() && m_pMapData)
+			m_pMapFile->unmap((uchar *) m_pMapData);
+		m_pMapFile->close();
+		delete m_pMapFile;
+		m_pMapFile = NULL;
+	}
+
+	m_mapData.clear();
+	m_pMapData = NULL;
+	m_iMapSize = 0;
+
 	if (m_pTrackInfo) {
 		delete [] m_pTrackInfo;
 		m_pTrackInfo = NULL;
@@ -248,271 +811,82 @@ void qtractorMidiFile::close (void)
 bool qtractorMidiFile::readTracks ( qtractorMidiSequence **ppSeqs,
 	unsigned short iSeqs, unsigned short iTrackChannel )
 {
-	if (m_pFile == NULL)
+	if (m_pMapData == NULL)
 		return false;
 	if (m_pTempoMap == NULL)
 		return false;
 	if (m_iMode != Read)
 		return false;
 
-	// Expedite RPN/NRPN controllers processor...
-	qtractorMidiFileRpn xrpn;
-
 	// So, how many tracks are we reading in a row?...
 	const unsigned short iSeqTracks = (iSeqs > 1 ? m_iTracks : 1);
 
-	// Go fetch them...
-	for (unsigned short iSeqTrack = 0; iSeqTrack < iSeqTracks; ++iSeqTrack) {
-
-		// If under a format 0 file, we'll filter for one single channel.
-		if (iSeqTracks > 1)
-			iTrackChannel = iSeqTrack;
-
-		const unsigned short iTrack = (m_iFormat == 1 ? iTrackChannel : 0);
-		if (iTrack >= m_iTracks)
+	// Whether to split (SMF format 1) track chunks in parallel...
+	const bool bParallel = (iSeqTracks > 1 && m_iFormat == 1
+		&& m_iMapSize >= c_iParallelSize
+		&& QThread::idealThreadCount() > 1);
+
+	bool bResult = true;
+
+	if (bParallel) {
+		// Distribute track chunks among as many threads...
+		unsigned short iThreads = QThread::idealThreadCount();
+		if (iThreads > iSeqTracks)
+			iThreads = iSeqTracks;
+		QList<qtractorMidiFileTrack *> tracks;
+		QList<qtractorMidiFileTrackThread *> threads;
+		for (unsigned short i = 0; i < iThreads; ++i) {
+			threads.append(
+				new qtractorMidiFileTrackThread(ppSeqs, iSeqs, m_iFormat));
+		}
+		for (unsigned short iTrack = 0; iTrack < iSeqTracks; ++iTrack) {
+			qtractorMidiFileTrack *pTrack = new qtractorMidiFileTrack(
+				m_pMapData, m_iMapSize,
+				m_pTrackInfo[iTrack].offset,
+				m_pTrackInfo[iTrack].length, m_iTicksPerBeat);
+			threads.at(iTrack % iThreads)->addTrack(iTrack, pTrack);
+			tracks.append(pTrack);
+		}
+		// Go fetch them, all at once...
+		QListIterator<qtractorMidiFileTrackThread *> thread_iter(threads);
+		while (thread_iter.hasNext())
+			thread_iter.next()->start();
+		thread_iter.toFront();
+		while (thread_iter.hasNext()) {
+			qtractorMidiFileTrackThread *pThread = thread_iter.next();
+			pThread->wait();
+			if (!pThread->result())
+				bResult = false;
+		}
+		qDeleteAll(threads);
+		// Commit tempo/time-signature/markers, in track order...
+		QListIterator<qtractorMidiFileTrack *> track_iter(tracks);
+		while (track_iter.hasNext())
+			track_iter.next()->commit(m_pTempoMap);
+		qDeleteAll(tracks);
+		if (!bResult)
 			return false;
-
-		const unsigned short iChannelFilter
-			= (m_iFormat == 1 || iSeqs > 1 ? 0xf0 : iTrackChannel);
-
-		// Locate the desired track stuff...
-		const unsigned long iTrackStart = m_pTrackInfo[iTrack].offset;
-		if (iTrackStart != m_iOffset) {
-			if (::fseek(m_pFile, iTrackStart, SEEK_SET))
+	} else {
+		// Go fetch them, one at a time...
+		for (unsigned short iSeqTrack = 0; iSeqTrack < iSeqTracks; ++iSeqTrack) {
+			// If under a format 0 file, we'll filter for one single channel.
+			if (iSeqTracks > 1)
+				iTrackChannel = iSeqTrack;
+			const unsigned short iTrack = (m_iFormat == 1 ? iTrackChannel : 0);
+			if (iTrack >= m_iTracks)
+				return false;
+			const unsigned short iChannelFilter
+				= (m_iFormat == 1 || iSeqs > 1 ? 0xf0 : iTrackChannel);
+			// Locate the desired track stuff...
+			qtractorMidiFileTrack track(m_pMapData, m_iMapSize,
+				m_pTrackInfo[iTrack].offset,
+				m_pTrackInfo[iTrack].length, m_iTicksPerBeat);
+			// Now we're going into business...
+			bResult = track.read(ppSeqs, iSeqs,
+				iSeqTrack, iTrack, m_iFormat, iChannelFilter);
+			track.commit(m_pTempoMap);
+			if (!bResult)
 				return false;
-			m_iOffset = iTrackStart;
-		}
-
-		// Now we're going into business...
-		const unsigned long iTrackEnd
-			= m_iOffset + m_pTrackInfo[iTrack].length;
-
-		unsigned long iTrackTime  = 0;
-		unsigned int  iLastStatus = 0;
-		unsigned long iTimeout    = 0;
-
-		// While this track lasts...
-		while (m_iOffset < iTrackEnd) {
-
-			// Read delta timestamp...
-			iTrackTime += readInt();
-
-			// Read probable status byte...
-			unsigned int iStatus = readInt(1);
-			// Maybe a running status byte?
-			if ((iStatus & 0x80) == 0) {
-				// Go back one byte...
-				::ungetc(iStatus, m_pFile);
-				--m_iOffset;
-				iStatus = iLastStatus;
-			} else {
-				iLastStatus = iStatus;
-			}
-
-			const unsigned short iChannel = (iStatus & 0x0f);
-
-			qtractorMidiEvent *pEvent;
-			qtractorMidiEvent::EventType type
-				= qtractorMidiEvent::EventType(iStatus & 0xf0);
-			if (iStatus == qtractorMidiEvent::META)
-				type = qtractorMidiEvent::META;
-
-			// Make proper sequence reference...
-			unsigned short iSeq = 0;
-			if (iSeqs > 1)
-				iSeq = (m_iFormat == 0 ? iChannel : iTrack);
-			qtractorMidiSequence *pSeq = ppSeqs[iSeq];
-
-			// Event time converted to sequence resolution...
-			const unsigned long iTime
-				= pSeq->timeq(iTrackTime, m_iTicksPerBeat);
-
-			// Check for sequence time length, if any...
-			if (pSeq->timeLength() > 0
-				&& iTime >= pSeq->timeOffset() + pSeq->timeLength()) {
-				xrpn.flush();
-				xrpn.dequeue(pSeq);
-				break;
-			}
-
-			// Flush/timeout RPN/NRPN stuff...
-			if (iTimeout < iTime || type != qtractorMidiEvent::CONTROLLER) {
-				iTimeout = iTime + (pSeq->ticksPerBeat() >> 2);
-				xrpn.flush();
-			}
-
-			// Check whether it won't be channel filtered...
-			const bool bChannelEvent = (iTime >= pSeq->timeOffset()
-				&& ((iChannelFilter & 0xf0) || (iChannelFilter == iChannel)));
-
-			unsigned char *data, data1, data2;
-			unsigned int len, meta, bank;
-
-			switch (type) {
-			case qtractorMidiEvent::NOTEOFF:
-			case qtractorMidiEvent::NOTEON:
-				data1 = readInt(1);
-				data2 = readInt(1);
-				// Check if its channel filtered...
-				if (bChannelEvent) {
-					if (data2 == 0 && type == qtractorMidiEvent::NOTEON)
-						type = qtractorMidiEvent::NOTEOFF;
-					pEvent = new qtractorMidiEvent(iTime, type, data1, data2);
-					pSeq->addEvent(pEvent);
-					pSeq->setChannel(iChannel);
-				}
-				break;
-			case qtractorMidiEvent::KEYPRESS:
-				data1 = readInt(1);
-				data2 = readInt(1);
-				// Check if its channel filtered...
-				if (bChannelEvent) {
-					// Create the new event...
-					pEvent = new qtractorMidiEvent(iTime, type, data1, data2);
-					pSeq->addEvent(pEvent);
-					pSeq->setChannel(iChannel);
-				}
-				break;
-			case qtractorMidiEvent::CONTROLLER:
-				data1 = readInt(1);
-				data2 = readInt(1);
-				// Check if its channel filtered...
-				if (bChannelEvent) {
-					// Check for RPN/NRPN stuff...
-					if (xrpn.process(iTime, iSeqTrack,
-						(qtractorMidiRpn::CC | iChannel), data1, data2)) {
-						iTimeout = iTime + (pSeq->ticksPerBeat() >> 2);
-						break;
-					}
-					// Create the new event...
-					pEvent = new qtractorMidiEvent(iTime, type, data1, data2);
-					pSeq->addEvent(pEvent);
-					pSeq->setChannel(iChannel);
-					// Set the primordial bank patch...
-					switch (data1) {
-					case BANK_MSB:
-						// Bank MSB...
-						bank = (pSeq->bank() < 0 ? 0 : (pSeq->bank() & 0x007f));
-						pSeq->setBank(bank | (data2 << 7));
-						break;
-					case BANK_LSB:
-						// Bank LSB...
-						bank = (pSeq->bank() < 0 ? 0 : (pSeq->bank() & 0x3f80));
-						pSeq->setBank(bank | data2);
-						break;
-					default:
-						break;
-					}
-				}
-				break;
-			case qtractorMidiEvent::PGMCHANGE:
-				data1 = 0;
-				data2 = readInt(1);
-				// Check if its channel filtered...
-				if (bChannelEvent) {
-					// Create the new event...
-					pEvent = new qtractorMidiEvent(iTime, type, data1, data2);
-					pSeq->addEvent(pEvent);
-					pSeq->setChannel(iChannel);
-					// Set the primordial program patch...
-					if (pSeq->prog() < 0)
-						pSeq->setProg(data2);
-				}
-				break;
-			case qtractorMidiEvent::CHANPRESS:
-				data1 = 0;
-				data2 = readInt(1);
-				// Check if its channel filtered...
-				if (bChannelEvent) {
-					// Create the new event...
-					pEvent = new qtractorMidiEvent(iTime, type, data1, data2);
-					pSeq->addEvent(pEvent);
-					pSeq->setChannel(iChannel);
-				}
-				break;
-			case qtractorMidiEvent::PITCHBEND:
-				data1 = readInt(1);
-				data2 = readInt(1);
-				// Check if its channel filtered...
-				if (bChannelEvent) {
-					const unsigned short value = (data2 << 7) | data1;
-					// Create the new event...
-					pEvent = new qtractorMidiEvent(iTime, type, 0, value);
-					pSeq->addEvent(pEvent);
-					pSeq->setChannel(iChannel);
-				}
-				break;
-			case qtractorMidiEvent::SYSEX:
-				len = readInt();
-				if ((int) len < 1) {
-					m_iOffset = iTrackEnd; // Force EoT!
-					break;
-				}
-				data = new unsigned char [1 + len];
-				data[0] = (unsigned char) type;	// Skip 0xf0 head.
-				if (readData(&data[1], len) < (int) len) {
-					delete [] data;
-					return false;
-				}
-				// Check if its channel filtered...
-				if (bChannelEvent) {
-					pEvent = new qtractorMidiEvent(iTime, type);
-					pEvent->setSysex(data, 1 + len);
-					pSeq->addEvent(pEvent);
-					pSeq->setChannel(iChannel);
-				}
-				delete [] data;
-				break;
-			case qtractorMidiEvent::META:
-				meta = qtractorMidiEvent::MetaType(readInt(1));
-				// Get the meta data...
-				len = readInt();
-				if ((int) len < 1) {
-				//	m_iOffset = iTrackEnd; // Force EoT!
-					break;
-				}
-				if (meta == qtractorMidiEvent::TEMPO) {
-					m_pTempoMap->addNodeTempo(iTrackTime,
-						qtractorTimeScale::uroundf(
-							60000000.0f / float(readInt(len))));
-				} else {
-					data = new unsigned char [len + 1];
-					if (readData(data, len) < (int) len) {
-						delete [] data;
-						return false;
-					}
-					data[len] = (unsigned char) 0;
-					// Now, we'll deal only with some...
-					switch (meta) {
-					case qtractorMidiEvent::TRACKNAME:
-						pSeq->setName(
-							QString::fromLatin1((const char *) data).simplified());
-						break;
-					case qtractorMidiEvent::TIME:
-						// Beats per bar is the numerator of time signature...
-						if ((unsigned short) data[0] > 0) {
-							m_pTempoMap->addNodeTime(iTrackTime,
-								(unsigned short) data[0],
-								(unsigned short) data[1]);
-						}
-						break;
-					case qtractorMidiEvent::MARKER:
-						m_pTempoMap->addMarker(iTrackTime,
-							QString::fromLatin1((const char *) data).simplified());
-						break;
-					default:
-						// Ignore all others...
-						break;
-					}
-					delete [] data;
-				}
-				// Fall thru...
-			default:
-				break;
-			}
-
-			// Flush/pending RPN/NRPN stuff...
-			xrpn.dequeue(pSeq);
 		}
 	}
 
@@ -546,7 +920,7 @@ bool qtractorMidiFile::readTrack ( qtractorMidiSequence *pSeq,
 // Sequence/track/channel duration reader helper.
 unsigned long qtractorMidiFile::readTrackDuration ( unsigned short iTrackChannel )
 {
-	if (m_pFile == NULL)
+	if (m_pMapData == NULL)
 		return 0;
 	if (m_iMode != Read)
 		return 0;
@@ -559,79 +933,11 @@ unsigned long qtractorMidiFile::readTrackDuration ( unsigned short iTrackChannel
 		= (m_iFormat == 1 ? 0xf0 : iTrackChannel);
 
 	// Locate the desired track stuff...
-	const unsigned long iTrackStart = m_pTrackInfo[iTrack].offset;
-	if (iTrackStart != m_iOffset) {
-		if (::fseek(m_pFile, iTrackStart, SEEK_SET))
-			return 0;
-		m_iOffset = iTrackStart;
-	}
-
-	// Now we're going into business...
-	const unsigned long iTrackEnd
-		= m_iOffset + m_pTrackInfo[iTrack].length;
-
-	unsigned long iTrackDuration = 0;
-
-	unsigned long iTrackTime  = 0;
-	unsigned int  iLastStatus = 0;
-
-	// While this track lasts...
-	while (m_iOffset < iTrackEnd) {
+	qtractorMidiFileTrack track(m_pMapData, m_iMapSize,
+		m_pTrackInfo[iTrack].offset,
+		m_pTrackInfo[iTrack].length, m_iTicksPerBeat);
 
-		// Read delta timestamp...
-		iTrackTime += readInt();
-
-		// Read probable status byte...
-		unsigned int iStatus = readInt(1);
-		// Maybe a running status byte?
-		if ((iStatus & 0x80) == 0) {
-			// Go back one byte...
-			::ungetc(iStatus, m_pFile);
-			--m_iOffset;
-			iStatus = iLastStatus;
-		} else {
-			iLastStatus = iStatus;
-		}
-
-		// Check whether it won't be channel filtered...
-		const unsigned short iChannel = (iStatus & 0x0f);
-		if ((iChannelFilter & 0xf0) || (iChannelFilter == iChannel))
-			iTrackDuration = iTrackTime;
-
-		qtractorMidiEvent::EventType type
-			= qtractorMidiEvent::EventType(iStatus & 0xf0);
-		if (iStatus == qtractorMidiEvent::META)
-			type = qtractorMidiEvent::META;
-
-		switch (type) {
-		case qtractorMidiEvent::NOTEOFF:
-		case qtractorMidiEvent::NOTEON:
-		case qtractorMidiEvent::KEYPRESS:
-		case qtractorMidiEvent::CONTROLLER:
-		case qtractorMidiEvent::PITCHBEND:
-			readInt(2);
-			break;
-		case qtractorMidiEvent::PGMCHANGE:
-		case qtractorMidiEvent::CHANPRESS:
-			readInt(1);
-			break;
-		case qtractorMidiEvent::META:
-			readInt(1);
-			// Fall thru...
-		case qtractorMidiEvent::SYSEX:
-		{
-			int n = readInt();
-			if (n < 1 || ::fseek(m_pFile, m_iOffset + n, SEEK_SET))
-				m_iOffset = iTrackEnd; // Force EoT!
-			else
-				m_iOffset += n;
-		}	// Fall thru...
-		default:
-			break;
-		}
-	}
-
-	return iTrackDuration;
+	return track.readDuration(iChannelFilter);
 }
 
 
@@ -1129,48 +1435,6 @@ bool qtractorMidiFile::writeTrack ( qtractorMidiSequence *pSeq )
 }
 
 
-// Integer read method.
-int qtractorMidiFile::readInt ( unsigned short n )
-{
-	int c, val = 0;
-	
-	if (n > 0) {
-		// Fixed length (n bytes) integer read.
-		for (int i = 0; i < n; ++i) {
-			val <<= 8;
-			c = ::fgetc(m_pFile);
-			if (c < 0)
-				return -1;
-			val |= c;
-			++m_iOffset;
-		}
-	} else {
-		// Variable length integer read.
-		do {
-			c = ::fgetc(m_pFile);
-			if (c < 0)
-				return -1;
-			val <<= 7;
-			val |= (c & 0x7f);
-			++m_iOffset;
-		}
-		while ((c & 0x80) == 0x80);
-	}
-
-	return val;
-}
-
-
-// Raw data read method.
-int qtractorMidiFile::readData ( unsigned char *pData, unsigned short n )
-{
-	const int nread = ::fread(pData, sizeof(unsigned char), n, m_pFile);
-	if (nread > 0)
-		m_iOffset += nread;
-	return nread;
-}
-
-
 // Integer write method.
 int qtractorMidiFile::writeInt ( int val, unsigned short n )
 {
@@ -26,8 +26,12 @@
 
 #include "qtractorMidiFileTempo.h"
 
+#include <QByteArray>
+
 class qtractorTimeScale;
 
+class QFile;
+
 
 //----------------------------------------------------------------------
 // class qtractorMidiFile -- A SMF (Standard MIDI File) class.
@@ -90,10 +94,6 @@ public:
 
 protected:
 
-	// Read methods.
-	int readInt   (unsigned short n = 0);
-	int readData  (unsigned char *pData, unsigned short n);
-
 	// Write methods.
 	int writeInt  (int val, unsigned short n = 0);
 	int writeData (unsigned char *pData, unsigned short n);
@@ -114,6 +114,12 @@ private:
 	FILE          *m_pFile;
 	unsigned long  m_iOffset;
 
+	// Memory-mapped (read mode) file data.
+	QFile         *m_pMapFile;
+	const unsigned char *m_pMapData;
+	unsigned long  m_iMapSize;
+	QByteArray     m_mapData;
+
 	// Header informational data.
 	unsigned short m_iFormat;
 	unsigned short m_iTracks;
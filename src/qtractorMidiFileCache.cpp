@@ -0,0 +1,412 @@
+// qtractorMidiFileCache.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2017, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "qtractorAbout.h"
+#include "qtractorMidiFileCache.h"
+#include "qtractorMidiFile.h"
+
+#include <QFileInfo>
+
+
+//----------------------------------------------------------------------
+// class qtractorMidiFileCache -- Parsed SMF track cache (singleton).
+//
+
+// Cache hash key function.
+uint qHash ( const qtractorMidiFileCache::Key& key )
+{
+	return qHash(key.filename())
+		^ qHash(key.trackChannel())
+		^ qHash(key.ticksPerBeat());
+}
+
+
+// The pseudo-singleton instance.
+qtractorMidiFileCache *qtractorMidiFileCache::g_pMidiFileCache = NULL;
+
+// Singleton instance accessor.
+qtractorMidiFileCache *qtractorMidiFileCache::getInstance (void)
+{
+	return g_pMidiFileCache;
+}
+
+
+// Constructor.
+qtractorMidiFileCache::qtractorMidiFileCache ( unsigned long iMaxEvents )
+	: m_iEvents(0), m_iMaxEvents(iMaxEvents)
+{
+	// Pseudo-singleton reference setup.
+	g_pMidiFileCache = this;
+}
+
+
+// Default destructor.
+qtractorMidiFileCache::~qtractorMidiFileCache (void)
+{
+	clear();
+
+	// Pseudo-singleton reference shut-down.
+	g_pMidiFileCache = NULL;
+}
+
+
+// Maximum total of cached events accessors.
+void qtractorMidiFileCache::setMaxEvents ( unsigned long iMaxEvents )
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_iMaxEvents = iMaxEvents;
+
+	evictItems(Key());
+}
+
+unsigned long qtractorMidiFileCache::maxEvents (void) const
+{
+	return m_iMaxEvents;
+}
+
+
+// Cached track-channel reader.
+bool qtractorMidiFileCache::readTrack ( const QString& sFilename,
+	unsigned short iTrackChannel, qtractorMidiSequence *pSeq, Info *pInfo )
+{
+	const QFileInfo info(sFilename);
+	if (!info.isReadable())
+		return false;
+
+	const QDateTime& modified = info.lastModified();
+	const qint64 size = info.size();
+
+	const unsigned short iTicksPerBeat = pSeq->ticksPerBeat();
+	const Key key(info.absoluteFilePath(), iTrackChannel, iTicksPerBeat);
+
+	QMutexLocker locker(&m_mutex);
+
+	Item *pItem = fetchItem(key, modified, size, locker);
+	if (pItem == NULL)
+		return false;
+
+	// Clone events in range...
+	qtractorMidiSequence *pCacheSeq = pItem->seq;
+
+	const unsigned long iTimeStart  = pSeq->timeOffset();
+	const unsigned long iTimeLength = pSeq->timeLength();
+	const unsigned long iTimeEnd    = iTimeStart + iTimeLength;
+
+	qtractorMidiEvent::reserve(pCacheSeq->events().count());
+
+	qtractorMidiEvent *pEvent = pCacheSeq->events().first();
+	for ( ; pEvent; pEvent = pEvent->next()) {
+		const unsigned long iTime = pEvent->time();
+		if (iTimeLength > 0 && iTime >= iTimeEnd)
+			break;
+		if (iTime < iTimeStart)
+			continue;
+		qtractorMidiEvent *pNewEvent = new qtractorMidiEvent(*pEvent);
+		switch (pEvent->type()) {
+		case qtractorMidiEvent::NOTEON:
+			// Cut notes short at the end...
+			if (iTimeLength > 0 && iTime + pEvent->duration() > iTimeEnd)
+				pNewEvent->setDuration(iTimeEnd - iTime);
+			break;
+		case qtractorMidiEvent::CONTROLLER:
+			// Set the primordial bank patch...
+			if (pEvent->controller() == 0x00) {
+				// Bank MSB...
+				const int iBank = (pSeq->bank() < 0 ? 0 : (pSeq->bank() & 0x007f));
+				pSeq->setBank(iBank | (pEvent->value() << 7));
+			}
+			else
+			if (pEvent->controller() == 0x20) {
+				// Bank LSB...
+				const int iBank = (pSeq->bank() < 0 ? 0 : (pSeq->bank() & 0x3f80));
+				pSeq->setBank(iBank | pEvent->value());
+			}
+			break;
+		case qtractorMidiEvent::PGMCHANGE:
+			// Set the primordial program patch...
+			if (pSeq->prog() < 0)
+				pSeq->setProg(pEvent->value());
+			break;
+		default:
+			break;
+		}
+		pNewEvent->adjustTime(iTimeStart);
+		pSeq->insertEvent(pNewEvent);
+	}
+
+	pSeq->setName(pCacheSeq->name());
+	pSeq->setChannel(pCacheSeq->channel());
+
+	// Commit the sequence length...
+	pSeq->close();
+
+	if (pInfo)
+		*pInfo = pItem->info;
+
+	return true;
+}
+
+
+// Parse track-channel into cache, if not already (eg. prefetch).
+bool qtractorMidiFileCache::parseTrack ( const QString& sFilename,
+	unsigned short iTrackChannel, unsigned short iTicksPerBeat )
+{
+	const QFileInfo info(sFilename);
+	if (!info.isReadable())
+		return false;
+
+	const Key key(info.absoluteFilePath(), iTrackChannel, iTicksPerBeat);
+
+	QMutexLocker locker(&m_mutex);
+
+	return (fetchItem(key, info.lastModified(), info.size(), locker) != NULL);
+}
+
+
+// Cached track-channel item lookup, parsed if not already (locked).
+qtractorMidiFileCache::Item *qtractorMidiFileCache::fetchItem (
+	const Key& key, const QDateTime& modified, qint64 size,
+	QMutexLocker& locker )
+{
+	const unsigned short iTrackChannel = key.trackChannel();
+	const unsigned short iTicksPerBeat = key.ticksPerBeat();
+
+	// Still the same file?
+	Item *pItem = m_items.value(key, NULL);
+	if (pItem && (pItem->modified != modified || pItem->size != size)) {
+		removeItems(key.filename());
+		pItem = NULL;
+	}
+
+	// Parse it, if not already, but without holding
+	// any other reader back in the meantime...
+	if (pItem == NULL) {
+		locker.unlock();
+		Items items;
+		const bool bParse = parseFile(key.filename(),
+			iTrackChannel, iTicksPerBeat, modified, size, items);
+		locker.relock();
+		if (!bParse)
+			return NULL;
+		// Somebody else might have got there first...
+		pItem = m_items.value(key, NULL);
+		if (pItem && pItem->modified == modified && pItem->size == size) {
+			QListIterator<Item *> iter(items);
+			while (iter.hasNext()) {
+				Item *pParseItem = iter.next();
+				delete pParseItem->seq;
+				delete pParseItem;
+			}
+		} else {
+			pItem = NULL;
+			QListIterator<Item *> iter(items);
+			while (iter.hasNext()) {
+				Item *pParseItem = iter.next();
+				const Key item_key(key.filename(),
+					pParseItem->trackChannel, iTicksPerBeat);
+				insertItem(item_key, pParseItem);
+				if (pParseItem->trackChannel == iTrackChannel)
+					pItem = pParseItem;
+			}
+			if (pItem == NULL)
+				return NULL;
+		}
+	}
+
+	// Most recently used go last...
+	touchItem(key);
+
+	// Keep total cached events under limit...
+	evictItems(key);
+
+	return pItem;
+}
+
+
+// Parse file track-channel(s), out of cache (unlocked).
+bool qtractorMidiFileCache::parseFile (
+	const QString& sFilename, unsigned short iTrackChannel,
+	unsigned short iTicksPerBeat, const QDateTime& modified, qint64 size,
+	Items& items )
+{
+	qtractorMidiFile file;
+	if (!file.open(sFilename))
+		return false;
+
+	Info info;
+	info.format = file.format();
+	info.tracks = file.tracks();
+	info.ticksPerBeat = file.ticksPerBeat();
+
+	// SMF format 1: split and parse all tracks in one go...
+	const unsigned short iTracks = file.tracks();
+	if (info.format == 1 && iTracks > 1 && iTrackChannel < iTracks) {
+		qtractorMidiSequence **ppSeqs = new qtractorMidiSequence * [iTracks];
+		for (unsigned short iTrack = 0; iTrack < iTracks; ++iTrack)
+			ppSeqs[iTrack] = new qtractorMidiSequence(QString(), 0, iTicksPerBeat);
+		const bool bReadTracks = file.readTracks(ppSeqs, iTracks);
+		for (unsigned short iTrack = 0; iTrack < iTracks; ++iTrack) {
+			if (bReadTracks) {
+				Item *pTrackItem = new Item;
+				pTrackItem->modified = modified;
+				pTrackItem->size = size;
+				pTrackItem->info = info;
+				pTrackItem->trackChannel = iTrack;
+				pTrackItem->seq  = ppSeqs[iTrack];
+				items.append(pTrackItem);
+			}
+			else delete ppSeqs[iTrack];
+		}
+		delete [] ppSeqs;
+		if (bReadTracks)
+			return true;
+	}
+
+	// Just the one track-channel...
+	qtractorMidiSequence *pSeq
+		= new qtractorMidiSequence(QString(), 0, iTicksPerBeat);
+	if (!file.readTrack(pSeq, iTrackChannel)) {
+		delete pSeq;
+		return false;
+	}
+
+	Item *pItem = new Item;
+	pItem->modified = modified;
+	pItem->size = size;
+	pItem->info = info;
+	pItem->trackChannel = iTrackChannel;
+	pItem->seq  = pSeq;
+
+	items.append(pItem);
+
+	return true;
+}
+
+
+// Cache item management.
+void qtractorMidiFileCache::insertItem ( const Key& key, Item *pItem )
+{
+	removeItem(key);
+
+	m_items.insert(key, pItem);
+	m_keys.append(key);
+
+	m_iEvents += pItem->seq->events().count();
+}
+
+
+// Refresh item usage order (most recently used go last).
+void qtractorMidiFileCache::touchItem ( const Key& key )
+{
+	if (!m_keys.isEmpty() && m_keys.last() == key)
+		return;
+
+	if (m_keys.removeOne(key))
+		m_keys.append(key);
+}
+
+
+void qtractorMidiFileCache::removeItem ( const Key& key )
+{
+	Item *pItem = m_items.take(key);
+	if (pItem == NULL)
+		return;
+
+	m_keys.removeAll(key);
+
+	const unsigned long iEvents = pItem->seq->events().count();
+	m_iEvents = (m_iEvents > iEvents ? m_iEvents - iEvents : 0);
+
+	delete pItem->seq;
+	delete pItem;
+}
+
+
+// Keep total cached events under limit (least recently used go first),
+// but never the one item which is about to be used.
+void qtractorMidiFileCache::evictItems ( const Key& key )
+{
+	QList<Key>::Iterator iter = m_keys.begin();
+	while (m_iEvents > m_iMaxEvents && iter != m_keys.end()) {
+		if (*iter == key) {
+			++iter;
+			continue;
+		}
+		Item *pItem = m_items.take(*iter);
+		iter = m_keys.erase(iter);
+		if (pItem) {
+			const unsigned long iEvents = pItem->seq->events().count();
+			m_iEvents = (m_iEvents > iEvents ? m_iEvents - iEvents : 0);
+			delete pItem->seq;
+			delete pItem;
+		}
+	}
+}
+
+
+// Drop all cached tracks of a given file.
+void qtractorMidiFileCache::removeFile ( const QString& sFilename )
+{
+	QMutexLocker locker(&m_mutex);
+
+	removeItems(QFileInfo(sFilename).absoluteFilePath());
+}
+
+
+void qtractorMidiFileCache::removeItems ( const QString& sFilename )
+{
+	QList<Key> keys;
+	QListIterator<Key> iter(m_keys);
+	while (iter.hasNext()) {
+		const Key& key = iter.next();
+		if (key.filename() == sFilename)
+			keys.append(key);
+	}
+
+	QListIterator<Key> key_iter(keys);
+	while (key_iter.hasNext())
+		removeItem(key_iter.next());
+}
+
+
+// Cleanup method.
+void qtractorMidiFileCache::clear (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	QHash<Key, Item *>::ConstIterator iter = m_items.constBegin();
+	const QHash<Key, Item *>::ConstIterator& iter_end = m_items.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		Item *pItem = iter.value();
+		delete pItem->seq;
+		delete pItem;
+	}
+
+	m_items.clear();
+	m_keys.clear();
+
+	m_iEvents = 0;
+}
+
+
+// end of qtractorMidiFileCache.cpp
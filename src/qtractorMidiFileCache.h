@@ -0,0 +1,182 @@
+// qtractorMidiFileCache.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2017, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#ifndef __qtractorMidiFileCache_h
+#define __qtractorMidiFileCache_h
+
+#include <QString>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+
+#include <QMutex>
+
+
+// Forward declarations.
+class qtractorMidiSequence;
+
+
+//----------------------------------------------------------------------
+// class qtractorMidiFileCache -- Parsed SMF track cache (singleton).
+//
+// Whole SMF tracks (format 1) or channels (format 0) are parsed only
+// once, at a given resolution, and kept around for as long as the file
+// stays the same (modification time and size), so that any number of
+// clips referring to the same file track-channel just get cloned.
+//
+
+class qtractorMidiFileCache
+{
+public:
+
+	// Constructor.
+	qtractorMidiFileCache(unsigned long iMaxEvents = 0x100000);
+	// Default destructor.
+	~qtractorMidiFileCache();
+
+	// SMF header information.
+	struct Info
+	{
+		unsigned short format;
+		unsigned short tracks;
+		unsigned short ticksPerBeat;
+	};
+
+	// Cached track-channel reader, into the given sequence
+	// (time-offset/length windowed, at its own resolution);
+	// returns false if the file could not be parsed at all.
+	bool readTrack(const QString& sFilename,
+		unsigned short iTrackChannel, qtractorMidiSequence *pSeq,
+		Info *pInfo = NULL);
+
+	// Parse track-channel into cache, if not already (eg. prefetch).
+	bool parseTrack(const QString& sFilename,
+		unsigned short iTrackChannel, unsigned short iTicksPerBeat);
+
+	// Drop all cached tracks of a given file.
+	void removeFile(const QString& sFilename);
+
+	// Cleanup method.
+	void clear();
+
+	// Maximum total of cached events accessors.
+	void setMaxEvents(unsigned long iMaxEvents);
+	unsigned long maxEvents() const;
+
+	// Singleton instance accessor.
+	static qtractorMidiFileCache *getInstance();
+
+	// Cache hash key.
+	class Key
+	{
+	public:
+
+		// Constructor.
+		Key(const QString& sFilename = QString(),
+			unsigned short iTrackChannel = 0,
+			unsigned short iTicksPerBeat = 0)
+			: m_sFilename(sFilename),
+				m_iTrackChannel(iTrackChannel),
+				m_iTicksPerBeat(iTicksPerBeat) {}
+
+		// Key accessors.
+		const QString& filename() const
+			{ return m_sFilename; }
+		unsigned short trackChannel() const
+			{ return m_iTrackChannel; }
+		unsigned short ticksPerBeat() const
+			{ return m_iTicksPerBeat; }
+
+		// Match descriminator.
+		bool operator== (const Key& other) const
+		{
+			return m_sFilename     == other.filename()
+				&& m_iTrackChannel == other.trackChannel()
+				&& m_iTicksPerBeat == other.ticksPerBeat();
+		}
+
+	private:
+
+		// Interesting variables.
+		QString        m_sFilename;
+		unsigned short m_iTrackChannel;
+		unsigned short m_iTicksPerBeat;
+	};
+
+protected:
+
+	// Cached (whole) track-channel item.
+	struct Item
+	{
+		QDateTime modified;
+		qint64    size;
+		Info      info;
+		unsigned short trackChannel;
+		qtractorMidiSequence *seq;
+	};
+
+	typedef QList<Item *> Items;
+
+	// Cached track-channel item lookup, parsed if not already (locked).
+	Item *fetchItem(const Key& key, const QDateTime& modified, qint64 size,
+		QMutexLocker& locker);
+
+	// Parse file track-channel(s), out of cache (unlocked).
+	bool parseFile(const QString& sFilename, unsigned short iTrackChannel,
+		unsigned short iTicksPerBeat, const QDateTime& modified, qint64 size,
+		Items& items);
+
+	// Cache item management.
+	void insertItem(const Key& key, Item *pItem);
+	void touchItem(const Key& key);
+	void removeItem(const Key& key);
+	void removeItems(const QString& sFilename);
+
+	// Keep total cached events under limit.
+	void evictItems(const Key& key);
+
+private:
+
+	// Cache mutex.
+	QMutex m_mutex;
+
+	// The cached items, in least recently used order.
+	QHash<Key, Item *> m_items;
+	QList<Key> m_keys;
+
+	// Total cached events and limit.
+	unsigned long m_iEvents;
+	unsigned long m_iMaxEvents;
+
+	// The pseudo-singleton instance.
+	static qtractorMidiFileCache *g_pMidiFileCache;
+};
+
+
+// Cache hash key function.
+uint qHash(const qtractorMidiFileCache::Key& key);
+
+
+#endif  // __qtractorMidiFileCache_h
+
+
+// end of qtractorMidiFileCache.h
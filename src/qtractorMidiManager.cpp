@@ -419,6 +419,9 @@ qtractorMidiManager::qtractorMidiManager (
 	m_pMidiParser(NULL),
 #endif
 	m_iEventBuffer(0),
+	m_iEventFormats(EventAll),
+	m_pMidiEvents(NULL), m_iMidiEvents(0),
+	m_pMidiData(NULL), m_iMidiDataSize(0),
 	m_bAudioOutputBus(pPluginList->isAudioOutputBus()),
 	m_sAudioOutputBusName(pPluginList->audioOutputBusName()),
 	m_bAudioOutputAutoConnect(pPluginList->isAudioOutputAutoConnect()),
@@ -433,6 +436,11 @@ qtractorMidiManager::qtractorMidiManager (
 
 	m_pEventBuffer = new snd_seq_event_t [MaxMidiEvents];
 
+	// Raw MIDI event buffer and (decoded) data pool...
+	m_pMidiEvents = new MidiEvent [MaxMidiEvents];
+	m_iMidiDataSize = (MaxMidiEvents << 2) + c_iMaxMidiData;
+	m_pMidiData = new unsigned char [m_iMidiDataSize];
+
 #ifdef CONFIG_MIDI_PARSER
 	if (snd_midi_event_new(c_iMaxMidiData, &m_pMidiParser) == 0)
 		snd_midi_event_no_status(m_pMidiParser, 1);
@@ -495,6 +503,11 @@ qtractorMidiManager::~qtractorMidiManager (void)
 	}
 #endif
 
+	if (m_pMidiData)
+		delete [] m_pMidiData;
+	if (m_pMidiEvents)
+		delete [] m_pMidiEvents;
+
 	if (m_pEventBuffer)
 		delete [] m_pEventBuffer;
 
@@ -570,6 +583,10 @@ void qtractorMidiManager::clear (void)
 	}
 
 	m_iEventBuffer = 0;
+
+	// All (empty) formats are valid now...
+	m_iMidiEvents = 0;
+	m_iEventFormats = EventAll;
 }
 
 
@@ -806,6 +823,9 @@ void qtractorMidiManager::processInputBuffer (
 
 	qtractorSubject *pDryGainSubject = pMidiInputBuffer->dryGainSubject();
 
+	// Current input might be from some plugin output...
+	updateEventBuffers(EventSeq);
+
 	for (unsigned int i = 0; i < m_iEventCount; ++i) {
 		pEv = &m_pEventBuffer[i];
 		// Apply gain (through/dry)...
@@ -843,84 +863,277 @@ void qtractorMidiManager::processInputBuffer (
 // Process/decode into other/plugin event buffers...
 void qtractorMidiManager::processEventBuffers (void)
 {
-#ifdef CONFIG_MIDI_PARSER
+	// Sequencer events are now the one and only valid input;
+	// all other formats are converted on demand, only once.
+	m_iMidiEvents = 0;
+	m_iEventFormats = EventSeq;
+}
+
+
+// Raw MIDI (short) message size, given its status byte.
+static inline unsigned int qtractorMidiDataSize ( unsigned char status )
+{
+	switch (status & 0xf0) {
+	case 0xc0:
+	case 0xd0:
+		return 2;
+	case 0xf0:
+		switch (status) {
+		case 0xf1:
+		case 0xf3:
+			return 2;
+		case 0xf2:
+			return 3;
+		default:
+			return 1;
+		}
+	default:
+		return 3;
+	}
+}
+
+
+// Convert (lazily) into the given event buffer format.
+void qtractorMidiManager::convertEventBuffers ( unsigned int iEventFormat )
+{
+	// Canonical raw MIDI events first...
+	if ((m_iEventFormats & EventRaw) == 0) {
+		readEventBuffers();
+		m_iEventFormats |= EventRaw;
+	}
+
+	// Then into the requested one...
+	if ((m_iEventFormats & iEventFormat) == 0) {
+		writeEventBuffers(iEventFormat);
+		m_iEventFormats |= iEventFormat;
+	}
+}
+
+
+// Append one raw MIDI event (canonical; zero-copy).
+bool qtractorMidiManager::writeMidiEvent (
+	unsigned long iFrames, unsigned char *pMidiData, unsigned int iMidiData )
+{
+	if (m_iMidiEvents >= bufferSize())
+		return false;
 
-	if (m_pMidiParser == NULL)
+	MidiEvent *pMidiEvent = &m_pMidiEvents[m_iMidiEvents++];
+	pMidiEvent->frames = iFrames;
+	pMidiEvent->size = iMidiData;
+	pMidiEvent->data = pMidiData;
+
+	return true;
+}
+
+
+// Read current input format into raw MIDI events (canonical).
+void qtractorMidiManager::readEventBuffers (void)
+{
+	m_iMidiEvents = 0;
+
+	const unsigned short iEventBuffer = (m_iEventBuffer & 1);
+
+	// Decode from sequencer events...
+	if (m_iEventFormats & EventSeq) {
+	#ifdef CONFIG_MIDI_PARSER
+		if (m_pMidiParser == NULL)
+			return;
+		unsigned int iMidiDataOffset = 0;
+		for (unsigned int i = 0; i < m_iEventCount; ++i) {
+			snd_seq_event_t *pEv = &m_pEventBuffer[i];
+			unsigned char *pMidiData = &m_pMidiData[iMidiDataOffset];
+			long iMidiData = m_iMidiDataSize - iMidiDataOffset;
+			if (iMidiData > c_iMaxMidiData)
+				iMidiData = c_iMaxMidiData;
+			iMidiData = snd_midi_event_decode(m_pMidiParser,
+				pMidiData, iMidiData, pEv);
+			if (iMidiData < 0)
+				break;
+			if (iMidiData < 1)
+				continue;
+		#ifdef CONFIG_DEBUG_0
+			// - show event for debug purposes...
+			unsigned long iTime = pEv->time.tick;
+			fprintf(stderr, "MIDI Raw %06lu {", iTime);
+			for (long i = 0; i < iMidiData; ++i)
+				fprintf(stderr, " %02x", pMidiData[i]);
+			fprintf(stderr, " }\n");
+		#endif
+			if (!writeMidiEvent(pEv->time.tick, pMidiData, iMidiData))
+				break;
+			iMidiDataOffset += iMidiData;
+		}
+	#endif	// CONFIG_MIDI_PARSER
 		return;
+	}
 
 #ifdef CONFIG_VST
-	VstEvents *pVstEvents = (VstEvents *) m_ppVstBuffers[m_iEventBuffer & 1];
+	// Read from VST plugin output...
+	if (m_iEventFormats & EventVst) {
+		VstEvents *pVstEvents = (VstEvents *) m_ppVstBuffers[iEventBuffer];
+		for (int i = 0; i < pVstEvents->numEvents; ++i) {
+			VstMidiEvent *pVstMidiEvent = (VstMidiEvent *) pVstEvents->events[i];
+			if (pVstMidiEvent->type != kVstMidiType)
+				continue;
+			unsigned char *pMidiData
+				= (unsigned char *) &pVstMidiEvent->midiData[0];
+			if (!writeMidiEvent(pVstMidiEvent->deltaFrames,
+					pMidiData, qtractorMidiDataSize(pMidiData[0])))
+				break;
+		}
+		return;
+	}
 #endif
+
 #ifdef CONFIG_LV2_EVENT
-	LV2_Event_Buffer *pLv2EventBuffer = m_ppLv2EventBuffers[m_iEventBuffer & 1];
-	LV2_Event_Iterator eiter;
-	lv2_event_begin(&eiter, pLv2EventBuffer);
+	// Read from LV2 (event) plugin output...
+	if (m_iEventFormats & EventLv2) {
+		LV2_Event_Buffer *pLv2EventBuffer = m_ppLv2EventBuffers[iEventBuffer];
+		LV2_Event_Iterator eiter;
+		lv2_event_begin(&eiter, pLv2EventBuffer);
+		while (lv2_event_is_valid(&eiter)) {
+			unsigned char *pMidiData;
+			LV2_Event *pLv2Event = lv2_event_get(&eiter, &pMidiData);
+			if (pLv2Event == NULL)
+				break;
+			if (pLv2Event->type == QTRACTOR_LV2_MIDI_EVENT_ID) {
+				if (pLv2Event->size < 1)
+					break;
+				if (!writeMidiEvent(pLv2Event->frames,
+						pMidiData, pLv2Event->size))
+					break;
+			}
+			lv2_event_increment(&eiter);
+		}
+		return;
+	}
 #endif
+
 #ifdef CONFIG_LV2_ATOM
-	LV2_Atom_Buffer *pLv2AtomBuffer = m_ppLv2AtomBuffers[m_iEventBuffer & 1];
-	LV2_Atom_Buffer_Iterator aiter;
-	lv2_atom_buffer_begin(&aiter, pLv2AtomBuffer);
-#endif
-	const unsigned int MaxMidiEvents = (bufferSize() << 1);
-	unsigned int iMidiEvents = 0;
-	// AG: Untangle treatment of VST and LV2 plugins,
-	// so that we can use a larger buffer for the latter...
-#ifdef CONFIG_VST
-	unsigned int iVstMidiEvents = 0;
+	// Read from LV2 (atom) plugin output...
+	if (m_iEventFormats & EventAtom) {
+		LV2_Atom_Buffer *pLv2AtomBuffer = m_ppLv2AtomBuffers[iEventBuffer];
+		LV2_Atom_Buffer_Iterator aiter;
+		lv2_atom_buffer_begin(&aiter, pLv2AtomBuffer);
+		for (;;) {
+			unsigned char *pMidiData;
+			LV2_Atom_Event *pLv2AtomEvent
+				= lv2_atom_buffer_get(&aiter, &pMidiData);
+			if (pLv2AtomEvent == NULL)
+				break;
+			if (pLv2AtomEvent->body.type == QTRACTOR_LV2_MIDI_EVENT_ID) {
+				if (pLv2AtomEvent->body.size < 1)
+					break;
+				if (!writeMidiEvent(pLv2AtomEvent->time.frames,
+						pMidiData, pLv2AtomEvent->body.size))
+					break;
+			}
+			lv2_atom_buffer_increment(&aiter);
+		}
+		return;
+	}
 #endif
-	unsigned char *pMidiData;
-	long iMidiData;
-	for (unsigned int i = 0; i < m_iEventCount; ++i) {
-		snd_seq_event_t *pEv = &m_pEventBuffer[i];
-		unsigned char midiData[c_iMaxMidiData];
-		pMidiData = &midiData[0];
-		iMidiData = sizeof(midiData);
-		iMidiData = snd_midi_event_decode(m_pMidiParser,
-			pMidiData, iMidiData, pEv);
-		if (iMidiData < 0)
+}
+
+
+// Write raw MIDI events (canonical) into the given format.
+void qtractorMidiManager::writeEventBuffers ( unsigned int iEventFormat )
+{
+	const unsigned short iEventBuffer = (m_iEventBuffer & 1);
+
+	switch (iEventFormat) {
+
+	// Encode into sequencer events...
+	case EventSeq: {
+		m_iEventCount = 0;
+	#ifdef CONFIG_MIDI_PARSER
+		if (m_pMidiParser == NULL)
 			break;
-	#ifdef CONFIG_DEBUG_0
-		// - show event for debug purposes...
-		unsigned long iTime = pEv->time.tick;
-		fprintf(stderr, "MIDI Raw %06lu {", iTime);
-		for (long i = 0; i < iMidiData; ++i)
-			fprintf(stderr, " %02x", pMidiData[i]);
-		fprintf(stderr, " }\n");
-	#endif
-	#ifdef CONFIG_LV2_EVENT
-		lv2_event_write(&eiter, pEv->time.tick, 0,
-			QTRACTOR_LV2_MIDI_EVENT_ID, iMidiData, pMidiData);
-	#endif
-	#ifdef CONFIG_LV2_ATOM
-		lv2_atom_buffer_write(&aiter, pEv->time.tick, 0,
-			QTRACTOR_LV2_MIDI_EVENT_ID, iMidiData, pMidiData);
+		for (unsigned int i = 0; i < m_iMidiEvents; ++i) {
+			MidiEvent *pMidiEvent = &m_pMidiEvents[i];
+			snd_seq_event_t *pEv = &m_pEventBuffer[m_iEventCount];
+		//	snd_seq_ev_clear(pEv);
+			const long iMidiData = snd_midi_event_encode(m_pMidiParser,
+				pMidiEvent->data, pMidiEvent->size, pEv);
+			if (iMidiData < 1 || pEv->type == SND_SEQ_EVENT_NONE)
+				break;
+			pEv->time.tick = pMidiEvent->frames;
+			++m_iEventCount;
+		}
 	#endif
-	#ifdef CONFIG_VST
-		VstMidiEvent *pVstMidiBuffer = m_ppVstMidiBuffers[m_iEventBuffer & 1];
-		VstMidiEvent *pVstMidiEvent = &pVstMidiBuffer[iVstMidiEvents];
-		if (iMidiData < long(sizeof(pVstMidiEvent->midiData))) {
+		break;
+	}
+
+#ifdef CONFIG_VST
+	// Into VST event buffer...
+	case EventVst: {
+		VstMidiEvent *pVstMidiBuffer = m_ppVstMidiBuffers[iEventBuffer];
+		VstEvents *pVstEvents = (VstEvents *) m_ppVstBuffers[iEventBuffer];
+		::memset(pVstEvents, 0, sizeof(VstEvents));
+		unsigned int iVstMidiEvents = 0;
+		for (unsigned int i = 0; i < m_iMidiEvents; ++i) {
+			MidiEvent *pMidiEvent = &m_pMidiEvents[i];
+			VstMidiEvent *pVstMidiEvent = &pVstMidiBuffer[iVstMidiEvents];
+			if (pMidiEvent->size >= sizeof(pVstMidiEvent->midiData))
+				continue;
 			::memset(pVstMidiEvent, 0, sizeof(VstMidiEvent));
 			pVstMidiEvent->type = kVstMidiType;
 			pVstMidiEvent->byteSize = sizeof(VstMidiEvent);
-			pVstMidiEvent->deltaFrames = pEv->time.tick;
-			::memcpy(&pVstMidiEvent->midiData[0], pMidiData, iMidiData);
+			pVstMidiEvent->deltaFrames = pMidiEvent->frames;
+			::memcpy(&pVstMidiEvent->midiData[0],
+				pMidiEvent->data, pMidiEvent->size);
 			pVstEvents->events[iVstMidiEvents++] = (VstEvent *) pVstMidiEvent;
 		}
-	#endif
-		if (++iMidiEvents >= MaxMidiEvents)
-			break;
+		pVstEvents->numEvents = iVstMidiEvents;
+		break;
 	}
-#ifdef CONFIG_VST
-	pVstEvents->numEvents = iVstMidiEvents;
-//	pVstEvents->reserved = 0;
 #endif
 
-#endif	// CONFIG_MIDI_PARSER
+#ifdef CONFIG_LV2_EVENT
+	// Into LV2 event buffer...
+	case EventLv2: {
+		LV2_Event_Buffer *pLv2EventBuffer = m_ppLv2EventBuffers[iEventBuffer];
+		lv2_event_buffer_reset(pLv2EventBuffer, LV2_EVENT_AUDIO_STAMP,
+			(unsigned char *) (pLv2EventBuffer + 1));
+		LV2_Event_Iterator eiter;
+		lv2_event_begin(&eiter, pLv2EventBuffer);
+		for (unsigned int i = 0; i < m_iMidiEvents; ++i) {
+			MidiEvent *pMidiEvent = &m_pMidiEvents[i];
+			if (!lv2_event_write(&eiter, pMidiEvent->frames, 0,
+					QTRACTOR_LV2_MIDI_EVENT_ID,
+					pMidiEvent->size, pMidiEvent->data))
+				break;
+		}
+		break;
+	}
+#endif
+
+#ifdef CONFIG_LV2_ATOM
+	// Into LV2 atom buffer...
+	case EventAtom: {
+		LV2_Atom_Buffer *pLv2AtomBuffer = m_ppLv2AtomBuffers[iEventBuffer];
+		lv2_atom_buffer_reset(pLv2AtomBuffer, true);
+		LV2_Atom_Buffer_Iterator aiter;
+		lv2_atom_buffer_begin(&aiter, pLv2AtomBuffer);
+		for (unsigned int i = 0; i < m_iMidiEvents; ++i) {
+			MidiEvent *pMidiEvent = &m_pMidiEvents[i];
+			if (!lv2_atom_buffer_write(&aiter, pMidiEvent->frames, 0,
+					QTRACTOR_LV2_MIDI_EVENT_ID,
+					pMidiEvent->size, pMidiEvent->data))
+				break;
+		}
+		break;
+	}
+#endif
+
+	default:
+		break;
+	}
 }
 
 
 // Swap event buffers (in for out and vice-versa)
-void qtractorMidiManager::swapEventBuffers (void)
+void qtractorMidiManager::swapEventBuffers ( unsigned int iEventFormat )
 {
 #ifdef CONFIG_VST
 	::memset(m_ppVstBuffers[m_iEventBuffer & 1], 0, sizeof(VstEvents));
@@ -935,6 +1148,11 @@ void qtractorMidiManager::swapEventBuffers (void)
 #endif
 
 	++m_iEventBuffer;
+
+	// Plugin output is the one and only valid input now;
+	// all other formats are converted on demand, only once.
+	m_iMidiEvents = 0;
+	m_iEventFormats = iEventFormat;
 }
 
 
@@ -947,7 +1165,7 @@ void qtractorMidiManager::vst_events_copy ( VstEvents *pVstBuffer )
 	VstMidiEvent *pVstMidiBuffer = m_ppVstMidiBuffers[iEventBuffer];
 	VstEvents *pVstEvents = (VstEvents *) m_ppVstBuffers[iEventBuffer];
 	::memset(pVstEvents, 0, sizeof(VstEvents));
-	const unsigned int MaxMidiEvents = (bufferSize() << 1);
+	const unsigned int MaxMidiEvents = bufferSize();
 	unsigned int iMidiEvents = pVstBuffer->numEvents;
 	if (iMidiEvents > MaxMidiEvents)
 		iMidiEvents = MaxMidiEvents;
@@ -964,52 +1182,7 @@ void qtractorMidiManager::vst_events_copy ( VstEvents *pVstBuffer )
 // Swap VST event buffers...
 void qtractorMidiManager::vst_events_swap (void)
 {
-	const unsigned short iEventBuffer = (m_iEventBuffer + 1) & 1;
-	VstMidiEvent *pVstMidiBuffer = m_ppVstMidiBuffers[iEventBuffer];
-	VstEvents *pVstEvents = (VstEvents *) m_ppVstBuffers[iEventBuffer];
-#ifdef CONFIG_LV2_EVENT
-	LV2_Event_Buffer *pLv2EventBuffer = m_ppLv2EventBuffers[iEventBuffer];
-	lv2_event_buffer_reset(pLv2EventBuffer, LV2_EVENT_AUDIO_STAMP,
-		(unsigned char *) (pLv2EventBuffer + 1));
-	LV2_Event_Iterator eiter;
-	lv2_event_begin(&eiter, pLv2EventBuffer);
-#endif
-#ifdef CONFIG_LV2_ATOM
-	LV2_Atom_Buffer *pLv2AtomBuffer = m_ppLv2AtomBuffers[iEventBuffer];
-	lv2_atom_buffer_reset(pLv2AtomBuffer, true);
-	LV2_Atom_Buffer_Iterator aiter;
-	lv2_atom_buffer_begin(&aiter, pLv2AtomBuffer);
-#endif
-	unsigned int iMidiEvents = 0;
-	const unsigned int MaxMidiEvents = (bufferSize() << 1);
-	while (iMidiEvents < MaxMidiEvents
-		   && int(iMidiEvents) < pVstEvents->numEvents) {
-		VstMidiEvent *pVstMidiEvent = &pVstMidiBuffer[iMidiEvents];
-		unsigned char *pMidiData = (unsigned char *) &pVstMidiEvent->midiData[0];
-		long iMidiData = sizeof(pVstMidiEvent->midiData);
-	#ifdef CONFIG_MIDI_PARSER
-		if (m_pMidiParser) {
-			snd_seq_event_t *pEv = &m_pEventBuffer[iMidiEvents];
-		//	snd_seq_ev_clear(pEv);
-			iMidiData = snd_midi_event_encode(m_pMidiParser,
-				pMidiData, iMidiData, pEv);
-			if (iMidiData < 1 || pEv->type == SND_SEQ_EVENT_NONE)
-				break;
-			pEv->time.tick = pVstMidiEvent->deltaFrames;
-		}
-	#endif
-	#ifdef CONFIG_LV2_EVENT
-		lv2_event_write(&eiter, pVstMidiEvent->deltaFrames, 0,
-			QTRACTOR_LV2_MIDI_EVENT_ID, iMidiData, pMidiData);
-	#endif
-	#ifdef CONFIG_LV2_ATOM
-		lv2_atom_buffer_write(&aiter, pVstMidiEvent->deltaFrames, 0,
-			QTRACTOR_LV2_MIDI_EVENT_ID, iMidiData, pMidiData);
-	#endif
-		++iMidiEvents;
-	}
-	m_iEventCount = iMidiEvents;
-	swapEventBuffers();
+	swapEventBuffers(EventVst);
 }
 
 #endif	// CONFIG_VST
@@ -1020,70 +1193,7 @@ void qtractorMidiManager::vst_events_swap (void)
 // Swap LV2 event buffers...
 void qtractorMidiManager::lv2_events_swap (void)
 {
-	const unsigned short iEventBuffer = (m_iEventBuffer + 1) & 1;
-	LV2_Event_Buffer *pLv2EventBuffer = m_ppLv2EventBuffers[iEventBuffer];
-#ifdef CONFIG_VST
-	VstMidiEvent *pVstMidiBuffer = m_ppVstMidiBuffers[iEventBuffer];
-	VstEvents *pVstEvents = (VstEvents *) m_ppVstBuffers[iEventBuffer];
-	::memset(pVstEvents, 0, sizeof(VstEvents));
-#endif
-#ifdef CONFIG_LV2_ATOM
-	LV2_Atom_Buffer *pLv2AtomBuffer = m_ppLv2AtomBuffers[iEventBuffer];
-	lv2_atom_buffer_reset(pLv2AtomBuffer, true);
-	LV2_Atom_Buffer_Iterator aiter;
-	lv2_atom_buffer_begin(&aiter, pLv2AtomBuffer);
-#endif
-	LV2_Event_Iterator eiter;
-	lv2_event_begin(&eiter, pLv2EventBuffer);
-	unsigned int iMidiEvents = 0;
-	const unsigned int MaxMidiEvents = (bufferSize() << 1);
-	while (iMidiEvents < MaxMidiEvents
-			&& lv2_event_is_valid(&eiter)) {
-		unsigned char *pMidiData;
-		LV2_Event *pLv2Event = lv2_event_get(&eiter, &pMidiData);
-		if (pLv2Event == NULL)
-			break;
-		if (pLv2Event->type == QTRACTOR_LV2_MIDI_EVENT_ID) {
-			long iMidiData = pLv2Event->size;
-			if (iMidiData < 1)
-				break;
-		#ifdef CONFIG_VST
-			VstMidiEvent *pVstMidiEvent = &pVstMidiBuffer[iMidiEvents];
-			if (iMidiData >= long(sizeof(pVstMidiEvent->midiData)))
-				break;
-		#endif
-		#ifdef CONFIG_MIDI_PARSER
-			if (m_pMidiParser) {
-				snd_seq_event_t *pEv = &m_pEventBuffer[iMidiEvents];
-			//	snd_seq_ev_clear(pEv);
-				iMidiData = snd_midi_event_encode(m_pMidiParser,
-					pMidiData, iMidiData, pEv);
-				if (iMidiData < 1 || pEv->type == SND_SEQ_EVENT_NONE)
-					break;
-				pEv->time.tick = pLv2Event->frames;
-			}
-		#endif
-		#ifdef CONFIG_VST
-			::memset(pVstMidiEvent, 0, sizeof(VstMidiEvent));
-			pVstMidiEvent->type = kVstMidiType;
-			pVstMidiEvent->byteSize = sizeof(VstMidiEvent);
-			pVstMidiEvent->deltaFrames = pLv2Event->frames;
-			::memcpy(&pVstMidiEvent->midiData[0], pMidiData, iMidiData);
-			pVstEvents->events[iMidiEvents] = (VstEvent *) pVstMidiEvent;
-		#endif
-		#ifdef CONFIG_LV2_ATOM
-			lv2_atom_buffer_write(&aiter, pLv2Event->frames, 0,
-				QTRACTOR_LV2_MIDI_EVENT_ID, iMidiData, pMidiData);
-		#endif
-			++iMidiEvents;
-		}
-		lv2_event_increment(&eiter);
-	}
-#ifdef CONFIG_VST
-	pVstEvents->numEvents = iMidiEvents;
-#endif
-	m_iEventCount = iMidiEvents;
-	swapEventBuffers();
+	swapEventBuffers(EventLv2);
 }
 
 #endif	// CONFIG_LV2_EVENT
@@ -1094,70 +1204,7 @@ void qtractorMidiManager::lv2_events_swap (void)
 // Swap LV2 atom buffers...
 void qtractorMidiManager::lv2_atom_buffer_swap (void)
 {
-	const unsigned short iEventBuffer = (m_iEventBuffer + 1) & 1;
-	LV2_Atom_Buffer *pLv2AtomBuffer = m_ppLv2AtomBuffers[iEventBuffer];
-#ifdef CONFIG_VST
-	VstMidiEvent *pVstMidiBuffer = m_ppVstMidiBuffers[iEventBuffer];
-	VstEvents *pVstEvents = (VstEvents *) m_ppVstBuffers[iEventBuffer];
-	::memset(pVstEvents, 0, sizeof(VstEvents));
-#endif
-#ifdef CONFIG_LV2_EVENT
-	LV2_Event_Buffer *pLv2EventBuffer = m_ppLv2EventBuffers[iEventBuffer];
-	lv2_event_buffer_reset(pLv2EventBuffer, LV2_EVENT_AUDIO_STAMP,
-		(unsigned char *) (pLv2EventBuffer + 1));
-	LV2_Event_Iterator eiter;
-	lv2_event_begin(&eiter, pLv2EventBuffer);
-#endif
-	LV2_Atom_Buffer_Iterator aiter;
-	lv2_atom_buffer_begin(&aiter, pLv2AtomBuffer);
-	unsigned int iMidiEvents = 0;
-	const unsigned int MaxMidiEvents = (bufferSize() << 1);
-	while (iMidiEvents < MaxMidiEvents) {
-		unsigned char *pMidiData;
-		LV2_Atom_Event *pLv2AtomEvent = lv2_atom_buffer_get(&aiter, &pMidiData);
-		if (pLv2AtomEvent == NULL)
-			break;
-		if (pLv2AtomEvent->body.type == QTRACTOR_LV2_MIDI_EVENT_ID) {
-			long iMidiData = pLv2AtomEvent->body.size;
-			if (iMidiData < 1)
-				break;
-		#ifdef CONFIG_VST
-			VstMidiEvent *pVstMidiEvent = &pVstMidiBuffer[iMidiEvents];
-			if (iMidiData >= long(sizeof(pVstMidiEvent->midiData)))
-				break;
-		#endif
-		#ifdef CONFIG_MIDI_PARSER
-			if (m_pMidiParser) {
-				snd_seq_event_t *pEv = &m_pEventBuffer[iMidiEvents];
-			//	snd_seq_ev_clear(pEv);
-				iMidiData = snd_midi_event_encode(m_pMidiParser,
-					pMidiData, iMidiData, pEv);
-				if (iMidiData < 1 || pEv->type == SND_SEQ_EVENT_NONE)
-					break;
-				pEv->time.tick = pLv2AtomEvent->time.frames;
-			}
-		#endif
-		#ifdef CONFIG_VST
-			::memset(pVstMidiEvent, 0, sizeof(VstMidiEvent));
-			pVstMidiEvent->type = kVstMidiType;
-			pVstMidiEvent->byteSize = sizeof(VstMidiEvent);
-			pVstMidiEvent->deltaFrames = pLv2AtomEvent->time.frames;
-			::memcpy(&pVstMidiEvent->midiData[0], pMidiData, iMidiData);
-			pVstEvents->events[iMidiEvents] = (VstEvent *) pVstMidiEvent;
-		#endif
-		#ifdef CONFIG_LV2_EVENT
-			lv2_event_write(&eiter, pLv2AtomEvent->time.frames, 0,
-				QTRACTOR_LV2_MIDI_EVENT_ID, iMidiData, pMidiData);
-		#endif
-			++iMidiEvents;
-		}
-		lv2_atom_buffer_increment(&aiter);
-	}
-#ifdef CONFIG_VST
-	pVstEvents->numEvents = iMidiEvents;
-#endif
-	m_iEventCount = iMidiEvents;
-	swapEventBuffers();
+	swapEventBuffers(EventAtom);
 }
 
 
@@ -187,10 +187,12 @@ public:
 	void clear();
 
 	// Event buffer accessor. 
-	snd_seq_event_t *events() const { return m_pEventBuffer; }
+	snd_seq_event_t *events()
+		{ updateEventBuffers(EventSeq); return m_pEventBuffer; }
 
 	// Returns number of events result of process.
-	unsigned int count() const { return m_iEventCount; }
+	unsigned int count()
+		{ updateEventBuffers(EventSeq); return m_iEventCount; }
 
 	// Direct buffering.
 	bool direct(snd_seq_event_t *pEvent);
@@ -227,8 +229,11 @@ public:
 
 #ifdef CONFIG_VST
 	// VST event buffer accessors...
-	VstEvents *vst_events_in() const
-		{ return (VstEvents *) m_ppVstBuffers[m_iEventBuffer & 1]; }
+	VstEvents *vst_events_in()
+	{
+		updateEventBuffers(EventVst);
+		return (VstEvents *) m_ppVstBuffers[m_iEventBuffer & 1];
+	}
 	VstEvents *vst_events_out() const
 		{ return (VstEvents *) m_ppVstBuffers[(m_iEventBuffer + 1) & 1]; }
 	// Copy VST event buffer (output)...
@@ -239,8 +244,11 @@ public:
 
 #ifdef CONFIG_LV2_EVENT
 	// LV2 event buffer accessors...
-	LV2_Event_Buffer *lv2_events_in() const
-		{ return m_ppLv2EventBuffers[m_iEventBuffer & 1]; }
+	LV2_Event_Buffer *lv2_events_in()
+	{
+		updateEventBuffers(EventLv2);
+		return m_ppLv2EventBuffers[m_iEventBuffer & 1];
+	}
 	LV2_Event_Buffer *lv2_events_out() const
 		{ return m_ppLv2EventBuffers[(m_iEventBuffer + 1) & 1]; }
 	// Swap LV2 event buffers...
@@ -249,8 +257,11 @@ public:
 
 #ifdef CONFIG_LV2_ATOM
 	// LV2 atom buffer accessors...
-	LV2_Atom_Buffer *lv2_atom_buffer_in() const
-		{ return m_ppLv2AtomBuffers[m_iEventBuffer & 1]; }
+	LV2_Atom_Buffer *lv2_atom_buffer_in()
+	{
+		updateEventBuffers(EventAtom);
+		return m_ppLv2AtomBuffers[m_iEventBuffer & 1];
+	}
 	LV2_Atom_Buffer *lv2_atom_buffer_out() const
 		{ return m_ppLv2AtomBuffers[(m_iEventBuffer + 1) & 1]; }
 	// Swap LV2 atom buffers...
@@ -324,11 +335,38 @@ protected:
 	void createAudioOutputBus();
 	void deleteAudioOutputBus();
 
+	// Event buffer formats (current input validity flags).
+	enum EventFormat {
+		EventSeq  = 1,	// ALSA sequencer events (m_pEventBuffer).
+		EventRaw  = 2,	// Raw MIDI events (canonical/intermediate).
+		EventVst  = 4,	// VST event buffer (in).
+		EventLv2  = 8,	// LV2 event buffer (in).
+		EventAtom = 16,	// LV2 atom buffer (in).
+		EventAll  = EventSeq | EventRaw | EventVst | EventLv2 | EventAtom
+	};
+
 	// Process/decode into other/plugin event buffers...
 	void processEventBuffers();
 
+	// Convert (lazily) into the given event buffer format,
+	// only if not already done for the current input (RT-safe).
+	void updateEventBuffers(unsigned int iEventFormat)
+	{
+		if ((m_iEventFormats & iEventFormat) == 0)
+			convertEventBuffers(iEventFormat);
+	}
+
+	// Actual event buffer format conversions.
+	void convertEventBuffers(unsigned int iEventFormat);
+	void readEventBuffers();
+	void writeEventBuffers(unsigned int iEventFormat);
+
+	// Append one raw MIDI event (canonical; zero-copy).
+	bool writeMidiEvent(unsigned long iFrames,
+		unsigned char *pMidiData, unsigned int iMidiData);
+
 	// Swap event buffers (in for out and vice-versa)
-	void swapEventBuffers();
+	void swapEventBuffers(unsigned int iEventFormat);
 
 private:
 
@@ -368,6 +406,24 @@ private:
 
 	unsigned short      m_iEventBuffer;
 
+	// Which formats are currently valid for input.
+	unsigned int        m_iEventFormats;
+
+	// Raw MIDI event buffer (canonical/intermediate).
+	struct MidiEvent
+	{
+		unsigned long   frames;
+		unsigned int    size;
+		unsigned char  *data;
+	};
+
+	MidiEvent          *m_pMidiEvents;
+	unsigned int        m_iMidiEvents;
+
+	// Raw MIDI data pool (decoded sequencer events only).
+	unsigned char      *m_pMidiData;
+	unsigned int        m_iMidiDataSize;
+
 #ifdef CONFIG_VST
 	VstMidiEvent       *m_ppVstMidiBuffers[2];
 	unsigned char      *m_ppVstBuffers[2];
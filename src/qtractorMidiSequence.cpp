@@ -213,6 +213,7 @@ void qtractorMidiSequence::replaceEvents ( qtractorMidiSequence *pSeq,
 	}
 
 	// Insert new (cloned and adjusted) ones...
+	qtractorMidiEvent::reserve(pSeq->events().count());
 	for (pEvent = pSeq->events().first(); pEvent; pEvent = pEvent->next()) {
 		qtractorMidiEvent *pNewEvent = new qtractorMidiEvent(*pEvent);
 		pNewEvent->setTime(timeq(iTimeOffset + pEvent->time(), iTicksPerBeat));
@@ -232,7 +233,8 @@ void qtractorMidiSequence::copyEvents ( qtractorMidiSequence *pSeq )
 	// Remove existing events.
 	m_events.clear();
 	
-	// Clone new ones...
+	// Clone new ones, in one bulk...
+	qtractorMidiEvent::reserve(pSeq->events().count());
 	qtractorMidiEvent *pEvent = pSeq->events().first();
 	for (; pEvent; pEvent = pEvent->next())
 		m_events.append(new qtractorMidiEvent(*pEvent));
@@ -409,6 +409,9 @@ qtractorMidiToolsForm::qtractorMidiToolsForm (
 	QObject::connect(m_ui.DialogButtonBox,
 		SIGNAL(rejected()),
 		SLOT(reject()));
+
+	// Initial tool settings snapshot.
+	updateTools();
 }
 
 
@@ -763,15 +766,9 @@ void qtractorMidiToolsForm::presetDelete (void)
 }
 
 
-// Create edit command based on given selection.
-qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
-	qtractorMidiClip *pMidiClip, qtractorMidiEditSelect *pSelect,
-	unsigned long iTimeOffset, unsigned long iTimeStart, unsigned long iTimeEnd )
+// Tool settings snapshot (to be safe off the GUI thread).
+void qtractorMidiToolsForm::updateTools (void)
 {
-	// Create command, it will be handed over...
-	qtractorMidiEditCommand *pEditCommand
-		= new qtractorMidiEditCommand(pMidiClip, tr("none"));
-
 	// Set composite command title.
 	QStringList tools;
 	if (m_ui.QuantizeCheckBox->isChecked())
@@ -788,7 +785,91 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 		tools.append(tr("rescale"));
 	if (m_ui.TimeshiftCheckBox->isChecked())
 		tools.append(tr("timeshift"));
-	pEditCommand->setName(tools.join(", "));
+	m_tools.sName = tools.join(", ");
+
+	// Quantize tool...
+	m_tools.bQuantize = m_ui.QuantizeCheckBox->isChecked();
+	m_tools.bQuantizeSwing = m_ui.QuantizeSwingCheckBox->isChecked();
+	m_tools.iQuantizeSwingIndex = m_ui.QuantizeSwingComboBox->currentIndex();
+	m_tools.fQuantizeSwing = float(m_ui.QuantizeSwingSpinBox->value());
+	m_tools.iQuantizeSwingTypeIndex = m_ui.QuantizeSwingTypeComboBox->currentIndex();
+	m_tools.bQuantizeTime = m_ui.QuantizeTimeCheckBox->isChecked();
+	m_tools.iQuantizeTimeIndex = m_ui.QuantizeTimeComboBox->currentIndex();
+	m_tools.fQuantizeTime = float(m_ui.QuantizeTimeSpinBox->value());
+	m_tools.bQuantizeDuration = m_ui.QuantizeDurationCheckBox->isChecked();
+	m_tools.iQuantizeDurationIndex = m_ui.QuantizeDurationComboBox->currentIndex();
+	m_tools.fQuantizeDuration = float(m_ui.QuantizeDurationSpinBox->value());
+	m_tools.bQuantizeScale = m_ui.QuantizeScaleCheckBox->isChecked();
+	m_tools.iQuantizeScaleKeyIndex = m_ui.QuantizeScaleKeyComboBox->currentIndex();
+	m_tools.iQuantizeScaleIndex = m_ui.QuantizeScaleComboBox->currentIndex();
+
+	// Transpose tool...
+	m_tools.bTranspose = m_ui.TransposeCheckBox->isChecked();
+	m_tools.bTransposeReverse = m_ui.TransposeReverseCheckBox->isChecked();
+	m_tools.bTransposeNote = m_ui.TransposeNoteCheckBox->isChecked();
+	m_tools.iTransposeNote = m_ui.TransposeNoteSpinBox->value();
+	m_tools.bTransposeTime = m_ui.TransposeTimeCheckBox->isChecked();
+	m_tools.iTransposeTime = m_ui.TransposeTimeSpinBox->value();
+
+	// Normalize tool...
+	m_tools.bNormalize = m_ui.NormalizeCheckBox->isChecked();
+	m_tools.bNormalizeValue = m_ui.NormalizeValueCheckBox->isChecked();
+	m_tools.iNormalizeValue = m_ui.NormalizeValueSpinBox->value();
+	m_tools.bNormalizePercent = m_ui.NormalizePercentCheckBox->isChecked();
+	m_tools.fNormalizePercent = float(m_ui.NormalizePercentSpinBox->value());
+
+	// Randomize tool...
+	m_tools.bRandomize = m_ui.RandomizeCheckBox->isChecked();
+	m_tools.bRandomizeNote = m_ui.RandomizeNoteCheckBox->isChecked();
+	m_tools.fRandomizeNote = float(m_ui.RandomizeNoteSpinBox->value());
+	m_tools.bRandomizeTime = m_ui.RandomizeTimeCheckBox->isChecked();
+	m_tools.fRandomizeTime = float(m_ui.RandomizeTimeSpinBox->value());
+	m_tools.bRandomizeDuration = m_ui.RandomizeDurationCheckBox->isChecked();
+	m_tools.fRandomizeDuration = float(m_ui.RandomizeDurationSpinBox->value());
+	m_tools.bRandomizeValue = m_ui.RandomizeValueCheckBox->isChecked();
+	m_tools.fRandomizeValue = float(m_ui.RandomizeValueSpinBox->value());
+
+	// Resize tool...
+	m_tools.bResize = m_ui.ResizeCheckBox->isChecked();
+	m_tools.bResizeValue = m_ui.ResizeValueCheckBox->isChecked();
+	m_tools.iResizeValue2Index = m_ui.ResizeValue2ComboBox->currentIndex();
+	m_tools.bResizeDuration = m_ui.ResizeDurationCheckBox->isChecked();
+	m_tools.iResizeDuration = m_ui.ResizeDurationSpinBox->value();
+	m_tools.iResizeValue = m_ui.ResizeValueSpinBox->value();
+	m_tools.iResizeValue2 = m_ui.ResizeValue2SpinBox->value();
+
+	// Rescale tool...
+	m_tools.bRescale = m_ui.RescaleCheckBox->isChecked();
+	m_tools.bRescaleTime = m_ui.RescaleTimeCheckBox->isChecked();
+	m_tools.fRescaleTime = float(m_ui.RescaleTimeSpinBox->value());
+	m_tools.bRescaleDuration = m_ui.RescaleDurationCheckBox->isChecked();
+	m_tools.fRescaleDuration = float(m_ui.RescaleDurationSpinBox->value());
+	m_tools.bRescaleValue = m_ui.RescaleValueCheckBox->isChecked();
+	m_tools.fRescaleValue = float(m_ui.RescaleValueSpinBox->value());
+
+	// Timeshift tool...
+	m_tools.bTimeshift = m_ui.TimeshiftCheckBox->isChecked();
+	m_tools.fTimeshift = float(m_ui.TimeshiftSpinBox->value());
+	m_tools.bTimeshiftDuration = m_ui.TimeshiftDurationCheckBox->isChecked();
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession) {
+		m_tools.iEditHeadTime = pSession->tickFromFrame(pSession->editHead());
+		m_tools.iEditTailTime = pSession->tickFromFrame(pSession->editTail());
+	} else {
+		m_tools.iEditHeadTime = 0;
+		m_tools.iEditTailTime = 0;
+	}
+}
+
+
+// Create edit command based on given selection.
+qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
+	qtractorMidiClip *pMidiClip, qtractorMidiEditSelect *pSelect,
+	unsigned long iTimeOffset, unsigned long iTimeStart, unsigned long iTimeEnd )
+{
+	// Create command, it will be handed over...
+	qtractorMidiEditCommand *pEditCommand
+		= new qtractorMidiEditCommand(pMidiClip, m_tools.sName);
 
 	const qtractorMidiEditSelect::ItemList& items = pSelect->items();
 	qtractorMidiEditSelect::ItemList::ConstIterator iter = items.constBegin();
@@ -813,12 +894,10 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 	// find maximum and minimum times and values from the selection...
 	int iMaxValue = 0;
 	int iMinValue = 0;
-	if (m_ui.NormalizeCheckBox->isChecked()
-		|| (m_ui.TransposeCheckBox->isChecked() &&
-			m_ui.TransposeReverseCheckBox->isChecked())
-		|| (m_ui.ResizeCheckBox->isChecked() &&
-			m_ui.ResizeValueCheckBox->isChecked() &&
-			m_ui.ResizeValue2ComboBox->currentIndex() > 0)) {
+	if (m_tools.bNormalize
+		|| (m_tools.bTranspose && m_tools.bTransposeReverse)
+		|| (m_tools.bResize && m_tools.bResizeValue
+			&& m_tools.iResizeValue2Index > 0)) {
 		// Make it through one time...
 		for (int i = 0 ; iter != iter_end; ++i, ++iter) {
 			qtractorMidiEvent *pEvent = iter.key();
@@ -854,12 +933,11 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 		int iValue = (bPitchBend ? pEvent->pitchBend() : pEvent->value());
 		qtractorTimeScale::Node *pNode = cursor.seekTick(iTime);
 		// Quantize tool...
-		if (m_ui.QuantizeCheckBox->isChecked()) {
-			tools.append(tr("quantize"));
+		if (m_tools.bQuantize) {
 			// Swing quantize...
-			if (m_ui.QuantizeSwingCheckBox->isChecked()) {
+			if (m_tools.bQuantizeSwing) {
 				const unsigned short p = qtractorTimeScale::snapFromIndex(
-					m_ui.QuantizeSwingComboBox->currentIndex() + 1);
+					m_tools.iQuantizeSwingIndex + 1);
 				const unsigned long q = pNode->ticksPerBeat / p;
 				if (q > 0) {
 					const unsigned long t0 = q * (iTime / q);
@@ -868,9 +946,9 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 						d0 = float(long(t0 + q) - long(iTime));
 					else
 						d0 = float(long(iTime) - long(t0));
-					float ds = 0.01f * float(m_ui.QuantizeSwingSpinBox->value());
+					float ds = 0.01f * m_tools.fQuantizeSwing;
 					ds = ds * d0;
-					const int n = m_ui.QuantizeSwingTypeComboBox->currentIndex();
+					const int n = m_tools.iQuantizeSwingTypeIndex;
 					for (int i = 0; i < n; ++i) // 0=Linear; 1=Quadratic; 2=Cubic.
 						ds = (ds * d0) / float(q);
 					iTime += long(ds);
@@ -879,29 +957,29 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 				}
 			}
 			// Time quantize...
-			if (m_ui.QuantizeTimeCheckBox->isChecked()) {
+			if (m_tools.bQuantizeTime) {
 				const unsigned short p = qtractorTimeScale::snapFromIndex(
-					m_ui.QuantizeTimeComboBox->currentIndex() + 1);
+					m_tools.iQuantizeTimeIndex + 1);
 				const unsigned long q = pNode->ticksPerBeat / p;
 				iTime = q * ((iTime + (q >> 1)) / q);
 				// Time percent quantize...
 				const float delta = 0.01f
-					* (100.0f - float(m_ui.QuantizeTimeSpinBox->value()))
+					* (100.0f - m_tools.fQuantizeTime)
 					* float(long(pEvent->time() + iTimeOffset) - iTime);
 				iTime += long(delta);
 				if (iTime < long(iTimeOffset))
 					iTime = long(iTimeOffset);
 			}
 			// Duration quantize...
-			if (m_ui.QuantizeDurationCheckBox->isChecked()
+			if (m_tools.bQuantizeDuration
 				&& pEvent->type() == qtractorMidiEvent::NOTEON) {
 				const unsigned short p = qtractorTimeScale::snapFromIndex(
-					m_ui.QuantizeDurationComboBox->currentIndex() + 1);
+					m_tools.iQuantizeDurationIndex + 1);
 				const unsigned long q = pNode->ticksPerBeat / p;
 				iDuration = q * ((iDuration + q - 1) / q);
 				// Duration percent quantize...
 				const float delta = 0.01f
-					* (100.0f - float(m_ui.QuantizeDurationSpinBox->value()))
+					* (100.0f - m_tools.fQuantizeDuration)
 					* float(long(pEvent->duration()) - iDuration);
 				iDuration += long(delta);
 				if (iDuration < 0)
@@ -909,33 +987,32 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 			}
 			pEditCommand->resizeEventTime(pEvent, iTime - iTimeOffset, iDuration);
 			// Scale quantize...
-			if (m_ui.QuantizeScaleCheckBox->isChecked()) {
+			if (m_tools.bQuantizeScale) {
 				const int iNote = qtractorMidiEditor::snapToScale(pEvent->note(),
-					m_ui.QuantizeScaleKeyComboBox->currentIndex(),
-					m_ui.QuantizeScaleComboBox->currentIndex());
+					m_tools.iQuantizeScaleKeyIndex,
+					m_tools.iQuantizeScaleIndex);
 				pEditCommand->moveEvent(pEvent, iNote, iTime - iTimeOffset);
 			}
 		}
 		// Transpose tool...
-		if (m_ui.TransposeCheckBox->isChecked()) {
-			tools.append(tr("transpose"));
+		if (m_tools.bTranspose) {
 			int iNote = int(pEvent->note());
-			if (m_ui.TransposeNoteCheckBox->isChecked()
+			if (m_tools.bTransposeNote
 				&& pEvent->type() == qtractorMidiEvent::NOTEON) {
-				iNote += m_ui.TransposeNoteSpinBox->value();
+				iNote += m_tools.iTransposeNote;
 				if (iNote < 0)
 					iNote = 0;
 				else
 				if (iNote > 127)
 					iNote = 127;
 			}
-			if (m_ui.TransposeTimeCheckBox->isChecked()) {
+			if (m_tools.bTransposeTime) {
 				iTime = pNode->tickFromFrame(pNode->frameFromTick(iTime)
-					+ m_ui.TransposeTimeSpinBox->value());
+					+ m_tools.iTransposeTime);
 				if (iTime < long(iTimeOffset))
 					iTime = long(iTimeOffset);
 			}
-			if (m_ui.TransposeReverseCheckBox->isChecked()) {
+			if (m_tools.bTransposeReverse) {
 				iTime = iMinTime2 + iMaxTime2 - iTime - iDuration;
 				if (iTime < long(iTimeOffset))
 					iTime = long(iTimeOffset);
@@ -943,15 +1020,14 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 			pEditCommand->moveEvent(pEvent, iNote, iTime - iTimeOffset);
 		}
 		// Normalize tool...
-		if (m_ui.NormalizeCheckBox->isChecked()) {
-			tools.append(tr("normalize"));
+		if (m_tools.bNormalize) {
 			float p, q = float(iMaxValue);
-			if (m_ui.NormalizeValueCheckBox->isChecked())
-				p = float(m_ui.NormalizeValueSpinBox->value());
+			if (m_tools.bNormalizeValue)
+				p = float(m_tools.iNormalizeValue);
 			else
 				p = (bPitchBend ? 8192.0f : 128.0f);
-			if (m_ui.NormalizePercentCheckBox->isChecked()) {
-				p *= float(m_ui.NormalizePercentSpinBox->value());
+			if (m_tools.bNormalizePercent) {
+				p *= m_tools.fNormalizePercent;
 				q *= 100.0f;
 			}
 			if (q > 0.0f) {
@@ -973,12 +1049,11 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 			pEditCommand->resizeEventValue(pEvent, iValue);
 		}
 		// Randomize tool...
-		if (m_ui.RandomizeCheckBox->isChecked()) {
-			tools.append(tr("randomize"));
+		if (m_tools.bRandomize) {
 			float p; int q;
-			if (m_ui.RandomizeNoteCheckBox->isChecked()) {
+			if (m_tools.bRandomizeNote) {
 				int iNote = int(pEvent->note());
-				p = 0.01f * float(m_ui.RandomizeNoteSpinBox->value());
+				p = 0.01f * m_tools.fRandomizeNote;
 				q = 127;
 				if (p > 0.0f) {
 					iNote += int(p * float(q - (::rand() % (q << 1))));
@@ -990,8 +1065,8 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 					pEditCommand->moveEvent(pEvent, iNote, iTime);
 				}
 			}
-			if (m_ui.RandomizeTimeCheckBox->isChecked()) {
-				p = 0.01f * float(m_ui.RandomizeTimeSpinBox->value());
+			if (m_tools.bRandomizeTime) {
+				p = 0.01f * m_tools.fRandomizeTime;
 				q = pNode->ticksPerBeat;
 				if (p > 0.0f) {
 					iTime += long(p * float(q - (::rand() % (q << 1))));
@@ -1001,8 +1076,8 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 						iTime - iTimeOffset, iDuration);
 				}
 			}
-			if (m_ui.RandomizeDurationCheckBox->isChecked()) {
-				p = 0.01f * float(m_ui.RandomizeDurationSpinBox->value());
+			if (m_tools.bRandomizeDuration) {
+				p = 0.01f * m_tools.fRandomizeDuration;
 				q = pNode->ticksPerBeat;
 				if (p > 0.0f) {
 					iDuration += long(p * float(q - (::rand() % (q << 1))));
@@ -1012,8 +1087,8 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 						iTime - iTimeOffset, iDuration);
 				}
 			}
-			if (m_ui.RandomizeValueCheckBox->isChecked()) {
-				p = 0.01f * float(m_ui.RandomizeValueSpinBox->value());
+			if (m_tools.bRandomizeValue) {
+				p = 0.01f * m_tools.fRandomizeValue;
 				q = (bPitchBend ? 8192 : 128);
 				if (p > 0.0f) {
 					iValue += int(p * float(q - (::rand() % (q << 1))));
@@ -1035,20 +1110,19 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 			}
 		}
 		// Resize tool...
-		if (m_ui.ResizeCheckBox->isChecked()) {
-			tools.append(tr("resize"));
-			if (m_ui.ResizeDurationCheckBox->isChecked()) {
+		if (m_tools.bResize) {
+			if (m_tools.bResizeDuration) {
 				iDuration = pNode->tickFromFrame(pNode->frameFromTick(iTime)
-					+ m_ui.ResizeDurationSpinBox->value()) - iTime;
+					+ m_tools.iResizeDuration) - iTime;
 				pEditCommand->resizeEventTime(pEvent,
 					iTime - iTimeOffset, iDuration);
 			}
-			if (m_ui.ResizeValueCheckBox->isChecked()) {
+			if (m_tools.bResizeValue) {
 				const int p = (bPitchBend && iValue < 0 ? -1 : 1); // sign
-				iValue = p * m_ui.ResizeValueSpinBox->value();
+				iValue = p * m_tools.iResizeValue;
 				if (bPitchBend) iValue <<= 6; // *128
-				if (m_ui.ResizeValue2ComboBox->currentIndex() > 0) {
-					int iValue2 = p * m_ui.ResizeValue2SpinBox->value();
+				if (m_tools.iResizeValue2Index > 0) {
+					int iValue2 = p * m_tools.iResizeValue2;
 					if (bPitchBend) iValue2 <<= 6; // *128
 					const int iDeltaValue = iValue2 - iValue;
 					const long iDeltaTime = iMaxTime - iMinTime;
@@ -1059,27 +1133,26 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 			}
 		}
 		// Rescale tool...
-		if (m_ui.RescaleCheckBox->isChecked()) {
-			tools.append(tr("rescale"));
+		if (m_tools.bRescale) {
 			float p;
-			if (m_ui.RescaleTimeCheckBox->isChecked()) {
-				p = 0.01f * float(m_ui.RescaleTimeSpinBox->value());
+			if (m_tools.bRescaleTime) {
+				p = 0.01f * m_tools.fRescaleTime;
 				iTime = iMinTime + long(p * float(iTime - iMinTime));
 				if (iTime < long(iTimeOffset))
 					iTime = long(iTimeOffset);
 				pEditCommand->moveEvent(pEvent,
 					pEvent->note(), iTime - iTimeOffset);
 			}
-			if (m_ui.RescaleDurationCheckBox->isChecked()) {
-				p = 0.01f * float(m_ui.RescaleDurationSpinBox->value());
+			if (m_tools.bRescaleDuration) {
+				p = 0.01f * m_tools.fRescaleDuration;
 				iDuration = long(p * float(iDuration));
 				if (iDuration < 0)
 					iDuration = 0;
 				pEditCommand->resizeEventTime(pEvent,
 					iTime - iTimeOffset, iDuration);
 			}
-			if (m_ui.RescaleValueCheckBox->isChecked()) {
-				p = 0.01f * float(m_ui.RescaleValueSpinBox->value());
+			if (m_tools.bRescaleValue) {
+				p = 0.01f * m_tools.fRescaleValue;
 				iValue = int(p * float(iValue));
 				if (bPitchBend) {
 					if (iValue > +8191)
@@ -1098,26 +1171,22 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 			}
 		}
 		// Timeshift tool...
-		if (m_ui.TimeshiftCheckBox->isChecked()) {
-			tools.append(tr("timeshift"));
-			qtractorSession *pSession = qtractorSession::getInstance();
-			const unsigned long iEditHeadTime
-				= pSession->tickFromFrame(pSession->editHead());
-			const unsigned long iEditTailTime
-				= pSession->tickFromFrame(pSession->editTail());
+		if (m_tools.bTimeshift) {
+			const unsigned long iEditHeadTime = m_tools.iEditHeadTime;
+			const unsigned long iEditTailTime = m_tools.iEditTailTime;
 			const float d = float(iEditTailTime - iEditHeadTime);
-			const float p = float(m_ui.TimeshiftSpinBox->value());
+			const float p = m_tools.fTimeshift;
 			if ((p < -1e-6f || p > 1e-6f) && (d > 0.0f)) {
 				const float t = float(iTime - iEditHeadTime);
 				float t1 = t / d;
 				float t2 = (t + float(iDuration)) / d;
 				if (t1 > 0.0f && t1 < 1.0f)
 					t1 = TimeshiftCurve::timeshift(t1, p);
-				if (m_ui.TimeshiftDurationCheckBox->isChecked()
+				if (m_tools.bTimeshiftDuration
 					&& (t2 > 0.0f && t2 < 1.0f))
 					t2 = TimeshiftCurve::timeshift(t2, p);
 				t1 = t1 * d + float(iEditHeadTime);
-				if (m_ui.TimeshiftDurationCheckBox->isChecked()) {
+				if (m_tools.bTimeshiftDuration) {
 					t2 = t2 * d + float(iEditHeadTime);
 					pEditCommand->resizeEventTime(pEvent,
 						t1 - iTimeOffset, t2 - t1);
@@ -1151,6 +1220,9 @@ void qtractorMidiToolsForm::accept (void)
 	// Save as default preset...
 	savePreset(g_sDefPreset);
 
+	// Take the current tool settings...
+	updateTools();
+
 	// Just go with dialog acceptance.
 	QDialog::accept();
 }
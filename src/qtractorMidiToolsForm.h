@@ -50,7 +50,8 @@ public:
 	void setToolIndex(int iToolIndex);
 	int toolIndex() const;
 
-	// Create edit command based on given selection.
+	// Create edit command based on given selection
+	// (thread-safe, after the form has been accepted).
 	qtractorMidiEditCommand *editCommand(qtractorMidiClip *pMidiClip,
 		qtractorMidiEditSelect *pSelect, unsigned long iTimeOffset,
 		unsigned long iTimeStart = 0, unsigned long iTimeEnd = 0);
@@ -81,6 +82,9 @@ protected:
 
 	void refreshPresets();
 
+	// Tool settings snapshot (to be safe off the GUI thread).
+	void updateTools();
+
 private:
 
 	// The Qt-designer UI struct...
@@ -93,6 +97,67 @@ private:
 	int m_iUpdate;
 
 	class TimeshiftCurve *m_pTimeshiftCurve;
+
+	// Tool settings snapshot (taken on acceptance).
+	struct Tools
+	{
+		QString       sName;
+		bool          bQuantize;
+		bool          bQuantizeSwing;
+		int           iQuantizeSwingIndex;
+		float         fQuantizeSwing;
+		int           iQuantizeSwingTypeIndex;
+		bool          bQuantizeTime;
+		int           iQuantizeTimeIndex;
+		float         fQuantizeTime;
+		bool          bQuantizeDuration;
+		int           iQuantizeDurationIndex;
+		float         fQuantizeDuration;
+		bool          bQuantizeScale;
+		int           iQuantizeScaleKeyIndex;
+		int           iQuantizeScaleIndex;
+		bool          bTranspose;
+		bool          bTransposeReverse;
+		bool          bTransposeNote;
+		int           iTransposeNote;
+		bool          bTransposeTime;
+		unsigned long iTransposeTime;
+		bool          bNormalize;
+		bool          bNormalizeValue;
+		int           iNormalizeValue;
+		bool          bNormalizePercent;
+		float         fNormalizePercent;
+		bool          bRandomize;
+		bool          bRandomizeNote;
+		float         fRandomizeNote;
+		bool          bRandomizeTime;
+		float         fRandomizeTime;
+		bool          bRandomizeDuration;
+		float         fRandomizeDuration;
+		bool          bRandomizeValue;
+		float         fRandomizeValue;
+		bool          bResize;
+		bool          bResizeValue;
+		int           iResizeValue2Index;
+		bool          bResizeDuration;
+		unsigned long iResizeDuration;
+		int           iResizeValue;
+		int           iResizeValue2;
+		bool          bRescale;
+		bool          bRescaleTime;
+		float         fRescaleTime;
+		bool          bRescaleDuration;
+		float         fRescaleDuration;
+		bool          bRescaleValue;
+		float         fRescaleValue;
+		bool          bTimeshift;
+		float         fTimeshift;
+		bool          bTimeshiftDuration;
+		unsigned long iEditHeadTime;
+		unsigned long iEditTailTime;
+	};
+
+	Tools m_tools;
 };
 
 
@@ -94,6 +94,7 @@ void qtractorOptions::loadOptions (void)
 	bKeepToolsOnTop = m_settings.value("/KeepToolsOnTop", true).toBool();
 	iDisplayFormat  = m_settings.value("/DisplayFormat", 1).toInt();
 	iMaxRecentFiles = m_settings.value("/MaxRecentFiles", 5).toInt();
+	iMaxUndoSize    = m_settings.value("/MaxUndoSize", 256).toInt();
 	iBaseFontSize   = m_settings.value("/BaseFontSize", 0).toInt();
 	m_settings.endGroup();
 
@@ -138,6 +139,10 @@ void qtractorOptions::loadOptions (void)
 	bAudioAutoTimeStretch = m_settings.value("/AutoTimeStretch", false).toBool();
 	bAudioWsolaTimeStretch = m_settings.value("/WsolaTimeStretch", true).toBool();
 	bAudioWsolaQuickSeek = m_settings.value("/WsolaQuickSeek", false).toBool();
+	bAudioRenderAhead    = m_settings.value("/RenderAhead", false).toBool();
+	iAudioSilentHold     = m_settings.value("/SilentHold", 1000).toInt();
+	bAudioPinned         = m_settings.value("/Pinned", false).toBool();
+	iAudioPinnedBudget   = m_settings.value("/PinnedBudget", 4096).toInt();
 	bAudioPlayerBus      = m_settings.value("/PlayerBus", false).toBool();
 	bAudioMetroBus       = m_settings.value("/MetroBus", false).toBool();
 	bAudioMetronome      = m_settings.value("/Metronome", false).toBool();
@@ -213,6 +218,9 @@ void qtractorOptions::loadOptions (void)
 	bMidButtonModifier = m_settings.value("/MidButtonModifier", false).toBool();
 	bMidiControlSync = m_settings.value("/MidiControlSync", false).toBool();
 	bExportAddTrack = m_settings.value("/ExportAddTrack", false).toBool();
+	bExportStems = m_settings.value("/ExportStems", false).toBool();
+	bExportTracks = m_settings.value("/ExportTracks", false).toBool();
+	bExportDither = m_settings.value("/ExportDither", false).toBool();
 	m_settings.endGroup();
 
 	// Session auto-save group.
@@ -385,6 +393,7 @@ void qtractorOptions::saveOptions (void)
 	m_settings.setValue("/KeepToolsOnTop", bKeepToolsOnTop);
 	m_settings.setValue("/DisplayFormat", iDisplayFormat);
 	m_settings.setValue("/MaxRecentFiles", iMaxRecentFiles);
+	m_settings.setValue("/MaxUndoSize", iMaxUndoSize);
 	m_settings.setValue("/BaseFontSize", iBaseFontSize);
 	m_settings.endGroup();
 
@@ -429,6 +438,10 @@ void qtractorOptions::saveOptions (void)
 	m_settings.setValue("/AutoTimeStretch", bAudioAutoTimeStretch);
 	m_settings.setValue("/WsolaTimeStretch", bAudioWsolaTimeStretch);
 	m_settings.setValue("/WsolaQuickSeek", bAudioWsolaQuickSeek);
+	m_settings.setValue("/RenderAhead", bAudioRenderAhead);
+	m_settings.setValue("/SilentHold", iAudioSilentHold);
+	m_settings.setValue("/Pinned", bAudioPinned);
+	m_settings.setValue("/PinnedBudget", iAudioPinnedBudget);
 	m_settings.setValue("/PlayerBus", bAudioPlayerBus);
 	m_settings.setValue("/MetroBus", bAudioMetroBus);
 	m_settings.setValue("/Metronome", bAudioMetronome);
@@ -504,6 +517,9 @@ void qtractorOptions::saveOptions (void)
 	m_settings.setValue("/MidButtonModifier", bMidButtonModifier);
 	m_settings.setValue("/MidiControlSync", bMidiControlSync);
 	m_settings.setValue("/ExportAddTrack", bExportAddTrack);
+	m_settings.setValue("/ExportStems", bExportStems);
+	m_settings.setValue("/ExportTracks", bExportTracks);
+	m_settings.setValue("/ExportDither", bExportDither);
 	m_settings.endGroup();
 
 	// Session auto-save group.
@@ -109,6 +109,10 @@ public:
 	bool    bAudioAutoTimeStretch;
 	bool    bAudioWsolaTimeStretch;
 	bool    bAudioWsolaQuickSeek;
+	bool    bAudioRenderAhead;
+	int     iAudioSilentHold;
+	bool    bAudioPinned;
+	int     iAudioPinnedBudget;
 	bool    bAudioPlayerBus;
 	bool    bAudioMetroBus;
 	bool    bAudioMetronome;
@@ -199,6 +203,11 @@ public:
 	// Export add new track(s) option.
 	bool    bExportAddTrack;
 
+	// Export stems (one file per bus/track) options.
+	bool    bExportStems;
+	bool    bExportTracks;
+	bool    bExportDither;
+
 	// Session auto-save options.
 	bool    bAutoSaveEnabled;
 	int     iAutoSavePeriod;
@@ -244,6 +253,9 @@ public:
 	int iMaxRecentFiles;
 	QStringList recentFiles;
 
+	// Undo/redo history memory budget (MB).
+	int iMaxUndoSize;
+
 	// Tracks view options...
 	int  iTrackViewSelectMode;
 	bool bTrackViewDropSpan;
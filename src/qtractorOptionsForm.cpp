@@ -225,6 +225,18 @@ qtractorOptionsForm::qtractorOptionsForm (
 	QObject::connect(m_ui.AudioWsolaQuickSeekCheckBox,
 		SIGNAL(stateChanged(int)),
 		SLOT(changed()));
+	QObject::connect(m_ui.AudioRenderAheadCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.AudioSilentHoldSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.AudioPinnedCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.AudioPinnedBudgetSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(changed()));
 	QObject::connect(m_ui.AudioPlayerBusCheckBox,
 		SIGNAL(stateChanged(int)),
 		SLOT(changed()));
@@ -354,6 +366,9 @@ qtractorOptionsForm::qtractorOptionsForm (
 	QObject::connect(m_ui.MaxRecentFilesSpinBox,
 		SIGNAL(valueChanged(int)),
 		SLOT(changed()));
+	QObject::connect(m_ui.MaxUndoSizeSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(changed()));
 	QObject::connect(m_ui.BaseFontSizeComboBox,
 		SIGNAL(editTextChanged(const QString&)),
 		SLOT(changed()));
@@ -555,6 +570,10 @@ void qtractorOptionsForm::setOptions ( qtractorOptions *pOptions )
 	m_ui.AudioWsolaTimeStretchCheckBox->setEnabled(false);
 #endif
 	m_ui.AudioWsolaQuickSeekCheckBox->setChecked(m_pOptions->bAudioWsolaQuickSeek);
+	m_ui.AudioRenderAheadCheckBox->setChecked(m_pOptions->bAudioRenderAhead);
+	m_ui.AudioSilentHoldSpinBox->setValue(m_pOptions->iAudioSilentHold);
+	m_ui.AudioPinnedCheckBox->setChecked(m_pOptions->bAudioPinned);
+	m_ui.AudioPinnedBudgetSpinBox->setValue(m_pOptions->iAudioPinnedBudget);
 	m_ui.AudioPlayerBusCheckBox->setChecked(m_pOptions->bAudioPlayerBus);
 	m_ui.AudioPlayerAutoConnectCheckBox->setChecked(m_pOptions->bAudioPlayerAutoConnect);
 
@@ -686,6 +705,7 @@ void qtractorOptionsForm::setOptions ( qtractorOptions *pOptions )
 	m_ui.TrackListMetersCheckBox->setChecked(m_pOptions->bTrackListMeters);
 	m_ui.MidButtonModifierCheckBox->setChecked(m_pOptions->bMidButtonModifier);
 	m_ui.MaxRecentFilesSpinBox->setValue(m_pOptions->iMaxRecentFiles);
+	m_ui.MaxUndoSizeSpinBox->setValue(m_pOptions->iMaxUndoSize);
 	m_ui.LoopRecordingModeComboBox->setCurrentIndex(m_pOptions->iLoopRecordingMode);
 	m_ui.DisplayFormatComboBox->setCurrentIndex(m_pOptions->iDisplayFormat);
 	if (m_pOptions->iBaseFontSize > 0)
@@ -767,6 +787,10 @@ void qtractorOptionsForm::accept (void)
 		m_pOptions->bAudioAutoTimeStretch = m_ui.AudioAutoTimeStretchCheckBox->isChecked();
 		m_pOptions->bAudioWsolaTimeStretch = m_ui.AudioWsolaTimeStretchCheckBox->isChecked();
 		m_pOptions->bAudioWsolaQuickSeek = m_ui.AudioWsolaQuickSeekCheckBox->isChecked();
+		m_pOptions->bAudioRenderAhead    = m_ui.AudioRenderAheadCheckBox->isChecked();
+		m_pOptions->iAudioSilentHold     = m_ui.AudioSilentHoldSpinBox->value();
+		m_pOptions->bAudioPinned         = m_ui.AudioPinnedCheckBox->isChecked();
+		m_pOptions->iAudioPinnedBudget   = m_ui.AudioPinnedBudgetSpinBox->value();
 		m_pOptions->bAudioPlayerBus      = m_ui.AudioPlayerBusCheckBox->isChecked();
 		m_pOptions->bAudioPlayerAutoConnect = m_ui.AudioPlayerAutoConnectCheckBox->isChecked();
 		// Audio metronome options.
@@ -812,6 +836,7 @@ void qtractorOptionsForm::accept (void)
 		m_pOptions->bTrackListMeters     = m_ui.TrackListMetersCheckBox->isChecked();
 		m_pOptions->bMidButtonModifier   = m_ui.MidButtonModifierCheckBox->isChecked();
 		m_pOptions->iMaxRecentFiles      = m_ui.MaxRecentFilesSpinBox->value();
+		m_pOptions->iMaxUndoSize         = m_ui.MaxUndoSizeSpinBox->value();
 		m_pOptions->iLoopRecordingMode   = m_ui.LoopRecordingModeComboBox->currentIndex();
 		m_pOptions->iDisplayFormat       = m_ui.DisplayFormatComboBox->currentIndex();
 		m_pOptions->iBaseFontSize        = m_ui.BaseFontSizeComboBox->currentText().toInt();
@@ -1576,6 +1601,9 @@ void qtractorOptionsForm::stabilizeForm (void)
 	m_ui.AudioPlayerAutoConnectCheckBox->setEnabled(
 		m_ui.AudioPlayerBusCheckBox->isChecked());
 
+	m_ui.AudioPinnedBudgetSpinBox->setEnabled(
+		m_ui.AudioPinnedCheckBox->isChecked());
+
 	const bool bAudioMetronome = m_ui.AudioMetronomeCheckBox->isChecked();
 	m_ui.MetroBarFilenameTextLabel->setEnabled(bAudioMetronome);
 	m_ui.MetroBarFilenameComboBox->setEnabled(bAudioMetronome);
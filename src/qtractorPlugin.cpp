@@ -39,12 +39,20 @@
 
 #include "qtractorMessageList.h"
 
+#include "qtractorAtomic.h"
+
 #include <QTextStream>
 #include <QFileInfo>
 #include <QDir>
 
 #include <QDomDocument>
 
+#include <QCryptographicHash>
+
+#include <QThread>
+#include <QVector>
+#include <QSet>
+
 #include <math.h>
 
 
@@ -229,6 +237,297 @@ QString qtractorPluginType::textFromHint (
 }
 
 
+//----------------------------------------------------------------------------
+// qtractorPluginBatch -- Parallel plugin (re)instantiation batch.
+//
+// Thread-safe plugin types (LADSPA, DSSI, LV2) get their instances
+// (re)created and their configuration state restored over a pool of
+// worker threads; plugins from the same library file are kept in the
+// same lane, one after the other, as most plugin standards forbid
+// concurrent instantiation within the same plugin library. Parameter
+// values and activation are realized later, back on the main thread.
+//
+
+class qtractorPluginBatch
+{
+public:
+
+	// Constructor.
+	qtractorPluginBatch() : m_iLanes(0) { ATOMIC_SET(&m_next, 0); }
+
+	// Destructor.
+	~qtractorPluginBatch() { clear(); }
+
+	// Whether the plugin type may be instantiated off the main thread.
+	static bool isThreadSafe(qtractorPlugin *pPlugin);
+
+	// Batch item registry (main thread).
+	void addPlugin(qtractorPlugin *pPlugin,
+		unsigned short iChannels, bool bReset);
+	bool takePlugin(qtractorPlugin *pPlugin);
+	void removePlugin(qtractorPlugin *pPlugin);
+
+	// Run all pending items, then realize them (main thread).
+	void execute();
+
+	// Worker thread executive.
+	void process();
+
+	// Whether there's anything pending.
+	bool isEmpty() const { return m_items.isEmpty(); }
+
+protected:
+
+	// Batch item.
+	struct Item
+	{
+		qtractorPlugin *plugin;
+		unsigned short  channels;
+		bool            reset;
+		bool            realized;
+		bool            activated;
+		qtractorPlugin::Values values;
+	};
+
+	// Give a pending item back to its former state (main thread).
+	void restoreItem(Item *pItem);
+
+	// Cleanup.
+	void clear();
+
+private:
+
+	// Instance variables.
+	QList<Item *> m_items;
+	QHash<qtractorPlugin *, Item *> m_hash;
+
+	// Per library file lanes (worker threads).
+	QVector<QList<Item *> > m_lanes;
+	int m_iLanes;
+
+	qtractorAtomic m_next;
+};
+
+
+//----------------------------------------------------------------------------
+// qtractorPluginBatchThread -- Parallel plugin batch worker thread.
+
+class qtractorPluginBatchThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorPluginBatchThread(qtractorPluginBatch *pBatch)
+		: QThread(), m_pBatch(pBatch) {}
+
+protected:
+
+	// The main thread executive.
+	void run() { m_pBatch->process(); }
+
+private:
+
+	// Instance variables.
+	qtractorPluginBatch *m_pBatch;
+};
+
+
+// Whether the plugin type may be instantiated off the main thread;
+// VST and the insert/aux-send pseudo-plugins stay on the main thread.
+bool qtractorPluginBatch::isThreadSafe ( qtractorPlugin *pPlugin )
+{
+	qtractorPluginType *pType = pPlugin->type();
+	if (pType == NULL)
+		return false;
+
+	switch (pType->typeHint()) {
+	case qtractorPluginType::Ladspa:
+	case qtractorPluginType::Dssi:
+	case qtractorPluginType::Lv2:
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+// Batch item registry (main thread).
+void qtractorPluginBatch::addPlugin ( qtractorPlugin *pPlugin,
+	unsigned short iChannels, bool bReset )
+{
+	Item *pItem = m_hash.value(pPlugin, NULL);
+	if (pItem) {
+		pItem->channels = iChannels;
+		pItem->reset = (pItem->reset || bReset);
+		return;
+	}
+
+	pItem = new Item;
+	pItem->plugin    = pPlugin;
+	pItem->channels  = iChannels;
+	pItem->reset     = bReset;
+	pItem->realized  = false;
+	pItem->activated = pPlugin->isActivated();
+	pItem->values    = pPlugin->values();
+
+	// Parameter values and activation are not thread-safe,
+	// so keep them out of the way for the time being...
+	pPlugin->clearValues();
+	pPlugin->setActivated(false);
+
+	m_items.append(pItem);
+	m_hash.insert(pPlugin, pItem);
+}
+
+
+// Give a pending plugin back to its former state, if any (main thread).
+bool qtractorPluginBatch::takePlugin ( qtractorPlugin *pPlugin )
+{
+	Item *pItem = m_hash.take(pPlugin);
+	if (pItem == NULL)
+		return false;
+
+	m_items.removeAll(pItem);
+	restoreItem(pItem);
+	delete pItem;
+
+	return true;
+}
+
+
+// Forget a pending plugin, if any (eg. on destruction).
+void qtractorPluginBatch::removePlugin ( qtractorPlugin *pPlugin )
+{
+	Item *pItem = m_hash.take(pPlugin);
+	if (pItem == NULL)
+		return;
+
+	m_items.removeAll(pItem);
+	delete pItem;
+}
+
+
+// Give a pending item back to its former state (main thread).
+void qtractorPluginBatch::restoreItem ( Item *pItem )
+{
+	qtractorPlugin *pPlugin = pItem->plugin;
+	pPlugin->setValues(pItem->values);
+	pPlugin->setActivated(pItem->activated);
+}
+
+
+// Worker thread executive: keep picking lanes until none left.
+void qtractorPluginBatch::process (void)
+{
+	for (;;) {
+		const int iLane = ATOMIC_INC(&m_next) - 1;
+		if (iLane >= m_iLanes)
+			break;
+		QListIterator<Item *> iter(m_lanes.at(iLane));
+		while (iter.hasNext()) {
+			Item *pItem = iter.next();
+			qtractorPlugin *pPlugin = pItem->plugin;
+			const unsigned short iOldInstances = pPlugin->instances();
+			pPlugin->setChannels(pItem->channels);
+			// New instances have had their configuration realized...
+			const unsigned short iInstances = pPlugin->instances();
+			pItem->realized = (iInstances > 0 && iInstances != iOldInstances);
+		}
+	}
+}
+
+
+// Run all pending items, then realize them (main thread).
+void qtractorPluginBatch::execute (void)
+{
+	if (m_items.isEmpty())
+		return;
+
+	// Sort items into lanes, one per plugin library file...
+	QHash<QString, int> files;
+	QListIterator<Item *> iter(m_items);
+	while (iter.hasNext()) {
+		Item *pItem = iter.next();
+		const QString& sFilename = (pItem->plugin)->type()->filename();
+		int iLane = files.value(sFilename, -1);
+		if (iLane < 0) {
+			iLane = m_lanes.count();
+			files.insert(sFilename, iLane);
+			m_lanes.append(QList<Item *> ());
+		}
+		m_lanes[iLane].append(pItem);
+	}
+
+	m_iLanes = m_lanes.count();
+	ATOMIC_SET(&m_next, 0);
+
+	int iThreads = QThread::idealThreadCount();
+	if (iThreads > m_iLanes)
+		iThreads = m_iLanes;
+
+	if (iThreads > 1) {
+		QList<qtractorPluginBatchThread *> threads;
+		for (int i = 0; i < iThreads; ++i) {
+			qtractorPluginBatchThread *pThread
+				= new qtractorPluginBatchThread(this);
+			threads.append(pThread);
+			pThread->start();
+		}
+		QListIterator<qtractorPluginBatchThread *> thread_iter(threads);
+		while (thread_iter.hasNext())
+			thread_iter.next()->wait();
+		qDeleteAll(threads);
+	} else {
+		// Not worth the trouble...
+		process();
+	}
+
+	// Realize parameter values and activation, in chain order...
+	QSet<qtractorPluginList *> lists;
+	iter.toFront();
+	while (iter.hasNext()) {
+		Item *pItem = iter.next();
+		qtractorPlugin *pPlugin = pItem->plugin;
+		pPlugin->setValues(pItem->values);
+		const bool bReset = (pItem->reset && !pItem->realized);
+		if (bReset)
+			pPlugin->realizeConfigs();
+		pPlugin->realizeValues();
+		if (bReset)
+			pPlugin->releaseConfigs();
+		pPlugin->releaseValues();
+		pPlugin->setActivated(pItem->activated);
+		lists.insert(pPlugin->list());
+	}
+
+	// Instrument (bank/program) names may have changed...
+	QSetIterator<qtractorPluginList *> list_iter(lists);
+	while (list_iter.hasNext()) {
+		qtractorMidiManager *pMidiManager = list_iter.next()->midiManager();
+		if (pMidiManager)
+			pMidiManager->updateInstruments();
+	}
+
+	clear();
+}
+
+
+// Cleanup.
+void qtractorPluginBatch::clear (void)
+{
+	qDeleteAll(m_items);
+	m_items.clear();
+	m_hash.clear();
+
+	m_lanes.clear();
+	m_iLanes = 0;
+}
+
+
+// The pending (deferred) plugin batch singleton.
+static qtractorPluginBatch g_pluginBatch;
+
+
 //----------------------------------------------------------------------------
 // qtractorPlugin -- Plugin instance.
 //
@@ -241,7 +540,7 @@ QString qtractorPlugin::g_sDefPreset = QObject::tr("(default)");
 qtractorPlugin::qtractorPlugin (
 	qtractorPluginList *pList, qtractorPluginType *pType )
 	: m_pList(pList), m_pType(pType), m_iUniqueID(0), m_iInstances(0),
-		m_bActivated(false), m_activateObserver(this),
+		m_bActivated(false), m_iTailLength(0), m_activateObserver(this),
 		m_iActivateSubjectIndex(0), m_pForm(NULL), m_iEditorType(-1),
 		m_iDirectAccessParamIndex(-1)
 {
@@ -261,6 +560,9 @@ qtractorPlugin::~qtractorPlugin (void)
 	// Clear out all dependables...
 	clearItems();
 
+	// Not pending anymore, if ever...
+	g_pluginBatch.removePlugin(this);
+
 	// Clear out all dependables...
 	qDeleteAll(m_params);
 	m_params.clear();
@@ -912,9 +1214,38 @@ void qtractorPlugin::realizeValues (void)
 }
 
 
+// Minimum encoded size for a config item to go into the BLOB store.
+static const int c_iConfigBlobSize = 4096;
+
+
+// Plugin configuration (BLOB) stuff; binary state gets compressed
+// and base64 encoded, but only if changed since last time.
+void qtractorPlugin::setConfigBlob (
+	const QString& sKey, const QByteArray& data )
+{
+	const QByteArray& digest
+		= QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+
+	ConfigBlob& cblob = m_cblobs[sKey];
+	if (cblob.digest != digest || cblob.text.isEmpty()) {
+		const QByteArray& zdata = qCompress(data);
+		QByteArray text = zdata.toBase64();
+		for (int i = text.size() - (text.size() % 72); i >= 0; i -= 72)
+			text.insert(i, "\n       "); // Indentation.
+		cblob.digest = digest;
+		cblob.hash = QString::fromLatin1(QCryptographicHash::hash(
+			zdata, QCryptographicHash::Sha1).toHex());
+		cblob.text = QString::fromLatin1(text.constData(), text.size());
+	}
+
+	setConfig(sKey, cblob.text);
+}
+
+
 // Load plugin configuration stuff (CLOB).
 void qtractorPlugin::loadConfigs (
-	QDomElement *pElement, Configs& configs, ConfigTypes& ctypes )
+	QDomElement *pElement, Configs& configs, ConfigTypes& ctypes,
+	qtractorDocument *pDocument )
 {
 	for (QDomNode nConfig = pElement->firstChild();
 			!nConfig.isNull();
@@ -926,7 +1257,19 @@ void qtractorPlugin::loadConfigs (
 		if (eConfig.tagName() == "config") {
 			const QString& sKey = eConfig.attribute("key");
 			if (!sKey.isEmpty()) {
-				configs[sKey] = eConfig.text();
+				const QString& sBlob = eConfig.attribute("blob");
+				if (!sBlob.isEmpty() && pDocument) {
+					QString sText;
+					if (!pDocument->loadBlob(sBlob, sText)) {
+						// Leave it absent, never restore an empty state...
+						qtractorMessageList::append(
+							QObject::tr("%1: Plugin state file not found.")
+								.arg(sBlob));
+						continue;
+					}
+					configs[sKey] = sText;
+				}
+				else configs[sKey] = eConfig.text();
 				const QString& sType = eConfig.attribute("type");
 				if (!sType.isEmpty())
 					ctypes[sKey] = sType;
@@ -977,6 +1320,45 @@ void qtractorPlugin::saveConfigs (
 }
 
 
+// Save plugin configuration stuff (CLOB), where large binary
+// state items (BLOB) may go into the document sidecar store.
+void qtractorPlugin::saveConfigs (
+	qtractorDocument *pDocument, QDomElement *pElement )
+{
+	QDomDocument *pDomDocument = pDocument->document();
+
+	const bool bBlobStore = pDocument->isBlobStore();
+
+	// Save plugin configs...
+	Configs::ConstIterator iter = m_configs.constBegin();
+	const Configs::ConstIterator& iter_end = m_configs.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		const QString& sKey = iter.key();
+		const QString& sValue = iter.value();
+		QDomElement eConfig = pDomDocument->createElement("config");
+		eConfig.setAttribute("key", sKey);
+		ConfigTypes::ConstIterator ctype = m_ctypes.find(sKey);
+		if (ctype != m_ctypes.constEnd())
+			eConfig.setAttribute("type", ctype.value());
+		QString sBlob;
+		if (bBlobStore && sValue.length() > c_iConfigBlobSize) {
+			// Reuse the encoded data hash, if still current...
+			QString sHash;
+			ConfigBlobs::ConstIterator cblob = m_cblobs.constFind(sKey);
+			if (cblob != m_cblobs.constEnd() && cblob.value().text == sValue)
+				sHash = cblob.value().hash;
+			sBlob = pDocument->saveBlob(sValue, sHash);
+		}
+		if (sBlob.isEmpty()) {
+			eConfig.appendChild(
+				pDomDocument->createTextNode(sValue));
+		}
+		else eConfig.setAttribute("blob", sBlob);
+		pElement->appendChild(eConfig);
+	}
+}
+
+
 // Save plugin parameter values.
 void qtractorPlugin::saveValues (
 	QDomDocument *pDocument, QDomElement *pElement )
@@ -1365,6 +1747,9 @@ qtractorPluginList::qtractorPluginList (
 	m_pppBuffers[0] = NULL;
 	m_pppBuffers[1] = NULL;
 
+	m_iSilentFrames = 0;
+	m_iSampleRate = 0;
+
 	m_pCurveList = new qtractorCurveList();
 
 	m_bAudioOutputBus
@@ -1482,6 +1867,10 @@ void qtractorPluginList::setChannelsEx (
 
 	const unsigned int iBufferSize = pAudioEngine->bufferSize();
 
+	// Ring-out hold time reference...
+	m_iSilentFrames = 0;
+	m_iSampleRate = pAudioEngine->sampleRate();
+
 	// Allocate new interim buffer...
 	if (m_iChannels > 0) {
 		m_pppBuffers[1] = new float * [m_iChannels];
@@ -1498,6 +1887,12 @@ void qtractorPluginList::setChannelsEx (
 			pPlugin->freezeConfigs();
 			pPlugin->freezeValues();
 		}
+		// Thread-safe plugin types go in parallel, later...
+		if (m_iChannels > 0 && qtractorPluginBatch::isThreadSafe(pPlugin)) {
+			g_pluginBatch.addPlugin(pPlugin, m_iChannels, bReset);
+			continue;
+		}
+		g_pluginBatch.takePlugin(pPlugin);
 		pPlugin->setChannels(m_iChannels);
 		if (bReset && m_iChannels > 0) {
 			pPlugin->realizeConfigs();
@@ -1506,6 +1901,17 @@ void qtractorPluginList::setChannelsEx (
 			pPlugin->releaseValues();
 		}
 	}
+
+	// Unless deferred (eg. session loading), do it now...
+	if (!pSession->isDeferPlugins())
+		g_pluginBatch.execute();
+}
+
+
+// Deferred (parallel) plugin instantiation (eg. after session loading).
+void qtractorPluginList::openDeferPlugins (void)
+{
+	g_pluginBatch.execute();
 }
 
 
@@ -1776,6 +2182,105 @@ void qtractorPluginList::process ( float **ppBuffer, unsigned int nframes )
 }
 
 
+// Silence-aware plugin-chain procedure.
+bool qtractorPluginList::process (
+	float **ppBuffer, unsigned int nframes, bool bSilent )
+{
+	// Non-silent input: business as usual...
+	if (!bSilent) {
+		m_iSilentFrames = 0;
+		process(ppBuffer, nframes);
+		return true;
+	}
+
+	// Silent input: nothing to ring out anymore?
+	if (isSilent())
+		return false;
+
+	// Keep the chain running until its output
+	// stays silent for longer than any tail...
+	process(ppBuffer, nframes);
+
+	if (isSilentBuffer(ppBuffer, m_iChannels, nframes))
+		m_iSilentFrames += nframes;
+	else
+		m_iSilentFrames = 0;
+
+	return true;
+}
+
+
+// Whether the plugin-chain output is known to be silent.
+bool qtractorPluginList::isSilent (void) const
+{
+	if (!isActivated())
+		return true;
+
+	// Endless ring-out?
+	if (g_iSilentHold < 1)
+		return false;
+
+	// Ring-out hold time, for plugins with unknown tail length...
+	unsigned long iTailLength = (unsigned long)
+		(0.001f * float(g_iSilentHold) * float(m_iSampleRate));
+
+	for (qtractorPlugin *pPlugin = first();
+			pPlugin; pPlugin = pPlugin->next()) {
+		if (!pPlugin->isActivated())
+			continue;
+		// Aux-sends are just routing, never a tail...
+		const qtractorPluginType::Hint typeHint
+			= pPlugin->type()->typeHint();
+		if (typeHint == qtractorPluginType::AuxSend)
+			continue;
+		// Inserts return whatever comes from outside, and
+		// sound generators are never silent either...
+		if (typeHint == qtractorPluginType::Insert
+			|| pPlugin->audioIns() < 1)
+			return false;
+		// Tails may pile up along the chain...
+		iTailLength += pPlugin->tailLength();
+	}
+
+	return (m_iSilentFrames >= iTailLength);
+}
+
+
+// Ring-out hold time (in msecs; zero for endless).
+unsigned int qtractorPluginList::g_iSilentHold = 1000;
+
+void qtractorPluginList::setSilentHold ( unsigned int iSilentHold )
+{
+	g_iSilentHold = iSilentHold;
+}
+
+unsigned int qtractorPluginList::silentHold (void)
+{
+	return g_iSilentHold;
+}
+
+
+// Silent buffer predicate helper (below -100dB).
+bool qtractorPluginList::isSilentBuffer ( float **ppBuffer,
+	unsigned short iChannels, unsigned int nframes )
+{
+	if (ppBuffer == NULL || *ppBuffer == NULL)
+		return true;
+
+	const float fThreshold = 1e-5f; // -100dB.
+
+	for (unsigned short i = 0; i < iChannels; ++i) {
+		const float *pFrames = ppBuffer[i];
+		for (unsigned int n = 0; n < nframes; ++n) {
+			if (pFrames[n] > fThreshold || pFrames[n] < -fThreshold)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+
 // Document element methods.
 bool qtractorPluginList::loadElement (
 	qtractorDocument *pDocument, QDomElement *pElement )
@@ -1857,7 +2362,8 @@ bool qtractorPluginList::loadElement (
 				else
 				if (eParam.tagName() == "configs") {
 					// Load plugin configuration stuff (CLOB)...
-					qtractorPlugin::loadConfigs(&eParam, configs, ctypes);
+					qtractorPlugin::loadConfigs(
+						&eParam, configs, ctypes, pDocument);
 				}
 				else
 				if (eParam.tagName() == "params") {
@@ -2019,7 +2525,7 @@ bool qtractorPluginList::saveElement ( qtractorDocument *pDocument,
 			qtractorDocument::textFromBool(pPlugin->isActivated()), &ePlugin);
 		// Plugin configuration stuff (CLOB)...
 		QDomElement eConfigs = pDocument->document()->createElement("configs");
-		pPlugin->saveConfigs(pDocument->document(), &eConfigs);
+		pPlugin->saveConfigs(pDocument, &eConfigs);
 		ePlugin.appendChild(eConfigs);
 		// Plugin parameter values...
 		QDomElement eParams = pDocument->document()->createElement("params");
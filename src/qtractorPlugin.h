@@ -409,6 +409,12 @@ public:
 	unsigned short midiOuts() const
 		{ return m_pType->midiOuts(); }
 
+	// Audio tail length accessors (in frames; zero if unknown).
+	void setTailLength(unsigned long iTailLength)
+		{ m_iTailLength = iTailLength; }
+	unsigned long tailLength() const
+		{ return m_iTailLength; }
+
 	// Plugin state serialization methods.
 	void setValueList(const QStringList& vlist);
 	QStringList valueList() const;
@@ -571,6 +577,10 @@ public:
 	const QString& config(const QString& sKey)
 		{ return m_configs[sKey]; }
 
+	// Plugin configuration (BLOB) stuff; binary state gets
+	// encoded only when changed since last time (by hash).
+	void setConfigBlob(const QString& sKey, const QByteArray& data);
+
 	// Plugin configuration (types) stuff.
 	typedef QHash<QString, QString> ConfigTypes;
 
@@ -612,11 +622,13 @@ public:
 
 	// Load plugin configuration/parameter values stuff.
 	static void loadConfigs(
-		QDomElement *pElement, Configs& configs, ConfigTypes& ctypes);
+		QDomElement *pElement, Configs& configs, ConfigTypes& ctypes,
+		qtractorDocument *pDocument = NULL);
 	static void loadValues(QDomElement *pElement, Values& values);
 
 	// Save plugin configuration/parameter values stuff.
 	void saveConfigs(QDomDocument *pDocument, QDomElement *pElement);
+	void saveConfigs(qtractorDocument *pDocument, QDomElement *pElement);
 	void saveValues(QDomDocument *pDocument, QDomElement *pElement);
 
 	// Load/save plugin parameter controllers (MIDI).
@@ -669,6 +681,9 @@ private:
 	// Activation flag.
 	bool m_bActivated;
 
+	// Audio tail length (in frames).
+	unsigned long m_iTailLength;
+
 	// Activate subject value.
 	qtractorSubject m_activateSubject;
 
@@ -723,6 +738,17 @@ private:
 	// Plugin configuration (type) stuff.
 	ConfigTypes m_ctypes;
 
+	// Plugin configuration (BLOB) encoding cache.
+	struct ConfigBlob
+	{
+		QByteArray digest;	// Raw binary state hash.
+		QString    hash;	// Encoded (compressed) data hash.
+		QString    text;	// Encoded (base64) data.
+	};
+
+	typedef QHash<QString, ConfigBlob> ConfigBlobs;
+	ConfigBlobs m_cblobs;
+
 	// Plugin parameter values (part of configuration).
 	Values m_values;
 
@@ -774,6 +800,9 @@ public:
 	void setChannels(unsigned short iChannels, unsigned int iFlags);
 	void setChannelsEx(unsigned short iChannels, bool bReset = false);
 
+	// Deferred (parallel) plugin instantiation (eg. after session loading).
+	static void openDeferPlugins();
+
 	// Reset and (re)activate all plugin chain.
 	void resetBuffers();
 
@@ -828,6 +857,24 @@ public:
 	// The meta-main audio-processing plugin-chain procedure.
 	void process(float **ppBuffer, unsigned int nframes);
 
+	// Silence-aware plugin-chain procedure: plugin tails are
+	// rung out after the input went silent; returns false when
+	// the chain output is known to be silent (left unprocessed).
+	bool process(float **ppBuffer, unsigned int nframes, bool bSilent);
+
+	// Whether the plugin-chain output is known to be silent,
+	// given silent input (ie. all tails have rung out).
+	bool isSilent() const;
+
+	// Silent buffer predicate helper (below -100dB).
+	static bool isSilentBuffer(float **ppBuffer,
+		unsigned short iChannels, unsigned int nframes);
+
+	// Ring-out hold time, for plugins with unknown tail
+	// length (in msecs; zero for endless, never silent).
+	static void setSilentHold(unsigned int iSilentHold);
+	static unsigned int silentHold();
+
 	// Document element methods.
 	bool loadElement(qtractorDocument *pDocument, QDomElement *pElement);
 	bool saveElement(qtractorDocument *pDocument, QDomElement *pElement);
@@ -956,11 +1003,18 @@ private:
 	// Internal running buffer chain references.
 	float **m_pppBuffers[2];
 
+	// Silence (ring-out) detection state.
+	unsigned long m_iSilentFrames;
+	unsigned int  m_iSampleRate;
+
 	// MIDI bank/program observable subject.
 	MidiProgramSubject *m_pMidiProgramSubject;
 
 	// Plugin registry (chain unique ids.)
 	QHash<unsigned long, unsigned int> m_uniqueIDs;
+
+	// Ring-out hold time (in msecs).
+	static unsigned int g_iSilentHold;
 };
 
 
@@ -34,6 +34,29 @@
 #include "qtractorTracks.h"
 
 
+//----------------------------------------------------------------------
+// Plugin list owner track contents change notification helper.
+//
+
+static void pluginListContentsDirty ( qtractorPluginList *pPluginList )
+{
+	if (pPluginList == NULL)
+		return;
+
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == NULL)
+		return;
+
+	for (qtractorTrack *pTrack = pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		if (pTrack->pluginList() == pPluginList) {
+			pTrack->setContentsDirty();
+			break;
+		}
+	}
+}
+
+
 //----------------------------------------------------------------------
 // class qtractorPluginCommand - implementation
 //
@@ -74,6 +97,7 @@ bool qtractorPluginCommand::addPlugins (void)
 		qtractorPluginList *pPluginList = pPlugin->list();
 		if (pPluginList)
 			pPluginList->addPlugin(pPlugin);
+		pluginListContentsDirty(pPluginList);
 	}
 	// Avoid the disposal of the plugin reference(s).
 	setAutoDelete(false);
@@ -101,6 +125,7 @@ bool qtractorPluginCommand::removePlugins (void)
 		qtractorPluginList *pPluginList = pPlugin->list();
 		if (pPluginList)
 			pPluginList->removePlugin(pPlugin);
+		pluginListContentsDirty(pPluginList);
 	}
 	// Allow the disposal of the plugin reference(s).
 	setAutoDelete(true);
@@ -222,6 +247,8 @@ bool qtractorAuxSendPluginCommand::redo (void)
 		pMidiAuxSendPlugin->updateFormAuxSendBusName();
 	}
 
+	pluginListContentsDirty(pPlugin->list());
+
 	return true;
 }
 
@@ -290,6 +317,7 @@ bool qtractorInsertPluginCommand::redo (void)
 
 	// Insert it...
 	pPluginList->insertPlugin(pPlugin, m_pNextPlugin);
+	pluginListContentsDirty(pPluginList);
 
 	// Swap it nice, finally.
 	m_pNextPlugin = pNextPlugin;
@@ -323,6 +351,7 @@ bool qtractorInsertPluginCommand::undo (void)
 
 	// Insert it...
 	pPluginList->removePlugin(pPlugin);
+	pluginListContentsDirty(pPluginList);
 
 	// Swap it nice, finally.
 	m_pNextPlugin = pNextPlugin;
@@ -373,6 +402,8 @@ bool qtractorMovePluginCommand::redo (void)
 
 	// Move it...
 	m_pPluginList->movePlugin(pPlugin, nextPlugin());
+	pluginListContentsDirty(m_pPluginList);
+	pluginListContentsDirty(pPluginList);
 
 	// Swap it nice, finally.
 	m_pPluginList = pPluginList;
@@ -420,8 +451,11 @@ bool qtractorActivatePluginCommand::redo (void)
 	const bool bActivated = !m_bActivated;
 
 	QListIterator<qtractorPlugin *> iter(plugins());
-	while (iter.hasNext())
-		iter.next()->setActivatedEx(m_bActivated);
+	while (iter.hasNext()) {
+		qtractorPlugin *pPlugin = iter.next();
+		pPlugin->setActivatedEx(m_bActivated);
+		pluginListContentsDirty(pPlugin->list());
+	}
 
 	// Swap it nice, finally.
 	m_bActivated = bActivated;
@@ -465,6 +499,7 @@ bool qtractorPresetPluginCommand::redo (void)
 	pPlugin->setValueList(m_vlist);
 	pPlugin->realizeValues();
 	pPlugin->releaseValues();
+	pluginListContentsDirty(pPlugin->list());
 
 	// Swap it nice, finally.
 	m_sPreset = sPreset;
@@ -514,6 +549,7 @@ bool qtractorResetPluginCommand::redo (void)
 		pPlugin->setValueList(m_vlist);
 		pPlugin->releaseValues();
 	}
+	pluginListContentsDirty(pPlugin->list());
 
 	// Swap it nice.
 	m_sPreset = sPreset;
@@ -565,6 +601,7 @@ bool qtractorPluginProgramCommand::redo (void)
 	const int iProg = pMidiProgramSubject->prog();
 
 	pMidiProgramSubject->setProgram(m_iBank, m_iProg);
+	pluginListContentsDirty(pPlugin->list());
 
 	m_iBank = iBank;
 	m_iProg = iProg;
@@ -627,6 +664,8 @@ bool qtractorPluginPropertyCommand::redo (void)
 
 	m_value = value;
 
+	pluginListContentsDirty(pPlugin->list());
+
 	// Update the form, showing it up as necessary...
 	pPlugin->updateFormDirtyCount();
 
@@ -699,6 +738,7 @@ bool qtractorPluginParamCommand::redo (void)
 	const float fValue = m_fPrevValue;
 
 	m_pParam->setValue(m_fValue, m_bUpdate);
+	pluginListContentsDirty(pPlugin->list());
 
 	// Set undo value...
 	m_fPrevValue = m_fValue;
@@ -39,6 +39,10 @@
 
 #include "qtractorInsertPlugin.h"
 
+#ifdef CONFIG_LV2_WORKER
+#include "qtractorLv2Plugin.h"
+#endif
+
 #include "qtractorOptions.h"
 
 #include <QItemDelegate>
@@ -1192,6 +1196,24 @@ bool qtractorPluginListView::eventFilter ( QObject *pObject, QEvent *pEvent )
 								.arg(pDirectAccessParam->display()));
 						}
 					}
+				#ifdef CONFIG_LV2_WORKER
+					// LV2 Worker/Schedule statistics, if any...
+					if ((pPlugin->type())->typeHint() == qtractorPluginType::Lv2) {
+						qtractorLv2Plugin::WorkerStats stats;
+						qtractorLv2Plugin *pLv2Plugin
+							= static_cast<qtractorLv2Plugin *> (pPlugin);
+						if (pLv2Plugin->lv2_worker_stats(stats)
+							&& stats.requests > 0) {
+							sToolTip.append('\n');
+							sToolTip.append(tr("(Worker: %1 requests, "
+								"depth %2 max, latency %3 ms avg, %4 ms max)")
+								.arg(stats.requests)
+								.arg(stats.depth_max)
+								.arg(stats.latency_avg, 0, 'f', 1)
+								.arg(stats.latency_max, 0, 'f', 1));
+						}
+					}
+				#endif
 					QToolTip::showText(pHelpEvent->globalPos(),
 						sToolTip, pViewport);
 					return true;
@@ -40,6 +40,10 @@ public:
 
 	// Constructors.
 	qtractorRingBuffer(unsigned short iChannels, unsigned int iBufferSize = 0);
+	// Read-only view over external (not owned) frame buffers;
+	// nothing gets readable until the write index is set.
+	qtractorRingBuffer(T **ppBuffer, unsigned short iChannels,
+		unsigned int iFrames, unsigned long iOffset = 0);
 	// Default destructor.
 	~qtractorRingBuffer();
 
@@ -79,6 +83,8 @@ private:
 	qtractorAtomic m_iWriteIndex;
 
 	T** m_ppBuffer;
+
+	bool m_bOwner;
 };
 
 
@@ -109,6 +115,34 @@ qtractorRingBuffer<T>::qtractorRingBuffer ( unsigned short iChannels,
 
 	ATOMIC_SET(&m_iReadIndex,  0);
 	ATOMIC_SET(&m_iWriteIndex, 0);
+
+	m_bOwner = true;
+}
+
+template<typename T>
+qtractorRingBuffer<T>::qtractorRingBuffer ( T **ppBuffer,
+	unsigned short iChannels, unsigned int iFrames, unsigned long iOffset )
+{
+	m_iChannels = iChannels;
+
+	// Power-of-two just past the view size, so it never wraps.
+	const unsigned int iMinBufferSize = 4096;
+	m_iBufferSize = iMinBufferSize;
+	while (m_iBufferSize < iFrames + 1)
+		m_iBufferSize <<= 1;
+
+	// The size overflow convenience mask and tthreshold.
+	m_iBufferMask = (m_iBufferSize - 1);
+
+	// Point to the actual (external) buffer stuff...
+	m_ppBuffer = new T* [m_iChannels];
+	for (unsigned short i = 0; i < m_iChannels; ++i)
+		m_ppBuffer[i] = ppBuffer[i] + iOffset;
+
+	ATOMIC_SET(&m_iReadIndex,  0);
+	ATOMIC_SET(&m_iWriteIndex, 0);
+
+	m_bOwner = false;
 }
 
 // Default destructor.
@@ -117,8 +151,10 @@ qtractorRingBuffer<T>::~qtractorRingBuffer (void)
 {
 	// Deallocate any buffer stuff...
 	if (m_ppBuffer) {
-		for (unsigned short i = 0; i < m_iChannels; ++i)
-			delete [] m_ppBuffer[i];
+		if (m_bOwner) {
+			for (unsigned short i = 0; i < m_iChannels; ++i)
+				delete [] m_ppBuffer[i];
+		}
 		delete [] m_ppBuffer;
 	}
 }
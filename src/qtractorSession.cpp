@@ -27,6 +27,8 @@
 
 #include "qtractorAudioEngine.h"
 #include "qtractorAudioPeak.h"
+#include "qtractorAudioCache.h"
+#include "qtractorMidiFileCache.h"
 #include "qtractorAudioClip.h"
 #include "qtractorAudioBuffer.h"
 
@@ -44,16 +46,193 @@
 #include "qtractorFiles.h"
 
 #include <QApplication>
+#include <QThread>
 #include <QDateTime>
 #include <QFileInfo>
 #include <QRegExp>
 #include <QDir>
 
 #include <QDomDocument>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 #include <stdlib.h>
 
 
+//-------------------------------------------------------------------------
+// qtractorSessionPrefetch -- Lazy (deferred) clip files prefetch.
+//
+// MIDI clip files still to be open get parsed into the MIDI file cache
+// in parallel, over a pool of worker threads, so that opening them on
+// the main thread later on just gets their events cloned.
+
+class qtractorSessionPrefetch
+{
+public:
+
+	// Constructor.
+	qtractorSessionPrefetch() : m_iTicksPerBeat(0)
+		{ ATOMIC_SET(&m_next, 0); ATOMIC_SET(&m_abort, 0); }
+
+	// Destructor.
+	~qtractorSessionPrefetch() { stop(); }
+
+	// Prefetch item registry (main thread):
+	// MIDI files get parsed, audio files just open.
+	void addItem(qtractorTrack::TrackType trackType,
+		const QString& sFilename, unsigned short iChannel)
+	{
+		Item item;
+		item.trackType = trackType;
+		item.filename = sFilename;
+		item.channel = iChannel;
+		m_items.append(item);
+	}
+
+	// Start/stop worker threads (main thread).
+	void start(unsigned short iTicksPerBeat);
+	void stop();
+
+	// Whether any worker thread is still at it (main thread).
+	bool isActive() const;
+
+	// Worker thread executive.
+	void process();
+
+private:
+
+	// Prefetch item.
+	struct Item
+	{
+		qtractorTrack::TrackType trackType;
+		QString filename;
+		unsigned short channel;  // MIDI track channel or audio channels.
+	};
+
+	// Instance variables.
+	QList<Item> m_items;
+	unsigned short m_iTicksPerBeat;
+
+	QList<QThread *> m_threads;
+
+	qtractorAtomic m_next;
+	qtractorAtomic m_abort;
+};
+
+
+// Audio channels a track clip buffer would be open with.
+static unsigned short deferClipChannels ( qtractorTrack *pTrack )
+{
+	if (pTrack->trackType() != qtractorTrack::Audio)
+		return 0;
+
+	qtractorAudioBus *pAudioBus
+		= static_cast<qtractorAudioBus *> (pTrack->outputBus());
+	return (pAudioBus ? pAudioBus->channels() : 0);
+}
+
+
+//-------------------------------------------------------------------------
+// qtractorSessionPrefetchThread -- Prefetch worker thread.
+
+class qtractorSessionPrefetchThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorSessionPrefetchThread(qtractorSessionPrefetch *pPrefetch)
+		: QThread(), m_pPrefetch(pPrefetch) {}
+
+protected:
+
+	// The main thread executive.
+	void run() { m_pPrefetch->process(); }
+
+private:
+
+	// Instance variables.
+	qtractorSessionPrefetch *m_pPrefetch;
+};
+
+
+// Start worker threads (main thread).
+void qtractorSessionPrefetch::start ( unsigned short iTicksPerBeat )
+{
+	if (m_items.isEmpty())
+		return;
+
+	m_iTicksPerBeat = iTicksPerBeat;
+
+	ATOMIC_SET(&m_next, 0);
+	ATOMIC_SET(&m_abort, 0);
+
+	int iThreads = QThread::idealThreadCount();
+	if (iThreads > m_items.count())
+		iThreads = m_items.count();
+	if (iThreads < 1)
+		iThreads = 1;
+
+	for (int i = 0; i < iThreads; ++i) {
+		QThread *pThread = new qtractorSessionPrefetchThread(this);
+		pThread->start(QThread::LowPriority);
+		m_threads.append(pThread);
+	}
+}
+
+
+// Stop (abort) and wait for all worker threads (main thread).
+void qtractorSessionPrefetch::stop (void)
+{
+	ATOMIC_SET(&m_abort, 1);
+
+	QListIterator<QThread *> iter(m_threads);
+	while (iter.hasNext()) {
+		QThread *pThread = iter.next();
+		pThread->wait();
+		delete pThread;
+	}
+
+	m_threads.clear();
+	m_items.clear();
+}
+
+
+// Whether any worker thread is still at it (main thread).
+bool qtractorSessionPrefetch::isActive (void) const
+{
+	QListIterator<QThread *> iter(m_threads);
+	while (iter.hasNext()) {
+		if (iter.next()->isRunning())
+			return true;
+	}
+
+	return false;
+}
+
+
+// Worker thread executive: keep picking items until none left.
+void qtractorSessionPrefetch::process (void)
+{
+	qtractorMidiFileCache *pMidiFileCache
+		= qtractorMidiFileCache::getInstance();
+	if (pMidiFileCache == NULL)
+		return;
+
+	while (!ATOMIC_GET(&m_abort)) {
+		const int iItem = ATOMIC_INC(&m_next) - 1;
+		if (iItem >= m_items.count())
+			break;
+		const Item& item = m_items.at(iItem);
+		if (item.trackType == qtractorTrack::Audio) {
+			qtractorAudioBuffer::prefetchFile(item.filename, item.channel);
+		} else {
+			pMidiFileCache->parseTrack(
+				item.filename, item.channel, m_iTicksPerBeat);
+		}
+	}
+}
+
+
 //-------------------------------------------------------------------------
 // qtractorSession::Properties -- Session properties structure.
 
@@ -116,11 +295,20 @@ qtractorSession::qtractorSession (void)
 	m_pMidiEngine       = new qtractorMidiEngine(this);
 	m_pAudioEngine      = new qtractorAudioEngine(this);
 	m_pAudioPeakFactory = new qtractorAudioPeakFactory();
+	m_pAudioCacheFactory = new qtractorAudioCacheFactory();
+	m_pMidiFileCache    = new qtractorMidiFileCache();
 
 	m_bAutoTimeStretch  = false;
 
 	m_iLoopRecordingMode = 0;
 
+	ATOMIC_SET(&m_render, 0);
+
+	m_bDeferClips = false;
+	m_bDeferPlugins = false;
+
+	m_pPrefetch = new qtractorSessionPrefetch();
+
 	clear();
 }
 
@@ -131,6 +319,9 @@ qtractorSession::~qtractorSession (void)
 	close();
 	clear();
 
+	delete m_pPrefetch;
+	delete m_pMidiFileCache;
+	delete m_pAudioCacheFactory;
 	delete m_pAudioPeakFactory;
 	delete m_pAudioEngine;
 	delete m_pMidiEngine;
@@ -236,6 +427,10 @@ void qtractorSession::clear (void)
 	ATOMIC_SET(&m_locks, 0);
 	ATOMIC_SET(&m_mutex, 0);
 
+	m_pPrefetch->stop();
+
+	qtractorAudioBuffer::clearPrefetchFiles();
+
 	m_pAudioPeakFactory->sync();
 
 	m_pCurrentTrack = NULL;
@@ -261,6 +456,8 @@ void qtractorSession::clear (void)
 	qtractorAudioClip::clearHashTable();
 	qtractorMidiClip::clearHashTable();
 
+	qtractorMidiEvent::release();
+
 	m_iSessionStart  = 0;
 	m_iSessionEnd    = 0;
 
@@ -311,6 +508,7 @@ void qtractorSession::clear (void)
 	}
 
 	m_pAudioPeakFactory->cleanup();
+	m_pAudioCacheFactory->cleanup();
 
 	qtractorMidiControl *pMidiControl = qtractorMidiControl::getInstance();
 	if (pMidiControl)
@@ -718,6 +916,7 @@ void qtractorSession::updateTimeScale (void)
 				pClip; pClip = pClip->next()) {
 			pClip->updateClipTime();
 		}
+		pTrack->updateClipIndex();
 	}
 
 	// Update loop points...
@@ -763,6 +962,7 @@ void qtractorSession::updateTimeResolution (void)
 			if (pTrack->trackType() == qtractorTrack::Midi)
 				pClip->open();
 		}
+		pTrack->updateClipIndex();
 	}
 
 	// Update loop points...
@@ -1169,6 +1369,7 @@ void qtractorSession::setPlaying ( bool bPlaying )
 			if (pClipRecord && !pTrack->isClipRecordEx()) {
 				pTrack->setClipRecordStart(iClipStart);
 				pClipRecord->setClipStart(iClipStart);
+				pTrack->updateClip(pClipRecord);
 				// MIDI adjust to playing queue start...
 				if (pTrack->trackType() == qtractorTrack::Midi
 					&& iClipStart > iPlayHead) {
@@ -1246,6 +1447,9 @@ void qtractorSession::lock (void)
 		// Get lost for a while...
 		while (!acquire())
 			stabilize();
+		// Wait for any render-ahead block to finish...
+		while (ATOMIC_GET(&m_render) > 0)
+			stabilize();
 	}
 }
 
@@ -1266,6 +1470,352 @@ bool qtractorSession::isBusy (void) const
 }
 
 
+// Render-ahead (worker) pseudo-locking primitives.
+bool qtractorSession::acquireRender (void)
+{
+	// Never while pending locks...
+	if (isBusy())
+		return false;
+
+	ATOMIC_INC(&m_render);
+
+	// Double-check, lest we've been overtaken...
+	if (isBusy()) {
+		ATOMIC_DEC(&m_render);
+		return false;
+	}
+
+	return true;
+}
+
+void qtractorSession::releaseRender (void)
+{
+	ATOMIC_DEC(&m_render);
+}
+
+
+// Update render-ahead state of all tracks.
+void qtractorSession::updateRenderAhead (void)
+{
+	const bool bRenderAhead
+		= (m_pAudioEngine->isActivated() && m_pAudioEngine->isRenderAhead());
+
+	for (qtractorTrack *pTrack = m_tracks.first();
+			pTrack; pTrack = pTrack->next()) {
+		pTrack->setRenderAhead(bRenderAhead && pTrack->canRenderAhead());
+	}
+}
+
+
+// Lazy (deferred) clip opening mode (ie. while loading).
+void qtractorSession::setDeferClips ( bool bDeferClips )
+{
+	m_bDeferClips = bDeferClips;
+
+	// Pending MIDI clip files get parsed and audio clip
+	// files get open in parallel, meanwhile...
+	if (!m_bDeferClips) {
+		m_pPrefetch->stop();
+		for (qtractorTrack *pTrack = m_tracks.first();
+				pTrack; pTrack = pTrack->next()) {
+			const qtractorTrack::TrackType trackType = pTrack->trackType();
+			const unsigned short iChannels = deferClipChannels(pTrack);
+			QListIterator<qtractorClip *> iter(pTrack->deferClips());
+			while (iter.hasNext()) {
+				qtractorClip *pClip = iter.next();
+				if (trackType == qtractorTrack::Audio) {
+					m_pPrefetch->addItem(trackType,
+						pClip->filename(), iChannels);
+				}
+				else
+				if (trackType == qtractorTrack::Midi) {
+					qtractorMidiClip *pMidiClip
+						= static_cast<qtractorMidiClip *> (pClip);
+					m_pPrefetch->addItem(trackType,
+						pMidiClip->filename(), pMidiClip->trackChannel());
+				}
+			}
+		}
+		m_pPrefetch->start(ticksPerBeat());
+	}
+}
+
+bool qtractorSession::isDeferClips (void) const
+{
+	return m_bDeferClips;
+}
+
+
+// Deferred (parallel) plugin instantiation mode (ie. while loading).
+void qtractorSession::setDeferPlugins ( bool bDeferPlugins )
+{
+	m_bDeferPlugins = bDeferPlugins;
+
+	// Instantiate all pending plugins, in parallel...
+	if (!m_bDeferPlugins) {
+		qtractorPluginList::openDeferPlugins();
+		// Frozen tracks signature is only valid by now...
+		for (qtractorTrack *pTrack = m_tracks.first();
+				pTrack; pTrack = pTrack->next()) {
+			pTrack->resetFreezeHash();
+		}
+	}
+}
+
+bool qtractorSession::isDeferPlugins (void) const
+{
+	return m_bDeferPlugins;
+}
+
+
+// Lazy (deferred) clips still pending.
+int qtractorSession::deferClipCount (void) const
+{
+	int iDeferClips = 0;
+
+	for (qtractorTrack *pTrack = m_tracks.first();
+			pTrack; pTrack = pTrack->next()) {
+		iDeferClips += pTrack->deferClips().count();
+	}
+
+	return iDeferClips;
+}
+
+
+// Make sure a clip is open, whether still lazy (deferred).
+bool qtractorSession::openDeferClip ( qtractorClip *pClip )
+{
+	qtractorTrack *pTrack = pClip->track();
+	if (pTrack == NULL)
+		return false;
+
+	if (pTrack->deferClips().contains(pClip)) {
+		if (isDeferClipLockFree(pClip)) {
+			openDeferClipLockFree(pClip);
+		} else {
+			lock();
+			if (pTrack->openDeferClip(pClip))
+				updateTrack(pTrack);
+			unlock();
+		}
+		cleanupDeferClips();
+	}
+
+	// Whether its file data is really there...
+	switch (pTrack->trackType()) {
+	case qtractorTrack::Audio: {
+		qtractorAudioClip *pAudioClip
+			= static_cast<qtractorAudioClip *> (pClip);
+		return (pAudioClip->buffer() != NULL);
+	}
+	case qtractorTrack::Midi: {
+		qtractorMidiClip *pMidiClip
+			= static_cast<qtractorMidiClip *> (pClip);
+		return (pMidiClip->sequence() != NULL);
+	}
+	default:
+		return false;
+	}
+}
+
+
+// Open all lazy (deferred) clips, right away.
+int qtractorSession::openDeferClips (void)
+{
+	if (deferClipCount() < 1)
+		return 0;
+
+	int iDeferClips = 0;
+
+	lock();
+
+	for (qtractorTrack *pTrack = m_tracks.first();
+			pTrack; pTrack = pTrack->next()) {
+		const int iTrackClips = pTrack->openDeferClips();
+		if (iTrackClips > 0) {
+			updateTrack(pTrack);
+			iDeferClips += iTrackClips;
+		}
+	}
+
+	unlock();
+
+	cleanupDeferClips();
+
+	return iDeferClips;
+}
+
+
+// Open all lazy (deferred) clips overlapping given range, right away.
+int qtractorSession::openDeferClips (
+	unsigned long iFrameStart, unsigned long iFrameEnd )
+{
+	QList<qtractorClip *> clips;
+
+	for (qtractorTrack *pTrack = m_tracks.first();
+			pTrack; pTrack = pTrack->next()) {
+		QListIterator<qtractorClip *> iter(pTrack->deferClips());
+		while (iter.hasNext()) {
+			qtractorClip *pClip = iter.next();
+			const unsigned long iClipStart = pClip->clipStart();
+			const unsigned long iClipEnd = iClipStart + pClip->clipLength();
+			if (iFrameStart < iClipEnd && iFrameEnd > iClipStart)
+				clips.append(pClip);
+		}
+	}
+
+	if (clips.isEmpty())
+		return 0;
+
+	int iDeferClips = 0;
+
+	// Audio clips need no lock at all while rolling...
+	QMutableListIterator<qtractorClip *> iter(clips);
+	while (iter.hasNext()) {
+		qtractorClip *pClip = iter.next();
+		if (isDeferClipLockFree(pClip)) {
+			if (openDeferClipLockFree(pClip))
+				++iDeferClips;
+			iter.remove();
+		}
+	}
+
+	// All the rest in one go, as each lock might cost a cycle...
+	if (!clips.isEmpty()) {
+		lock();
+		QList<qtractorTrack *> tracks;
+		iter.toFront();
+		while (iter.hasNext()) {
+			qtractorClip *pClip = iter.next();
+			qtractorTrack *pTrack = pClip->track();
+			if (pTrack->openDeferClip(pClip)) {
+				if (!tracks.contains(pTrack))
+					tracks.append(pTrack);
+				++iDeferClips;
+			}
+		}
+		QListIterator<qtractorTrack *> track_iter(tracks);
+		while (track_iter.hasNext())
+			updateTrack(track_iter.next());
+		unlock();
+	}
+
+	cleanupDeferClips();
+
+	return iDeferClips;
+}
+
+
+// Open lazy (deferred) clips, closest to given range first,
+// for as long as the given time-slice (msecs) allows; audio
+// clip files still being open in the background are left
+// for later, as are any clips needing a lock while rolling.
+int qtractorSession::openDeferClipsIdle (
+	unsigned long iFrameStart, unsigned long iFrameEnd, int iTimeSlice )
+{
+	int iDeferClips = 0;
+
+	const bool bPlaying = isPlaying();
+	const bool bPrefetch = m_pPrefetch->isActive();
+
+	QTime t;
+	t.start();
+
+	do {
+		// Find the nearest pending clip (ready to open)...
+		qtractorClip *pDeferClip = NULL;
+		unsigned long iDeferDelta = 0;
+		for (qtractorTrack *pTrack = m_tracks.first();
+				pTrack; pTrack = pTrack->next()) {
+			const bool bAudio = (pTrack->trackType() == qtractorTrack::Audio);
+			const unsigned short iChannels = deferClipChannels(pTrack);
+			QListIterator<qtractorClip *> iter(pTrack->deferClips());
+			while (iter.hasNext()) {
+				qtractorClip *pClip = iter.next();
+				if (bPlaying && !isDeferClipLockFree(pClip))
+					continue;
+				if (bPrefetch && bAudio && !qtractorAudioBuffer::isPrefetchFile(
+						pClip->filename(), iChannels))
+					continue;
+				const unsigned long iClipStart = pClip->clipStart();
+				const unsigned long iClipEnd
+					= iClipStart + pClip->clipLength();
+				unsigned long iDelta = 0;
+				if (iClipEnd < iFrameStart)
+					iDelta = iFrameStart - iClipEnd;
+				else
+				if (iClipStart > iFrameEnd)
+					iDelta = iClipStart - iFrameEnd;
+				if (pDeferClip == NULL || iDeferDelta > iDelta) {
+					pDeferClip  = pClip;
+					iDeferDelta = iDelta;
+				}
+			}
+		}
+		// None left?
+		if (pDeferClip == NULL)
+			break;
+		// Open it up...
+		if (isDeferClipLockFree(pDeferClip)) {
+			if (openDeferClipLockFree(pDeferClip))
+				++iDeferClips;
+		} else {
+			qtractorTrack *pTrack = pDeferClip->track();
+			lock();
+			if (pTrack->openDeferClip(pDeferClip)) {
+				updateTrack(pTrack);
+				++iDeferClips;
+			}
+			unlock();
+		}
+	}
+	while (t.elapsed() < iTimeSlice);
+
+	cleanupDeferClips();
+
+	return iDeferClips;
+}
+
+
+// Whether a lazy (deferred) clip may be open without locking:
+// audio clips of known length, while rolling, as their buffers
+// get published only when open and the real-time cycle syncs
+// any fresh one on its own.
+bool qtractorSession::isDeferClipLockFree ( qtractorClip *pClip ) const
+{
+	qtractorTrack *pTrack = pClip->track();
+
+	return (isPlaying()
+		&& pTrack && pTrack->trackType() == qtractorTrack::Audio
+		&& pClip->clipLength() > 0);
+}
+
+
+bool qtractorSession::openDeferClipLockFree ( qtractorClip *pClip )
+{
+	qtractorTrack *pTrack = pClip->track();
+	if (!pTrack->openDeferClip(pClip))
+		return false;
+
+	// Render-ahead has been rendering it as missing...
+	pTrack->resetRenderAhead();
+
+	return true;
+}
+
+
+// Pending background open/parse leftovers, once all are done.
+void qtractorSession::cleanupDeferClips (void)
+{
+	if (deferClipCount() > 0)
+		return;
+
+	m_pPrefetch->stop();
+
+	qtractorAudioBuffer::clearPrefetchFiles();
+}
+
+
 // Playhead positioning.
 void qtractorSession::setPlayHead ( unsigned long iPlayHead )
 {
@@ -1769,6 +2319,13 @@ qtractorAudioPeakFactory *qtractorSession::audioPeakFactory (void) const
 }
 
 
+// Audio transcoding cache factory accessor.
+qtractorAudioCacheFactory *qtractorSession::audioCacheFactory (void) const
+{
+	return m_pAudioCacheFactory;
+}
+
+
 // MIDI track tagging specifics.
 unsigned short qtractorSession::midiTag (void) const
 {
@@ -1909,16 +2466,18 @@ qtractorFileList *qtractorSession::files (void) const
 }
 
 
-// Document element methods.
-bool qtractorSession::loadElement (
-	qtractorSessionDocument *pDocument, QDomElement *pElement )
+// Document element (streaming) methods.
+bool qtractorSession::loadStream (
+	qtractorSessionDocument *pDocument, QXmlStreamReader *pReader )
 {
 	qtractorSession::clear();
 	qtractorSession::lock();
 
 	// Templates have no session name...
-	if (!pDocument->isTemplate())
-		qtractorSession::setSessionName(pElement->attribute("name"));
+	if (!pDocument->isTemplate()) {
+		qtractorSession::setSessionName(
+			pReader->attributes().value("name").toString());
+	}
 
 	// Session state should be postponed...
 	unsigned long iLoopStart = 0;
@@ -1928,190 +2487,166 @@ bool qtractorSession::loadElement (
 	unsigned long iPunchOut  = 0;
 
 	// Load session children...
-	for (QDomNode nChild = pElement->firstChild();
-			!nChild.isNull();
-				nChild = nChild.nextSibling()) {
+	while (pReader->readNextStartElement()) {
 
-		// Convert node to element...
-		QDomElement eChild = nChild.toElement();
-		if (eChild.isNull())
-			continue;
+		const QString& sChild = pReader->name().toString();
 
 		// Load session properties...
-		if (eChild.tagName() == "properties") {
-			for (QDomNode nProp = eChild.firstChild();
-					!nProp.isNull();
-						nProp = nProp.nextSibling()) {
-				// Convert property node to element...
-				QDomElement eProp = nProp.toElement();
-				if (eProp.isNull())
-					continue;
-				if (eProp.tagName() == "directory")
-					qtractorSession::setSessionDir(eProp.text());
-				else if (eProp.tagName() == "description")
-					qtractorSession::setDescription(eProp.text());
-				else if (eProp.tagName() == "sample-rate")
-					qtractorSession::setSampleRate(eProp.text().toUInt());
-				else if (eProp.tagName() == "tempo")
-					qtractorSession::setTempo(eProp.text().toFloat());
-				else if (eProp.tagName() == "ticks-per-beat")
-					qtractorSession::setTicksPerBeat(eProp.text().toUShort());
-				else if (eProp.tagName() == "beats-per-bar")
-					qtractorSession::setBeatsPerBar(eProp.text().toUShort());
-				else if (eProp.tagName() == "beat-divisor")
-					qtractorSession::setBeatDivisor(eProp.text().toUShort());
+		if (sChild == "properties") {
+			while (pReader->readNextStartElement()) {
+				const QString& sProp = pReader->name().toString();
+				if (sProp == "directory")
+					qtractorSession::setSessionDir(pReader->readElementText());
+				else if (sProp == "description")
+					qtractorSession::setDescription(pReader->readElementText());
+				else if (sProp == "sample-rate")
+					qtractorSession::setSampleRate(pReader->readElementText().toUInt());
+				else if (sProp == "tempo")
+					qtractorSession::setTempo(pReader->readElementText().toFloat());
+				else if (sProp == "ticks-per-beat")
+					qtractorSession::setTicksPerBeat(pReader->readElementText().toUShort());
+				else if (sProp == "beats-per-bar")
+					qtractorSession::setBeatsPerBar(pReader->readElementText().toUShort());
+				else if (sProp == "beat-divisor")
+					qtractorSession::setBeatDivisor(pReader->readElementText().toUShort());
+				else
+					pReader->skipCurrentElement();
 			}
 			// We need to make this permanent, right now.
 			qtractorSession::updateTimeScale();
 		}
 		else
-		if (eChild.tagName() == "state") {
-			for (QDomNode nState = eChild.firstChild();
-					!nState.isNull();
-						nState = nState.nextSibling()) {
-				// Convert state node to element...
-				QDomElement eState = nState.toElement();
-				if (eState.isNull())
-					continue;
-				if (eState.tagName() == "loop-start")
-					iLoopStart = eState.text().toULong();
-				else if (eState.tagName() == "loop-end")
-					iLoopEnd = eState.text().toULong();
-				else if (eState.tagName() == "punch-in")
-					iPunchIn = eState.text().toULong();
-				else if (eState.tagName() == "punch-out")
-					iPunchOut = eState.text().toULong();
+		if (sChild == "state") {
+			while (pReader->readNextStartElement()) {
+				const QString& sState = pReader->name().toString();
+				if (sState == "loop-start")
+					iLoopStart = pReader->readElementText().toULong();
+				else if (sState == "loop-end")
+					iLoopEnd = pReader->readElementText().toULong();
+				else if (sState == "punch-in")
+					iPunchIn = pReader->readElementText().toULong();
+				else if (sState == "punch-out")
+					iPunchOut = pReader->readElementText().toULong();
+				else
+					pReader->skipCurrentElement();
 			}
 		}
 		else
 		// Load file lists...
-		if (eChild.tagName() == "files" && !pDocument->isTemplate()) {
-			for (QDomNode nList = eChild.firstChild();
-					!nList.isNull();
-						nList = nList.nextSibling()) {
-				// Convert filelist node to element...
-				QDomElement eList = nList.toElement();
-				if (eList.isNull())
-					continue;
-				if (eList.tagName() == "audio-list") {
+		if (sChild == "files" && !pDocument->isTemplate()) {
+			while (pReader->readNextStartElement()) {
+				const QString& sList = pReader->name().toString();
+				if (sList == "audio-list") {
 					qtractorAudioListView *pAudioList = NULL;
 					if (pDocument->files())
 						pAudioList = pDocument->files()->audioListView();
 					if (pAudioList == NULL)
 						return false;
+					QDomElement eList;
+					if (!pDocument->readElement(pReader, &eList))
+						return false;
 					if (!pAudioList->loadElement(pDocument, &eList))
 						return false;
 				}
 				else
-				if (eList.tagName() == "midi-list") {
+				if (sList == "midi-list") {
 					qtractorMidiListView *pMidiList = NULL;
 					if (pDocument->files())
 						pMidiList = pDocument->files()->midiListView();
 					if (pMidiList == NULL)
 						return false;
+					QDomElement eList;
+					if (!pDocument->readElement(pReader, &eList))
+						return false;
 					if (!pMidiList->loadElement(pDocument, &eList))
 						return false;
 				}
+				else pReader->skipCurrentElement();
 			}
 			// Stabilize things a bit...
 			stabilize();
 		}
 		else
 		// Load device lists...
-		if (eChild.tagName() == "devices") {
-			for (QDomNode nDevice = eChild.firstChild();
-					!nDevice.isNull();
-						nDevice = nDevice.nextSibling()) {
-				// Convert buses list node to element...
-				QDomElement eDevice = nDevice.toElement();
-				if (eDevice.isNull())
-					continue;
-				if (eDevice.tagName() == "audio-engine") {
+		if (sChild == "devices") {
+			while (pReader->readNextStartElement()) {
+				const QString& sDevice = pReader->name().toString();
+				if (sDevice == "audio-engine") {
+					QDomElement eDevice;
+					if (!pDocument->readElement(pReader, &eDevice))
+						return false;
 					if (!qtractorSession::audioEngine()
 							->loadElement(pDocument, &eDevice)) {
 						return false;
 					}
 				}
-				else 
-				if (eDevice.tagName() == "midi-engine") {
+				else
+				if (sDevice == "midi-engine") {
+					QDomElement eDevice;
+					if (!pDocument->readElement(pReader, &eDevice))
+						return false;
 					if (!qtractorSession::midiEngine()
 							->loadElement(pDocument, &eDevice)) {
 						return false;
 					}
 				}
+				else pReader->skipCurrentElement();
 			}
 			// Stabilize things a bit...
 			stabilize();
 		}
 		else
 		// Load tempo/time-signature map...
-		if (eChild.tagName() == "tempo-map") {
-			for (QDomNode nNode = eChild.firstChild();
-					!nNode.isNull();
-						nNode = nNode.nextSibling()) {
-				// Convert tempo node to element...
-				QDomElement eNode = nNode.toElement();
-				if (eNode.isNull())
-					continue;
+		if (sChild == "tempo-map") {
+			while (pReader->readNextStartElement()) {
 				// Load tempo-map...
-				if (eNode.tagName() == "tempo-node") {
+				if (pReader->name().toString() == "tempo-node") {
 					const unsigned long iFrame
-						= eNode.attribute("frame").toULong();
+						= pReader->attributes().value("frame").toString().toULong();
 					float fTempo = 120.0f;
 					unsigned short iBeatType = 2;
 					unsigned short iBeatsPerBar = 4;
 					unsigned short iBeatDivisor = 2;
-					for (QDomNode nItem = eNode.firstChild();
-							!nItem.isNull();
-								nItem = nItem.nextSibling()) {
-						// Convert node to element...
-						QDomElement eItem = nItem.toElement();
-						if (eItem.isNull())
-							continue;
-						if (eItem.tagName() == "tempo")
-							fTempo = eItem.text().toFloat();
-						else if (eItem.tagName() == "beat-type")
-							iBeatType = eItem.text().toUShort();
-						else if (eItem.tagName() == "beats-per-bar")
-							iBeatsPerBar = eItem.text().toUShort();
-						else if (eItem.tagName() == "beat-divisor")
-							iBeatDivisor = eItem.text().toUShort();
+					while (pReader->readNextStartElement()) {
+						const QString& sItem = pReader->name().toString();
+						if (sItem == "tempo")
+							fTempo = pReader->readElementText().toFloat();
+						else if (sItem == "beat-type")
+							iBeatType = pReader->readElementText().toUShort();
+						else if (sItem == "beats-per-bar")
+							iBeatsPerBar = pReader->readElementText().toUShort();
+						else if (sItem == "beat-divisor")
+							iBeatDivisor = pReader->readElementText().toUShort();
+						else
+							pReader->skipCurrentElement();
 					}
 					// Add new node to tempo/time-signature map...
 					qtractorSession::timeScale()->addNode(iFrame,
 						fTempo, iBeatType, iBeatsPerBar, iBeatDivisor);
 				}
+				else pReader->skipCurrentElement();
 			}
 			// Again, make view/time scaling factors permanent.
 			qtractorSession::updateTimeScale();
 		}
 		else
 		// Load location markers...
-		if (eChild.tagName() == "markers") {
-			for (QDomNode nMarker = eChild.firstChild();
-					!nMarker.isNull();
-						nMarker = nMarker.nextSibling()) {
-				// Convert tempo node to element...
-				QDomElement eMarker = nMarker.toElement();
-				if (eMarker.isNull())
-					continue;
+		if (sChild == "markers") {
+			while (pReader->readNextStartElement()) {
 				// Load markers...
-				if (eMarker.tagName() == "marker") {
+				if (pReader->name().toString() == "marker") {
 					const unsigned long iFrame
-						= eMarker.attribute("frame").toULong();
+						= pReader->attributes().value("frame").toString().toULong();
 					QString sText;
 					QColor rgbColor = Qt::darkGray;
-					for (QDomNode nItem = eMarker.firstChild();
-							!nItem.isNull();
-								nItem = nItem.nextSibling()) {
-						// Convert node to element...
-						QDomElement eItem = nItem.toElement();
-						if (eItem.isNull())
-							continue;
-						if (eItem.tagName() == "text")
-							sText = eItem.text();
-						else if (eItem.tagName() == "color")
-							rgbColor.setNamedColor(eItem.text());
+					while (pReader->readNextStartElement()) {
+						const QString& sItem = pReader->name().toString();
+						if (sItem == "text")
+							sText = pReader->readElementText();
+						else if (sItem == "color")
+							rgbColor.setNamedColor(pReader->readElementText());
+						else
+							pReader->skipCurrentElement();
 					}
 					// Add new marker...
 					if (!sText.isEmpty()) {
@@ -2119,55 +2654,50 @@ bool qtractorSession::loadElement (
 							iFrame, sText, rgbColor);
 					}
 				}
+				else pReader->skipCurrentElement();
 			}
 		}
 		else
 		// Load tracks...
-		if (eChild.tagName() == "tracks") {
-			for (QDomNode nTrack = eChild.firstChild();
-					!nTrack.isNull();
-						nTrack = nTrack.nextSibling()) {
-				// Convert track node to element...
-				QDomElement eTrack = nTrack.toElement();
-				if (eTrack.isNull())
-					continue;
+		if (sChild == "tracks") {
+			while (pReader->readNextStartElement()) {
+				const QString& sTrack = pReader->name().toString();
 				// Load track-view state...
-				if (eTrack.tagName() == "view") {
-					for (QDomNode nView = eTrack.firstChild();
-							!nView.isNull();
-								nView = nView.nextSibling()) {
-						// Convert state node to element...
-						QDomElement eView = nView.toElement();
-						if (eView.isNull())
-							continue;
-						if (eView.tagName() == "pixels-per-beat")
-							qtractorSession::setPixelsPerBeat(eView.text().toUShort());
-						else if (eView.tagName() == "horizontal-zoom")
-							qtractorSession::setHorizontalZoom(eView.text().toUShort());
-						else if (eView.tagName() == "vertical-zoom")
-							qtractorSession::setVerticalZoom(eView.text().toUShort());
-						else if (eView.tagName() == "snap-per-beat")
-							qtractorSession::setSnapPerBeat(eView.text().toUShort());
-						else if (eView.tagName() == "edit-head")
-							qtractorSession::setEditHead(eView.text().toULong());
-						else if (eView.tagName() == "edit-tail")
-							qtractorSession::setEditTail(eView.text().toULong());
+				if (sTrack == "view") {
+					while (pReader->readNextStartElement()) {
+						const QString& sView = pReader->name().toString();
+						if (sView == "pixels-per-beat")
+							qtractorSession::setPixelsPerBeat(pReader->readElementText().toUShort());
+						else if (sView == "horizontal-zoom")
+							qtractorSession::setHorizontalZoom(pReader->readElementText().toUShort());
+						else if (sView == "vertical-zoom")
+							qtractorSession::setVerticalZoom(pReader->readElementText().toUShort());
+						else if (sView == "snap-per-beat")
+							qtractorSession::setSnapPerBeat(pReader->readElementText().toUShort());
+						else if (sView == "edit-head")
+							qtractorSession::setEditHead(pReader->readElementText().toULong());
+						else if (sView == "edit-tail")
+							qtractorSession::setEditTail(pReader->readElementText().toULong());
+						else
+							pReader->skipCurrentElement();
 					}
 					// Again, make view/time scaling factors permanent.
 					qtractorSession::updateTimeScale();
 				}
 				else
 				// Load track...
-				if (eTrack.tagName() == "track") {
+				if (sTrack == "track") {
 					qtractorTrack *pTrack = new qtractorTrack(this);
-					if (!pTrack->loadElement(pDocument, &eTrack))
+					if (!pTrack->loadStream(pDocument, pReader))
 						return false;
 					qtractorSession::addTrack(pTrack);
 				}
+				else pReader->skipCurrentElement();
 			}
 			// Stabilize things a bit...
 			stabilize();
 		}
+		else pReader->skipCurrentElement();
 	}
 
 	// Just stabilize things around.
@@ -2181,55 +2711,55 @@ bool qtractorSession::loadElement (
 
 	qtractorSession::unlock();
 
-	return true;
+	return !pReader->hasError();
 }
 
 
-bool qtractorSession::saveElement (
-	qtractorSessionDocument *pDocument, QDomElement *pElement )
+bool qtractorSession::saveStream (
+	qtractorSessionDocument *pDocument, QXmlStreamWriter *pWriter )
 {
 	// Templates should have no session name...
 	if (!pDocument->isTemplate())
-		pElement->setAttribute("name", qtractorSession::sessionName());
+		pWriter->writeAttribute("name", qtractorSession::sessionName());
 
-	pElement->setAttribute("version", PACKAGE_STRING);
+	pWriter->writeAttribute("version", PACKAGE_STRING);
 
 	// Save session properties...
-	QDomElement eProps = pDocument->document()->createElement("properties");
+	pWriter->writeStartElement("properties");
 	if (!pDocument->isArchive()) {
-		pDocument->saveTextElement("directory",
-			qtractorSession::sessionDir(), &eProps);
-	}
-	pDocument->saveTextElement("description",
-		qtractorSession::description(), &eProps);
-	pDocument->saveTextElement("sample-rate",
-		QString::number(qtractorSession::sampleRate()), &eProps);
-	pDocument->saveTextElement("tempo",
-		QString::number(qtractorSession::tempo()), &eProps);
-	pDocument->saveTextElement("ticks-per-beat",
-		QString::number(qtractorSession::ticksPerBeat()), &eProps);
-	pDocument->saveTextElement("beats-per-bar",
-		QString::number(qtractorSession::beatsPerBar()), &eProps);
-	pDocument->saveTextElement("beat-divisor",
-		QString::number(qtractorSession::beatDivisor()), &eProps);
-	pElement->appendChild(eProps);
+		pWriter->writeTextElement("directory",
+			qtractorSession::sessionDir());
+	}
+	pWriter->writeTextElement("description",
+		qtractorSession::description());
+	pWriter->writeTextElement("sample-rate",
+		QString::number(qtractorSession::sampleRate()));
+	pWriter->writeTextElement("tempo",
+		QString::number(qtractorSession::tempo()));
+	pWriter->writeTextElement("ticks-per-beat",
+		QString::number(qtractorSession::ticksPerBeat()));
+	pWriter->writeTextElement("beats-per-bar",
+		QString::number(qtractorSession::beatsPerBar()));
+	pWriter->writeTextElement("beat-divisor",
+		QString::number(qtractorSession::beatDivisor()));
+	pWriter->writeEndElement();
 
 	// Save session state...
-	QDomElement eState = pDocument->document()->createElement("state");
-	pDocument->saveTextElement("loop-start",
-		QString::number(qtractorSession::loopStart()), &eState);
-	pDocument->saveTextElement("loop-end",
-		QString::number(qtractorSession::loopEnd()), &eState);
-	pDocument->saveTextElement("punch-in",
-		QString::number(qtractorSession::punchIn()), &eState);
-	pDocument->saveTextElement("punch-out",
-		QString::number(qtractorSession::punchOut()), &eState);
-	pElement->appendChild(eState);
+	pWriter->writeStartElement("state");
+	pWriter->writeTextElement("loop-start",
+		QString::number(qtractorSession::loopStart()));
+	pWriter->writeTextElement("loop-end",
+		QString::number(qtractorSession::loopEnd()));
+	pWriter->writeTextElement("punch-in",
+		QString::number(qtractorSession::punchIn()));
+	pWriter->writeTextElement("punch-out",
+		QString::number(qtractorSession::punchOut()));
+	pWriter->writeEndElement();
 
 	// Files are not saved when in template mode...
 	if (!pDocument->isTemplate()) {
 		// Save file lists...
-		QDomElement eFiles = pDocument->document()->createElement("files");
+		pWriter->writeStartElement("files");
 		// Audio files...
 		QDomElement eAudioList
 			= pDocument->document()->createElement("audio-list");
@@ -2240,7 +2770,7 @@ bool qtractorSession::saveElement (
 			return false;
 		if (!pAudioList->saveElement(pDocument, &eAudioList))
 			return false;
-		eFiles.appendChild(eAudioList);
+		pDocument->writeElement(pWriter, eAudioList);
 		// MIDI files...
 		QDomElement eMidiList
 			= pDocument->document()->createElement("midi-list");
@@ -2251,93 +2781,92 @@ bool qtractorSession::saveElement (
 			return false;
 		if (!pMidiList->saveElement(pDocument, &eMidiList))
 			return false;
-		eFiles.appendChild(eMidiList);
-		pElement->appendChild(eFiles);
+		pDocument->writeElement(pWriter, eMidiList);
+		pWriter->writeEndElement();
 	}
 
 	// Save device lists...
-	QDomElement eDevices = pDocument->document()->createElement("devices");
+	pWriter->writeStartElement("devices");
 	// Audio engine...
 	QDomElement eAudioEngine
 		= pDocument->document()->createElement("audio-engine");
 	if (!qtractorSession::audioEngine()->saveElement(pDocument, &eAudioEngine))
 		return false;
-	eDevices.appendChild(eAudioEngine);
+	pDocument->writeElement(pWriter, eAudioEngine);
 	// MIDI engine...
 	QDomElement eMidiEngine
 		= pDocument->document()->createElement("midi-engine");
 	if (!qtractorSession::midiEngine()->saveElement(pDocument, &eMidiEngine))
 		return false;
-	eDevices.appendChild(eMidiEngine);
-	pElement->appendChild(eDevices);
+	pDocument->writeElement(pWriter, eMidiEngine);
+	pWriter->writeEndElement();
 
 	// Save tempo/time-signature, if any...
 	qtractorTimeScale::Node *pNode
 		= qtractorSession::timeScale()->nodes().first();
 	if (pNode) pNode = pNode->next(); // Skip first anchor node.
 	if (pNode) {
-		QDomElement eTempoMap = pDocument->document()->createElement("tempo-map");
+		pWriter->writeStartElement("tempo-map");
 		while (pNode) {
-			QDomElement eNode = pDocument->document()->createElement("tempo-node");
-			eNode.setAttribute("bar", QString::number(pNode->bar));
-			eNode.setAttribute("frame", QString::number(pNode->frame));
-			pDocument->saveTextElement("tempo",
-				QString::number(pNode->tempo), &eNode);
-			pDocument->saveTextElement("beat-type",
-				QString::number(pNode->beatType), &eNode);
-			pDocument->saveTextElement("beats-per-bar",
-				QString::number(pNode->beatsPerBar), &eNode);
-			pDocument->saveTextElement("beat-divisor",
-				QString::number(pNode->beatDivisor), &eNode);
-			eTempoMap.appendChild(eNode);
+			pWriter->writeStartElement("tempo-node");
+			pWriter->writeAttribute("bar", QString::number(pNode->bar));
+			pWriter->writeAttribute("frame", QString::number(pNode->frame));
+			pWriter->writeTextElement("tempo",
+				QString::number(pNode->tempo));
+			pWriter->writeTextElement("beat-type",
+				QString::number(pNode->beatType));
+			pWriter->writeTextElement("beats-per-bar",
+				QString::number(pNode->beatsPerBar));
+			pWriter->writeTextElement("beat-divisor",
+				QString::number(pNode->beatDivisor));
+			pWriter->writeEndElement();
 			pNode = pNode->next();
 		}
-		pElement->appendChild(eTempoMap);
+		pWriter->writeEndElement();
 	}
 
 	// Save location markers, if any...
 	qtractorTimeScale::Marker *pMarker
 		= qtractorSession::timeScale()->markers().first();
 	if (pMarker) {
-		QDomElement eMarkers = pDocument->document()->createElement("markers");
+		pWriter->writeStartElement("markers");
 		while (pMarker) {
-			QDomElement eMarker = pDocument->document()->createElement("marker");
-			eMarker.setAttribute("frame", QString::number(pMarker->frame));
-			pDocument->saveTextElement("text", pMarker->text, &eMarker);
-			pDocument->saveTextElement("color", pMarker->color.name(), &eMarker);
-			eMarkers.appendChild(eMarker);
+			pWriter->writeStartElement("marker");
+			pWriter->writeAttribute("frame", QString::number(pMarker->frame));
+			pWriter->writeTextElement("text", pMarker->text);
+			pWriter->writeTextElement("color", pMarker->color.name());
+			pWriter->writeEndElement();
 			pMarker = pMarker->next();
 		}
-		pElement->appendChild(eMarkers);
+		pWriter->writeEndElement();
 	}
 
 	// Save track view state...
-	QDomElement eTracks = pDocument->document()->createElement("tracks");
-	QDomElement eView   = pDocument->document()->createElement("view");
-	pDocument->saveTextElement("pixels-per-beat",
-		QString::number(qtractorSession::pixelsPerBeat()), &eView);
-	pDocument->saveTextElement("horizontal-zoom",
-		QString::number(qtractorSession::horizontalZoom()), &eView);
-	pDocument->saveTextElement("vertical-zoom",
-		QString::number(qtractorSession::verticalZoom()), &eView);
-	pDocument->saveTextElement("snap-per-beat",
-		QString::number(qtractorSession::snapPerBeat()), &eView);
-	pDocument->saveTextElement("edit-head",
-		QString::number(qtractorSession::editHead()), &eView);
-	pDocument->saveTextElement("edit-tail",
-		QString::number(qtractorSession::editTail()), &eView);
-	eTracks.appendChild(eView);
+	pWriter->writeStartElement("tracks");
+	pWriter->writeStartElement("view");
+	pWriter->writeTextElement("pixels-per-beat",
+		QString::number(qtractorSession::pixelsPerBeat()));
+	pWriter->writeTextElement("horizontal-zoom",
+		QString::number(qtractorSession::horizontalZoom()));
+	pWriter->writeTextElement("vertical-zoom",
+		QString::number(qtractorSession::verticalZoom()));
+	pWriter->writeTextElement("snap-per-beat",
+		QString::number(qtractorSession::snapPerBeat()));
+	pWriter->writeTextElement("edit-head",
+		QString::number(qtractorSession::editHead()));
+	pWriter->writeTextElement("edit-tail",
+		QString::number(qtractorSession::editTail()));
+	pWriter->writeEndElement();
 	// Save session tracks...
 	for (qtractorTrack *pTrack = qtractorSession::tracks().first();
 			pTrack; pTrack = pTrack->next()) {
-		// Create the new track element...
-		QDomElement eTrack = pDocument->document()->createElement("track");
-		if (!pTrack->saveElement(pDocument, &eTrack))
+		// Stream the new track element...
+		pWriter->writeStartElement("track");
+		if (!pTrack->saveStream(pDocument, pWriter))
 			return false;
-		// Add this slot...
-		eTracks.appendChild(eTrack);
+		pWriter->writeEndElement();
 	}
-	pElement->appendChild(eTracks);
+	pWriter->writeEndElement();
 
 	return true;
 }
@@ -35,6 +35,8 @@ class qtractorClip;
 class qtractorMidiEngine;
 class qtractorAudioEngine;
 class qtractorAudioPeakFactory;
+class qtractorAudioCacheFactory;
+class qtractorMidiFileCache;
 class qtractorSessionCursor;
 class qtractorSessionDocument;
 class qtractorMidiManager;
@@ -42,8 +44,10 @@ class qtractorInstrumentList;
 class qtractorCommandList;
 class qtractorCommand;
 class qtractorFileList;
+class qtractorSessionPrefetch;
 
-class QDomElement;
+class QXmlStreamReader;
+class QXmlStreamWriter;
 
 
 //-------------------------------------------------------------------------
@@ -235,6 +239,37 @@ public:
 	// Re-entrancy check.
 	bool isBusy() const;
 
+	// Render-ahead (worker) pseudo-locking primitives.
+	bool acquireRender();
+	void releaseRender();
+
+	// Update render-ahead state of all tracks.
+	void updateRenderAhead();
+
+	// Lazy (deferred) clip opening mode (ie. while loading).
+	void setDeferClips(bool bDeferClips);
+	bool isDeferClips() const;
+
+	// Lazy (deferred) clips still pending.
+	int deferClipCount() const;
+
+	// Make sure a clip is open, whether still lazy (deferred);
+	// returns false whenever its file data is not there.
+	bool openDeferClip(qtractorClip *pClip);
+
+	// Open lazy (deferred) clips: all of them, those overlapping
+	// a given range, or the ones closest to a given range for as
+	// long as a time-slice allows; returns the number of clips open.
+	int openDeferClips();
+	int openDeferClips(unsigned long iFrameStart, unsigned long iFrameEnd);
+	int openDeferClipsIdle(unsigned long iFrameStart,
+		unsigned long iFrameEnd, int iTimeSlice);
+
+	// Deferred (parallel) plugin instantiation mode (ie. while loading);
+	// all pending plugins get instantiated when reset.
+	void setDeferPlugins(bool bDeferPlugins);
+	bool isDeferPlugins() const;
+
 	// Consolidated session engine start status.
 	void setPlaying(bool bPlaying);
 	bool isPlaying() const;
@@ -321,6 +356,9 @@ public:
 	// Audio peak factory accessor.
 	qtractorAudioPeakFactory *audioPeakFactory() const;
 
+	// Audio transcoding cache factory accessor.
+	qtractorAudioCacheFactory *audioCacheFactory() const;
+
 	// MIDI track tagging specifics.
 	unsigned short midiTag() const;
 	void acquireMidiTag(qtractorTrack *pTrack);
@@ -350,9 +388,9 @@ public:
 	// Session special process automation executive.
 	void process_curve(unsigned long iFrame);
 
-	// Document element methods.
-	bool loadElement(qtractorSessionDocument *pDocument, QDomElement *pElement);
-	bool saveElement(qtractorSessionDocument *pDocument, QDomElement *pElement);
+	// Document element (streaming) methods.
+	bool loadStream(qtractorSessionDocument *pDocument, QXmlStreamReader *pReader);
+	bool saveStream(qtractorSessionDocument *pDocument, QXmlStreamWriter *pWriter);
 
 	// Session property structure.
 	struct Properties
@@ -402,6 +440,13 @@ public:
 	// Pseudo-singleton instance accessor.
 	static qtractorSession *getInstance();
 
+protected:
+
+	// Lazy (deferred) clip opening helpers.
+	bool isDeferClipLockFree(qtractorClip *pClip) const;
+	bool openDeferClipLockFree(qtractorClip *pClip);
+	void cleanupDeferClips();
+
 private:
 
 	Properties     m_props;             // Session properties.
@@ -430,6 +475,10 @@ private:
 
 	// Audio peak factory (singleton) instance.
 	qtractorAudioPeakFactory *m_pAudioPeakFactory;
+	qtractorAudioCacheFactory *m_pAudioCacheFactory;
+
+	// Parsed MIDI file cache (singleton) instance.
+	qtractorMidiFileCache *m_pMidiFileCache;
 
 	// Track recording counts.
 	unsigned short m_iAudioRecord;
@@ -477,6 +526,16 @@ private:
 	// RT-safeness hackish lock-mutex.
 	qtractorAtomic m_locks;
 	qtractorAtomic m_mutex;
+	qtractorAtomic m_render;
+
+	// Lazy (deferred) clip opening mode.
+	bool m_bDeferClips;
+
+	// Lazy (deferred) clip files parallel prefetch.
+	qtractorSessionPrefetch *m_pPrefetch;
+
+	// Deferred (parallel) plugin instantiation mode.
+	bool m_bDeferPlugins;
 
 	// Instrument names mapping.
 	qtractorInstrumentList *m_pInstruments;
@@ -92,10 +92,18 @@ void qtractorSessionCursor::seek ( unsigned long iFrame, bool bSync )
 		pClip = seekClip(pTrack, pClip, iFrame);
 		// Update cursor track clip...
 		m_ppClips[iTrack] = pClip;
+		// Render-ahead must let go before the reader gets there...
+		if (bSync && pTrack->isRenderAheadActive())
+			pTrack->resetRenderAhead();
 		// Now something fulcral for clips around...
-		if (pTrack->trackType() == m_syncType) {
+		// (render-ahead tracks do position their own, while active)
+		if (pTrack->trackType() == m_syncType
+			&& !pTrack->isRenderAheadActive()) {
 			// Tell whether play-head is after loop-start position...
 			const bool bLooping = (iFrame >= m_pSession->loopStart());
+			// Frozen track render cache goes along...
+			if (bSync && pTrack->isFrozen())
+				pTrack->seekFreeze(iFrame);
 			// Care for old/previous clip...
 			if (pClipLast && pClipLast != pClip)
 				pClipLast->reset(bLooping);
@@ -166,15 +174,22 @@ qtractorClip *qtractorSessionCursor::clip ( unsigned int iTrack ) const
 qtractorClip *qtractorSessionCursor::seekClip (
 	qtractorTrack *pTrack, qtractorClip *pClip, unsigned long iFrame ) const
 {
-	if (pClip == NULL)
-		pClip = pTrack->clips().first();
-
+	// Just a few steps forward (eg. while rolling)?
+	int iSteps = 0;
 	while (pClip && iFrame > pClip->clipStart() + pClip->clipLength()) {
 	//	if (pTrack->trackType() == m_syncType)
 	//		pClip->reset(m_pSession->isLooping());
+		if (++iSteps > 4) {
+			pClip = NULL;
+			break;
+		}
 		pClip = pClip->next();
 	}
 
+	// Otherwise go straight through the clip (interval) index...
+	if (pClip == NULL)
+		pClip = pTrack->seekClip(iFrame);
+
 	if (pClip == NULL)
 		pClip = pTrack->clips().last();
 
@@ -210,11 +225,16 @@ void qtractorSessionCursor::updateTrack ( qtractorTrack *pTrack )
 	const int iTrack = m_pSession->tracks().find(pTrack);
 	if (iTrack >= 0) {
 		qtractorClip *pClip = seekClip(pTrack, NULL, m_iFrame);
-		if (pClip && pTrack->trackType() == m_syncType
+		if (pTrack->isRenderAhead())
+			pTrack->resetRenderAhead();
+		if (pClip && !pTrack->isRenderAheadActive()
+			&& pTrack->trackType() == m_syncType
 			&& m_iFrame >= pClip->clipStart()
 			&& m_iFrame <  pClip->clipStart() + pClip->clipLength()) {
 			pClip->seek(m_iFrame - pClip->clipStart());
 		}
+		if (pTrack->isFrozen() && pTrack->trackType() == m_syncType)
+			pTrack->seekFreeze(m_iFrame);
 		m_ppClips[iTrack] = pClip;
 	}
 }
@@ -243,7 +263,10 @@ void qtractorSessionCursor::updateTrackClip ( qtractorTrack *pTrack )
 	const int iTrack = m_pSession->tracks().find(pTrack);
 	if (iTrack >= 0) {
 		qtractorClip *pClip = m_ppClips[iTrack];
-		if (pClip && pTrack->trackType() == m_syncType) {
+		if (pTrack->isRenderAhead())
+			pTrack->resetRenderAhead();
+		if (pClip && !pTrack->isRenderAheadActive()
+			&& pTrack->trackType() == m_syncType) {
 			if (m_iFrame >= pClip->clipStart() &&
 				m_iFrame <  pClip->clipStart() + pClip->clipLength()) {
 				pClip->seek(m_iFrame - pClip->clipStart());
@@ -251,6 +274,8 @@ void qtractorSessionCursor::updateTrackClip ( qtractorTrack *pTrack )
 				pClip->reset(m_iFrame >= m_pSession->loopStart());
 			}
 		}
+		if (pTrack->isFrozen() && pTrack->trackType() == m_syncType)
+			pTrack->seekFreeze(m_iFrame);
 	}
 }
 
@@ -264,11 +289,16 @@ void qtractorSessionCursor::updateClips ( qtractorClip **ppClips,
 	qtractorTrack *pTrack = m_pSession->tracks().first();
 	while (pTrack && iTrack < iTracks) {
 		qtractorClip *pClip = seekClip(pTrack, NULL, m_iFrame);
-		if (pClip && pTrack->trackType() == m_syncType
+		if (pTrack->isRenderAhead())
+			pTrack->resetRenderAhead();
+		if (pClip && !pTrack->isRenderAheadActive()
+			&& pTrack->trackType() == m_syncType
 			&& m_iFrame >= pClip->clipStart()
 			&& m_iFrame <  pClip->clipStart() + pClip->clipLength()) {
 			pClip->seek(m_iFrame - pClip->clipStart());
 		}
+		if (pTrack->isFrozen() && pTrack->trackType() == m_syncType)
+			pTrack->seekFreeze(m_iFrame);
 		ppClips[iTrack] = pClip;
 		pTrack = pTrack->next();
 		++iTrack;
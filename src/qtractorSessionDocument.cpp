@@ -24,6 +24,8 @@
 
 #include "qtractorSession.h"
 
+#include <QXmlStreamWriter>
+
 
 //-------------------------------------------------------------------------
 // qtractorSessionDocument -- Session file import/export helper class.
@@ -59,17 +61,21 @@ qtractorFiles *qtractorSessionDocument::files (void) const
 }
 
 
-// The elemental loader implementation.
-bool qtractorSessionDocument::loadElement ( QDomElement *pElement )
+// The elemental (streaming) loader implementation.
+bool qtractorSessionDocument::loadStream ( QXmlStreamReader *pReader )
 {
-	return m_pSession->loadElement(this, pElement);
+	return m_pSession->loadStream(this, pReader);
 }
 
 
-// The elemental saver implementation.
-bool qtractorSessionDocument::saveElement ( QDomElement *pElement )
+// The elemental (streaming) saver implementation.
+bool qtractorSessionDocument::saveStream ( QXmlStreamWriter *pWriter )
 {
-	return m_pSession->saveElement(this, pElement);
+	pWriter->writeStartElement("session");
+	const bool bResult = m_pSession->saveStream(this, pWriter);
+	pWriter->writeEndElement();
+
+	return bResult;
 }
 
 
@@ -47,9 +47,9 @@ public:
 	qtractorSession *session() const;
 	qtractorFiles   *files() const;
 
-	// Elemental loader/savers...
-	bool loadElement(QDomElement *pElement);
-	bool saveElement(QDomElement *pElement);
+	// Elemental (streaming) loader/savers...
+	bool loadStream(QXmlStreamReader *pReader);
+	bool saveStream(QXmlStreamWriter *pWriter);
 
 private:
 
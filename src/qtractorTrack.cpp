@@ -31,6 +31,7 @@
 #include "qtractorAudioEngine.h"
 #include "qtractorAudioMonitor.h"
 #include "qtractorAudioBuffer.h"
+#include "qtractorAudioRender.h"
 #include "qtractorMidiEngine.h"
 #include "qtractorMidiMonitor.h"
 #include "qtractorMidiManager.h"
@@ -39,6 +40,7 @@
 #include "qtractorMixer.h"
 #include "qtractorMeter.h"
 #include "qtractorCurveFile.h"
+#include "qtractorFileList.h"
 
 #include "qtractorTrackCommand.h"
 
@@ -47,9 +49,15 @@
 #include "qtractorTrackList.h"
 
 #include <QPainter>
+#include <QVector>
 
 #include <QDomDocument>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QDataStream>
 #include <QFileInfo>
+#include <QFile>
+#include <QDir>
 
 
 //------------------------------------------------------------------------
@@ -203,6 +211,155 @@ private:
 };
 
 
+//----------------------------------------------------------------------------
+// qtractorTrack::ClipIndex -- Track clip interval index.
+//
+// Clips are kept in the very same order as the track clip list (by start),
+// along with the running maximum of their end frames: being monotonic, it
+// may be binary-searched for the first clip still sounding at any given
+// frame, no matter how clips overlap each other.
+
+class qtractorTrack::ClipIndex
+{
+public:
+
+	// Constructor.
+	ClipIndex() {}
+
+	// Index size.
+	int count() const
+		{ return m_items.count(); }
+
+	// Clip reference at given index (null if past end).
+	qtractorClip *at(int iIndex) const
+		{ return (iIndex < m_items.count() ? m_items.at(iIndex).clip : NULL); }
+
+	// First index of clip starting at or past given frame.
+	int lowerBound(unsigned long iFrame) const
+	{
+		int i = 0;
+		int n = m_items.count();
+		while (n > 0) {
+			const int h = (n >> 1);
+			if (m_items.at(i + h).start < iFrame) {
+				i += h + 1;
+				n -= h + 1;
+			} else {
+				n = h;
+			}
+		}
+		return i;
+	}
+
+	// First index of clip ending at or past given frame.
+	int seek(unsigned long iFrame) const
+	{
+		int i = 0;
+		int n = m_items.count();
+		while (n > 0) {
+			const int h = (n >> 1);
+			if (m_items.at(i + h).maxEnd < iFrame) {
+				i += h + 1;
+				n -= h + 1;
+			} else {
+				n = h;
+			}
+		}
+		return i;
+	}
+
+	// Clip reference lookup.
+	int find(qtractorClip *pClip) const
+	{
+		const int n = m_items.count();
+		int i = lowerBound(pClip->clipStart());
+		for ( ; i < n && m_items.at(i).start == pClip->clipStart(); ++i) {
+			if (m_items.at(i).clip == pClip)
+				return i;
+		}
+		// Changed in place? go the slow way...
+		for (i = 0; i < n; ++i) {
+			if (m_items.at(i).clip == pClip)
+				return i;
+		}
+		return -1;
+	}
+
+	// Index maintenance.
+	void insert(int iIndex, qtractorClip *pClip)
+	{
+		m_items.insert(iIndex, Item(pClip));
+		updateMaxEnd(iIndex);
+	}
+
+	void remove(int iIndex)
+	{
+		m_items.remove(iIndex);
+		if (iIndex < m_items.count())
+			updateMaxEnd(iIndex);
+	}
+
+	void update(int iIndex)
+	{
+		Item& item = m_items[iIndex];
+		item.start = item.clip->clipStart();
+		item.end = item.start + item.clip->clipLength();
+		updateMaxEnd(iIndex);
+	}
+
+	void rebuild(const qtractorList<qtractorClip>& clips)
+	{
+		m_items.clear();
+		m_items.reserve(clips.count());
+		for (qtractorClip *pClip = clips.first();
+				pClip; pClip = pClip->next()) {
+			m_items.append(Item(pClip));
+		}
+		if (!m_items.isEmpty())
+			updateMaxEnd(0);
+	}
+
+	void clear()
+		{ m_items.clear(); }
+
+protected:
+
+	// Running maximum end update (stops short when settled).
+	void updateMaxEnd(int iIndex)
+	{
+		unsigned long iMaxEnd = (iIndex > 0 ? m_items.at(iIndex - 1).maxEnd : 0);
+		const int n = m_items.count();
+		for (int i = iIndex; i < n; ++i) {
+			Item& item = m_items[i];
+			if (iMaxEnd < item.end)
+				iMaxEnd = item.end;
+			if (i > iIndex && item.maxEnd == iMaxEnd)
+				break;
+			item.maxEnd = iMaxEnd;
+		}
+	}
+
+private:
+
+	// Index item.
+	struct Item
+	{
+		Item(qtractorClip *pClip = NULL) : clip(pClip),
+			start(pClip ? pClip->clipStart() : 0),
+			end(pClip ? pClip->clipStart() + pClip->clipLength() : 0),
+			maxEnd(0) {}
+
+		qtractorClip *clip;
+		unsigned long start;
+		unsigned long end;
+		unsigned long maxEnd;
+	};
+
+	// Instance members.
+	QVector<Item> m_items;
+};
+
+
 //-------------------------------------------------------------------------
 // qtractorTrack::Properties -- Track properties structure.
 
@@ -321,7 +478,22 @@ qtractorTrack::qtractorTrack ( qtractorSession *pSession, TrackType trackType )
 
 	m_clips.setAutoDelete(true);
 
+	m_pClipIndex = new ClipIndex();
+
 	m_pSyncThread = NULL;
+	m_pRecordThread = NULL;
+
+	m_pFreezeBuff = NULL;
+	m_bFreezePostFader = true;
+	m_iFreezeHash = 0;
+
+	m_bContentsDirty = false;
+
+	m_bThawPostFader = true;
+	m_iThawHash = 0;
+
+	m_pRender = NULL;
+	m_iRenderHash = 0;
 
 	m_pMidiVolumeObserver  = NULL;
 	m_pMidiPanningObserver = NULL;
@@ -391,15 +563,21 @@ qtractorTrack::~qtractorTrack (void)
 		delete m_pPluginList;
 	if (m_pMonitor)
 		delete m_pMonitor;
+
+	delete m_pClipIndex;
 }
 
 
 // Reset track.
 void qtractorTrack::clear (void)
 {
+	setRenderAhead(false);
+
 	setClipRecord(NULL);
 
 	clearTakeInfo();
+	m_deferClips.clear();
+	m_pClipIndex->clear();
 	m_clips.clear();
 
 	m_pPluginList->clear();
@@ -416,6 +594,16 @@ void qtractorTrack::clear (void)
 	m_props.gain    = 1.0f;
 	m_props.panning = 0.0f;
 
+	closeFreeze();
+
+	m_sFreezeFilename.clear();
+	m_bFreezePostFader = true;
+	m_iFreezeHash = 0;
+
+	m_sThawFilename.clear();
+	m_bThawPostFader = true;
+	m_iThawHash = 0;
+
 	if (m_pSyncThread) {
 		if (m_pSyncThread->isRunning()) do {
 			m_pSyncThread->setRunState(false);
@@ -425,6 +613,12 @@ void qtractorTrack::clear (void)
 		delete m_pSyncThread;
 		m_pSyncThread = NULL;
 	}
+
+	if (m_pRecordThread) {
+		m_pRecordThread->stop();
+		delete m_pRecordThread;
+		m_pRecordThread = NULL;
+	}
 }
 
 
@@ -611,6 +805,10 @@ bool qtractorTrack::open (void)
 	// Ah, at least make new name feedback...
 	updateTrackName();
 
+	// Frozen track render cache, if any...
+	if (!m_sFreezeFilename.isEmpty())
+		openFreeze();
+
 	// Done.
 	return (m_pMonitor != NULL);
 }
@@ -641,6 +839,10 @@ void qtractorTrack::close (void)
 	}
 #endif
 
+	setRenderAhead(false);
+
+	closeFreeze();
+
 	m_pInputBus  = NULL;
 	m_pOutputBus = NULL;
 
@@ -1068,6 +1270,15 @@ void qtractorTrack::addClip ( qtractorClip *pClip )
 {
 	// Preliminary settings...
 	pClip->setTrack(this);
+
+	// Insert the clip in proper place in track first, so that
+	// its length settled on open is just an in-place update...
+	insertClip(pClip);
+	openClip(pClip);
+}
+
+void qtractorTrack::openClip ( qtractorClip *pClip )
+{
 	pClip->open();
 
 	// Special case for initial MIDI tracks...
@@ -1081,30 +1292,82 @@ void qtractorTrack::addClip ( qtractorClip *pClip )
 				setMidiProg(pMidiClip->prog());
 		}
 	}
-
-	// Now do insert the clip in proper place in track...
-	insertClip(pClip);
 }
 
 void qtractorTrack::insertClip ( qtractorClip *pClip )
 {
-	qtractorClip *pNextClip = m_clips.first();
-	while (pNextClip && pNextClip->clipStart() < pClip->clipStart())
-		pNextClip = pNextClip->next();
+	const int iIndex = m_pClipIndex->lowerBound(pClip->clipStart());
+	qtractorClip *pNextClip = m_pClipIndex->at(iIndex);
 	if (pNextClip)
 		m_clips.insertBefore(pClip, pNextClip);
 	else
 		m_clips.append(pClip);
+	m_pClipIndex->insert(iIndex, pClip);
+
+	m_bContentsDirty = true;
 }
 
 
 void qtractorTrack::unlinkClip ( qtractorClip *pClip )
 {
+	const int iIndex = m_pClipIndex->find(pClip);
+	if (iIndex >= 0)
+		m_pClipIndex->remove(iIndex);
+
 	m_clips.unlink(pClip);
+
+	m_bContentsDirty = true;
+}
+
+
+// Clip (interval) index update, on clip changed in place.
+void qtractorTrack::updateClip ( qtractorClip *pClip )
+{
+	const int iIndex = m_pClipIndex->find(pClip);
+	if (iIndex < 0)
+		return;
+
+	// Whether it's still in proper order...
+	qtractorClip *pPrevClip = pClip->prev();
+	qtractorClip *pNextClip = pClip->next();
+	if ((pPrevClip && pPrevClip->clipStart() > pClip->clipStart()) ||
+		(pNextClip && pNextClip->clipStart() < pClip->clipStart())) {
+		m_pClipIndex->remove(iIndex);
+		m_clips.unlink(pClip);
+		insertClip(pClip);
+	} else {
+		m_pClipIndex->update(iIndex);
+	}
+
+	m_bContentsDirty = true;
+}
+
+
+// Clip (interval) index rebuild, on bulk changes (eg. tempo).
+void qtractorTrack::updateClipIndex (void)
+{
+	m_pClipIndex->rebuild(m_clips);
+
+	m_bContentsDirty = true;
+}
+
+
+// Clip (interval) index lookup: first clip ending at or past given frame.
+qtractorClip *qtractorTrack::seekClip ( unsigned long iFrame ) const
+{
+	qtractorClip *pClip = m_pClipIndex->at(m_pClipIndex->seek(iFrame));
+
+	// Make sure (in case of any stale index)...
+	while (pClip && iFrame > pClip->clipStart() + pClip->clipLength())
+		pClip = pClip->next();
+
+	return pClip;
 }
 
 void qtractorTrack::removeClip ( qtractorClip *pClip )
 {
+	m_deferClips.removeAll(pClip);
+
 //	pClip->setTrack(NULL);
 	pClip->close();
 
@@ -1112,6 +1375,59 @@ void qtractorTrack::removeClip ( qtractorClip *pClip )
 }
 
 
+// Lazy (deferred) clip insertion: clip files are to be open later.
+void qtractorTrack::deferClip ( qtractorClip *pClip )
+{
+	pClip->setTrack(this);
+
+	insertClip(pClip);
+
+	m_deferClips.append(pClip);
+}
+
+
+// Open a lazy (deferred) clip, if still pending.
+bool qtractorTrack::openDeferClip ( qtractorClip *pClip )
+{
+	const int iDeferClip = m_deferClips.indexOf(pClip);
+	if (iDeferClip < 0)
+		return false;
+
+	m_deferClips.removeAt(iDeferClip);
+
+	openClip(pClip);
+
+	// Clip file length might be different than expected...
+	updateClip(pClip);
+
+	return true;
+}
+
+
+// Open all pending lazy (deferred) clips, right away.
+int qtractorTrack::openDeferClips (void)
+{
+	int iDeferClips = 0;
+
+	while (!m_deferClips.isEmpty()) {
+		openClip(m_deferClips.takeFirst());
+		++iDeferClips;
+	}
+
+	if (iDeferClips > 0)
+		updateClipIndex();
+
+	return iDeferClips;
+}
+
+
+// Pending lazy (deferred) clips accessor.
+const QList<qtractorClip *>& qtractorTrack::deferClips (void) const
+{
+	return m_deferClips;
+}
+
+
 // Current clip on record (capture).
 void qtractorTrack::setClipRecord ( qtractorClip *pClipRecord )
 {
@@ -1270,6 +1586,9 @@ void qtractorTrack::process ( qtractorClip *pClip,
 {
 	// Audio-buffers needs some preparation...
 	const unsigned int nframes = iFrameEnd - iFrameStart;
+	const bool bPlayback
+		= (!isMute() && (!m_pSession->soloTracks() || isSolo()));
+	bool bSilent = false;
 	qtractorAudioMonitor *pAudioMonitor = NULL;
 	qtractorAudioBus *pOutputBus = NULL;
 	if (m_props.trackType == qtractorTrack::Audio) {
@@ -1279,26 +1598,76 @@ void qtractorTrack::process ( qtractorClip *pClip,
 		if (pOutputBus) {
 			qtractorAudioBus *pInputBus = (m_pSession->isTrackMonitor(this)
 				? static_cast<qtractorAudioBus *> (m_pInputBus) : NULL);
+			// Provably silent? (no input, no clip under the play-head)
+			if (pInputBus == NULL && m_pFreezeBuff == NULL && m_pRender == NULL) {
+				bSilent = true;
+				if (bPlayback) {
+					qtractorClip *pClipEx = pClip;
+					while (pClipEx && pClipEx->clipStart() < iFrameEnd) {
+						if (iFrameStart
+							< pClipEx->clipStart() + pClipEx->clipLength()) {
+							bSilent = false;
+							break;
+						}
+						pClipEx = pClipEx->next();
+					}
+				}
+				// Skip it all, once all plugin tails are gone...
+				if (bSilent && m_pPluginList->isSilent())
+					return;
+			}
 			pOutputBus->buffer_prepare(nframes, pInputBus);
 		}
 	}
 
+	// Frozen track render cache stands for all clips and plugins...
+	qtractorAudioBuffer *pFreezeBuff = (pOutputBus ? m_pFreezeBuff : NULL);
+
+	// And so does the anticipative (render-ahead) lookahead,
+	// unless it falls back to regular processing (on misses)...
+	qtractorAudioRender *pAudioRender = (pOutputBus ? m_pRender : NULL);
+	const bool bRender = (pAudioRender
+		&& pAudioRender->process(bPlayback ? pOutputBus->buffer() : NULL,
+			iFrameStart, iFrameEnd));
+
 	// Playback...
-	if (!isMute() && (!m_pSession->soloTracks() || isSolo())) {
-		// Now, for every clip...
-		while (pClip && pClip->clipStart() < iFrameEnd) {
-			if (iFrameStart < pClip->clipStart() + pClip->clipLength())
-				pClip->process(iFrameStart, iFrameEnd);
-			pClip = pClip->next();
+	if (bPlayback && !bSilent && !bRender) {
+		if (pFreezeBuff) {
+			// Frozen playback...
+			if (iFrameStart < pFreezeBuff->length()
+				&& pFreezeBuff->inSync(iFrameStart, iFrameEnd)) {
+				pFreezeBuff->readMix(pOutputBus->buffer(),
+					nframes, pOutputBus->channels(), 0, 1.0f);
+			}
+		} else {
+			// Now, for every clip...
+			while (pClip && pClip->clipStart() < iFrameEnd) {
+				if (iFrameStart < pClip->clipStart() + pClip->clipLength())
+					pClip->process(iFrameStart, iFrameEnd);
+				pClip = pClip->next();
+			}
 		}
 	}
 
 	// Audio buffers needs monitoring and commitment...
 	if (pAudioMonitor && pOutputBus) {
-		// Plugin chain post-processing...
-		m_pPluginList->process(pOutputBus->buffer(), nframes);
-		// Monitor passthru...
-		pAudioMonitor->process(pOutputBus->buffer(), nframes);
+		// Plugin chain post-processing (ringing out, when silent)...
+		if (pFreezeBuff == NULL && !bRender) {
+			const bool bProcess
+				= m_pPluginList->process(pOutputBus->buffer(), nframes, bSilent);
+			// Render-ahead may take over from here, once settled...
+			if (pAudioRender)
+				pAudioRender->handover(iFrameEnd);
+			if (!bProcess)
+				return;
+		}
+		// Monitor passthru (or metering only, when frozen post-fader)...
+		if (pFreezeBuff && m_bFreezePostFader) {
+			pAudioMonitor->process_meter(
+				pOutputBus->buffer(), nframes, pOutputBus->channels());
+		} else {
+			pAudioMonitor->process(pOutputBus->buffer(), nframes);
+		}
 		// Actually render it...
 		pOutputBus->buffer_commit(nframes);
 	}
@@ -1316,37 +1685,120 @@ void qtractorTrack::process_export ( qtractorClip *pClip,
 
 	// Audio-buffers needs some preparation...
 	const unsigned int nframes = iFrameEnd - iFrameStart;
+	const bool bPlayback
+		= (!isMute() && (!m_pSession->soloTracks() || isSolo()));
+	bool bSilent = false;
 	qtractorAudioMonitor *pAudioMonitor = NULL;
 	qtractorAudioBus *pOutputBus = NULL;
 	if (m_props.trackType == qtractorTrack::Audio) {
 		pAudioMonitor = static_cast<qtractorAudioMonitor *> (m_pMonitor);
 		pOutputBus = static_cast<qtractorAudioBus *> (m_pOutputBus);
-		if (pOutputBus)
+		if (pOutputBus) {
+			// Track stems may still grab this (silent) buffer...
 			pOutputBus->buffer_prepare(nframes);
+			// Provably silent? (no clip under the play-head)
+			if (m_pFreezeBuff == NULL) {
+				bSilent = true;
+				if (bPlayback) {
+					qtractorClip *pClipEx = pClip;
+					while (pClipEx && pClipEx->clipStart() < iFrameEnd) {
+						if (iFrameStart
+							< pClipEx->clipStart() + pClipEx->clipLength()) {
+							bSilent = false;
+							break;
+						}
+						pClipEx = pClipEx->next();
+					}
+				}
+				// Skip it all, once all plugin tails are gone...
+				if (bSilent && m_pPluginList->isSilent())
+					return;
+			}
+		}
 	}
 
+	// Frozen track render cache stands for all clips and plugins...
+	qtractorAudioBuffer *pFreezeBuff = (pOutputBus ? m_pFreezeBuff : NULL);
+
 	// Playback...
-	if (!isMute() && (!m_pSession->soloTracks() || isSolo())) {
-		// Now, for every clip...
-		while (pClip && pClip->clipStart() < iFrameEnd) {
-			if (iFrameStart < pClip->clipStart() + pClip->clipLength())
-				pClip->process_export(iFrameStart, iFrameEnd);
-			pClip = pClip->next();
+	if (bPlayback && !bSilent) {
+		if (pFreezeBuff) {
+			// Frozen playback (direct sync)...
+			pFreezeBuff->syncExport();
+			if (iFrameStart < pFreezeBuff->length()
+				&& pFreezeBuff->inSync(iFrameStart, iFrameEnd)) {
+				pFreezeBuff->readMix(pOutputBus->buffer(),
+					nframes, pOutputBus->channels(), 0, 1.0f);
+			}
+		} else {
+			// Now, for every clip...
+			while (pClip && pClip->clipStart() < iFrameEnd) {
+				if (iFrameStart < pClip->clipStart() + pClip->clipLength())
+					pClip->process_export(iFrameStart, iFrameEnd);
+				pClip = pClip->next();
+			}
 		}
 	}
 
 	// Audio buffers needs monitoring and commitment...
 	if (pAudioMonitor && pOutputBus) {
-		// Plugin chain post-processing...
-		m_pPluginList->process(pOutputBus->buffer(), nframes);
-		// Monitor passthru...
-		pAudioMonitor->process(pOutputBus->buffer(), nframes);
+		// Plugin chain post-processing (ringing out, when silent)...
+		if (pFreezeBuff == NULL
+			&& !m_pPluginList->process(pOutputBus->buffer(), nframes, bSilent))
+			return;
+		// Monitor passthru (or metering only, when frozen post-fader)...
+		if (pFreezeBuff && m_bFreezePostFader) {
+			pAudioMonitor->process_meter(
+				pOutputBus->buffer(), nframes, pOutputBus->channels());
+		} else {
+			pAudioMonitor->process(pOutputBus->buffer(), nframes);
+		}
 		// Actually render it...
 		pOutputBus->buffer_commit(nframes);
 	}
 }
 
 
+// Track freeze rendering process executive (needed for freeze).
+void qtractorTrack::process_freeze ( qtractorClip *pClip,
+	unsigned long iFrameStart, unsigned long iFrameEnd, bool bPostFader )
+{
+	if (m_props.trackType != qtractorTrack::Audio)
+		return;
+
+	qtractorAudioBus *pOutputBus
+		= static_cast<qtractorAudioBus *> (m_pOutputBus);
+	if (pOutputBus == NULL)
+		return;
+
+	// Track automation processing...
+	qtractorCurveList *pCurveList = curveList();
+	if (pCurveList && pCurveList->isProcess())
+		pCurveList->process(iFrameStart);
+
+	// Audio-buffers needs some preparation...
+	const unsigned int nframes = iFrameEnd - iFrameStart;
+	pOutputBus->buffer_prepare(nframes);
+
+	// Render all clips, regardless of mute/solo state...
+	while (pClip && pClip->clipStart() < iFrameEnd) {
+		if (iFrameStart < pClip->clipStart() + pClip->clipLength())
+			pClip->process_export(iFrameStart, iFrameEnd);
+		pClip = pClip->next();
+	}
+
+	// Plugin chain post-processing...
+	m_pPluginList->process(pOutputBus->buffer(), nframes);
+
+	// Fader (gain and panning) is rendered only if post-fader;
+	// the track buffer is left uncommitted, for the caller to grab.
+	qtractorAudioMonitor *pAudioMonitor
+		= static_cast<qtractorAudioMonitor *> (m_pMonitor);
+	if (pAudioMonitor && bPostFader)
+		pAudioMonitor->process(pOutputBus->buffer(), nframes);
+}
+
+
 // Track special process record executive (audio recording only).
 void qtractorTrack::process_record (
 	unsigned long iFrameStart, unsigned long iFrameEnd )
@@ -1408,7 +1860,7 @@ void qtractorTrack::drawTrack ( QPainter *pPainter, const QRect& trackRect,
 	const int h = trackRect.height();
 
 	if (pClip == NULL)
-		pClip = m_clips.first();
+		pClip = seekClip(iTrackStart);
 
 	// Track/clip background...
 	QColor bg = background();
@@ -1477,6 +1929,13 @@ void qtractorTrack::setLoop (
 		}
 		pClip = pClip->next();
 	}
+
+	// Frozen track render cache loop...
+	if (m_pFreezeBuff)
+		m_pFreezeBuff->setLoop(iLoopStart, iLoopEnd);
+
+	// Anticipative (render-ahead) lookahead is now stale...
+	resetRenderAhead();
 }
 
 
@@ -1539,6 +1998,441 @@ qtractorAudioBufferThread *qtractorTrack::syncThread (void)
 }
 
 
+// Audio recording (write-behind) thread, one per track,
+// so that simultaneous recordings don't wait on each other.
+qtractorAudioBufferThread *qtractorTrack::recordThread (void)
+{
+	if (m_pRecordThread == NULL) {
+		m_pRecordThread = new qtractorAudioBufferThread();
+		m_pRecordThread->start(QThread::HighPriority);
+	}
+
+	return m_pRecordThread;
+}
+
+
+// Track freeze (render cache) methods.
+bool qtractorTrack::freeze ( bool bPostFader )
+{
+	if (m_pSession == NULL)
+		return false;
+
+	if (m_props.trackType != qtractorTrack::Audio)
+		return false;
+
+	qtractorAudioEngine *pAudioEngine = m_pSession->audioEngine();
+	if (pAudioEngine == NULL)
+		return false;
+
+	// Last thawed render cache may be just good enough...
+	if (m_sFreezeFilename.isEmpty()
+		&& !m_sThawFilename.isEmpty()
+		&& m_bThawPostFader == bPostFader
+		&& m_iThawHash == contentsHash(bPostFader)
+		&& QFileInfo(m_sThawFilename).exists()) {
+		m_sFreezeFilename  = m_sThawFilename;
+		m_bFreezePostFader = m_bThawPostFader;
+		m_iFreezeHash = m_iThawHash;
+		m_sThawFilename.clear();
+		m_pSession->files()->addClipItem(
+			qtractorFileList::Audio, m_sFreezeFilename);
+		return openFreeze();
+	}
+
+	// Always start from scratch...
+	unfreeze();
+
+	// Render it offline, through the freewheeling export path...
+	const QString& sFilename = m_pSession->createFilePath(
+		trackName() + "-freeze", qtractorAudioFileFactory::defaultExt());
+	if (!pAudioEngine->fileFreeze(sFilename, this, bPostFader)) {
+		m_pSession->releaseFilePath(sFilename);
+		QFile::remove(sFilename);
+		return false;
+	}
+
+	m_sFreezeFilename  = sFilename;
+	m_bFreezePostFader = bPostFader;
+	m_iFreezeHash = freezeHash();
+	m_bContentsDirty = false;
+
+	// Register as a brand new (auto-removable) render file,
+	// just like recorded ones, until the session gets saved...
+	m_pSession->files()->addClipItem(
+		qtractorFileList::Audio, m_sFreezeFilename, true);
+
+	return openFreeze();
+}
+
+
+void qtractorTrack::unfreeze (void)
+{
+	if (m_sFreezeFilename.isEmpty())
+		return;
+
+	closeFreeze();
+
+	// Thaw any stale plugin state...
+	m_pPluginList->resetBuffers();
+
+	// Rendered cache is of no use anymore, though it might still be
+	// referenced by a saved session: unsaved renders are only removed
+	// on session cleanup, as for any other recorded file...
+	if (m_pSession) {
+		m_pSession->files()->removeClipItem(
+			qtractorFileList::Audio, m_sFreezeFilename);
+	}
+
+	// Keep it around, in case it gets frozen back again...
+	m_sThawFilename  = m_sFreezeFilename;
+	m_bThawPostFader = m_bFreezePostFader;
+	m_iThawHash = m_iFreezeHash;
+
+	m_sFreezeFilename.clear();
+	m_bFreezePostFader = true;
+	m_iFreezeHash = 0;
+
+	// Resume to normal clip playback...
+	if (m_pSession) {
+		qtractorAudioEngine *pAudioEngine = m_pSession->audioEngine();
+		if (pAudioEngine && pAudioEngine->sessionCursor())
+			pAudioEngine->sessionCursor()->updateTrackClip(this);
+	}
+}
+
+
+bool qtractorTrack::isFrozen (void) const
+{
+	return (m_pFreezeBuff != NULL);
+}
+
+
+bool qtractorTrack::isFreezePostFader (void) const
+{
+	return m_bFreezePostFader;
+}
+
+
+const QString& qtractorTrack::freezeFilename (void) const
+{
+	return m_sFreezeFilename;
+}
+
+
+// Track freeze render cache positioning.
+void qtractorTrack::seekFreeze ( unsigned long iFrame )
+{
+	if (m_pFreezeBuff == NULL)
+		return;
+
+	if (iFrame < m_pFreezeBuff->length())
+		m_pFreezeBuff->seek(iFrame);
+	else
+		m_pFreezeBuff->reset(iFrame >= m_pSession->loopStart());
+}
+
+
+// Take current contents as the frozen ones (eg. on load).
+void qtractorTrack::resetFreezeHash (void)
+{
+	if (!m_sFreezeFilename.isEmpty())
+		m_iFreezeHash = freezeHash();
+
+	m_bContentsDirty = false;
+}
+
+
+// Thaw frozen track if contents have changed ever since.
+bool qtractorTrack::updateFreeze (void)
+{
+	if (m_sFreezeFilename.isEmpty())
+		return false;
+
+	// Nothing changed locally, nothing to check...
+	if (!m_bContentsDirty)
+		return false;
+
+	m_bContentsDirty = false;
+
+	if (m_iFreezeHash == freezeHash())
+		return false;
+
+	unfreeze();
+	return true;
+}
+
+
+// Track-local contents change notification.
+void qtractorTrack::setContentsDirty (void)
+{
+	m_bContentsDirty = true;
+}
+
+bool qtractorTrack::isContentsDirty (void) const
+{
+	return m_bContentsDirty;
+}
+
+
+// Track contents signature (clips, automation, plugins).
+unsigned int qtractorTrack::freezeHash (void) const
+{
+	return contentsHash(m_bFreezePostFader);
+}
+
+unsigned int qtractorTrack::contentsHash ( bool bFader ) const
+{
+	QByteArray data;
+	QDataStream ds(&data, QIODevice::WriteOnly);
+
+	ds << outputBusName();
+
+	// Clips...
+	for (qtractorClip *pClip = m_clips.first();
+			pClip; pClip = pClip->next()) {
+		ds << pClip->filename()
+			<< quint64(pClip->clipStart())
+			<< quint64(pClip->clipOffset())
+			<< quint64(pClip->clipLength())
+			<< pClip->clipGain()
+			<< quint64(pClip->fadeInLength())
+			<< qint32(pClip->fadeInType())
+			<< quint64(pClip->fadeOutLength())
+			<< qint32(pClip->fadeOutType());
+		if (m_props.trackType == qtractorTrack::Audio) {
+			qtractorAudioClip *pAudioClip
+				= static_cast<qtractorAudioClip *> (pClip);
+			ds << pAudioClip->timeStretch() << pAudioClip->pitchShift();
+		}
+	}
+
+	// Plugins...
+	for (qtractorPlugin *pPlugin = m_pPluginList->first();
+			pPlugin; pPlugin = pPlugin->next()) {
+		qtractorPluginType *pType = pPlugin->type();
+		if (pType)
+			ds << pType->filename() << quint64(pType->index());
+		ds << qint32(pPlugin->isActivated());
+		// Only the static parameter values count,
+		// automated ones are given by their curves...
+		const qtractorPlugin::Params& params = pPlugin->params();
+		qtractorPlugin::Params::ConstIterator param = params.constBegin();
+		const qtractorPlugin::Params::ConstIterator& param_end = params.constEnd();
+		for ( ; param != param_end; ++param) {
+			qtractorPluginParam *pParam = param.value();
+			if (!isCurveProcess(pParam->subject()))
+				ds << quint64(param.key()) << pParam->value();
+		}
+	}
+
+	// Automation...
+	qtractorCurveList *pCurveList = curveList();
+	if (pCurveList) {
+		for (qtractorCurve *pCurve = pCurveList->first();
+				pCurve; pCurve = pCurve->next()) {
+			if (!pCurve->isProcess())
+				continue;
+			qtractorSubject *pSubject = pCurve->subject();
+			if (pSubject)
+				ds << pSubject->name();
+			for (qtractorCurve::Node *pNode = pCurve->nodes().first();
+					pNode; pNode = pNode->next()) {
+				ds << quint64(pNode->frame) << pNode->value;
+			}
+		}
+	}
+
+	// Fader, when rendered and not automated...
+	if (bFader && m_pMonitor) {
+		if (!isCurveProcess(m_pMonitor->gainSubject()))
+			ds << m_props.gain;
+		if (!isCurveProcess(m_pMonitor->panningSubject()))
+			ds << m_props.panning;
+	}
+
+	return qHash(data);
+}
+
+
+// Whether a subject value is currently driven by automation.
+bool qtractorTrack::isCurveProcess ( qtractorSubject *pSubject ) const
+{
+	qtractorCurve *pCurve = (pSubject ? pSubject->curve() : NULL);
+	return (pCurve && pCurve->list() == curveList() && pCurve->isProcess());
+}
+
+
+// Anticipative (render-ahead) processing eligibility.
+bool qtractorTrack::canRenderAhead (void)
+{
+	if (m_props.trackType != qtractorTrack::Audio || m_pOutputBus == NULL)
+		return false;
+
+	// Armed, monitored or frozen tracks go on their own...
+	if (isRecord() || isFrozen() || m_pSession->isTrackMonitor(this))
+		return false;
+
+	// Exports (and freezes) must go through regular processing...
+	qtractorAudioEngine *pAudioEngine = m_pSession->audioEngine();
+	if (pAudioEngine == NULL || pAudioEngine->isExporting())
+		return false;
+
+	// Automation must be applied on the spot...
+	qtractorCurveList *pCurveList = curveList();
+	if (pCurveList && pCurveList->isProcess())
+		return false;
+
+	// Plugins that talk to anything else than this track audio...
+	if (m_pPluginList->midiManager())
+		return false;
+
+	for (qtractorPlugin *pPlugin = m_pPluginList->first();
+			pPlugin; pPlugin = pPlugin->next()) {
+		qtractorPluginType *pType = pPlugin->type();
+		if (pType && (pType->typeHint() == qtractorPluginType::Insert
+			|| pType->typeHint() == qtractorPluginType::AuxSend))
+			return false;
+	}
+
+	return true;
+}
+
+
+// Anticipative (render-ahead) processing methods.
+void qtractorTrack::setRenderAhead ( bool bRenderAhead )
+{
+	if (( bRenderAhead && m_pRender) ||
+		(!bRenderAhead && m_pRender == NULL))
+		return;
+
+	qtractorAudioEngine *pAudioEngine
+		= (m_pSession ? m_pSession->audioEngine() : NULL);
+	qtractorAudioRenderPool *pRenderPool
+		= (pAudioEngine ? pAudioEngine->renderPool() : NULL);
+
+	if (bRenderAhead) {
+		qtractorAudioBus *pAudioBus
+			= static_cast<qtractorAudioBus *> (m_pOutputBus);
+		if (pRenderPool == NULL || pAudioBus == NULL
+			|| m_props.trackType != qtractorTrack::Audio)
+			return;
+		qtractorAudioRender *pAudioRender
+			= new qtractorAudioRender(this, pRenderPool,
+				pAudioBus->channels(),
+				pAudioEngine->sampleRate(),
+				pAudioEngine->bufferSize());
+		m_iRenderHash = contentsHash(false);
+		m_pSession->lock();
+		m_pRender = pAudioRender;
+		m_pSession->unlock();
+		pRenderPool->addRender(pAudioRender);
+	} else {
+		qtractorAudioRender *pAudioRender = m_pRender;
+		// Render-ahead workers must let go first...
+		if (pRenderPool)
+			pRenderPool->removeRender(pAudioRender);
+		m_pSession->lock();
+		m_pRender = NULL;
+		// Give all clips back to regular processing...
+		if (!pAudioRender->isDirect()) {
+			pAudioRender->syncClips(m_pSession->playHead());
+			m_pPluginList->resetBuffers();
+		}
+		qtractorSessionCursor *pAudioCursor
+			= (pAudioEngine ? pAudioEngine->sessionCursor() : NULL);
+		if (pAudioCursor)
+			pAudioCursor->updateTrack(this);
+		m_pSession->unlock();
+		delete pAudioRender;
+		m_iRenderHash = 0;
+	}
+}
+
+bool qtractorTrack::isRenderAhead (void) const
+{
+	return (m_pRender != NULL);
+}
+
+bool qtractorTrack::isRenderAheadActive (void) const
+{
+	return (m_pRender && !m_pRender->isDirect());
+}
+
+
+// Render all over again (eg. on edits).
+void qtractorTrack::resetRenderAhead (void)
+{
+	if (m_pRender) m_pRender->reset();
+}
+
+
+// Render all over again if contents have changed ever since.
+bool qtractorTrack::refreshRenderAhead (void)
+{
+	if (m_pRender == NULL)
+		return false;
+
+	const unsigned int iRenderHash = contentsHash(false);
+	if (m_iRenderHash == iRenderHash)
+		return false;
+
+	m_iRenderHash = iRenderHash;
+	m_pRender->reset();
+	return true;
+}
+
+
+// Track freeze render cache open/close.
+bool qtractorTrack::openFreeze (void)
+{
+	closeFreeze();
+
+	if (m_pSession == NULL || m_sFreezeFilename.isEmpty())
+		return false;
+
+	if (m_props.trackType != qtractorTrack::Audio)
+		return false;
+
+	qtractorAudioBus *pAudioBus
+		= static_cast<qtractorAudioBus *> (m_pOutputBus);
+	if (pAudioBus == NULL)
+		return false;
+
+	qtractorAudioBuffer *pFreezeBuff
+		= new qtractorAudioBuffer(syncThread(), pAudioBus->channels());
+	if (!pFreezeBuff->open(m_sFreezeFilename)) {
+		delete pFreezeBuff;
+		return false;
+	}
+
+	pFreezeBuff->setLoop(m_pSession->loopStart(), m_pSession->loopEnd());
+
+	m_pSession->lock();
+	m_pFreezeBuff = pFreezeBuff;
+	m_pSession->unlock();
+
+	seekFreeze(m_pSession->playHead());
+
+	return true;
+}
+
+
+void qtractorTrack::closeFreeze (void)
+{
+	if (m_pFreezeBuff == NULL)
+		return;
+
+	qtractorAudioBuffer *pFreezeBuff = m_pFreezeBuff;
+
+	if (m_pSession) m_pSession->lock();
+	m_pFreezeBuff = NULL;
+	if (m_pSession) m_pSession->unlock();
+
+	pFreezeBuff->close();
+	delete pFreezeBuff;
+}
+
+
 // Track state (monitor record, mute, solo) button setup.
 qtractorSubject *qtractorTrack::monitorSubject (void) const
 {
@@ -1611,128 +2505,115 @@ void qtractorTrack::stateChangeNotify ( ToolType toolType, bool bOn )
 }
 
 
-// Document element methods.
-bool qtractorTrack::loadElement (
-	qtractorDocument *pDocument, QDomElement *pElement )
+// Document element (streaming) methods.
+bool qtractorTrack::loadStream (
+	qtractorDocument *pDocument, QXmlStreamReader *pReader )
 {
 	if (m_pSession == NULL)
 		return false;
 
+	const QXmlStreamAttributes& attrs = pReader->attributes();
 	qtractorTrack::setTrackName(
-		m_pSession->uniqueTrackName(pElement->attribute("name")));
+		m_pSession->uniqueTrackName(attrs.value("name").toString()));
 	qtractorTrack::setTrackType(
-		qtractorTrack::trackTypeFromText(pElement->attribute("type")));
+		qtractorTrack::trackTypeFromText(attrs.value("type").toString()));
 
 	// Reset take(record) descriptor/id registry.
 	clearTakeInfo();
 
 	// Load track children...
-	for (QDomNode nChild = pElement->firstChild();
-			!nChild.isNull();
-				nChild = nChild.nextSibling()) {
+	while (pReader->readNextStartElement()) {
 
-		// Convert node to element...
-		QDomElement eChild = nChild.toElement();
-		if (eChild.isNull())
-			continue;
+		const QString& sChild = pReader->name().toString();
 
 		// Load (other) track properties..
-		if (eChild.tagName() == "properties") {
-			for (QDomNode nProp = eChild.firstChild();
-					!nProp.isNull();
-						nProp = nProp.nextSibling()) {
-				// Convert property node to element...
-				QDomElement eProp = nProp.toElement();
-				if (eProp.isNull())
-					continue;
-				if (eProp.tagName() == "input-bus")
-					qtractorTrack::setInputBusName(eProp.text());
-				else if (eProp.tagName() == "output-bus")
-					qtractorTrack::setOutputBusName(eProp.text());
-				else if (eProp.tagName() == "midi-omni")
+		if (sChild == "properties") {
+			while (pReader->readNextStartElement()) {
+				const QString& sProp = pReader->name().toString();
+				if (sProp == "input-bus")
+					qtractorTrack::setInputBusName(pReader->readElementText());
+				else if (sProp == "output-bus")
+					qtractorTrack::setOutputBusName(pReader->readElementText());
+				else if (sProp == "midi-omni")
 					qtractorTrack::setMidiOmni(
-						qtractorDocument::boolFromText(eProp.text()));
-				else if (eProp.tagName() == "midi-channel")
-					qtractorTrack::setMidiChannel(eProp.text().toUShort());
-				else if (eProp.tagName() == "midi-bank-sel-method")
-					qtractorTrack::setMidiBankSelMethod(eProp.text().toInt());
-				else if (eProp.tagName() == "midi-bank")
-					qtractorTrack::setMidiBank(eProp.text().toInt());
-				else if (eProp.tagName() == "midi-program")
-					qtractorTrack::setMidiProg(eProp.text().toInt());
-				else if (eProp.tagName() == "icon")
-					qtractorTrack::setTrackIcon(eProp.text());
+						qtractorDocument::boolFromText(pReader->readElementText()));
+				else if (sProp == "midi-channel")
+					qtractorTrack::setMidiChannel(pReader->readElementText().toUShort());
+				else if (sProp == "midi-bank-sel-method")
+					qtractorTrack::setMidiBankSelMethod(pReader->readElementText().toInt());
+				else if (sProp == "midi-bank")
+					qtractorTrack::setMidiBank(pReader->readElementText().toInt());
+				else if (sProp == "midi-program")
+					qtractorTrack::setMidiProg(pReader->readElementText().toInt());
+				else if (sProp == "icon")
+					qtractorTrack::setTrackIcon(pReader->readElementText());
+				else
+					pReader->skipCurrentElement();
 			}
 		}
 		else
 		// Load track state..
-		if (eChild.tagName() == "state") {
-			for (QDomNode nState = eChild.firstChild();
-					!nState.isNull();
-						nState = nState.nextSibling()) {
-				// Convert state node to element...
-				QDomElement eState = nState.toElement();
-				if (eState.isNull())
-					continue;
-				if (eState.tagName() == "mute")
+		if (sChild == "state") {
+			while (pReader->readNextStartElement()) {
+				const QString& sState = pReader->name().toString();
+				if (sState == "mute")
 					qtractorTrack::setMute(
-						qtractorDocument::boolFromText(eState.text()));
-				else if (eState.tagName() == "solo")
+						qtractorDocument::boolFromText(pReader->readElementText()));
+				else if (sState == "solo")
 					qtractorTrack::setSolo(
-						qtractorDocument::boolFromText(eState.text()));
-				else if (eState.tagName() == "record")
+						qtractorDocument::boolFromText(pReader->readElementText()));
+				else if (sState == "record")
 					qtractorTrack::setRecord(
-						qtractorDocument::boolFromText(eState.text()));
-				else if (eState.tagName() == "monitor")
+						qtractorDocument::boolFromText(pReader->readElementText()));
+				else if (sState == "monitor")
 					qtractorTrack::setMonitor(
-						qtractorDocument::boolFromText(eState.text()));
-				else if (eState.tagName() == "gain")
-					qtractorTrack::setGain(eState.text().toFloat());
-				else if (eState.tagName() == "panning")
-					qtractorTrack::setPanning(eState.text().toFloat());
+						qtractorDocument::boolFromText(pReader->readElementText()));
+				else if (sState == "gain")
+					qtractorTrack::setGain(pReader->readElementText().toFloat());
+				else if (sState == "panning")
+					qtractorTrack::setPanning(pReader->readElementText().toFloat());
+				else
+					pReader->skipCurrentElement();
 			}
 		}
 		else
-		if (eChild.tagName() == "view") {
-			for (QDomNode nView = eChild.firstChild();
-					!nView.isNull();
-						nView = nView.nextSibling()) {
-				// Convert view node to element...
-				QDomElement eView = nView.toElement();
-				if (eView.isNull())
-					continue;
-				if (eView.tagName() == "height") {
-					qtractorTrack::setHeight(eView.text().toInt());
-				} else if (eView.tagName() == "background-color") {
-					QColor bg; bg.setNamedColor(eView.text());
+		if (sChild == "view") {
+			while (pReader->readNextStartElement()) {
+				const QString& sView = pReader->name().toString();
+				if (sView == "height") {
+					qtractorTrack::setHeight(pReader->readElementText().toInt());
+				} else if (sView == "background-color") {
+					QColor bg; bg.setNamedColor(pReader->readElementText());
 					qtractorTrack::setBackground(bg);
-				} else if (eView.tagName() == "foreground-color") {
-					QColor fg; fg.setNamedColor(eView.text());
+				} else if (sView == "foreground-color") {
+					QColor fg; fg.setNamedColor(pReader->readElementText());
 					qtractorTrack::setForeground(fg);
+				} else {
+					pReader->skipCurrentElement();
 				}
 			}
 		}
 		else
-		if (eChild.tagName() == "controllers") {
+		if (sChild == "controllers") {
 			// Load track controllers...
-			qtractorTrack::loadControllers(&eChild);
+			QDomElement eControllers;
+			if (!pDocument->readElement(pReader, &eControllers))
+				return false;
+			qtractorTrack::loadControllers(&eControllers);
 		}
 		else
-		if (eChild.tagName() == "curve-file") {
+		if (sChild == "curve-file") {
 			// Load track automation curves...
-			qtractorTrack::loadCurveFile(&eChild, m_pCurveFile);
+			QDomElement eCurveFile;
+			if (!pDocument->readElement(pReader, &eCurveFile))
+				return false;
+			qtractorTrack::loadCurveFile(&eCurveFile, m_pCurveFile);
 		}
 		else
 		// Load clips...
-		if (eChild.tagName() == "clips" && !pDocument->isTemplate()) {
-			for (QDomNode nClip = eChild.firstChild();
-					!nClip.isNull();
-						nClip = nClip.nextSibling()) {
-				// Convert clip node to element...
-				QDomElement eClip = nClip.toElement();
-				if (eClip.isNull())
-					continue;
-				if (eClip.tagName() == "clip") {
+		if (sChild == "clips" && !pDocument->isTemplate()) {
+			while (pReader->readNextStartElement()) {
+				if (pReader->name().toString() == "clip") {
 					qtractorClip *pClip = NULL;
 					switch (qtractorTrack::trackType()) {
 						case qtractorTrack::Audio:
@@ -1747,95 +2628,130 @@ bool qtractorTrack::loadElement (
 					}
 					if (pClip == NULL)
 						return false;
-					if (!pClip->loadElement(pDocument, &eClip))
+					if (!pClip->loadStream(pDocument, pReader))
 						return false;
-					qtractorTrack::addClip(pClip);
+					// Clip files might be open later, on demand...
+					if (m_pSession->isDeferClips())
+						qtractorTrack::deferClip(pClip);
+					else
+						qtractorTrack::addClip(pClip);
 				}
+				else pReader->skipCurrentElement();
 			}
 		}
 		else
 		// Load plugins...
-		if (eChild.tagName() == "plugins")
-			m_pPluginList->loadElement(pDocument, &eChild);
+		if (sChild == "plugins") {
+			QDomElement ePlugins;
+			if (!pDocument->readElement(pReader, &ePlugins))
+				return false;
+			m_pPluginList->loadElement(pDocument, &ePlugins);
+		}
+		else
+		// Load freeze (render cache) state...
+		if (sChild == "freeze" && !pDocument->isTemplate()) {
+			const QXmlStreamAttributes& attrs = pReader->attributes();
+			m_bFreezePostFader = (!attrs.hasAttribute("post-fader")
+				|| qtractorDocument::boolFromText(
+					attrs.value("post-fader").toString()));
+			const QDir dir(m_pSession->sessionDir());
+			m_sFreezeFilename = QDir::cleanPath(
+				dir.absoluteFilePath(pReader->readElementText()));
+		}
+		else pReader->skipCurrentElement();
 	}
 
 	// Reset take(record) descriptor/id registry.
 	clearTakeInfo();
-	
-	return true;
+
+	// Frozen as it was, if render cache is still there...
+	if (!m_sFreezeFilename.isEmpty()) {
+		if (QFileInfo(m_sFreezeFilename).exists()) {
+			m_pSession->acquireFilePath(m_sFreezeFilename);
+			m_pSession->files()->addClipItem(
+				qtractorFileList::Audio, m_sFreezeFilename);
+			// Deferred plugins aren't realized just yet...
+			if (!m_pSession->isDeferPlugins())
+				resetFreezeHash();
+		} else {
+			m_sFreezeFilename.clear();
+		}
+	}
+
+	return !pReader->hasError();
 }
 
 
-bool qtractorTrack::saveElement (
-	qtractorDocument *pDocument, QDomElement *pElement ) const
+bool qtractorTrack::saveStream (
+	qtractorDocument *pDocument, QXmlStreamWriter *pWriter ) const
 {
-	pElement->setAttribute("name", qtractorTrack::trackName());
-	pElement->setAttribute("type",
+	pWriter->writeAttribute("name", qtractorTrack::trackName());
+	pWriter->writeAttribute("type",
 		qtractorTrack::textFromTrackType(qtractorTrack::trackType()));
 
 	// Reset take(record) descriptor/id registry.
 	clearTakeInfo();
 
 	// Save track properties...
-	QDomElement eProps = pDocument->document()->createElement("properties");
+	pWriter->writeStartElement("properties");
 	const QString& sTrackIcon = qtractorTrack::trackIcon();
 	if (!sTrackIcon.isEmpty())
-		pDocument->saveTextElement("icon", sTrackIcon, &eProps);
-	pDocument->saveTextElement("input-bus",
-		qtractorTrack::inputBusName(), &eProps);
-	pDocument->saveTextElement("output-bus",
-		qtractorTrack::outputBusName(), &eProps);
+		pWriter->writeTextElement("icon", sTrackIcon);
+	pWriter->writeTextElement("input-bus",
+		qtractorTrack::inputBusName());
+	pWriter->writeTextElement("output-bus",
+		qtractorTrack::outputBusName());
 	if (qtractorTrack::trackType() == qtractorTrack::Midi) {
-		pDocument->saveTextElement("midi-omni",
-			qtractorDocument::textFromBool(qtractorTrack::isMidiOmni()), &eProps);
-		pDocument->saveTextElement("midi-channel",
-			QString::number(qtractorTrack::midiChannel()), &eProps);
+		pWriter->writeTextElement("midi-omni",
+			qtractorDocument::textFromBool(qtractorTrack::isMidiOmni()));
+		pWriter->writeTextElement("midi-channel",
+			QString::number(qtractorTrack::midiChannel()));
 		if (qtractorTrack::midiBankSelMethod() >= 0) {
-			pDocument->saveTextElement("midi-bank-sel-method",
-				QString::number(qtractorTrack::midiBankSelMethod()), &eProps);
+			pWriter->writeTextElement("midi-bank-sel-method",
+				QString::number(qtractorTrack::midiBankSelMethod()));
 		}
 		if (qtractorTrack::midiBank() >= 0) {
-			pDocument->saveTextElement("midi-bank",
-				QString::number(qtractorTrack::midiBank()), &eProps);
+			pWriter->writeTextElement("midi-bank",
+				QString::number(qtractorTrack::midiBank()));
 		}
 		if (qtractorTrack::midiProg() >= 0) {
-			pDocument->saveTextElement("midi-program",
-				QString::number(qtractorTrack::midiProg()), &eProps);
+			pWriter->writeTextElement("midi-program",
+				QString::number(qtractorTrack::midiProg()));
 		}
 	}
-	pElement->appendChild(eProps);
+	pWriter->writeEndElement();
 
 	// Save track state...
-	QDomElement eState = pDocument->document()->createElement("state");
-	pDocument->saveTextElement("mute",
-		qtractorDocument::textFromBool(qtractorTrack::isMute()), &eState);
-	pDocument->saveTextElement("solo",
-		qtractorDocument::textFromBool(qtractorTrack::isSolo()), &eState);
-	pDocument->saveTextElement("record",
-		qtractorDocument::textFromBool(qtractorTrack::isRecord()), &eState);
-	pDocument->saveTextElement("monitor",
-		qtractorDocument::textFromBool(qtractorTrack::isMonitor()), &eState);
-	pDocument->saveTextElement("gain",
-		QString::number(qtractorTrack::gain()), &eState);
-	pDocument->saveTextElement("panning",
-		QString::number(qtractorTrack::panning()), &eState);
-	pElement->appendChild(eState);
+	pWriter->writeStartElement("state");
+	pWriter->writeTextElement("mute",
+		qtractorDocument::textFromBool(qtractorTrack::isMute()));
+	pWriter->writeTextElement("solo",
+		qtractorDocument::textFromBool(qtractorTrack::isSolo()));
+	pWriter->writeTextElement("record",
+		qtractorDocument::textFromBool(qtractorTrack::isRecord()));
+	pWriter->writeTextElement("monitor",
+		qtractorDocument::textFromBool(qtractorTrack::isMonitor()));
+	pWriter->writeTextElement("gain",
+		QString::number(qtractorTrack::gain()));
+	pWriter->writeTextElement("panning",
+		QString::number(qtractorTrack::panning()));
+	pWriter->writeEndElement();
 
 	// Save track view attributes...
-	QDomElement eView = pDocument->document()->createElement("view");
-	pDocument->saveTextElement("height",
-		QString::number(qtractorTrack::height()), &eView);
-	pDocument->saveTextElement("background-color",
-		qtractorTrack::background().name(), &eView);
-	pDocument->saveTextElement("foreground-color",
-		qtractorTrack::foreground().name(), &eView);
-	pElement->appendChild(eView);
+	pWriter->writeStartElement("view");
+	pWriter->writeTextElement("height",
+		QString::number(qtractorTrack::height()));
+	pWriter->writeTextElement("background-color",
+		qtractorTrack::background().name());
+	pWriter->writeTextElement("foreground-color",
+		qtractorTrack::foreground().name());
+	pWriter->writeEndElement();
 
 	// Save track controllers...
 	QDomElement eControllers
 		= pDocument->document()->createElement("controllers");
 	qtractorTrack::saveControllers(pDocument, &eControllers);
-	pElement->appendChild(eControllers);
+	pDocument->writeElement(pWriter, eControllers);
 
 	// Save track automation...
 	qtractorCurveList *pCurveList = qtractorTrack::curveList();
@@ -1844,29 +2760,39 @@ bool qtractorTrack::saveElement (
 		QDomElement eCurveFile
 			= pDocument->document()->createElement("curve-file");
 		qtractorTrack::saveCurveFile(pDocument, &eCurveFile, &cfile);
-		pElement->appendChild(eCurveFile);
+		pDocument->writeElement(pWriter, eCurveFile);
 	}
 
 	// Clips are not saved when in template mode...
 	if (!pDocument->isTemplate()) {
 		// Save track clips...
-		QDomElement eClips = pDocument->document()->createElement("clips");
+		pWriter->writeStartElement("clips");
 		for (qtractorClip *pClip = qtractorTrack::clips().first();
 				pClip; pClip = pClip->next()) {
-			// Create the new clip element...
-			QDomElement eClip = pDocument->document()->createElement("clip");
-			if (!pClip->saveElement(pDocument, &eClip))
+			// Stream the new clip element...
+			pWriter->writeStartElement("clip");
+			if (!pClip->saveStream(pDocument, pWriter))
 				return false;
-			// Add this clip...
-			eClips.appendChild(eClip);
+			pWriter->writeEndElement();
 		}
-		pElement->appendChild(eClips);
+		pWriter->writeEndElement();
 	}
 
 	// Save track plugins...
 	QDomElement ePlugins = pDocument->document()->createElement("plugins");
 	m_pPluginList->saveElement(pDocument, &ePlugins);
-	pElement->appendChild(ePlugins);
+	pDocument->writeElement(pWriter, ePlugins);
+
+	// Save track freeze (render cache) state, if not archiving...
+	if (!m_sFreezeFilename.isEmpty()
+		&& !pDocument->isTemplate() && !pDocument->isArchive()) {
+		const QDir dir(m_pSession->sessionDir());
+		pWriter->writeStartElement("freeze");
+		pWriter->writeAttribute("post-fader",
+			qtractorDocument::textFromBool(m_bFreezePostFader));
+		pWriter->writeCharacters(dir.relativeFilePath(m_sFreezeFilename));
+		pWriter->writeEndElement();
+	}
 
 	// Reset take(record) descriptor/id registry.
 	clearTakeInfo();
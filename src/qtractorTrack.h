@@ -27,6 +27,7 @@
 #include "qtractorMidiControl.h"
 
 #include <QColor>
+#include <QList>
 
 
 // Forward declarations.
@@ -41,12 +42,16 @@ class qtractorBus;
 class qtractorSubject;
 class qtractorMidiControlObserver;
 class qtractorAudioBufferThread;
+class qtractorAudioBuffer;
+class qtractorAudioRender;
 class qtractorCurveList;
 class qtractorCurveFile;
 class qtractorCurve;
 
 // Special forward declarations.
 class QDomElement;
+class QXmlStreamReader;
+class QXmlStreamWriter;
 class QPainter;
 class QRect;
 
@@ -178,6 +183,20 @@ public:
 	void unlinkClip(qtractorClip *pClip);
 	void removeClip(qtractorClip *pClip);
 
+	// Clip (interval) index maintenance.
+	void updateClip(qtractorClip *pClip);
+	void updateClipIndex();
+
+	// Clip (interval) index lookup (first clip ending at or past frame).
+	qtractorClip *seekClip(unsigned long iFrame) const;
+
+	// Lazy (deferred) clip opening.
+	void deferClip(qtractorClip *pClip);
+	bool openDeferClip(qtractorClip *pClip);
+	int openDeferClips();
+
+	const QList<qtractorClip *>& deferClips() const;
+
 	// Current clip on record (capture).
 	void setClipRecord(qtractorClip *pClipRecord);
 	qtractorClip *clipRecord() const;
@@ -216,6 +235,10 @@ public:
 	// Track special process automation executive.
 	void process_curve(unsigned long iFrame);
 
+	// Track freeze rendering process executive (needed for freeze).
+	void process_freeze(qtractorClip *pClip,
+		unsigned long iFrameStart, unsigned long iFrameEnd, bool bPostFader);
+
 	// Track paint method.
 	void drawTrack(QPainter *pPainter, const QRect& trackRect,
 		unsigned long iTrackStart, unsigned long iTrackEnd,
@@ -233,6 +256,53 @@ public:
 	// Audio buffer ring-cache (playlist) methods.
 	qtractorAudioBufferThread *syncThread();
 
+	// Audio recording (write-behind) thread.
+	qtractorAudioBufferThread *recordThread();
+
+	// Track freeze (render cache) methods.
+	bool freeze(bool bPostFader = true);
+	void unfreeze();
+
+	bool isFrozen() const;
+	bool isFreezePostFader() const;
+	const QString& freezeFilename() const;
+
+	// Track freeze render cache positioning.
+	void seekFreeze(unsigned long iFrame);
+
+	// Take current contents as the frozen ones (eg. on load).
+	void resetFreezeHash();
+
+	// Thaw frozen track if contents have changed ever since.
+	bool updateFreeze();
+
+	// Track-local contents change notification
+	// (frozen track contents are only checked then).
+	void setContentsDirty();
+	bool isContentsDirty() const;
+
+	// Track contents signature (clips, automation, plugins).
+	unsigned int freezeHash() const;
+	unsigned int contentsHash(bool bFader) const;
+
+	// Whether a subject value is currently driven by automation.
+	bool isCurveProcess(qtractorSubject *pSubject) const;
+
+	// Anticipative (render-ahead) processing methods.
+	bool canRenderAhead();
+	void setRenderAhead(bool bRenderAhead);
+	bool isRenderAhead() const;
+
+	// Whether clips are currently being rendered ahead
+	// (otherwise processed as regular, eg. on misses).
+	bool isRenderAheadActive() const;
+
+	// Render all over again (eg. on edits).
+	void resetRenderAhead();
+
+	// Render all over again if contents have changed ever since.
+	bool refreshRenderAhead();
+
 	// Track state (monitor, record, mute, solo) button setup.
 	qtractorSubject *monitorSubject() const;
 	qtractorSubject *recordSubject() const;
@@ -250,9 +320,9 @@ public:
 	// Track state (record, mute, solo) notifier (proto-slot).
 	void stateChangeNotify(ToolType toolType, bool bOn);
 
-	// Document element methods.
-	bool loadElement(qtractorDocument *pDocument, QDomElement *pElement);
-	bool saveElement(qtractorDocument *pDocument, QDomElement *pElement) const;
+	// Document element (streaming) methods.
+	bool loadStream(qtractorDocument *pDocument, QXmlStreamReader *pReader);
+	bool saveStream(qtractorDocument *pDocument, QXmlStreamWriter *pWriter) const;
 
 	// Load/save track state (record, mute, solo) controllers (MIDI).
 	void loadControllers(QDomElement *pElement);
@@ -359,6 +429,14 @@ private:
 
 	qtractorList<qtractorClip> m_clips; // List of clips.
 
+	class ClipIndex;
+	ClipIndex *m_pClipIndex;            // Clip (interval) index.
+
+	QList<qtractorClip *> m_deferClips; // Clips still to be open (lazy).
+
+	// Clip open helper (initial MIDI track bank/program).
+	void openClip(qtractorClip *pClip);
+
 	qtractorClip *m_pClipRecord;        // Current clip on record (capture).
 	unsigned long m_iClipRecordStart;   // Current clip on record start frame.
 
@@ -369,6 +447,30 @@ private:
 	// Audio buffer ring-cache (playlist).
 	qtractorAudioBufferThread *m_pSyncThread;
 
+	// Audio recording (write-behind) thread.
+	qtractorAudioBufferThread *m_pRecordThread;
+
+	// Track freeze render cache.
+	bool openFreeze();
+	void closeFreeze();
+
+	qtractorAudioBuffer *m_pFreezeBuff;
+	QString      m_sFreezeFilename;
+	bool         m_bFreezePostFader;
+	unsigned int m_iFreezeHash;
+
+	// Whether contents might have changed since last check.
+	bool         m_bContentsDirty;
+
+	// Last thawed render cache (kept for re-freezing).
+	QString      m_sThawFilename;
+	bool         m_bThawPostFader;
+	unsigned int m_iThawHash;
+
+	// Anticipative (render-ahead) processing.
+	qtractorAudioRender *m_pRender;
+	unsigned int m_iRenderHash;
+
 	// MIDI track/channel (volume, panning) observers.
 	class MidiVolumeObserver;
 	class MidiPanningObserver;
@@ -158,6 +158,9 @@ bool qtractorTrackCommand::removeTrack (void)
 	if (iTrack < 0)
 		return false;
 
+	// Render-ahead must let go of all clips first...
+	m_pTrack->setRenderAhead(false);
+
 	// Close all clips...
 	qtractorClip *pClip = m_pTrack->clips().last();
 	for ( ; pClip; pClip = pClip->prev())
@@ -749,6 +752,7 @@ bool qtractorEditTrackCommand::redo (void)
 	// Reopen to assign a probable new bus...
 	if (bResult)
 		bResult = m_pTrack->open();
+	m_pTrack->setContentsDirty();
 
 	// Re-acquire track-name for uniqueness...
 	pSession->acquireTrackName(m_pTrack);
@@ -1167,6 +1171,7 @@ bool qtractorTrackGainCommand::redo (void)
 
 	// Set track gain (respective monitor gets set too...)
 	pTrack->setGain(m_fGain);
+	pTrack->setContentsDirty();
 #if 0
 	// MIDI tracks are special...
 	if (pTrack->trackType() == qtractorTrack::Midi) {
@@ -1256,6 +1261,7 @@ bool qtractorTrackPanningCommand::redo (void)
 
 	// Set track panning (respective monitor gets set too...)
 	pTrack->setPanning(m_fPanning);
+	pTrack->setContentsDirty();
 
 	// MIDI tracks are special...
 	if (pTrack->trackType() == qtractorTrack::Midi) {
@@ -66,6 +66,7 @@
 
 #include <QVBoxLayout>
 #include <QProgressBar>
+#include <QProgressDialog>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QFileInfo>
@@ -74,6 +75,10 @@
 
 #include <QHeaderView>
 
+#include <QThread>
+#include <QHash>
+#include <QVector>
+
 
 //----------------------------------------------------------------------------
 // qtractorTracks -- The main session track listview widget.
@@ -559,13 +564,17 @@ bool qtractorTracks::unlinkClip ( qtractorClip *pClip )
 	if (pMidiClip == NULL)
 		return false;
 
-	if (!pMidiClip->isHashLinked())
-		return false;
-
 	qtractorSession *pSession = qtractorSession::getInstance();
 	if (pSession == NULL)
 		return false;
 
+	// Lazy (deferred) clips must be open by now...
+	if (!pSession->openDeferClip(pMidiClip))
+		return false;
+
+	if (!pMidiClip->isHashLinked())
+		return false;
+
 	// Have a new filename revision...
 	const QString& sFilename
 		= pMidiClip->createFilePathRevision(true);
@@ -655,13 +664,158 @@ bool qtractorTracks::splitClip ( qtractorClip *pClip )
 }
 
 
+//----------------------------------------------------------------------------
+// qtractorTracksBatch -- Multi-clip batch executive (worker pool).
+
+// Running batches count (GUI thread only).
+static int g_iTracksBatchBusy = 0;
+
+class qtractorTracksBatch
+{
+public:
+
+	// Constructor.
+	qtractorTracksBatch() : m_iItems(0), m_bCancel(false)
+		{ ATOMIC_SET(&m_next, 0); ATOMIC_SET(&m_done, 0); }
+
+	// Destructor.
+	virtual ~qtractorTracksBatch() {}
+
+	// Run all batch items over a pool of worker threads,
+	// with progress and cancel feedback; false if cancelled.
+	bool execute(int iItems, const QString& sLabel);
+
+	// Worker thread executive.
+	void process();
+
+protected:
+
+	// Batch item executive (worker thread).
+	virtual void processItem(int iItem) = 0;
+
+	// Whether the user has given up.
+	bool isCancelled() const { return m_bCancel; }
+
+private:
+
+	// Instance variables.
+	int m_iItems;
+
+	qtractorAtomic m_next;
+	qtractorAtomic m_done;
+
+	volatile bool m_bCancel;
+};
+
+
+//----------------------------------------------------------------------------
+// qtractorTracksBatchThread -- Multi-clip batch worker thread.
+
+class qtractorTracksBatchThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorTracksBatchThread(qtractorTracksBatch *pBatch)
+		: QThread(), m_pBatch(pBatch) {}
+
+protected:
+
+	// The main thread executive.
+	void run() { m_pBatch->process(); }
+
+private:
+
+	// Instance variables.
+	qtractorTracksBatch *m_pBatch;
+};
+
+
+// Worker thread executive: keep picking items until none left.
+void qtractorTracksBatch::process (void)
+{
+	while (!m_bCancel) {
+		const int iItem = ATOMIC_INC(&m_next) - 1;
+		if (iItem >= m_iItems)
+			break;
+		processItem(iItem);
+		ATOMIC_INC(&m_done);
+	}
+}
+
+
+// Run all batch items over a pool of worker threads.
+bool qtractorTracksBatch::execute ( int iItems, const QString& sLabel )
+{
+	m_iItems = iItems;
+	m_bCancel = false;
+
+	ATOMIC_SET(&m_next, 0);
+	ATOMIC_SET(&m_done, 0);
+
+	if (m_iItems < 1)
+		return true;
+
+	int iThreads = QThread::idealThreadCount();
+	if (iThreads > m_iItems)
+		iThreads = m_iItems;
+	if (iThreads < 1)
+		iThreads = 1;
+
+	++g_iTracksBatchBusy;
+
+	QList<qtractorTracksBatchThread *> threads;
+	for (int i = 0; i < iThreads; ++i) {
+		qtractorTracksBatchThread *pThread = new qtractorTracksBatchThread(this);
+		threads.append(pThread);
+		pThread->start();
+	}
+
+	// Progress and cancel feedback, only if it takes a while;
+	// application modal, as workers walk live clip data...
+	QProgressDialog progress(sLabel, QObject::tr("Cancel"),
+		0, m_iItems, qtractorMainForm::getInstance());
+	progress.setWindowModality(Qt::ApplicationModal);
+	progress.setMinimumDuration(500);
+
+	// Wait for the whole pool, while keeping the UI alive, but
+	// never letting any user edits through (until it's done)...
+	QListIterator<qtractorTracksBatchThread *> iter(threads);
+	while (iter.hasNext()) {
+		qtractorTracksBatchThread *pThread = iter.next();
+		while (!pThread->wait(20)) {
+			progress.setValue(ATOMIC_GET(&m_done));
+			if (progress.wasCanceled())
+				m_bCancel = true;
+			QApplication::processEvents(progress.isVisible()
+				? QEventLoop::AllEvents
+				: QEventLoop::ExcludeUserInputEvents);
+		}
+	}
+
+	qDeleteAll(threads);
+
+	--g_iTracksBatchBusy;
+
+	progress.setValue(m_iItems);
+
+	return !m_bCancel;
+}
+
+
+// Whether a multi-clip batch is running (workers on live clips).
+bool qtractorTracks::isBatchBusy (void)
+{
+	return (g_iTracksBatchBusy > 0);
+}
+
+
 // Audio clip normalize callback.
 struct audioClipNormalizeData
 {	// Ctor.
 	audioClipNormalizeData(unsigned short iChannels)
-		: count(0), channels(iChannels), max(0.0f) {};
+		: channels(iChannels), max(0.0f) {};
 	// Members.
-	unsigned int count;
 	unsigned short channels;
 	float max;
 };
@@ -682,17 +836,168 @@ static void audioClipNormalize (
 				pData->max = fSample;
 		}
 	}
+}
 
-	if (++(pData->count) > 100) {
-		qtractorMainForm *pMainForm = qtractorMainForm::getInstance();
-		if (pMainForm) {
-			QProgressBar *pProgressBar = pMainForm->progressBar();
-			pProgressBar->setValue(pProgressBar->value() + iFrames);
+
+//----------------------------------------------------------------------------
+// qtractorTracksNormalizeBatch -- Audio clip normalize (peak scan) batch.
+//
+// Each clip gets its own private audio buffer sync thread, driven
+// directly from the worker, so that clips of the very same track
+// may be scanned concurrently.
+
+class qtractorTracksNormalizeBatch : public qtractorTracksBatch
+{
+public:
+
+	// Batch item.
+	struct Item
+	{
+		qtractorAudioClip *clip;
+		unsigned long offset;
+		unsigned long length;
+		unsigned short channels;
+		float max;
+	};
+
+	// Batch item registry.
+	void addItem ( qtractorAudioClip *pAudioClip,
+		unsigned long iOffset, unsigned long iLength, unsigned short iChannels )
+	{
+		Item item;
+		item.clip = pAudioClip;
+		item.offset = iOffset;
+		item.length = iLength;
+		item.channels = iChannels;
+		item.max = 0.0f;
+		m_items.append(item);
+	}
+
+	// Batch items accessors.
+	int count() const { return m_items.count(); }
+	const Item& item(int iItem) const { return m_items.at(iItem); }
+
+protected:
+
+	// Batch item executive (worker thread).
+	void processItem ( int iItem )
+	{
+		Item& item = m_items[iItem];
+		// Private sync thread, stopped on destruction...
+		qtractorAudioBufferThread syncThread;
+		syncThread.start();
+		audioClipNormalizeData data(item.channels);
+		(item.clip)->clipExport(audioClipNormalize,
+			&data, item.offset, item.length, &syncThread);
+		item.max = data.max;
+	}
+
+private:
+
+	// Instance variables.
+	QVector<Item> m_items;
+};
+
+
+//----------------------------------------------------------------------------
+// qtractorTracksClipToolBatch -- MIDI clip tools batch.
+
+class qtractorTracksClipToolBatch : public qtractorTracksBatch
+{
+public:
+
+	// Constructor.
+	qtractorTracksClipToolBatch ( qtractorMidiToolsForm *pMidiToolsForm )
+		: qtractorTracksBatch(), m_pMidiToolsForm(pMidiToolsForm) {}
+
+	// Destructor.
+	~qtractorTracksClipToolBatch ()
+	{
+		// Any command not taken over...
+		QVectorIterator<Item> iter(m_items);
+		while (iter.hasNext()) {
+			const Item& item = iter.next();
+			if (item.command)
+				delete item.command;
 		}
-		qtractorSession::stabilize();
-		pData->count = 0;
 	}
-}
+
+	// Batch item.
+	struct Item
+	{
+		qtractorMidiClip *clip;
+		unsigned long timeOffset;
+		unsigned long timeStart;
+		unsigned long timeEnd;
+		qtractorMidiEditCommand *command;
+	};
+
+	// Check if a clip is already part of the editing set.
+	bool isLinkedMidiClip ( qtractorMidiClip *pMidiClip ) const
+	{
+		QVectorIterator<Item> iter(m_items);
+		while (iter.hasNext()) {
+			if ((iter.next().clip)->isLinkedClip(pMidiClip))
+				return true;
+		}
+		return false;
+	}
+
+	// Batch item registry.
+	void addItem ( qtractorMidiClip *pMidiClip, unsigned long iTimeOffset,
+		unsigned long iTimeStart, unsigned long iTimeEnd )
+	{
+		Item item;
+		item.clip = pMidiClip;
+		item.timeOffset = iTimeOffset;
+		item.timeStart = iTimeStart;
+		item.timeEnd = iTimeEnd;
+		item.command = NULL;
+		m_items.append(item);
+	}
+
+	// Batch items accessors.
+	int count() const { return m_items.count(); }
+
+	qtractorMidiClip *clip ( int iItem ) const
+		{ return m_items.at(iItem).clip; }
+
+	// Command hand over.
+	qtractorMidiEditCommand *takeCommand ( int iItem )
+	{
+		qtractorMidiEditCommand *pEditCommand = m_items.at(iItem).command;
+		m_items[iItem].command = NULL;
+		return pEditCommand;
+	}
+
+protected:
+
+	// Batch item executive (worker thread).
+	void processItem ( int iItem )
+	{
+		Item& item = m_items[iItem];
+		qtractorMidiSequence *pSeq = (item.clip)->sequence();
+		// Emulate an user-made selection...
+		qtractorMidiEditSelect select;
+		const QRect rect; // Dummy event rectangle.
+		for (qtractorMidiEvent *pEvent = pSeq->events().first();
+				pEvent; pEvent = pEvent->next()) {
+			const unsigned long iTime = pEvent->time();
+			if (iTime >= item.timeStart && iTime < item.timeEnd)
+				select.addItem(pEvent, rect, rect);
+		}
+		// New edit command from tool...
+		item.command = m_pMidiToolsForm->editCommand(item.clip, &select,
+			item.timeOffset, item.timeStart, item.timeEnd);
+	}
+
+private:
+
+	// Instance variables.
+	qtractorMidiToolsForm *m_pMidiToolsForm;
+
+	QVector<Item> m_items;
+};
 
 
 // MIDI clip normalize callback.
@@ -723,25 +1028,14 @@ bool qtractorTracks::normalizeClip ( qtractorClip *pClip )
 
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
-	// Multiple clip selection...
-	if (isClipSelected()) {
-		qtractorClipSelect *pClipSelect = m_pTrackView->clipSelect();
-		const qtractorClipSelect::ItemList& items = pClipSelect->items();
-		qtractorClipSelect::ItemList::ConstIterator iter = items.constBegin();
-		const qtractorClipSelect::ItemList::ConstIterator& iter_end = items.constEnd();
-		for ( ; iter != iter_end; ++iter) {
-			// Make sure it's legal selection...
-			pClip = iter.key();
-			if (pClip->track() && pClip->isClipSelected())
-				normalizeClipCommand(pClipCommand, pClip);
-		}
-	}	// Single, current clip instead?
-	else normalizeClipCommand(pClipCommand, pClip);
+	// Multiple clip selection or single, current clip instead...
+	const bool bResult
+		= normalizeClipCommand(pClipCommand, selectedClips(pClip));
 
 	QApplication::restoreOverrideCursor();
 
 	// Check if valid...
-	if (pClipCommand->isEmpty()) {
+	if (!bResult || pClipCommand->isEmpty()) {
 		delete pClipCommand;
 		return false;
 	}
@@ -753,71 +1047,81 @@ bool qtractorTracks::normalizeClip ( qtractorClip *pClip )
 
 
 bool qtractorTracks::normalizeClipCommand (
-	qtractorClipCommand *pClipCommand, qtractorClip *pClip )
+	qtractorClipCommand *pClipCommand, const QList<qtractorClip *>& clips )
 {
-	if (pClip == NULL)
-		pClip = m_pTrackView->currentClip();
-	if (pClip == NULL)
-		return false;
-
-	qtractorTrack *pTrack = pClip->track();
-	if (pTrack == NULL)
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == NULL)
 		return false;
 
-	qtractorMainForm *pMainForm = qtractorMainForm::getInstance();
-
-	unsigned long iOffset = 0;
-	unsigned long iLength = pClip->clipLength();
+	// Audio clips without exact peak stats are scanned in parallel...
+	qtractorTracksNormalizeBatch batch;
 
-	if (pClip->isClipSelected()) {
-		iOffset = pClip->clipSelectStart() - pClip->clipStart();
-		iLength = pClip->clipSelectEnd() - pClip->clipSelectStart();
+	QListIterator<qtractorClip *> iter(clips);
+	while (iter.hasNext()) {
+		qtractorClip *pClip = iter.next();
+		qtractorTrack *pTrack = pClip->track();
+		if (pTrack == NULL)
+			continue;
+		// Lazy (deferred) clips must be open by now...
+		if (!pSession->openDeferClip(pClip))
+			continue;
+		unsigned long iOffset = 0;
+		unsigned long iLength = pClip->clipLength();
+		if (pClip->isClipSelected()) {
+			iOffset = pClip->clipSelectStart() - pClip->clipStart();
+			iLength = pClip->clipSelectEnd() - pClip->clipSelectStart();
+		}
+		// Default non-normalized setting...
+		float fGain = pClip->clipGain();
+		if (pTrack->trackType() == qtractorTrack::Audio) {
+			// Normalize audio clip...
+			qtractorAudioClip *pAudioClip
+				= static_cast<qtractorAudioClip *> (pClip);
+			if (pAudioClip == NULL)
+				continue;
+			qtractorAudioBus *pAudioBus
+				= static_cast<qtractorAudioBus *> (pTrack->outputBus());
+			if (pAudioBus == NULL)
+				continue;
+			// Try the (exact) peak file stats first...
+			float fMax = 0.0f;
+			if (!pAudioClip->clipPeak(fMax, iOffset, iLength)) {
+				// Otherwise go through it all, later...
+				batch.addItem(pAudioClip,
+					iOffset, iLength, pAudioBus->channels());
+				continue;
+			}
+			if (fMax > 0.01f && fMax < 1.1f)
+				fGain /= fMax;
+		}
+		else
+		if (pTrack->trackType() == qtractorTrack::Midi) {
+			// Normalize MIDI clip...
+			qtractorMidiClip *pMidiClip
+				= static_cast<qtractorMidiClip *> (pClip);
+			if (pMidiClip == NULL)
+				continue;
+			unsigned char max = 0;
+			pMidiClip->clipExport(midiClipNormalize, &max, iOffset, iLength);
+			if (max > 0x0c && max < 0x7f)
+				fGain *= (127.0f / float(max));
+		}
+		// Make it as an undoable command...
+		pClipCommand->gainClip(pClip, fGain);
 	}
 
-	// Default non-normalized setting...
-	float fGain = pClip->clipGain();
+	// Go through all the (audio) clips left...
+	if (!batch.execute(batch.count(), tr("Normalizing clips...")))
+		return false;
 
-	if (pTrack->trackType() == qtractorTrack::Audio) {
-		// Normalize audio clip...
-		qtractorAudioClip *pAudioClip
-			= static_cast<qtractorAudioClip *> (pClip);
-		if (pAudioClip == NULL)
-			return false;
-		qtractorAudioBus *pAudioBus
-			= static_cast<qtractorAudioBus *> (pTrack->outputBus());
-		if (pAudioBus == NULL)
-			return false;
-		QProgressBar *pProgressBar = NULL;
-		if (pMainForm)
-			pProgressBar = pMainForm->progressBar();
-		if (pProgressBar) {
-			pProgressBar->setRange(0, iLength / 100);
-			pProgressBar->reset();
-			pProgressBar->show();
-		}
-		audioClipNormalizeData data(pAudioBus->channels());
-		pAudioClip->clipExport(audioClipNormalize, &data, iOffset, iLength);
-		if (data.max > 0.01f && data.max < 1.1f)
-			fGain /= data.max;
-		if (pProgressBar)
-			pProgressBar->hide();
-	}
-	else
-	if (pTrack->trackType() == qtractorTrack::Midi) {
-		// Normalize MIDI clip...
-		qtractorMidiClip *pMidiClip
-			= static_cast<qtractorMidiClip *> (pClip);
-		if (pMidiClip == NULL)
-			return false;
-		unsigned char max = 0;
-		pMidiClip->clipExport(midiClipNormalize, &max, iOffset, iLength);
-		if (max > 0x0c && max < 0x7f)
-			fGain *= (127.0f / float(max));
+	for (int iItem = 0; iItem < batch.count(); ++iItem) {
+		const qtractorTracksNormalizeBatch::Item& item = batch.item(iItem);
+		float fGain = (item.clip)->clipGain();
+		if (item.max > 0.01f && item.max < 1.1f)
+			fGain /= item.max;
+		pClipCommand->gainClip(item.clip, fGain);
 	}
 
-	// Make it as an undoable command...
-	pClipCommand->gainClip(pClip, fGain);
-
 	// That's it...
 	return true;
 }
@@ -852,25 +1156,14 @@ bool qtractorTracks::executeClipTool ( int iTool, qtractorClip *pClip )
 
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
-	// Multiple clip selection...
-	if (isClipSelected()) {
-		qtractorClipSelect *pClipSelect = m_pTrackView->clipSelect();
-		const qtractorClipSelect::ItemList& items = pClipSelect->items();
-		qtractorClipSelect::ItemList::ConstIterator iter = items.constBegin();
-		const qtractorClipSelect::ItemList::ConstIterator& iter_end = items.constEnd();
-		for ( ; iter != iter_end; ++iter) {
-			// Make sure it's legal selection...
-			qtractorClip *pClip = iter.key();
-			if (pClip->track() && pClip->isClipSelected())
-				executeClipToolCommand(pClipToolCommand, pClip, &toolsForm);
-		}
-	}	// Single, current clip instead?
-	else executeClipToolCommand(pClipToolCommand, pClip, &toolsForm);
+	// Multiple clip selection or single, current clip instead...
+	const bool bResult = executeClipToolCommand(
+		pClipToolCommand, selectedClips(pClip), &toolsForm);
 
 	QApplication::restoreOverrideCursor();
 
 	// Check if valid...
-	if (pClipToolCommand->isEmpty()) {
+	if (!bResult || pClipToolCommand->isEmpty()) {
 		delete pClipToolCommand;
 		return false;
 	}
@@ -881,76 +1174,97 @@ bool qtractorTracks::executeClipTool ( int iTool, qtractorClip *pClip )
 
 
 bool qtractorTracks::executeClipToolCommand (
-	qtractorClipToolCommand *pClipToolCommand, qtractorClip *pClip,
+	qtractorClipToolCommand *pClipToolCommand,
+	const QList<qtractorClip *>& clips,
 	qtractorMidiToolsForm *pMidiToolsForm )
 {
 	qtractorSession *pSession = qtractorSession::getInstance();
 	if (pSession == NULL)
 		return false;
 
-	if (pClip == NULL)
-		pClip = m_pTrackView->currentClip();
-	if (pClip == NULL)
-		return false;
+	// Edit commands get computed in parallel...
+	qtractorTracksClipToolBatch batch(pMidiToolsForm);
 
-	qtractorTrack *pTrack = pClip->track();
-	if (pTrack == NULL)
-		return false;
-	if (pTrack->trackType() != qtractorTrack::Midi)
-		return false;
+	qtractorTimeScale::Cursor cursor(pSession->timeScale());
 
-	qtractorMidiClip *pMidiClip = static_cast<qtractorMidiClip *> (pClip);
-	if (pMidiClip == NULL)
-		return false;
+	QListIterator<qtractorClip *> iter(clips);
+	while (iter.hasNext()) {
+		qtractorClip *pClip = iter.next();
+		qtractorTrack *pTrack = pClip->track();
+		if (pTrack == NULL)
+			continue;
+		if (pTrack->trackType() != qtractorTrack::Midi)
+			continue;
+		qtractorMidiClip *pMidiClip = static_cast<qtractorMidiClip *> (pClip);
+		if (pMidiClip == NULL)
+			continue;
+		// Lazy (deferred) clips must be open by now...
+		if (!pSession->openDeferClip(pMidiClip))
+			continue;
+		if (batch.isLinkedMidiClip(pMidiClip))
+			continue;
+		unsigned long iOffset = 0;
+		unsigned long iLength = pClip->clipLength();
+		if (pClip->isClipSelected()) {
+			iOffset = pClip->clipSelectStart() - pClip->clipStart();
+			iLength = pClip->clipSelectEnd() - pClip->clipSelectStart();
+		}
+		qtractorMidiSequence *pSeq = pMidiClip->sequence();
+		const unsigned long iTimeOffset = pSeq->timeOffset();
+		qtractorTimeScale::Node *pNode = cursor.seekFrame(pClip->clipStart());
+		const unsigned long t0 = pNode->tickFromFrame(pClip->clipStart());
+		unsigned long f1 = pClip->clipStart() + pClip->clipOffset() + iOffset;
+		pNode = cursor.seekFrame(f1);
+		const unsigned long t1 = pNode->tickFromFrame(f1);
+		unsigned long iTimeStart = t1 - t0;
+		iTimeStart = (iTimeStart > iTimeOffset ? iTimeStart - iTimeOffset : 0);
+		pNode = cursor.seekFrame(f1 += iLength);
+		const unsigned long iTimeEnd = iTimeStart + pNode->tickFromFrame(f1) - t1;
+		batch.addItem(pMidiClip,
+			pSession->tickFromFrame(pClip->clipStart()),
+			iTimeStart, iTimeEnd);
+	}
 
-	if (pClipToolCommand->isLinkedMidiClip(pMidiClip))
+	// Go through all the clips...
+	if (!batch.execute(batch.count(), tr("Processing clips...")))
 		return false;
 
-	unsigned long iOffset = 0;
-	unsigned long iLength = pClip->clipLength();
-
-	if (pClip->isClipSelected()) {
-		iOffset = pClip->clipSelectStart() - pClip->clipStart();
-		iLength = pClip->clipSelectEnd() - pClip->clipSelectStart();
+	for (int iItem = 0; iItem < batch.count(); ++iItem) {
+		// Add new edit command from tool...
+		pClipToolCommand->addMidiEditCommand(batch.takeCommand(iItem));
+		// Must be brand new revision...
+		batch.clip(iItem)->setRevision(0);
 	}
 
-	qtractorMidiSequence *pSeq = pMidiClip->sequence();
-	const unsigned long iTimeOffset = pSeq->timeOffset();
+	// That's it...
+	return true;
+}
+
 
-	qtractorTimeScale::Cursor cursor(pSession->timeScale());
-	qtractorTimeScale::Node *pNode = cursor.seekFrame(pClip->clipStart());
-	const unsigned long t0 = pNode->tickFromFrame(pClip->clipStart());
-
-	unsigned long f1 = pClip->clipStart() + pClip->clipOffset() + iOffset;
-	pNode = cursor.seekFrame(f1);
-	const unsigned long t1 = pNode->tickFromFrame(f1);
-	unsigned long iTimeStart = t1 - t0;
-	iTimeStart = (iTimeStart > iTimeOffset ? iTimeStart - iTimeOffset : 0);
-	pNode = cursor.seekFrame(f1 += iLength);
-	const unsigned long iTimeEnd = iTimeStart + pNode->tickFromFrame(f1) - t1;
-
-	// Emulate an user-made selection...
-	qtractorMidiEditSelect select;
-	const QRect rect; // Dummy event rectangle.	
-	for (qtractorMidiEvent *pEvent = pSeq->events().first();
-			pEvent; pEvent = pEvent->next()) {
-		const unsigned long iTime = pEvent->time();
-		if (iTime >= iTimeStart && iTime < iTimeEnd) {
-			select.addItem(pEvent, rect, rect);
+// Multiple clip selection, or the single given(current) clip instead.
+QList<qtractorClip *> qtractorTracks::selectedClips ( qtractorClip *pClip ) const
+{
+	QList<qtractorClip *> clips;
+
+	if (isClipSelected()) {
+		qtractorClipSelect *pClipSelect = m_pTrackView->clipSelect();
+		const qtractorClipSelect::ItemList& items = pClipSelect->items();
+		qtractorClipSelect::ItemList::ConstIterator iter = items.constBegin();
+		const qtractorClipSelect::ItemList::ConstIterator& iter_end = items.constEnd();
+		for ( ; iter != iter_end; ++iter) {
+			// Make sure it's legal selection...
+			qtractorClip *pClipIter = iter.key();
+			if (pClipIter->track() && pClipIter->isClipSelected())
+				clips.append(pClipIter);
 		}
+	} else {
+		if (pClip == NULL)
+			pClip = m_pTrackView->currentClip();
+		if (pClip)
+			clips.append(pClip);
 	}
 
-	// Add new edit command from tool...
-	pClipToolCommand->addMidiEditCommand(
-		pMidiToolsForm->editCommand(pMidiClip, &select,
-			pSession->tickFromFrame(pClip->clipStart()),
-			iTimeStart, iTimeEnd));
-			
-	// Must be brand new revision...
-	pMidiClip->setRevision(0);
-
-	// That's it...
-	return true;
+	return clips;
 }
 
 
@@ -1590,7 +1904,7 @@ bool qtractorTracks::mergeExportMidiClips ( qtractorClipCommand *pClipCommand )
 			// Do the MIDI merge, itself...
 			qtractorMidiClip *pMidiClip
 				= static_cast<qtractorMidiClip *> (pClip);
-			if (pMidiClip) {
+			if (pMidiClip && pSession->openDeferClip(pMidiClip)) {
 				const unsigned long iTimeClip
 					= pSession->tickFromFrame(pClip->clipStart());
 				const unsigned long iTimeOffset = iTimeClip - iTimeStart;
@@ -172,6 +172,9 @@ public:
 	// Update/sync recording tracks.
 	void updateContentsRecord();
 
+	// Whether a multi-clip batch is running (workers on live clips).
+	static bool isBatchBusy();
+
 protected:
 
 	// Zoom factor constants.
@@ -195,11 +198,14 @@ protected:
 	void zoomCenterPre(ZoomCenter& zc) const;
 	void zoomCenterPost(const ZoomCenter& zc);
 
-	// Multi-clip command builders.
-	bool normalizeClipCommand(
-		qtractorClipCommand *pClipCommand, qtractorClip *pClip);
-	bool executeClipToolCommand(
-		qtractorClipToolCommand *pClipToolCommand, qtractorClip *pClip,
+	// Multiple clip selection, or the single given(current) clip.
+	QList<qtractorClip *> selectedClips(qtractorClip *pClip) const;
+
+	// Multi-clip command builders (in parallel).
+	bool normalizeClipCommand(qtractorClipCommand *pClipCommand,
+		const QList<qtractorClip *>& clips);
+	bool executeClipToolCommand(qtractorClipToolCommand *pClipToolCommand,
+		const QList<qtractorClip *>& clips,
 		qtractorMidiToolsForm *pMidiToolsForm);
 
 	// Common clip-export/merge methods.
@@ -826,6 +826,12 @@ void qtractorVstPlugin::activate (void)
 		vst_dispatch(i, effStartProcess, 0, 0, NULL, 0.0f);
 	#endif
 	}
+
+#ifndef CONFIG_VESTIGE
+	// Audio tail length (0=unknown, 1=none)...
+	const int iTailSize = vst_dispatch(0, effGetTailSize, 0, 0, NULL, 0.0f);
+	setTailLength(iTailSize > 1 ? iTailSize : 0);
+#endif
 }
 
 
@@ -1045,10 +1051,7 @@ void qtractorVstPlugin::freezeConfigs (void)
 #endif
 
 	// Set special plugin configuration item (base64 encoded)...
-	QByteArray data = qCompress(QByteArray(pData, iData)).toBase64();
-	for (int i = data.size() - (data.size() % 72); i >= 0; i -= 72)
-		data.insert(i, "\n       "); // Indentation.
-	setConfig("chunk", data.constData());
+	setConfigBlob("chunk", QByteArray(pData, iData));
 }
 
 void qtractorVstPlugin::releaseConfigs (void)
@@ -13,7 +13,9 @@ HEADERS += config.h \
 	qtractorAbout.h \
 	qtractorAtomic.h \
 	qtractorActionControl.h \
+	qtractorAudioAnalyzer.h \
 	qtractorAudioBuffer.h \
+	qtractorAudioCache.h \
 	qtractorAudioClip.h \
 	qtractorAudioConnect.h \
 	qtractorAudioEngine.h \
@@ -23,6 +25,7 @@ HEADERS += config.h \
 	qtractorAudioMeter.h \
 	qtractorAudioMonitor.h \
 	qtractorAudioPeak.h \
+	qtractorAudioRender.h \
 	qtractorAudioSndFile.h \
 	qtractorAudioVorbisFile.h \
 	qtractorClip.h \
@@ -74,6 +77,7 @@ HEADERS += config.h \
 	qtractorMidiEvent.h \
 	qtractorMidiEventList.h \
 	qtractorMidiFile.h \
+	qtractorMidiFileCache.h \
 	qtractorMidiFileTempo.h \
 	qtractorMidiListView.h \
 	qtractorMidiManager.h \
@@ -144,7 +148,9 @@ HEADERS += config.h \
 SOURCES += \
 	qtractor.cpp \
 	qtractorActionControl.cpp \
+	qtractorAudioAnalyzer.cpp \
 	qtractorAudioBuffer.cpp \
+	qtractorAudioCache.cpp \
 	qtractorAudioClip.cpp \
 	qtractorAudioConnect.cpp \
 	qtractorAudioEngine.cpp \
@@ -154,6 +160,7 @@ SOURCES += \
 	qtractorAudioMeter.cpp \
 	qtractorAudioMonitor.cpp \
 	qtractorAudioPeak.cpp \
+	qtractorAudioRender.cpp \
 	qtractorAudioSndFile.cpp \
 	qtractorAudioVorbisFile.cpp \
 	qtractorClip.cpp \
@@ -198,8 +205,10 @@ SOURCES += \
 	qtractorMidiEditTime.cpp \
 	qtractorMidiEditView.cpp \
 	qtractorMidiEngine.cpp \
+	qtractorMidiEvent.cpp \
 	qtractorMidiEventList.cpp \
 	qtractorMidiFile.cpp \
+	qtractorMidiFileCache.cpp \
 	qtractorMidiFileTempo.cpp \
 	qtractorMidiListView.cpp \
 	qtractorMidiManager.cpp \